@@ -12,12 +12,22 @@
 %   lcaGetPrecision          - read the display precision associated with EPICS PVs
 %   lcaGetUnits              - read the engineering units string associated with EPICS PVs
 %   lcaGetEnumStrings         - read the ENUM strings defined for a PV
+%   lcaGetMetadata           - read units, precision, limits and ENUM strings in one request
 %   lcaGetRetryCount         - read/set the EZCA library retry count parameter
 %   lcaGetTimeout            - read/set the EZCA library timeout parameter
 %   lcaDebugOn               - toggle EZCA library debugging messages on/off
 %   lcaSetSeverityWarnLevel  - set the warning threshold used when reading EPICS 'VAL' PVs
 %   lcaClear                 - clear (destroy/cleanup) channels and associated monitors
+%   lcaNewPVSet              - create a persistent set of PVs for fast repeated lcaGet
+%   lcaClearPVSet            - release a PV set
 %   lcaSetMonitor            - monitor a channel
 %   lcaNewMonitorValue       - check if a monitored channel has new data
 %   lcaNewMonitorWait        - block/wait until a monitored channel has new data
+%   lcaGetQueued             - read all updates queued by a monitor
+%   lcaGetAsync              - start reading PVs without waiting for the values
+%   lcaFetch                 - wait for and return the values of an lcaGetAsync
+%   lcaConnect               - start connecting channels without waiting
+%   lcaGetConnectionState    - return the connection state of channels
+%   lcaGetStats              - return per-channel performance counters
+%   lcaGetLockStats          - return contention of the library lock
 %   lcaLastError             - return error code(s) reported by last faulting lcaXXX operation
@@ -17,6 +17,8 @@
 #include <stdlib.h>
 #include <string.h>
 #include <stdarg.h>
+#include <time.h>
+#include <ctype.h>
 /* #include <strings.h>  index()  */
 /* #include <malloc.h> */
 /* #include <memory.h>  for memcpy()  */
@@ -32,6 +34,8 @@
 #include <shareLib.h>
 
 #include <ezca.h> /* what all users of EZCA include */
+#include <ezcaReg.h>
+#include <ezcaTrace.h>
 
 /* Check consistency between our symbols and CA's (the designers of ezca decided not to export the CA API) */
 #if EZCA_UNITS_SIZE != MAX_UNITS_SIZE
@@ -57,21 +61,67 @@
 extern char *strdup(const char *s1);
 #endif
 
+/* An EZCA_LOCK() call site; collects the statistics of the  */
+/* acquisitions made there (see ezcaGetLockStats()). They are */
+/* static and register themselves when they are first used.   */
+struct lock_site
+{
+    const char *func;
+    int line;
+    struct lock_site *next;
+    char registered;
+    unsigned long count;
+    unsigned long contended;
+    double wait_sum;
+    double wait_max;
+    unsigned long holds;
+    double hold_sum;
+    double hold_max;
+};
+
+#if defined(__STDC_VERSION__) && __STDC_VERSION__ >= 199901L
+#define EZCA_FUNC __func__
+#elif defined(__GNUC__) || defined(_MSC_VER)
+#define EZCA_FUNC __FUNCTION__
+#else
+#define EZCA_FUNC "?"
+#endif
+
+#define LOCK_SITE_INIT { EZCA_FUNC, __LINE__ }
+
 #if 1 && BASE_IS_MIN_VERSION(3,14,0) 
 #define EPICS_THREE_FOURTEEN
 #include <epicsMutex.h>
 #include <epicsEvent.h>
 #include <epicsThread.h>
+#if BASE_IS_MIN_VERSION(3,15,0)
+/* contexts are recycled when their thread exits (see ctx_exit()) */
+#define EZCA_CTX_AT_EXIT
+#endif
 static epicsMutexId	ezcaMutex       = 0;
-/* count outstanding CA requests and post 'ezcaDone' when
- * no more requests are outstanding.
+/* Every thread counts its outstanding CA requests (in its
+ * context, see struct context) and has the context's 'done'
+ * event posted when no more requests are outstanding.
  * This is more efficient than ca_pend_event() which always
  * waits for the full timeout to expire. We take advantage
  * of 3.14 being multithreaded here since another CA worker
  * thread handles CA activity for us.
  */
-static volatile int ezcaOutstanding = 0;
-static epicsEventId ezcaDone        = 0;
+/* posted when an async group's last request reports */
+static epicsEventId ezcaTicketDone  = 0;
+/* get and put callbacks count down without ezcaMutex; the
+ * counters (those of the contexts and of the tickets) are
+ * protected by this one which is only held for the update.
+ */
+static epicsMutexId	ezcaCountMutex  = 0;
+/* the calling thread's struct context */
+static epicsThreadPrivateId ezcaCtxKey;
+/* a plain mutex (EPICS 3.14 has no reader/writer lock) taken, with
+ * ezcaMutex held, for modifying the channel registry; lookups need
+ * either of the two so that callbacks can look up a channel without
+ * ezcaMutex (see my_connection_callback()).
+ */
+static epicsMutexId	ezcaRegMutex    = 0;
 
 #ifndef EZCA_MALLOC_TRACE
 #define ezcamalloc	malloc
@@ -82,12 +132,19 @@ static epicsEventId ezcaDone        = 0;
 #define DEBUG_LOCK 0
 
 #define	EZCA_LOCK() \
+	do { \
+		static struct lock_site site_ = LOCK_SITE_INIT; \
+		EZCA_LOCK_AT(&site_); \
+	} while (0)
+#define	EZCA_LOCK_AT(sp) \
 	do { \
 		if (DEBUG_LOCK)								\
 		printf("Thread %s (0x%lx) tries to lock\n",	\
 			epicsThreadGetNameSelf(),				\
 			(unsigned long)epicsThreadGetIdSelf()); \
-		epicsMutexLock(ezcaMutex);					\
+		EZCA_TRACE(EZCA_EV_LOCK_WAIT, ezcaMutex, 0, 0); \
+		lock_enter(sp);								\
+		EZCA_TRACE(EZCA_EV_LOCK, ezcaMutex, 0, 0); \
 	} while (0)
 #define	EZCA_UNLOCK()	\
 	do { \
@@ -95,48 +152,159 @@ static epicsEventId ezcaDone        = 0;
 		printf("Thread %s (0x%lx) unlocks\n",		\
 			epicsThreadGetNameSelf(),				\
 			(unsigned long)epicsThreadGetIdSelf()); \
-		epicsMutexUnlock(ezcaMutex); 				\
+		EZCA_TRACE(EZCA_EV_UNLOCK, ezcaMutex, 0, 0); \
+		lock_leave(); 								\
 	} while (0)
 #define DO_INIT_ONCE() \
 	do { epicsThreadOnce(&Initialized, init, 0); } while (0)
 
-/* remember # of outstanding requests and flush */
-#define MARK_OUTSTANDING(n) do { if ( (ezcaOutstanding = (n)) ) ca_flush_io(); } while (0)
+/* add the # of requests just issued (by the thread holding the
+ * lock) and flush. Callbacks may have counted some of them down
+ * already (the count is negative then); if all have, the context's
+ * 'done' is posted for the waiter.
+ */
+#define MARK_OUTSTANDING(n) \
+	do { \
+		epicsMutexLock(ezcaCountMutex); \
+		if ( 0 == (Ctx->outstanding += (n)) && (n) ) \
+			epicsEventSignal(Ctx->done); \
+		epicsMutexUnlock(ezcaCountMutex); \
+		if ( n ) \
+			ca_flush_io(); \
+	} while (0)
+/* nothing issued yet; late callbacks of earlier requests never count.
+ * Only the owning thread adds to its count, so if it reads zero
+ * without the lock there is nothing to reset (the common case).
+ */
+#define RESET_OUTSTANDING() \
+	do { \
+		if ( Ctx->outstanding ) { \
+			epicsMutexLock(ezcaCountMutex); \
+			Ctx->outstanding = 0; \
+			epicsMutexUnlock(ezcaCountMutex); \
+		} \
+	} while (0)
+
+/* every channel node has a lock of its own (created with the node;
+ * nodes are never freed) protecting the monitors of the channel
+ * (buffer hand-off, queues, waiters), its statistics and the work
+ * which has a callback outstanding on the channel (see 'cbcp' in
+ * struct work). It is only held for short copies, never across a
+ * CA call which may wait for a callback. Lock order is ezcaMutex,
+ * channel lock, ezcaCountMutex.
+ */
+#define CHAN_LOCK(cp) \
+	do { \
+		EZCA_TRACE(EZCA_EV_LOCK_WAIT, (cp)->lock, 0, 0); \
+		epicsMutexLock((cp)->lock); \
+		EZCA_TRACE(EZCA_EV_LOCK, (cp)->lock, 0, 0); \
+	} while (0)
+#define CHAN_UNLOCK(cp) \
+	do { \
+		EZCA_TRACE(EZCA_EV_UNLOCK, (cp)->lock, 0, 0); \
+		epicsMutexUnlock((cp)->lock); \
+	} while (0)
+#define CHAN_LOCK_INIT(cp) \
+	do { (cp)->lock = epicsMutexMustCreate(); } while (0)
+
+#define REG_LOCK()   do { epicsMutexLock(ezcaRegMutex); } while (0)
+#define REG_UNLOCK() do { epicsMutexUnlock(ezcaRegMutex); } while (0)
 
-/* decrement # of outstanding requests and post 'ezcaDone' when zero is reached */
-#define POST_DONE() do { if ( --ezcaOutstanding == 0 ) epicsEventSignal(ezcaDone); if ( ezcaOutstanding < 0 ) { fprintf(stderr,"EZCA FATAL ERROR; no outstanding transaction expected\n"); exit(1); }; } while (0)
+/* decrement # of outstanding requests of context 'cx' and post its
+ * 'done' when zero is reached
+ */
+#define POST_DONE(cx) \
+	do { \
+		epicsMutexLock(ezcaCountMutex); \
+		if ( --(cx)->outstanding == 0 ) \
+			epicsEventSignal((cx)->done); \
+		epicsMutexUnlock(ezcaCountMutex); \
+	} while (0)
+/* book 'n' bytes of monitor memory; monitor callbacks (re)allocate */
+/* their buffers holding the channel lock only                      */
+#define MONMEM_ADD(n) \
+	do { \
+		epicsMutexLock(ezcaCountMutex); \
+		MonitorMem += (n); \
+		epicsMutexUnlock(ezcaCountMutex); \
+	} while (0)
 #else
 #define EZCA_LOCK() \
 	do { \
 	} while (0)
+#define EZCA_LOCK_AT(sp) \
+	do { \
+	} while (0)
 #define EZCA_UNLOCK() \
 	do { \
 	} while (0)
 #define DO_INIT_ONCE() \
     do { if (!Initialized) init(0); } while (0)
-#define MARK_OUTSTANDING(n) do { } while (0)
-#define POST_DONE() do { } while (0)
+/* callbacks are executed from ca_pend_event() in our own
+ * thread; we still count them so that waiting for a group
+ * doesn't have to scan the work list.
+ */
+#define MARK_OUTSTANDING(n) do { if ( (Ctx->outstanding = (n)) ) ca_flush_io(); } while (0)
+#define RESET_OUTSTANDING() do { Ctx->outstanding = 0; } while (0)
+#define POST_DONE(cx) do { if ( (cx)->outstanding > 0 ) (cx)->outstanding--; } while (0)
+#define MONMEM_ADD(n) do { MonitorMem += (n); } while (0)
+#define CHAN_LOCK(cp) \
+	do { \
+	} while (0)
+#define CHAN_UNLOCK(cp) \
+	do { \
+	} while (0)
+#define CHAN_LOCK_INIT(cp) \
+	do { \
+	} while (0)
+#define REG_LOCK() \
+	do { \
+	} while (0)
+#define REG_UNLOCK() \
+	do { \
+	} while (0)
 #endif
 
+/* count down the group a piece of work belongs to; work of an
+ * async group (ezcaEndGroupAsync()) is counted by its ticket
+ */
+#define WORK_DONE(wp) do { if ( (wp)->ticket ) ticket_done((wp)->ticket); else POST_DONE((wp)->ctx); } while (0)
+
 
 #define BOOL  char
 #define FALSE 0
 #define TRUE  1
 
-#define NODESPERMAL 3
+/* channel, monitor and work nodes are carved from slabs of
+ * NodesPerSlab nodes (see ezcaSetNodesPerSlab()); every node
+ * starts on a cache line of its own.
+ */
+#define NODESPERSLAB 64
+#define CACHELINE    64
+
+/* Initial # of buckets of the channel registry; it grows as needed */
+#define CHANNEL_BUCKETS 256
 
-/* For Hashing.                                                      */
-/* The hash algorithm is the algorithm described in:                 */
-/* "Fast Hashing of Variable Length Text Strings", Peter K. Pearson, */
-/* Communications of the ACM, June 1990.                             */
-/* DO NOT CHANGE THE VALUE OF HASHTABLESIZE!!!!!!!!!                 */
-#define HASHTABLESIZE 256
+/* channels evicted per pass at most and the time between passes */
+/* (see evict_channels())                                         */
+#define EVICT_BUDGET 64
+#define EVICT_PERIOD 1.0
+/* without the eviction thread every EVICT_CALLS-th call (a power */
+/* of two) checks whether a pass is due                           */
+#define EVICT_CALLS  64
 
 #define SHORT_TIME ((float)1.e-12)
+/* without a CA thread, waiting for async groups must poll */
+#define TICKET_POLL_TIME ((float)0.05)
 #define MAXPVARNAMELENGTH ((PVNAME_SZ)+(FLDNAME_SZ)+2)
 
 #define UNDEFINED -1
 
+/* ezcadatatype of a monitor which only holds a subscription shared
+ * by the monitors of all (numeric) types on a channel
+ */
+#define SHARED_SOURCE ((char) -2)
+
 /**************/
 /*            */
 /* Work Types */
@@ -174,6 +342,33 @@ static epicsEventId ezcaDone        = 0;
 #define GETWARNLIMITS       28
 #define GETALARMLIMITS      29
 #define GETENUMSTATES       30
+#define RESOLVE             31
+#define RELEASEHANDLE       32
+#define PREPAREGROUP        33
+#define EXECUTEGROUP        34
+#define FREEGROUP           35
+#define SETNOTFOUNDHOLDOFF  36
+#define GETNOTFOUNDHOLDOFF  37
+#define SETMONITORQUEUED    38
+#define GETQUEUED           39
+#define SETNODESPERSLAB     40
+#define GETNODESTATS        41
+#define GETWORKALLOCS       42
+#define ENDGROUPASYNC       43
+#define ADDMONITORCALLBACK  44
+#define REMOVEMONITORCALLBACK 45
+#define CONNECTMANY         46
+#define SAVECHANNELS        47
+#define LOADCHANNELS        48
+#define SETCACHEPOLICY      49
+#define GETCACHESTATS       50
+#define GETMETADATA         51
+
+/* work types answered from a DBR_CTRL_xxx (see struct chanmeta) */
+#define META_WORK(t) \
+	(GETUNITS == (t) || GETPRECISION == (t) || GETGRAPHICLIMITS == (t) \
+	|| GETCONTROLLIMITS == (t) || GETWARNLIMITS == (t) \
+	|| GETALARMLIMITS == (t) || GETENUMSTATES == (t) || GETMETADATA == (t))
 
 /********************************/
 /*                              */
@@ -222,6 +417,27 @@ static epicsEventId ezcaDone        = 0;
 #define MONBLOCK_MSG			"ezcaNewMontorWait()"
 #define GETWARNLIMITS_MSG       "ezcaGetWarnLimits()"
 #define GETALARMLIMITS_MSG      "ezcaGetAlarmLimits()"
+#define RESOLVE_MSG             "ezcaResolve()"
+#define RELEASEHANDLE_MSG       "ezcaReleaseHandle()"
+#define PREPAREGROUP_MSG        "ezcaPrepareGroup()"
+#define EXECUTEGROUP_MSG        "ezcaExecuteGroup()"
+#define FREEGROUP_MSG           "ezcaFreeGroup()"
+#define SETNOTFOUNDHOLDOFF_MSG  "ezcaSetNotFoundHoldoff()"
+#define GETNOTFOUNDHOLDOFF_MSG  "ezcaGetNotFoundHoldoff()"
+#define SETMONITORQUEUED_MSG    "ezcaSetMonitorQueued()"
+#define GETQUEUED_MSG           "ezcaGetQueued()"
+#define SETNODESPERSLAB_MSG     "ezcaSetNodesPerSlab()"
+#define GETNODESTATS_MSG        "ezcaGetNodeStats()"
+#define GETWORKALLOCS_MSG       "ezcaGetWorkAllocs()"
+#define ENDGROUPASYNC_MSG       "ezcaEndGroupAsync()"
+#define ADDMONITORCALLBACK_MSG  "ezcaAddMonitorCallback()"
+#define REMOVEMONITORCALLBACK_MSG "ezcaRemoveMonitorCallback()"
+#define CONNECTMANY_MSG         "ezcaConnectMany()"
+#define SAVECHANNELS_MSG        "ezcaSaveChannels()"
+#define LOADCHANNELS_MSG        "ezcaLoadChannels()"
+#define SETCACHEPOLICY_MSG      "ezcaSetCachePolicy()"
+#define GETCACHESTATS_MSG       "ezcaGetCacheStats()"
+#define GETMETADATA_MSG         "ezcaGetMetadata()"
 /* Error Messages */
 #define INVALID_PVNAME_MSG  "invalid process variable name"
 #define INVALID_TYPE_MSG    "invalid EZCA data type"
@@ -252,6 +468,14 @@ static epicsEventId ezcaDone        = 0;
 #define NO_MONITOR_MSG         "no monitor on PV/type found" 
 #define ABORTED_MSG            "EZCA call aborted by user"
 #define INTERNALERR_MSG        "EZCA internal error"
+#define INVALID_HANDLE_MSG     "invalid (released?) handle"
+#define NOT_PREPARABLE_MSG     "work cannot be part of a prepared group"
+#define RECENTLY_NOT_FOUND_MSG "process variable recently not found"
+#define NOT_QUEUED_MSG         "no queued monitor on PV/type found"
+#define QUEUE_CONFLICT_MSG     "monitor exists with a different queue depth"
+#define FILE_ACCESS_MSG        "unable to access file"
+#define GROUP_BUSY_MSG         "prepared group is running in another thread"
+#define MONITOR_CAP_MSG        "monitor memory cap (ezcaSetCachePolicy()) reached"
 
 /************************/
 /*                      */
@@ -288,7 +512,15 @@ static char *ErrorMsgs[] =
 
 	NO_MONITOR_MSG,
 	ABORTED_MSG,
-	INTERNALERR_MSG
+	INTERNALERR_MSG,
+	INVALID_HANDLE_MSG,
+	NOT_PREPARABLE_MSG,
+	RECENTLY_NOT_FOUND_MSG,
+	NOT_QUEUED_MSG,
+	QUEUE_CONFLICT_MSG,
+	FILE_ACCESS_MSG,
+	GROUP_BUSY_MSG,
+	MONITOR_CAP_MSG
 };
 
 /* These MUST match the above table */
@@ -319,6 +551,14 @@ static char *ErrorMsgs[] =
 #define NO_MONITOR_MSG_IDX         23
 #define ABORTED_MSG_IDX            24
 #define INTERNALERR_MSG_IDX        25
+#define INVALID_HANDLE_MSG_IDX     26
+#define NOT_PREPARABLE_MSG_IDX     27
+#define RECENTLY_NOT_FOUND_MSG_IDX 28
+#define NOT_QUEUED_MSG_IDX         29
+#define QUEUE_CONFLICT_MSG_IDX     30
+#define FILE_ACCESS_MSG_IDX        31
+#define GROUP_BUSY_MSG_IDX         32
+#define MONITOR_CAP_MSG_IDX        33
 
 /**********************/
 /*                    */
@@ -338,37 +578,182 @@ typedef enum {
 	needs_reading = 1
 } MON_STATE;
 
+/* points in time (deadlines and stamps, see set_deadline()) */
+#ifdef EPICS_THREE_FOURTEEN
+typedef epicsTimeStamp Deadline_t;
+#else
+typedef time_t Deadline_t;
+#endif
+
+/* one copy of the data delivered by a monitor */
+struct monbuf
+{
+    void *pval;
+    unsigned size; /* bytes allocated at pval */
+    int nelem;     /* UNDEFINED if this buffer holds no value */
+    /* other info */
+    short status;
+    short severity;
+    epicsTimeStamp time_stamp;
+};
+
+/* Optional queue of every update of a monitor (ezcaSetMonitorQueued()).
+ * The callback is the only producer and fills the slot at 'tail',
+ * ezcaGetQueued() (holding ezcaMutex) the only consumer reading from
+ * 'head'. Only 'count' and 'dropped' are shared (under the lock of
+ * the channel) so that neither copies while holding the lock. Updates arriving while
+ * the queue is full are dropped (and counted).
+ */
+struct monq
+{
+    unsigned depth;
+    unsigned head;  /* consumer only */
+    unsigned tail;  /* producer only */
+    unsigned count;
+    unsigned long dropped;
+    int nelem;      /* elements per slot */
+    int dbr_type;   /* of the elements */
+    int esize;      /* bytes per element */
+    char *data;     /* depth * nelem * esize */
+    int *nvals;     /* # of elements actually held by each slot */
+    short *status;
+    short *severity;
+    epicsTimeStamp *time_stamp;
+};
+
+/* Monitor data is triple buffered: the CA callback fills 'back'
+ * and swaps it with 'mid', readers swap 'mid' into 'front' if it
+ * is 'fresh' and copy from 'front'. Only the swaps (and 'fresh',
+ * 'needs_reading' and 'waiter') are protected by the channel lock
+ * (CHAN_LOCK()); 'back' belongs to the callback and 'front' to the (ezcaMutex holding)
+ * reader so neither ever waits for the other's memcpy.
+ */
 struct monitor
 {
 	struct work    *waiter;	/* work struct waiting for this monitor */
     struct monitor *left;
     struct monitor *right;
-    struct channel *cp; /* for debugging printing only */
+    struct channel *cp; /* whose lock protects the hand-off */
     char ezcadatatype;
     char dbr_type;
     evid evd;
     BOOL needs_reading;
+    BOOL fresh;  /* mid holds data which was not swapped to front yet */
     BOOL active; /* only goes active after OK add_event and OK pend_io */
-    int last_nelem;
-    void *pval;
-    /* other info */
-    short status;
-    short severity;
-    epicsTimeStamp time_stamp;
+    struct monbuf *front;
+    struct monbuf *mid;
+    struct monbuf *back;
+    struct monbuf buf[3];
+    struct monq *queue; /* NULL unless queued */
+    /* The monitor owning the CA subscription, buffers and queue; this
+     * is the monitor itself or a SHARED_SOURCE whose data are converted
+     * to ezcadatatype when read.
+     */
+    struct monitor *src;
+    int nviews; /* # of monitors using this one as their 'src' */
+    unsigned long count; /* requested from CA (0: native count) */
+    /* statistics of the subscription (see ezcaGetStats()); */
+    /* written by the callback under the channel lock       */
+    unsigned long nupdates;
+    Deadline_t last_update;
+    double interval_sum;
+    double interval_max;
+    double bytes;
 }; /* end struct monitor */
 
+/* A user callback (ezcaAddMonitorCallback()) has a CA subscription of
+ * its own whose updates are handed to 'fn' right out of the CA buffer;
+ * it keeps no data and the callback takes no lock. The list hanging
+ * off the channel is only used under ezcaMutex. 'active' is cleared
+ * before the subscription is cleared; ca_clear_event() waits for a
+ * callback which is running.
+ */
+struct moncb
+{
+    struct moncb *next;
+    struct channel *cp;
+    char ezcadatatype;
+    int dbr_type;
+    evid evd;
+    EzcaMonitorCallback fn;
+    void *arg;
+    BOOL active;
+}; /* end struct moncb */
+
+/* counters of a channel (see ezcaGetStats()); under CHAN_LOCK() */
+struct chanstats
+{
+    Deadline_t		searched;	/* search was issued */
+    double		connect_time;	/* < 0: never connected */
+    unsigned long	connects;
+    unsigned long	gets;
+    unsigned long	puts;
+    double		bytes_in;
+    double		bytes_out;
+    unsigned long	latency[EZCA_STATS_NBINS];
+    unsigned long	nlatency;
+    double		latency_sum;
+    double		latency_max;
+}; /* end struct chanstats */
+
+/* control metadata of a channel: the last DBR_CTRL_xxx (of the native
+ * type) received for it, by a metadata request or by the DBE_PROPERTY
+ * subscription which keeps it current (see meta_subscribe()). Invalid
+ * while disconnected. Allocated with the first reply and kept with the
+ * channel node. Under CHAN_LOCK().
+ */
+struct chanmeta
+{
+    BOOL		valid;
+    int			dbr_type;
+    EzcaMetadataRec	md;
+}; /* end struct chanmeta */
+
 struct channel
 {
+    EzcaRegNodeRec	reg;	/* MUST be first; see REG2CHANNEL() */
     struct channel	*next;
     char 		*pvname;
     chid		cid;
 	struct monitor *monitor_list;
+    struct moncb	*callbacks; /* see ezcaAddMonitorCallback() */
     int			refcnt;
+    int			nhandles; /* # of EzcaHandles; each also holds a refcnt */
+    struct work		*pending; /* group work waiting for the connection */
+    struct work		*inflight; /* gets others may join (see join_get()); */
+				   /* under CHAN_LOCK() */
+    time_t		not_found_at; /* search failed (negative cache) or 0 */
 #define SEARCHED	1
 #define CONNECTED	2
     char		ever_successfully_searched;
+    struct chanstats	stats;	/* under CHAN_LOCK() */
+    struct chanmeta	*meta;	/* NULL until metadata arrived */
+    evid		meta_evd; /* DBE_PROPERTY subscription or NULL */
+    BOOL		meta_subscribing; /* meta_subscribe() in progress */
+    /* Lru (see touch_channel()); 'next' is only used while the */
+    /* channel is not cached or is about to be evicted           */
+    struct channel	*lru_prev;
+    struct channel	*lru_next;
+    Deadline_t		last_used;
+#ifdef EPICS_THREE_FOURTEEN
+    epicsMutexId	lock;	/* see CHAN_LOCK() */
+#endif
 }; /* end struct channel */
 
+#define REG2CHANNEL(n)	((struct channel *)(n))
+/* An EzcaHandle points to one of these. Records are recycled   */
+/* but never freed: a released handle has a NULL 'cp' (until the */
+/* record is handed out again) rather than pointing at a channel */
+/* node which may have been recycled meanwhile. Under ezcaMutex. */
+struct EzcaHandleRec_
+{
+    struct channel		*cp;
+    struct EzcaHandleRec_	*next;	/* on Handle_avail_hdr */
+};
+
+/* what an invalid handle maps to; it has no handles (see check_target()) */
+#define H2CHANNEL(h)	((h) && (h)->cp ? (h)->cp : &Invalid_channel)
+
 /* map to printable chars at offset 'U'... */
 typedef enum { usable=0, trashed='T'-'U', recyclable='R'-'U' } Trash_t;
 
@@ -398,14 +783,46 @@ struct work
     epicsTimeStamp *tsp;
     chid *pchid;
     evid *pevid;
+    BOOL deferred;              /* waiting on cp->pending for a connection */
+    struct work *next_pending;
+    BOOL in_arena;              /* pvname, aux_error_msg and PUT data are */
+                                /* in the group arena of 'ctx' (see       */
+                                /* work_strdup())                         */
+    EzcaTicket ticket;          /* async group owning the node or NULL    */
+    struct context *ctx;        /* thread which counts the node (unless   */
+                                /* 'ticket' does) and owns its arena      */
+    Deadline_t issued;          /* CA request sent (round trip statistics) */
+    struct channel *cbcp;       /* channel a get/put callback is pending */
+                                /* on; its lock guards the node until    */
+                                /* the callback reported or was ignored  */
+    struct work *next_inflight; /* on cbcp->inflight                     */
+    struct work *joined;        /* nodes sharing this one's get reply    */
 }; /* end struct work */
 
+/* work created via a handle has no pvname of its own */
+#define WORK_PVNAME(wp) \
+	((wp)->pvname ? (wp)->pvname : ((wp)->cp && (wp)->cp->pvname ? (wp)->cp->pvname : ""))
+
 struct work_list
 {
     struct work *head;
     struct work *tail;
 }; /* end struct work_list */
 
+/* A prepared group owns its work nodes. 'tmpl' holds pristine */
+/* copies of them (including a channel reference each) which   */
+/* are restored before every execution. A NULL slot in 'work'  */
+/* means the node had to be trashed and must be replaced.      */
+/* 'attached' is the context whose work list holds the nodes   */
+/* (the thread which prepared or last executed the group).     */
+struct EzcaGroupRec_
+{
+    int nwork;
+    struct work **work;
+    struct work *tmpl;
+    struct context *attached;
+}; /* end struct EzcaGroupRec_ */
+
 /**************************/
 /*                        */
 /* Local Global Variables */
@@ -418,25 +835,170 @@ static /*volatile*/ epicsThreadOnceId Initialized = 0;
 static BOOL Initialized = FALSE;
 #endif
 
-static struct work_list Work_list;
-static struct work *Workp;
-static struct channel *Channels[HASHTABLESIZE];
+static EzcaReg Channels;
+/* the cached channels, least recently used first; under ezcaMutex */
+static struct channel *LruHead;
+static struct channel *LruTail;
+/* # of channels evict_channels() has cleared */
+static unsigned long Evictions;
+/* bytes of monitor buffers and queues; see MONMEM_ADD() */
+static double MonitorMem;
+/* TRUE while evict_thread() runs; otherwise prologue() evicts */
+static BOOL EvictInBackground = FALSE;
+static Deadline_t EvictDue;
+static unsigned EvictCalls;
+#ifdef EPICS_THREE_FOURTEEN
+static epicsEventId EvictWake;
+/* asks evict_thread() to exit; it posts EvictDone when it has */
+static BOOL EvictStop = FALSE;
+static epicsEventId EvictDone;
+#endif
 
 static struct channel *Channel_avail_hdr;
+static struct EzcaHandleRec_ *Handle_avail_hdr;
+static struct channel Invalid_channel;
 static struct monitor *Monitor_avail_hdr;
 static struct work *Work_avail_hdr;
 
 static struct channel *Discarded_channels;
 static struct monitor *Discarded_monitors;
 static struct work *Discarded_work;
+/* user callbacks whose subscription could not be cleared */
+static struct moncb *Discarded_callbacks;
+
+/* occupancy of the node slabs; nodes are either on the */
+/* avail list, on the discarded list or in use          */
+struct node_pool
+{
+    size_t stride;             /* node size rounded up to CACHELINE */
+    unsigned long nslabs;
+    unsigned long nnodes;
+    unsigned long navail;
+    unsigned long ndiscarded;
+};
+
+/* bump allocator for the names, error strings and PUT data of */
+/* grouped work; empty_work_list() releases it in one step.    */
+struct arena_blk
+{
+    struct arena_blk *next;
+    size_t size;
+    size_t used;
+}; /* end struct arena_blk */
+
+struct arena
+{
+    struct arena_blk *blks;    /* current block first */
+    size_t total;              /* bytes in all blocks */
+    size_t hint;               /* size of the next first block */
+}; /* end struct arena */
+
+#define ARENA_ALIGN   sizeof(double)
+#define ARENA_ROUND(n) (((n) + ARENA_ALIGN - 1) & ~(ARENA_ALIGN - 1))
+#define ARENA_HDR     ARENA_ROUND(sizeof(struct arena_blk))
+#define ARENA_BLKSIZE 4096
+/* arena memory kept across groups */
+#define ARENA_KEEP    (4*1024*1024)
+
+/* A group ended by ezcaEndGroupAsync(). It takes over the work  */
+/* list and the arena of the group; callbacks count down its own */
+/* 'outstanding' instead of that of the context. 'finished' is set */
+/* once the final rcs have been assigned (finish_group()).       */
+struct EzcaTicketRec_
+{
+    struct EzcaTicketRec_ *next;
+    struct work_list work;
+    struct arena arena;
+    int outstanding;
+    Deadline_t deadline;
+    BOOL finished;
+}; /* end struct EzcaTicketRec_ */
+
+/* The group and single-work state of a thread. A context is */
+/* created when its thread first uses one (see ctx_self())    */
+/* and is only used by that thread with ezcaMutex held -      */
+/* except for 'outstanding' (under ezcaCountMutex) which      */
+/* callbacks count down for the work the thread has issued,   */
+/* and 'awaiting' (see post_connected()). Threads running     */
+/* groups at the same time hence don't see each other's lists */
+/* and counters. Work nodes and tickets refer to their        */
+/* context, so contexts are never freed; when its thread      */
+/* exits a context is emptied and kept for the next thread    */
+/* (EPICS 3.15 and later; 3.14 has no hook for a thread's     */
+/* exit).                                                     */
+struct context
+{
+    struct context *next;
+    struct work_list work_list;
+    struct work *workp;
+    /* prepared group whose nodes are currently on work_list (if any) */
+    EzcaGroup work_list_group;
+    struct arena group_arena;
+    char error_location;
+    char list_print;
+    BOOL in_group;
+    /* channel a single request waits to connect (wait_connected()) */
+    struct channel *awaiting;
+    volatile int outstanding;
+#ifdef EPICS_THREE_FOURTEEN
+    epicsEventId done;
+#endif
+}; /* end struct context */
+
+/* all contexts in use */
+static struct context *Contexts;
+/* contexts of threads which have exited */
+static struct context *Context_avail_hdr;
+#ifdef EPICS_THREE_FOURTEEN
+/* the calling thread's */
+#define Ctx             (ctx_self())
+#else
+/* the one and only thread's */
+static struct context *Ctx;
+#endif
+
+#define Work_list       (Ctx->work_list)
+#define Workp           (Ctx->workp)
+#define Work_list_group (Ctx->work_list_group)
+#define Group_arena     (Ctx->group_arena)
+#define ErrorLocation   (Ctx->error_location)
+#define ListPrint       (Ctx->list_print)
+#define InGroup         (Ctx->in_group)
 
-static char ErrorLocation;
-static char ListPrint;
+/* tickets not collected yet */
+static EzcaTicket Tickets;
+/* # of heap allocations made for work strings and PUT data */
+static unsigned long WorkAllocs;
+
+static struct node_pool ChannelPool;
+static struct node_pool MonitorPool;
+static struct node_pool WorkPool;
+static int NodesPerSlab = NODESPERSLAB;
 
 /* User Configurable Parameters */
 static BOOL AutoErrorMessage;
-static BOOL InGroup;
 static float TimeoutSeconds;
+/* CA delivers callbacks from its own threads; no need to pend for them */
+static BOOL PreemptiveCallbacks = FALSE;
+#ifdef EPICS_THREE_FOURTEEN
+/* the context created by init(); threads using ezca attach to it */
+static struct ca_client_context *CaContext;
+/* EZCA_LOCK() statistics (see ezcaLockStatsOn()); all but the */
+/* flag are protected by ezcaMutex itself                      */
+static volatile BOOL LockStats = FALSE;
+static struct lock_site *LockSites;
+/* site of the outermost (timed) acquisition and since when */
+static struct lock_site *LockHolder;
+static epicsTimeStamp LockHeldSince;
+static int LockDepth;
+#endif
+/* how long a PV that could not be found fails immediately */
+static float NotFoundHoldoff;
+/* cache policy (see ezcaSetCachePolicy()); 0 is no limit */
+static unsigned long CacheMaxChannels;
+static float CacheMaxIdle;
+static double MonitorMemCap;
+#define EVICTING() (CacheMaxChannels || CacheMaxIdle > 0.)
 static unsigned volatile RetryCount;
 static unsigned SavedRetryCount;
 
@@ -445,29 +1007,6 @@ static EzcaPollCb pollCb = 0;
 static BOOL Debug;
 static BOOL Trace;
 
-/* For Hashing.                                                      */
-/* The hash algorithm is the algorithm described in:                 */
-/* "Fast Hashing of Variable Length Text Strings", Peter K. Pearson, */
-/* Communications of the ACM, June 1990.                             */
-static unsigned char RandomNumbers[256] =
-{
-     39,159,180,252, 71,  6, 13,164,232, 35,226,155, 98,120,154, 69,
-    157, 24,137, 29,147, 78,121, 85,112,  8,248,130, 55,117,190,160,
-    176,131,228, 64,211,106, 38, 27,140, 30, 88,210,227,104, 84, 77,
-     75,107,169,138,195,184, 70, 90, 61,166,  7,244,165,108,219, 51,
-      9,139,209, 40, 31,202, 58,179,116, 33,207,146, 76, 60,242,124,
-    254,197, 80,167,153,145,129,233,132, 48,246, 86,156,177, 36,187,
-     45,  1, 96, 18, 19, 62,185,234, 99, 16,218, 95,128,224,123,253,
-     42,109,  4,247, 72,  5,151,136,  0,152,148,127,204,133, 17, 14,
-    182,217, 54,199,119,174, 82, 57,215, 41,114,208,206,110,239, 23,
-    189, 15,  3, 22,188, 79,113,172, 28,  2,222, 21,251,225,237,105,
-    102, 32, 56,181,126, 83,230, 53,158, 52, 59,213,118,100, 67,142,
-    220,170,144,115,205, 26,125,168,249, 66,175, 97,255, 92,229, 91,
-    214,236,178,243, 46, 44,201,250,135,186,150,221,163,216,162, 43,
-     11,101, 34, 37,194, 25, 50, 12, 87,198,173,240,193,171,143,231,
-    111,141,191,103, 74,245,223, 20,161,235,122, 63, 89,149, 73,238,
-    134, 68, 93,183,241, 81,196, 49,192, 65,212, 94,203, 10,200, 47 
-};
 
 
 /*******************/
@@ -481,18 +1020,67 @@ static void append_to_work_list(struct work *);
 static void copy_time_stamp(epicsTimeStamp *, epicsTimeStamp *); /* really should be */
 						     /* in tsDefs.h      */
 static void empty_work_list(void);
+static void detach_group(EzcaGroup);
+static int end_group(int **, int *);
+static int issue_group(struct work *);
+static void stop_group(struct work *);
+static void finish_group(struct work *, int);
+static int report_group(struct work *, int **, int *);
+static void release_work_list_channels(void);
+static EzcaTicket find_ticket(EzcaTicket);
+static BOOL test_ticket(EzcaTicket);
+static void ticket_done(EzcaTicket);
+static void ticket_issued(EzcaTicket, int);
+static void free_ticket(EzcaTicket);
+static void set_deadline(Deadline_t *, double);
+static double time_left(Deadline_t *);
+static double time_diff(Deadline_t *, Deadline_t *);
+static void record_round_trip(struct channel *, Deadline_t *);
+static void channel_stats(struct channel *, EzcaStatsRec *);
+static int wait_tickets(EzcaTicket *, int, float);
+static BOOL preparable(struct work *);
+static void free_group(EzcaGroup);
 static struct channel *find_channel(char *);
+static size_t chan_name_len(const char *);
+static char *chan_name_dup(const char *);
 static void get_channel(struct work *, struct channel **);
 static BOOL get_from_monitor(struct work *, struct channel *);
+static struct monbuf *latch_monitor(struct monitor *);
 static void release_channel(struct channel **);
+static BOOL check_target(struct work *, struct channel *, char *);
+static void use_handle(struct channel *, struct channel **);
+static char *worktype_msg(struct work *, char *);
 static struct work *get_work(void);
 static struct work *get_work_single(void);
-static unsigned char hash(char *);
 static void init(void *);
 static BOOL issue_get(struct work *, struct channel *);
 static void issue_wait(struct work *);
 static void print_error(struct work *);
-static void prologue(void);
+static void trash_work(struct work *);
+static BOOL join_get(struct work *, struct channel *);
+static void leave_inflight(struct channel *, struct work *);
+static struct work *detach_joined(struct channel *, struct work *);
+static void reissue_get(struct channel *, struct work *);
+static void close_inflight(struct channel *);
+static void get_reply(struct work *, struct event_handler_args);
+static BOOL trash_unreported(struct work *);
+static void prologue_at(struct lock_site *);
+#ifdef EPICS_THREE_FOURTEEN
+static void lock_enter(struct lock_site *);
+static void lock_leave(void);
+static struct context *ctx_self(void);
+#endif
+#ifdef EZCA_CTX_AT_EXIT
+static void epicsShareAPI ctx_exit(void *);
+#endif
+static struct context *new_context(void);
+static void post_connected(struct channel *);
+/* the lock statistics attribute an API call to its own function */
+#define prologue() \
+	do { \
+		static struct lock_site site_ = LOCK_SITE_INIT; \
+		prologue_at(&site_); \
+	} while (0)
 static void epilogue(void);
 
 /* Channel Access Interface Functions */
@@ -507,13 +1095,21 @@ static unsigned EzcaElementCount(struct channel *);
 static void EzcaInitializeChannelAccess(void);
 static int EzcaNativeType(struct channel *);
 static int EzcaPendEvent(struct work *, float, BOOL);
+static int EzcaWaitOutstanding(void);
 static int EzcaPendIO(struct work *, float);
 static int EzcaQueueSearchAndConnect(struct work *, struct channel *);
 
 /* Callbacks */
 static void my_connection_callback(struct connection_handler_args);
 static void my_get_callback(struct event_handler_args);
+static void my_meta_callback(struct event_handler_args);
+static BOOL meta_from_cache(struct work *, struct channel *);
+static void meta_store(struct channel *, long, const void *);
+static void meta_clear(EzcaMetadataRec *);
+static BOOL meta_decode(EzcaMetadataRec *, long, const void *);
+static void meta_subscribe(struct channel *, int);
 static void my_monitor_callback(struct event_handler_args);
+static void my_user_monitor_callback(struct event_handler_args);
 static void my_put_callback(struct event_handler_args);
 
 /* Memory Management */
@@ -523,10 +1119,52 @@ static struct channel *pop_channel(void);
 static struct monitor *pop_monitor(void);
 static struct work *pop_work(void);
 static void init_work(struct work *);
+static void issue_pending(struct channel *);
+static void issue_work(struct work *);
+static void not_connected(struct work *);
+static BOOL negative_cached(struct work *, struct channel *);
+static BOOL await_connection(struct channel *);
+static int connection_state(struct channel *);
+static void connect_many(struct work *, char **, int);
+static void search_failed(struct work *, struct channel **);
+static void wait_connected(struct work *, struct channel **);
 static void push_channel(struct channel *, struct channel**);
+static void register_channel(struct channel *);
+static void touch_channel(struct channel *);
+static void lru_unlink(struct channel *);
+static int evict_channels(int);
+static int clear_victims(struct channel *);
+#ifdef EPICS_THREE_FOURTEEN
+static void evict_thread(void *);
+#endif
+static double monitor_mem(void);
+static double queue_bytes(struct monq *);
 static void push_monitor(struct monitor *, struct monitor**);
+static void free_monitor_buffers(struct monitor *);
+static struct monq *create_queue(int, unsigned long, unsigned);
+static void free_queue(struct monq *);
+static void enqueue_update(struct monitor *, struct monbuf *);
+static void link_monitor(struct monitor *);
+static void unlink_monitor(struct monitor *);
+static void remove_monitor(struct monitor *);
+static struct monitor *add_subscription(struct work *, struct channel *, char, int, unsigned long, unsigned);
+static struct monitor *add_view(struct work *, struct monitor *, char);
+static struct monitor *find_source(struct channel *, unsigned long);
+static int ezca2dbrtime(char);
+static void convert_values(void *, char, void *, int, int);
 static void push_work(struct work *);
 static void recycle_work(struct work *);
+static void init_pool(struct node_pool *, size_t);
+static void *arena_alloc(struct arena *, size_t);
+static void arena_reset(struct arena *);
+static void arena_free(struct arena *);
+static void *work_alloc(struct work *, size_t);
+static char *work_strdup(struct work *, const char *);
+static void work_free(struct work *, void *);
+static char *carve_slab(struct node_pool *, int *);
+static void reclaim_monitors(struct channel *);
+static void remove_callback(struct moncb *);
+static void reclaim_callbacks(struct channel *);
 
 /* Debugging */
 static void print_avails(void);
@@ -634,15 +1272,6 @@ int epicsShareAPI ezcaEndGroup()
 int epicsShareAPI ezcaEndGroupWithReport(int **rcs, int *nrcs)
 {
 
-struct work *wp;
-int needs_work;
-int status = 0;
-unsigned attempts;
-unsigned int nelem;
-unsigned int i;
-BOOL all_reported, error;
-int issued_a_search;
-unsigned char hi;
 int rc;
 
     prologue();
@@ -651,77 +1280,166 @@ int rc;
     {
 	/* in a group */
 
+	rc = end_group(rcs, nrcs);
+
+	/* release all channel structs we reference */
+	release_work_list_channels();
+
+    }
+    else
+    {
+	/* not in a group */
+	rc = EZCA_NOTINGROUP;
+
+	if (nrcs)
+	    *nrcs = -1;
+
+	if (rcs)
+	    *rcs = (int *) NULL;
+
+	if (AutoErrorMessage)
+	    printf("%s\n", NOTINGROUP_MSG);
+    } /* endif */
+
+    epilogue();
+    return rc;
+
+} /* end endgroup() */
+
+/****************************************************************
+*
+* processes the work list of the current group; InGroup must be
+* set.  The work nodes' channel references are not released here
+* since ezcaPrepareGroup() takes them over.
+*
+****************************************************************/
+
+static int end_group(int **rcs, int *nrcs)
+{
+
+int needs_work;
+int status = ECA_TIMEOUT;
+int rc;
+
+    if (Trace || Debug)
+printf("ezcaEndGroupWithReport() about to process work list\n");
+
+    if ((needs_work = issue_group(Work_list.head)))
+    {
 	if (Trace || Debug)
-    printf("ezcaEndGroupWithReport() about to process work list\n");
+	    printf("ezcaEndGroupWithReport() found work\n");
 
-	for (wp = Work_list.head; wp; wp = wp->next) {
-		if ( wp->cp ) {
-			fprintf(stderr,"EZCA FATAL ERROR: ezcaEndGroupWithReport() found non-NULL wp->cp\n");
-			exit(1);
-		}
-	}
+	    MARK_OUTSTANDING(needs_work);
 
-	/* searching for all the channels */
-	for (wp = Work_list.head, nelem = 0, issued_a_search = 0; 
-	    wp; wp = wp->next)
-	{
-	    nelem ++;
+	    /* the callbacks count down 'needs_work' (which includes the
+	     * work waiting for a connection); we return as soon as the
+	     * last one has reported or the deadline has passed
+	     */
+	    status = EzcaWaitOutstanding();
+    }
+    else
+    {
+	if (Trace || Debug)
+	    printf("ezcaEndGroupWithReport() found no work\n");
 
-	    if (wp->rc == EZCA_OK)
+	/* there may be requests without callback (ezcaPutOldCa());  */
+	/* prologue() no longer flushes them by pending              */
+	ca_flush_io();
+    } /* endif */
+
+    finish_group(Work_list.head, status);
+
+    rc = report_group(Work_list.head, rcs, nrcs);
+
+    if (Trace || Debug)
+printf("ezcaEndGroupWithReport() setting ErrorLocation LIST and clearing InGroup\n");
+
+    ErrorLocation = LISTWORK;
+    ListPrint = WHOLELIST;
+    InGroup = FALSE;
+
+    return rc;
+
+} /* end end_group() */
+
+/****************************************************************
+*
+* searches the channels of a group's work list and issues the
+* requests on those that are connected. Work on channels we are
+* still searching for is queued on the channel and issued by the
+* connection callback (see issue_pending()).
+*
+* Returns the number of callbacks (including work waiting for a
+* connection) the group has to wait for. The library mutex is
+* held throughout.
+*
+****************************************************************/
+
+static int issue_group(struct work *head)
+{
+
+struct work *wp;
+int needs_work;
+
+    for (wp = head; wp; wp = wp->next) {
+	    /* only work created from a handle comes with a channel */
+	    if ( wp->cp && wp->pvname ) {
+		    fprintf(stderr,"EZCA FATAL ERROR: ezcaEndGroupWithReport() found non-NULL wp->cp\n");
+		    exit(1);
+	    }
+	    /* a prepared group may run in any thread */
+	    wp->ctx = Ctx;
+    }
+
+    /* searching for all the channels */
+    for (wp = head; wp; wp = wp->next)
+    {
+	if (wp->rc == EZCA_OK)
+	{
+	    /* all input args OK */
+	    if (wp->cp)
 	    {
-		/* all input args OK */
-		if ((wp->cp = find_channel(wp->pvname)))
-		{
-		    if (Trace || Debug)
-	printf("ezcaEndGroupWithReport() was able to find_channel() >%s<\n", 
-			wp->pvname);
-		}
-		else
-		{
-		    /* not in Channels  must ca_search_and_connect() and add */
-		    if (Trace || Debug)
+		/* from a handle; channel already referenced */
+	    }
+	    else if ((wp->cp = find_channel(wp->pvname)))
+	    {
+		if (Trace || Debug)
+    printf("ezcaEndGroupWithReport() was able to find_channel() >%s<\n", 
+		    wp->pvname);
+	    }
+	    else
+	    {
+		/* not in Channels  must ca_search_and_connect() and add */
+		if (Trace || Debug)
 printf("ezcaEndGroupWithReport() could not find_channel() >%s< must ca_search_and_connect() and add\n", wp->pvname);
-		    if ((wp->cp = pop_channel()))
+		if ((wp->cp = pop_channel()))
+		{
+		    if (((wp->cp)->pvname = chan_name_dup(wp->pvname)))
 		    {
-			if (((wp->cp)->pvname = strdup(wp->pvname)))
+			if (EzcaQueueSearchAndConnect(wp, wp->cp) 
+				== ECA_NORMAL)
 			{
-			    if (EzcaQueueSearchAndConnect(wp, wp->cp) 
-				    == ECA_NORMAL)
-			    {
-				issued_a_search++;
-
-				/* adding to Channels */
-				hi = hash((wp->cp)->pvname);
-				(wp->cp)->next = Channels[hi];
-				Channels[hi] = wp->cp;
-			    }
-			    else
-			    {
-				if ( wp->cp->ever_successfully_searched ) {
-					/* MARK_OUTSTANDING() is only issued
-					 * below when we know the number of
-					 * outstanding search requests. Hence
-					 * we must make sure not to release the
-					 * library mutex before we can MARK
-					 */
-					fprintf(stderr,"EZCA FATAL ERROR: clean_and_push_channel would release library MUTEX here\n");
-					exit (1);
-				}
-				/* something went wrong ... rc and */
-				/* error msg have already been set */
-
-				EZCA_LOCK(); /* make *sure* mutex is not relinquished by adding a nest count */
-				clean_and_push_channel(&wp->cp);
-				EZCA_UNLOCK();
-			    } /* endif */
+			    /* adding to Channels */
+			    register_channel(wp->cp);
 			}
 			else
 			{
-			    wp->rc = EZCA_FAILEDMALLOC;
-			    wp->error_msg = ErrorMsgs[FAILED_MALLOC_MSG_IDX];
+			    if ( wp->cp->ever_successfully_searched ) {
+				    /* MARK_OUTSTANDING() is only issued
+				     * below when we know the number of
+				     * outstanding search requests. Hence
+				     * we must make sure not to release the
+				     * library mutex before we can MARK
+				     */
+				    fprintf(stderr,"EZCA FATAL ERROR: clean_and_push_channel would release library MUTEX here\n");
+				    exit (1);
+			    }
+			    /* something went wrong ... rc and */
+			    /* error msg have already been set */
 
-			    if (AutoErrorMessage)
-				print_error(wp);
+			    EZCA_LOCK(); /* make *sure* mutex is not relinquished by adding a nest count */
+			    clean_and_push_channel(&wp->cp);
+			    EZCA_UNLOCK();
 			} /* endif */
 		    }
 		    else
@@ -732,1107 +1450,4526 @@ printf("ezcaEndGroupWithReport() could not find_channel() >%s< must ca_search_an
 			if (AutoErrorMessage)
 			    print_error(wp);
 		    } /* endif */
+		}
+		else
+		{
+		    wp->rc = EZCA_FAILEDMALLOC;
+		    wp->error_msg = ErrorMsgs[FAILED_MALLOC_MSG_IDX];
+
+		    if (AutoErrorMessage)
+			print_error(wp);
 		} /* endif */
 	    } /* endif */
-	} /* endfor */
+	} /* endif */
+    } /* endfor */
 
-	/* waiting for all searches to connect */
-	if (issued_a_search)
+    /* Identifying those that are not connected. Channels we just
+     * searched for are not waited for here: their work is queued on
+     * the channel and issued by the connection callback as soon as
+     * the channel comes up (see issue_pending()).
+     * All unconnected work is flagged only after waiting since
+     * not_connected() may release the library mutex.
+     */
+    for (wp = head; wp; wp = wp->next)
+    {
+	if (wp->rc == EZCA_OK && wp->cp && !EzcaConnected(wp->cp))
 	{
-		MARK_OUTSTANDING(issued_a_search);
+	    if ( negative_cached(wp, wp->cp) )
+		continue;
 
-	    for (all_reported = FALSE, attempts = 0; 
-		!all_reported && attempts <= RetryCount; attempts ++)
+	    wp->deferred = TRUE;
+	    if ( wp->cp->cid 
+		&& (ca_puser(wp->cp->cid) || await_connection(wp->cp)) )
 	    {
-		if (Trace || Debug)
-		    printf("ezcaEndGroupWithReport() search attempt %d of %d\n",
-			attempts+1, RetryCount+1);
-
-		EzcaPendEvent((struct work *) NULL, TimeoutSeconds, FALSE);
+		wp->needs_work   = TRUE;
+		wp->next_pending = wp->cp->pending;
+		wp->cp->pending  = wp;
+	    } /* endif */
+	} /* endif */
+    } /* endfor */
 
-		for (all_reported = TRUE, wp = Work_list.head; 
-		    all_reported && wp; 
-			wp = wp->next)
-		    /* (wp->rc = OK) ==> (wp->cp is connected) */
-		    all_reported = (wp->rc != EZCA_OK 
-			|| (wp->cp ? EzcaConnected(wp->cp) : FALSE));
-	    } /* endfor */
+    /* issuing the work for those that are connected and still EZCA_OK */
+    for (wp = head; wp; wp = wp->next)
+    {
+	if (wp->rc == EZCA_OK && !wp->deferred)
+	    issue_work(wp);
+    } /* endor */
 
-		/* Make sure 'report-required' flag (puser!=0) is
-		 * cleared on all channels
-		 */
-		for ( wp = Work_list.head; wp; wp=wp->next ) {
-			if ( wp->cp && wp->cp->cid ) {
-				ca_set_puser(wp->cp->cid, 0);
-			}
-		}
-	} /* endif */
+    /* looking for work that is still EZCA_OK and needs_work */
+    for (wp = head, needs_work = 0; wp ; wp = wp->next)
+    {
+	    if (wp->rc == EZCA_OK && wp->needs_work)
+		    needs_work++;
+    }
 
-	/* identifying those that were not able to connect */
-	for (wp = Work_list.head; wp; wp = wp->next)
-	{
+    return needs_work;
 
-	    if (wp->rc == EZCA_OK && wp->cp && !EzcaConnected(wp->cp))
-	    {
+} /* end issue_group() */
 
-	        if ( CONNECTED == wp->cp->ever_successfully_searched )
-	        {
-		   	    wp->rc = EZCA_NOTCONNECTED;
-	            wp->error_msg = ErrorMsgs[NOT_CONNECTED_MSG_IDX];
-	        }
-	        else
-	        {
-	            /* remove */
-	            clean_and_push_channel( &wp->cp );
-
-				if ( RetryCount )
-				{
-	            	wp->rc = EZCA_NOTIMELYRESPONSE;
-	            	wp->error_msg = ErrorMsgs[NO_PVAR_FOUND_MSG_IDX];
-				}
-				else
-				{
-	            	wp->rc = EZCA_ABORTED;
-	            	wp->error_msg = ErrorMsgs[ABORTED_MSG_IDX];
-				}
-	        }
+/****************************************************************
+*
+* Stops the connection callback from issuing any more work of
+* a group; this must happen before the library mutex can be
+* released. Other groups (async tickets) may still have work
+* waiting on the same channels; a channel only stops reporting
+* once nobody waits for it any more.
+*
+****************************************************************/
 
-		    wp->aux_error_msg = strdup(wp->pvname);
+static void stop_group(struct work *head)
+{
 
-		    if (AutoErrorMessage)
-		        print_error(wp);
-	    } /* endif */
-	} /* endfor */
+struct work *wp, **pp, *pw;
+struct channel *cp;
 
-	/* issuing the work for those that are still EZCA_OK */
-	for (wp = Work_list.head; wp; wp = wp->next)
+    for (wp = head; wp; wp = wp->next)
+    {
+	if ((cp = wp->cp))
 	{
-	    if (wp->rc == EZCA_OK)
+	    for (pp = &cp->pending; (pw = *pp); )
 	    {
-		switch (wp->worktype)
+		if (pw->ticket == wp->ticket)
 		{
-		    case GET:
-		    case GETWITHSTATUS:
-			if (get_from_monitor(wp, wp->cp))
-			{
-			    if (Trace || Debug)
-    printf("ezcaEndGroupWithReport(): found an active monitor with a value for >%s<\n", 
-		wp->pvname);
-			    wp->needs_work = FALSE;
-			}
-			else
-			{
-			    if (Trace || Debug)
-printf("ezcaEndGroupWithReport(): did not find an active monitor with a value for >%s<\n",
-				wp->pvname);
-
-			    wp->needs_work = issue_get(wp, wp->cp);
-			} /* endif */
-			break;
-		    case GETCONTROLLIMITS:
-		    case GETGRAPHICLIMITS:
-		    case GETPRECISION:
-		    case GETUNITS:
-			case GETWARNLIMITS:
-			case GETALARMLIMITS:
-			wp->nelem = 1; /* = EzcaElementCount(wp->cp); */
-			wp->needs_work = issue_get(wp, wp->cp);
-			break;
-			case GETENUMSTATES:
-				if ( DBF_ENUM != EzcaNativeType(wp->cp) ) {
-					wp->strp[0] = 0;
-					wp->needs_work = FALSE;
-				} else {
-					wp->nelem = 1;
-					wp->needs_work = issue_get(wp, wp->cp);
-				}
-			break;
-		    case GETNELEM:
-			*wp->intp = wp->nelem = EzcaElementCount(wp->cp);
-			wp->needs_work = FALSE;
-			break;
-		    case GETSTATUS:
-			if (get_from_monitor(wp, wp->cp))
-			{
-			    if (Trace || Debug)
-    printf("ezcaEndGroupWithReport(): found an active monitor with a value for >%s<\n", 
-		wp->pvname);
-			    wp->needs_work = FALSE;
-			}
-			else
-			{
-			    if (Trace || Debug)
-printf("ezcaEndGroupWithReport(): did not find an active monitor with a value for >%s<\n",
-				wp->pvname);
+		    *pp = pw->next_pending;
+		    pw->next_pending = (struct work *) NULL;
+		}
+		else
+		{
+		    pp = &pw->next_pending;
+		} /* endif */
+	    } /* endfor */
 
-			    wp->nelem = 1; /* = EzcaElementCount(wp->cp); */
-			    wp->needs_work = issue_get(wp, wp->cp);
-			} /* endif */
-			break;
-		    case PUT:
-			if (wp->nelem <= (int)EzcaElementCount(wp->cp))
-			{
-			    wp->reported = FALSE;
-			    if (EzcaArrayPutCallback(wp, wp->cp) == ECA_NORMAL)
-				wp->needs_work = TRUE;
-			    else
-			    {
-				/* something went wrong ... rc and */
-				/* error msg have already been set */
+	    if (cp->cid && !cp->pending)
+		ca_set_puser(cp->cid, 0);
+	} /* endif */
+	wp->next_pending = (struct work *) NULL;
+    } /* endfor */
 
-				/* need to trash this wp so it's */
-				/* never used again in case the  */
-				/* callback fires off later      */
+} /* end stop_group() */
 
-				wp->needs_work = FALSE;
-				wp->trashme = trashed;
-				if (Debug)
-				    printf("trashing wp %p\n", wp);
+/****************************************************************
+*
+* Sets the final rc of every piece of work once a group is over;
+* 'status' is what waiting for it returned (ECA_TIMEOUT if the
+* wait was not interrupted). Unreported work is trashed so that
+* a late callback never touches it.
+*
+****************************************************************/
 
-			    } /* endif */
-			}
-			else
-			{
-			    /* too many elements requested */
-			    wp->rc = EZCA_INVALIDARG;
-			    wp->error_msg = ErrorMsgs[TOO_MANY_NELEM_MSG_IDX];
+static void finish_group(struct work *head, int status)
+{
 
-			    if (AutoErrorMessage)
-				print_error(wp);
-			} /* endif */
-			break;
-		    case PUTOLDCA:
-			wp->needs_work = FALSE;
-			if (wp->nelem <= (int)EzcaElementCount(wp->cp))
-			    EzcaArrayPut(wp, wp->cp);
-			else
-			{
-			    /* too many elements requested */
-			    wp->rc = EZCA_INVALIDARG;
-			    wp->error_msg = ErrorMsgs[TOO_MANY_NELEM_MSG_IDX];
+struct work *wp;
+BOOL error;
 
-			    if (AutoErrorMessage)
-				print_error(wp);
-			} /* endif */
-			break;
+	    error = (status != ECA_TIMEOUT);
 
-			case MONBLOCK:
-				{ struct monitor *mp;
+	    stop_group(head);
 
-					wp->reported = FALSE;
+	if (error)
+	{
+	    /* abnormal completion ... must identify all wp's whose */
+	    /* rc is currently EZCA_OK and needs_work and set       */
+	    /* their rc's appropriately and trash_them              */
 
-					mp = wp->cp->monitor_list;
-
-					while (mp && ( ! (wp->ezcadatatype == mp->ezcadatatype) || !mp->active))
-						mp = mp->right;
-					if ( !mp ) {
-						wp->rc = EZCA_INVALIDARG;
-						wp->error_msg = ErrorMsgs[NO_MONITOR_MSG_IDX];
-						if (AutoErrorMessage)
-							print_error(wp);
-					} else {
-						if ( (wp->needs_work = !mp->needs_reading) ) {
-							wp->pval   = mp;
-							if ( mp->waiter ) {
-								fprintf(stderr,"EZCA FATAL ERROR: mp->waiter is already set\n");
-								exit(1);
-							}
-							mp->waiter = wp;
-						} else {
-							wp->pval = NULL;
-						}
-					}
-				}
-			break;
-		    default:
-			fprintf(stderr,
-"EZCA FATAL ERROR: ezcaEndGroupWithReport() found invalid worktype %d in group list\n",
-			    wp->worktype);
-			exit(1);
-			break;
-		} /* end switch() */
-	    } /* endif */
-	} /* endor */
+	    for (wp = head; wp; wp = wp->next)
+	    {
+		if (wp->rc == EZCA_OK && wp->needs_work && !wp->deferred)
+		{
+			    if ( MONBLOCK == wp->worktype && wp->pval )
+			    {
+			    struct monitor *mp = wp->pval;
+			    /* no need to trash (no callback has a pointer to this
+			     * work node). Just clear the 'waiter'...
+			     */
+			    CHAN_LOCK(mp->cp);
+			    mp->waiter = (struct work *)NULL;
+			    CHAN_UNLOCK(mp->cp);
+			    wp->pval = 0;
+			    }
+			    else
+			    {
+			    trash_work(wp);
+			    }
+		    wp->rc = EZCA_CAFAILURE;
+		    wp->error_msg = ErrorMsgs[CAPENDEVENT_MSG_IDX];
+		    wp->aux_error_msg = work_strdup(wp, ca_message(status));
 
-	/* looking for work that is still EZCA_OK and needs_work */
-	for (wp = Work_list.head, needs_work = 0; wp ; wp = wp->next)
-	{
-		if (wp->rc == EZCA_OK && wp->needs_work)
-			needs_work++;
+		    if (AutoErrorMessage)
+			print_error(wp);
+		} /* endif */
+	    } /* endfor */
 	}
-
-	if (needs_work)
+	else
 	{
-	    if (Trace || Debug)
-		printf("ezcaEndGroupWithReport() found work\n");
-
-		MARK_OUTSTANDING(needs_work);
-
-	    for (all_reported = FALSE, error = FALSE, attempts = 0;
-		!all_reported && !error && attempts <= RetryCount; 
-		    attempts ++)
+	    /* normal completion ... must identify all wp's whose    */
+	    /* rc is currently EZCA_OK and needs_work and check      */
+	    /* their reported flags and set their rc's appropriately */
+	    for (wp = head; wp; wp = wp->next)
 	    {
-		if (Trace || Debug)
-		    printf("ezcaEndGroupWithReport(): attempt %d of %d\n", 
-			attempts+1, RetryCount+1);
+		if (wp->rc == EZCA_OK && wp->needs_work && !wp->deferred)
+		{
+		    /* a MONBLOCK is reported with ezcaMutex held; */
+		    /* other callbacks may still be coming in      */
+		    if (!(wp->reported)
+			&& ((MONBLOCK == wp->worktype && wp->pval) || trash_unreported(wp)))
+		    {
+			/* callback did not respond back */
+			/* int time no value received    */
+
+			/* need to trash this wp so it's */
+			/* never used again in case the  */
+			/* callback fires off later      */
+			/* (trash_unreported() did)      */
+			    if ( RetryCount )
+			    {
+			    wp->rc = EZCA_NOTIMELYRESPONSE;
+			    wp->error_msg = 
+				    ErrorMsgs[NO_RESPONSE_IN_TIME_MSG_IDX];
+			    }
+			    else
+			    {
+		    wp->rc = EZCA_ABORTED;
+		    wp->error_msg = ErrorMsgs[ABORTED_MSG_IDX];
+			    }
 
-		status = EzcaPendEvent((struct work *) NULL, TimeoutSeconds, FALSE);
+			if (AutoErrorMessage)
+			    print_error(wp);
 
-		if (status == ECA_TIMEOUT)
-		{
-		    /* normal completion ... must identify all wp's whose    */
-		    /* rc is currently EZCA_OK and needs_work and check      */
-		    /* their reported                                        */
-
-		    for (all_reported = TRUE, wp = Work_list.head; 
-			all_reported && wp; 
-			    wp = wp->next)
-			/* (EZCA_OK && needs_work) ===> reported */
-			all_reported = 
-		    (!(wp->rc == EZCA_OK && wp->needs_work) || wp->reported);
-		}
-		else
-		    error = TRUE;
+			    if ( MONBLOCK == wp->worktype && wp->pval )
+			    {
+			    struct monitor *mp = wp->pval;
+			    /* no need to trash (no callback has a pointer to this
+			     * work node). Just clear the 'waiter'...
+			     */
+			    CHAN_LOCK(mp->cp);
+			    mp->waiter = (struct work *)NULL;
+			    CHAN_UNLOCK(mp->cp);
+			    wp->pval = 0;
+			    }
+		    } /* endif */
+		} /* endif */
 	    } /* endfor */
+	} /* endif */
 
-	    if (error)
+    /* identifying those that were not able to connect */
+    for (wp = head; wp; wp = wp->next)
+    {
+	if (wp->deferred)
+	{
+	    wp->deferred   = FALSE;
+	    wp->needs_work = FALSE;
+	    if (wp->rc == EZCA_OK)
 	    {
-		/* abnormal completion ... must identify all wp's whose */
-		/* rc is currently EZCA_OK and needs_work and set       */
-		/* their rc's appropriately and trash_them              */
+		/* may have come up just now; don't remove it then */
+		EzcaConnected(wp->cp);
+		not_connected(wp);
+	    } /* endif */
+	} /* endif */
+    } /* endfor */
 
-		for (wp = Work_list.head; wp; wp = wp->next)
-		{
-		    if (wp->rc == EZCA_OK && wp->needs_work)
-		    {
-				if ( MONBLOCK == wp->worktype && wp->pval )
-				{
-				struct monitor *mp = wp->pval;
-				/* no need to trash (no callback has a pointer to this
-				 * work node). Just clear the 'waiter'...
-				 */
-				mp->waiter = (struct work *)NULL;
-				wp->pval = 0;
-				}
-				else
-				{
-				wp->trashme = trashed;
+} /* end finish_group() */
 
-				if (Debug)
-					printf("trashing wp %p\n", wp);
+/****************************************************************
+*
+* Returns the rc of the first failed piece of work of a finished
+* group (or EZCA_OK), optionally a malloc'd array of all rcs, and
+* releases the PUT data.
+*
+****************************************************************/
 
-				}
-			wp->rc = EZCA_CAFAILURE;
-			wp->error_msg = ErrorMsgs[CAPENDEVENT_MSG_IDX];
-			wp->aux_error_msg = strdup(ca_message(status));
+static int report_group(struct work *head, int **rcs, int *nrcs)
+{
 
-			if (AutoErrorMessage)
-			    print_error(wp);
-		    } /* endif */
-		} /* endfor */
-	    }
-	    else
-	    {
-		/* normal completion ... must identify all wp's whose    */
-		/* rc is currently EZCA_OK and needs_work and check      */
-		/* their reported flags and set their rc's appropriately */
-		for (wp = Work_list.head; wp; wp = wp->next)
-		{
-		    if (wp->rc == EZCA_OK && wp->needs_work)
-		    {
-			if (!(wp->reported))
-			{
-			    /* callback did not respond back */
-			    /* int time no value received    */
+struct work *wp;
+unsigned int nelem;
+unsigned int i;
+int rc;
 
-			    /* need to trash this wp so it's */
-			    /* never used again in case the  */
-			    /* callback fires off later      */
-				if ( RetryCount )
-				{
-			    	wp->rc = EZCA_NOTIMELYRESPONSE;
-			    	wp->error_msg = 
-					ErrorMsgs[NO_RESPONSE_IN_TIME_MSG_IDX];
-				}
-				else
-				{
-	            	wp->rc = EZCA_ABORTED;
-	            	wp->error_msg = ErrorMsgs[ABORTED_MSG_IDX];
-				}
+    for (wp = head, nelem = 0; wp; wp = wp->next)
+	nelem ++;
 
-			    if (AutoErrorMessage)
-				print_error(wp);
+    if (nrcs)
+	*nrcs = nelem;
 
-				if ( MONBLOCK == wp->worktype && wp->pval )
-				{
-				struct monitor *mp = wp->pval;
-				/* no need to trash (no callback has a pointer to this
-				 * work node). Just clear the 'waiter'...
-				 */
-				mp->waiter = (struct work *)NULL;
-				wp->pval = 0;
-				}
-				else
-				{
-			    wp->trashme = trashed;
+    if (rcs)
+	*rcs = (int *) ezcamalloc(nelem*sizeof(int));
 
-			    if (Debug)
-				printf("trashing wp %p\n", wp);
-				}
-			} /* endif */
-		    } /* endif */
-		} /* endfor */
-	    } /* endif */
-	}
-	else
+    for (i = 0, wp = head, rc = EZCA_OK; wp; wp = wp->next, i ++)
+    {
+	/* setting rc to first encoutered problem or EZCA_OK */
+	if (rc == EZCA_OK && wp->rc != EZCA_OK)
+	    rc = wp->rc;
+
+	if (rcs && *rcs)
+	    (*rcs)[i] = wp->rc;
+
+	/* clearing all the malloc'd memory in PUT works */
+	if ( (wp->worktype == PUT || wp->worktype == PUTOLDCA) && wp->pval)
 	{
-	    if (Trace || Debug)
-		printf("ezcaEndGroupWithReport() found no work\n");
+	    work_free(wp, wp->pval);
+	    wp->pval = (void *) NULL;
 	} /* endif */
+    } /* endfor */
 
-	if (nrcs)
-	    *nrcs = nelem;
+    return rc;
 
-	if (rcs)
-	    *rcs = (int *) ezcamalloc(nelem*sizeof(int));
+} /* end report_group() */
 
-	for (i = 0, wp = Work_list.head, rc = EZCA_OK; wp; wp = wp->next, i ++)
-	{
-	    /* setting rc to first encoutered problem or EZCA_OK */
-	    if (rc == EZCA_OK && wp->rc != EZCA_OK)
-		rc = wp->rc;
+/****************************************************************
+*
+* Flag work whose channel is not connected. Channels that never
+* connected are removed.
+*
+****************************************************************/
+
+static void not_connected(struct work *wp)
+{
 
-	    if (rcs && *rcs)
-		(*rcs)[i] = wp->rc;
+    if ( CONNECTED == wp->cp->ever_successfully_searched )
+    {
+	wp->rc = EZCA_NOTCONNECTED;
+	wp->error_msg = ErrorMsgs[NOT_CONNECTED_MSG_IDX];
+    }
+    else
+    {
+	search_failed( wp, &wp->cp );
+    }
 
-	    /* clearing all the malloc'd memory in PUT works */
-	    if ( (wp->worktype == PUT || wp->worktype == PUTOLDCA) && wp->pval)
-	    {
-		ezcafree((char *) wp->pval);
-		wp->pval = (void *) NULL;
-	    } /* endif */
-	} /* endfor */
+    wp->aux_error_msg = work_strdup(wp, WORK_PVNAME(wp));
 
-	if (Trace || Debug)
-    printf("ezcaEndGroupWithReport() setting ErrorLocation LIST and clearing InGroup\n");
+    if (AutoErrorMessage)
+	print_error(wp);
 
-	ErrorLocation = LISTWORK;
-	ListPrint = WHOLELIST;
-	InGroup = FALSE;
+} /* end not_connected() */
 
-	/* release all channel structs we reference */
-	for (wp = Work_list.head; wp; wp = wp->next) {
-		release_channel( & wp->cp );
-	}
+/****************************************************************
+*
+* A channel that was searched for never connected. Set wp->rc and
+* either remove the channel or - unless the user aborted - keep it
+* in the negative cache: CA goes on searching for it in the
+* background and EzcaConnected() promotes it once it shows up.
+* Until then, and for NotFoundHoldoff seconds, requests for the
+* PV fail immediately (see negative_cached()).
+*
+* Sets *cpp to NULL.
+*
+****************************************************************/
+
+static void search_failed(struct work *wp, struct channel **cpp)
+{
 
+    if ( RetryCount )
+    {
+	wp->rc = EZCA_NOTIMELYRESPONSE;
+	wp->error_msg = ErrorMsgs[NO_PVAR_FOUND_MSG_IDX];
+
+	if ( NotFoundHoldoff > 0. )
+	{
+	    (*cpp)->not_found_at = time( (time_t *) NULL );
+	    release_channel( cpp );
+	    return;
+	}
     }
     else
     {
-	/* not in a group */
-	rc = EZCA_NOTINGROUP;
+	wp->rc = EZCA_ABORTED;
+	wp->error_msg = ErrorMsgs[ABORTED_MSG_IDX];
+    }
 
-	if (nrcs)
-	    *nrcs = -1;
+    /* remove */
+    clean_and_push_channel( cpp );
 
-	if (rcs)
-	    *rcs = (int *) NULL;
+} /* end search_failed() */
+
+/****************************************************************
+*
+* Check if a (disconnected) channel is in the negative cache.
+* If so, flag wp with EZCA_NOTFOUND and return TRUE. An expired
+* entry is dropped from the cache and the channel is marked for
+* reporting (puser) so that it is waited for like a fresh search.
+*
+****************************************************************/
+
+static BOOL negative_cached(struct work *wp, struct channel *cp)
+{
+
+    if ( !cp->not_found_at || EzcaConnected(cp) )
+	return FALSE;
+
+    if ( NotFoundHoldoff > 0. 
+	&& difftime( time( (time_t *) NULL ), cp->not_found_at ) < NotFoundHoldoff )
+    {
+	if (Trace || Debug)
+	    printf("negative_cached(): >%s< recently not found\n", cp->pvname);
+
+	wp->rc = EZCA_NOTFOUND;
+	wp->error_msg = ErrorMsgs[RECENTLY_NOT_FOUND_MSG_IDX];
+	wp->aux_error_msg = work_strdup(wp, cp->pvname);
 
 	if (AutoErrorMessage)
-	    printf("%s\n", NOTINGROUP_MSG);
+	    print_error(wp);
+
+	return TRUE;
     } /* endif */
 
-    epilogue();
-    return rc;
+    /* give it another chance */
+    cp->not_found_at = 0;
+    ca_set_puser(cp->cid, (void *) cp);
 
-} /* end endgroup() */
+    return FALSE;
+
+} /* end negative_cached() */
 
 /****************************************************************
 *
-* if there are no errors to report (no work done) retuns NULL in **buff
-* with EZCA_OK.
+* A channel which was searched for by ezcaConnectMany() and has not
+* come up yet is waited for like a fresh search: mark it for
+* reporting (puser) and return TRUE. Channels which were connected
+* before or are in the negative cache are left alone.
 *
 ****************************************************************/
 
-int epicsShareAPI ezcaGetErrorString(char *prefix, char **buff)
+static BOOL await_connection(struct channel *cp)
 {
 
-struct work *wp;
-char *wtm;
-char *cp;
-size_t nbytes;
-int rc;
+    if ( SEARCHED != cp->ever_successfully_searched || cp->not_found_at )
+	return FALSE;
 
-    prologue();
+    ca_set_puser(cp->cid, (void *) cp);
 
-    if (buff)
-    {
-	/* calculating size of buffer */
+    return TRUE;
 
-	nbytes = 0;
+} /* end await_connection() */
 
-	if (ErrorLocation == SINGLEWORK)
+/****************************************************************
+*
+* cached connection state of a channel (EZCA_CS_XXX); nothing is
+* sent over the network.
+*
+****************************************************************/
+
+static int connection_state(struct channel *cp)
+{
+
+    if ( !cp || &Invalid_channel == cp )
+	return EZCA_CS_NOCHANNEL;
+
+    if ( EzcaConnected(cp) )
+	return EZCA_CS_CONNECTED;
+
+    if ( cp->not_found_at )
+	return EZCA_CS_NOTFOUND;
+
+    return CONNECTED == cp->ever_successfully_searched 
+	? EZCA_CS_DISCONNECTED : EZCA_CS_SEARCHING;
+
+} /* end connection_state() */
+
+/****************************************************************
+*
+* Queue searches for all PVs which are not cached yet and return
+* without waiting for any of them. Nobody is told when they connect
+* (puser is cleared); the first request which needs the channel
+* waits for it (see await_connection()). Stops at the first error
+* (wp->rc is set).
+*
+****************************************************************/
+
+static void connect_many(struct work *wp, char **pvnames, int n)
+{
+
+struct channel *cp;
+int i;
+
+    wp->rc = EZCA_OK;
+
+    for (i = 0; i < n && wp->rc == EZCA_OK; i++)
+    {
+	if (!pvnames[i])
 	{
-	    /* using Workp */
+	    wp->rc = EZCA_INVALIDARG;
+	    wp->error_msg = ErrorMsgs[INVALID_PVNAME_MSG_IDX];
 
-	    if (Debug)
-		printf("ezcaGetErrorString() using SINGLEWORK (Workp)\n");
-		
-	    if (Workp)
-	    {
-		wp = Workp;
-		switch (wp->worktype)
-		{
-		    case GET:              wtm = GET_MSG;              break;
-		    case PUT:              wtm = PUT_MSG;              break;
-		    case PUTOLDCA:         wtm = PUTOLDCA_MSG;         break;
-		    case GETUNITS:         wtm = GETUNITS_MSG;         break;
-		    case GETENUMSTATES:    wtm = GETENUMSTATES_MSG;    break;
-		    case GETNELEM:         wtm = GETNELEM_MSG;         break;
-		    case GETPRECISION:     wtm = GETPRECISION_MSG;     break;
-		    case GETGRAPHICLIMITS: wtm = GETGRAPHICLIMITS_MSG; break;
-		    case GETCONTROLLIMITS: wtm = GETCONTROLLIMITS_MSG; break;
-		    case GETWARNLIMITS:    wtm = GETWARNLIMITS_MSG;    break;
-		    case GETALARMLIMITS:   wtm = GETALARMLIMITS_MSG;   break;
-		    case GETSTATUS:        wtm = GETSTATUS_MSG;        break;
-		    case GETWITHSTATUS:    wtm = GETWITHSTATUS_MSG;    break;
-		    case SETMONITOR:       wtm = SETMONITOR_MSG;       break;
-		    case CLEARMONITOR:     wtm = CLEARMONITOR_MSG;     break;
-		    case AUTOERRORMESSAGEOFF: 
-			wtm = AUTOERRORMESSAGEOFF_MSG;                 break;
-		    case AUTOERRORMESSAGEON:     
-			wtm = AUTOERRORMESSAGEON_MSG;                  break;
-		    case DEBUGOFF:         wtm = DEBUGOFF_MSG;         break;
-		    case DEBUGON:          wtm = DEBUGON_MSG;          break;
-		    case DELAY:            wtm = DELAY_MSG;            break;
-		    case FREEMEM:          wtm = FREEMEM_MSG;  break;
-		    case PVTOCHID:         wtm = PVTOCHID_MSG;         break;
-		    case SETTIMEOUT:       wtm = SETTIMEOUT_MSG;       break;
-		    case STARTGROUP:       wtm = STARTGROUP_MSG;       break;
-		    case CLEARCHANNEL:     wtm = CLEARCHANNEL_MSG;     break;
-		    case MONBLOCK:         wtm = MONBLOCK_MSG;         break;
-		    case TRACEOFF:         wtm = TRACEOFF_MSG;         break;
-		    case TRACEON:          wtm = TRACEON_MSG;          break;
-		    case SETRETRYCOUNT:    wtm = SETRETRYCOUNT_MSG;    break;
-		    case GETRETRYCOUNT:    wtm = GETRETRYCOUNT_MSG;    break;
-		    case GETTIMEOUT:       wtm = GETTIMEOUT_MSG;       break;
-		    default:
-			fprintf(stderr, 
-	"EZCA FATAL ERROR: ezcaGetErrorString() found invalid worktype %d\n", 
-			    wp->worktype);
-			exit(1);
-			break;
-		} /* end switch() */
+	    if (AutoErrorMessage)
+		print_error(wp);
+	}
+	else if (ezcaRegFindN(Channels, pvnames[i], chan_name_len(pvnames[i])))
+	{
+	    /* connected, connecting or negative cached */
+	}
+	else if (!(cp = pop_channel()))
+	{
+	    wp->rc = EZCA_FAILEDMALLOC;
+	    wp->error_msg = ErrorMsgs[FAILED_MALLOC_MSG_IDX];
 
-		nbytes = nbytes 
-			    + (prefix ? strlen(prefix) : 0) + 1
-			    + strlen(wtm) + 2
-			    + (wp->rc == EZCA_OK 
-				? strlen(OKMSG) 
-				: (strlen(wp->error_msg) 
-				    + (wp->aux_error_msg 
-					? strlen(wp->aux_error_msg)+3 
-					: 0)))
-			    + 1; /* for <CR> or NULL character */
+	    if (AutoErrorMessage)
+		print_error(wp);
+	}
+	else if (!(cp->pvname = chan_name_dup(pvnames[i])))
+	{
+	    cp->refcnt = 0;
+	    push_channel(cp, &Channel_avail_hdr);
 
-	    } /* endif */
+	    wp->rc = EZCA_FAILEDMALLOC;
+	    wp->error_msg = ErrorMsgs[FAILED_MALLOC_MSG_IDX];
+
+	    if (AutoErrorMessage)
+		print_error(wp);
+	}
+	else if (EzcaQueueSearchAndConnect(wp, cp) == ECA_NORMAL)
+	{
+	    /* the connection callback takes ezcaMutex */
+	    /* (or runs from ca_pend_event()) so this  */
+	    /* is in time                              */
+	    ca_set_puser(cp->cid, 0);
+	    register_channel(cp);
+	    release_channel(&cp);
 	}
 	else
 	{
-	    /* using Work_list */
+	    /* rc and error msg have already been set */
+	    clean_and_push_channel(&cp);
+	} /* endif */
+    } /* endfor */
 
-	    if (Debug)
-		printf("ezcaGetErrorString() using LISTWORK (Work_list)\n");
+    ca_flush_io();
 
-	    for (wp = (ListPrint == WHOLELIST ? Work_list.head: Work_list.tail); 
-		    wp; wp = wp->next)
-	    {
-		switch (wp->worktype)
-		{
-		    case GET:              wtm = GET_MSG;              break;
-		    case PUT:              wtm = PUT_MSG;              break;
-		    case PUTOLDCA:         wtm = PUTOLDCA_MSG;         break;
-		    case GETUNITS:         wtm = GETUNITS_MSG;         break;
-		    case GETENUMSTATES:    wtm = GETENUMSTATES_MSG;    break;
-		    case GETNELEM:         wtm = GETNELEM_MSG;         break;
-		    case GETPRECISION:     wtm = GETPRECISION_MSG;     break;
-		    case GETGRAPHICLIMITS: wtm = GETGRAPHICLIMITS_MSG; break;
-		    case GETCONTROLLIMITS: wtm = GETCONTROLLIMITS_MSG; break;
-		    case GETWARNLIMITS:    wtm = GETWARNLIMITS_MSG;    break;
-		    case GETALARMLIMITS:   wtm = GETALARMLIMITS_MSG;   break;
-		    case GETSTATUS:        wtm = GETSTATUS_MSG;        break;
-		    case GETWITHSTATUS:    wtm = GETWITHSTATUS_MSG;    break;
-		    case SETMONITOR:       wtm = SETMONITOR_MSG;       break;
-		    case CLEARMONITOR:     wtm = CLEARMONITOR_MSG;     break;
-		    case AUTOERRORMESSAGEOFF: 
-			wtm = AUTOERRORMESSAGEOFF_MSG;                 break;
-		    case AUTOERRORMESSAGEON:     
-			wtm = AUTOERRORMESSAGEON_MSG;                  break;
-		    case DEBUGOFF:         wtm = DEBUGOFF_MSG;         break;
-		    case DEBUGON:          wtm = DEBUGON_MSG;          break;
-		    case DELAY:            wtm = DELAY_MSG;            break;
-		    case FREEMEM:          wtm = FREEMEM_MSG;  break;
-		    case PVTOCHID:         wtm = PVTOCHID_MSG;         break;
-		    case SETTIMEOUT:       wtm = SETTIMEOUT_MSG;       break;
-		    case STARTGROUP:       wtm = STARTGROUP_MSG;       break;
-		    case CLEARCHANNEL:     wtm = CLEARCHANNEL_MSG;     break;
-		    case MONBLOCK:         wtm = MONBLOCK_MSG;         break;
-		    case TRACEOFF:         wtm = TRACEOFF_MSG;         break;
-		    case TRACEON:          wtm = TRACEON_MSG;          break;
-		    case SETRETRYCOUNT:    wtm = SETRETRYCOUNT_MSG;    break;
-		    case GETRETRYCOUNT:    wtm = GETRETRYCOUNT_MSG;    break;
-		    case GETTIMEOUT:       wtm = GETTIMEOUT_MSG;       break;
-		    default:
-			fprintf(stderr, 
-	"EZCA FATAL ERROR: ezcaGetErrorString() found invalid worktype %d\n", 
-			    wp->worktype);
-			exit(1);
-			break;
-		} /* end switch() */
+} /* end connect_many() */
 
-		nbytes = nbytes 
-			    + (prefix ? strlen(prefix) : 0) + 1
-			    + strlen(wtm) + 2
-			    + (wp->rc == EZCA_OK 
-				? strlen(OKMSG) 
-				: (strlen(wp->error_msg)
-				    + (wp->aux_error_msg 
-					? strlen(wp->aux_error_msg)+3 
-					: 0)))
-			    + 1; /* for <CR> or NULL character */
+/****************************************************************
+*
+* Issue the CA request for a piece of group work on its (connected)
+* channel and set wp->needs_work if a callback is to be expected.
+*
+****************************************************************/
 
-	    } /* endfor */
-	} /* endif */
+static void issue_work(struct work *wp)
+{
 
-	if (nbytes > 0)
-	{
-	    if ((*buff = ezcacalloc(nbytes, 1)))
+    switch (wp->worktype)
+    {
+	case GET:
+	case GETWITHSTATUS:
+	    if (get_from_monitor(wp, wp->cp))
 	    {
-		if (Debug)
-	    printf("ezcaGetErrorString() just allocated %ld bytes\n", 
-		    (long)nbytes);
+		if (Trace || Debug)
+printf("ezcaEndGroupWithReport(): found an active monitor with a value for >%s<\n", 
+    WORK_PVNAME(wp));
+		wp->needs_work = FALSE;
+	    }
+	    else
+	    {
+		if (Trace || Debug)
+printf("ezcaEndGroupWithReport(): did not find an active monitor with a value for >%s<\n",
+		    WORK_PVNAME(wp));
 
-		/* filling the buffer */
+		wp->needs_work = issue_get(wp, wp->cp);
+	    } /* endif */
+	    break;
+	case GETCONTROLLIMITS:
+	case GETGRAPHICLIMITS:
+	case GETPRECISION:
+	case GETUNITS:
+	    case GETWARNLIMITS:
+	    case GETALARMLIMITS:
+	    wp->nelem = 1; /* = EzcaElementCount(wp->cp); */
+	    wp->needs_work = issue_get(wp, wp->cp);
+	    break;
+	    case GETENUMSTATES:
+		    if ( DBF_ENUM != EzcaNativeType(wp->cp) ) {
+			    wp->strp[0] = 0;
+			    wp->needs_work = FALSE;
+		    } else {
+			    wp->nelem = 1;
+			    wp->needs_work = issue_get(wp, wp->cp);
+		    }
+	    break;
+	case GETMETADATA:
+	    if (DBF_STRING == EzcaNativeType(wp->cp))
+	    {
+		/* nothing to ask for */
+		meta_clear((EzcaMetadataRec *) wp->pval);
+		wp->needs_work = FALSE;
+	    }
+	    else
+	    {
+		wp->nelem = 1;
+		wp->needs_work = issue_get(wp, wp->cp);
+	    } /* endif */
+	    break;
+	case GETNELEM:
+	    *wp->intp = wp->nelem = EzcaElementCount(wp->cp);
+	    wp->needs_work = FALSE;
+	    break;
+	case GETSTATUS:
+	    if (get_from_monitor(wp, wp->cp))
+	    {
+		if (Trace || Debug)
+printf("ezcaEndGroupWithReport(): found an active monitor with a value for >%s<\n", 
+    WORK_PVNAME(wp));
+		wp->needs_work = FALSE;
+	    }
+	    else
+	    {
+		if (Trace || Debug)
+printf("ezcaEndGroupWithReport(): did not find an active monitor with a value for >%s<\n",
+		    WORK_PVNAME(wp));
 
-		if (ErrorLocation == SINGLEWORK)
+		wp->nelem = 1; /* = EzcaElementCount(wp->cp); */
+		wp->needs_work = issue_get(wp, wp->cp);
+	    } /* endif */
+	    break;
+	case PUT:
+	    if (wp->nelem <= (int)EzcaElementCount(wp->cp))
+	    {
+		wp->reported = FALSE;
+		if (EzcaArrayPutCallback(wp, wp->cp) == ECA_NORMAL)
+		    wp->needs_work = TRUE;
+		else
 		{
-		    /* using Workp */
-		    if (Workp)
-		    {
-			wp = Workp;
-			cp = *buff;
+		    /* something went wrong ... rc and */
+		    /* error msg have already been set */
 
-			switch (wp->worktype)
-			{
-			    case GET:              
-				wtm = GET_MSG;                 break;
-			    case PUT:              
-				wtm = PUT_MSG;                 break;
-			    case PUTOLDCA:         
-				wtm = PUTOLDCA_MSG;            break;
-			    case GETUNITS:         
-				wtm = GETUNITS_MSG;            break;
-			    case GETENUMSTATES:         
-				wtm = GETENUMSTATES_MSG;       break;
-			    case GETNELEM:         
-				wtm = GETNELEM_MSG;            break;
-			    case GETPRECISION:     
-				wtm = GETPRECISION_MSG;        break;
-			    case GETGRAPHICLIMITS: 
-				wtm = GETGRAPHICLIMITS_MSG;    break;
-			    case GETCONTROLLIMITS: 
-				wtm = GETCONTROLLIMITS_MSG;    break;
-		    	case GETWARNLIMITS:
-				wtm = GETWARNLIMITS_MSG;       break;
-			    case GETALARMLIMITS:
-				wtm = GETALARMLIMITS_MSG;      break;
-			    case GETSTATUS:        
-				wtm = GETSTATUS_MSG;           break;
-			    case GETWITHSTATUS:    
-				wtm = GETWITHSTATUS_MSG;       break;
-			    case SETMONITOR:       
-				wtm = SETMONITOR_MSG;          break;
-			    case CLEARMONITOR:     
-				wtm = CLEARMONITOR_MSG;        break;
-			    case AUTOERRORMESSAGEOFF: 
-				wtm = AUTOERRORMESSAGEOFF_MSG; break;
-			    case AUTOERRORMESSAGEON:     
-				wtm = AUTOERRORMESSAGEON_MSG;  break;
-			    case DEBUGOFF:         
-				wtm = DEBUGOFF_MSG;            break;
-			    case DEBUGON:          
-				wtm = DEBUGON_MSG;             break;
-			    case DELAY:            
-				wtm = DELAY_MSG;               break;
-			    case FREEMEM:  
-				wtm = FREEMEM_MSG;             break;
-			    case PVTOCHID:         
-				wtm = PVTOCHID_MSG;            break;
-			    case SETTIMEOUT:       
-				wtm = SETTIMEOUT_MSG;          break;
-			    case STARTGROUP:       
-				wtm = STARTGROUP_MSG;          break;
-		    	case CLEARCHANNEL:
-			    wtm = CLEARCHANNEL_MSG;        break;
-		    	case MONBLOCK:
-				wtm = MONBLOCK_MSG;            break;
-			    case TRACEOFF:         
-				wtm = TRACEOFF_MSG;            break;
-			    case TRACEON:          
-				wtm = TRACEON_MSG;             break;
-			    case SETRETRYCOUNT:    
-				wtm = SETRETRYCOUNT_MSG;       break;
-			    case GETRETRYCOUNT:    
-				wtm = GETRETRYCOUNT_MSG;       break;
-			    case GETTIMEOUT:       
-				wtm = GETTIMEOUT_MSG;          break;
-			    default:
-				fprintf(stderr, 
-	"EZCA FATAL ERROR: ezcaGetErrorString() found invalid worktype %d\n", 
-				    wp->worktype);
-				exit(1);
-				break;
-			} /* end switch() */
+		    /* need to trash this wp so it's */
+		    /* never used again in case the  */
+		    /* callback fires off later      */
 
-			if (prefix)
-			{
-			    strcat(cp, prefix);
-			    cp += strlen(prefix);
-			} /* endif */
+		    wp->needs_work = FALSE;
+		    wp->trashme = trashed;
+		    if (Debug)
+			printf("trashing wp %p\n", wp);
 
-			strcat(cp, " ");
-			cp ++;
+		} /* endif */
+	    }
+	    else
+	    {
+		/* too many elements requested */
+		wp->rc = EZCA_INVALIDARG;
+		wp->error_msg = ErrorMsgs[TOO_MANY_NELEM_MSG_IDX];
 
-			strcat(cp, wtm);
-			cp += strlen(wtm);
+		if (AutoErrorMessage)
+		    print_error(wp);
+	    } /* endif */
+	    break;
+	case PUTOLDCA:
+	    wp->needs_work = FALSE;
+	    if (wp->nelem <= (int)EzcaElementCount(wp->cp))
+		EzcaArrayPut(wp, wp->cp);
+	    else
+	    {
+		/* too many elements requested */
+		wp->rc = EZCA_INVALIDARG;
+		wp->error_msg = ErrorMsgs[TOO_MANY_NELEM_MSG_IDX];
 
-			strcat(cp, ": ");
-			cp += 2;
+		if (AutoErrorMessage)
+		    print_error(wp);
+	    } /* endif */
+	    break;
 
-			if (wp->rc == EZCA_OK)
-			{
-			    strcat(cp, OKMSG);
-			    cp += strlen(OKMSG);
-			}
-			else
-			{
-			    strcat(cp, wp->error_msg);
-			    cp += strlen(wp->error_msg);
-			    if (wp->aux_error_msg)
-			    {
-				strcat(cp, " : ");
-				cp += 3;
+	    case MONBLOCK:
+		    { struct monitor *mp;
 
-				strcat(cp, wp->aux_error_msg);
-				cp += strlen(wp->aux_error_msg);
-			    } /* endif */
-			} /* endif */
+			    wp->reported = FALSE;
 
-			*cp = '\0';
+			    mp = wp->cp->monitor_list;
+
+			    while (mp && ( ! (wp->ezcadatatype == mp->ezcadatatype) || !mp->active))
+				    mp = mp->right;
+			    if ( !mp ) {
+				    wp->rc = EZCA_INVALIDARG;
+				    wp->error_msg = ErrorMsgs[NO_MONITOR_MSG_IDX];
+				    if (AutoErrorMessage)
+					    print_error(wp);
+			    } else {
+				    CHAN_LOCK(mp->cp);
+				    if ( (wp->needs_work = !mp->needs_reading) ) {
+					    wp->pval   = mp;
+					    if ( mp->waiter ) {
+						    fprintf(stderr,"EZCA FATAL ERROR: mp->waiter is already set\n");
+						    exit(1);
+					    }
+					    mp->waiter = wp;
+				    } else {
+					    wp->pval = NULL;
+				    }
+				    CHAN_UNLOCK(mp->cp);
+			    }
 		    }
-		    else
-		    {
-			fprintf(stderr, 
-"EZCA FATAL ERROR: ezcaGetErrorString() found NULL Workp when known to be non-NULL\n");
-			exit(1);
-		    } /* endif */
+	    break;
+	default:
+	    fprintf(stderr,
+"EZCA FATAL ERROR: ezcaEndGroupWithReport() found invalid worktype %d in group list\n",
+		wp->worktype);
+	    exit(1);
+	    break;
+    } /* end switch() */
+
+} /* end issue_work() */
+
+/****************************************************************
+*
+* Called from the connection callback when a channel searched by
+* the current group (or an async group) comes up: issue all the
+* group work that has been waiting for it. Work which does not
+* result in a callback (or failed to be issued) is counted down
+* right away.
+*
+****************************************************************/
+
+static void issue_pending(struct channel *cp)
+{
+
+struct work *wp;
+
+    /* marks the channel CONNECTED */
+    EzcaConnected(cp);
+
+    while ((wp = cp->pending))
+    {
+	cp->pending      = wp->next_pending;
+	wp->next_pending = (struct work *) NULL;
+	wp->deferred     = FALSE;
+
+	if (Trace || Debug)
+	    printf("issue_pending(): issuing work for >%s<\n", WORK_PVNAME(wp));
+
+	issue_work(wp);
+
+	if (wp->rc != EZCA_OK || !wp->needs_work)
+	{
+	    wp->needs_work = FALSE;
+	    WORK_DONE(wp);
+	} /* endif */
+    } /* endwhile */
+
+    ca_flush_io();
+
+} /* end issue_pending() */
+
+/****************************************************************
+*
+* Ends the current group like ezcaEndGroupWithReport() but keeps
+* the work list (resolved channels, node and user buffers) as a
+* prepared group which can be run again by ezcaExecuteGroup().
+* The group is executed once as part of this call.  Only 'get'
+* type work may be prepared; if there is other work in the list
+* (or no memory) nothing is executed and *pg is set to NULL.
+*
+****************************************************************/
+
+int epicsShareAPI ezcaPrepareGroup(EzcaGroup *pg, int **rcs, int *nrcs)
+{
+
+struct work *wp;
+EzcaGroup g = (EzcaGroup) NULL;
+int n, i;
+int rc;
+
+    prologue();
+
+    if (pg)
+	*pg = (EzcaGroup) NULL;
+
+    if (InGroup)
+    {
+	/* in a group */
+
+	for (wp = Work_list.head, n = 0, rc = EZCA_OK; wp; wp = wp->next, n++)
+	{
+	    if (!preparable(wp))
+	    {
+		wp->rc = EZCA_INVALIDARG;
+		wp->error_msg = ErrorMsgs[NOT_PREPARABLE_MSG_IDX];
+
+		if (AutoErrorMessage)
+		    print_error(wp);
+
+		rc = EZCA_INVALIDARG;
+	    } /* endif */
+	} /* endfor */
+
+	if (!pg && rc == EZCA_OK)
+	{
+	    rc = EZCA_INVALIDARG;
+
+	    if (AutoErrorMessage)
+		printf("%s\n", INVALID_ARG_MSG);
+	} /* endif */
+
+	if (rc == EZCA_OK)
+	{
+	    if (!(g = (EzcaGroup) ezcacalloc(1, sizeof(*g)))
+		|| !(g->work = (struct work **) ezcacalloc(n + 1, sizeof(*g->work)))
+		|| !(g->tmpl = (struct work *) ezcacalloc(n + 1, sizeof(*g->tmpl))))
+	    {
+		rc = EZCA_FAILEDMALLOC;
+
+		if (AutoErrorMessage)
+		    printf("%s\n", FAILED_MALLOC_MSG);
+	    } /* endif */
+	} /* endif */
+
+	if (rc == EZCA_OK)
+	{
+	    g->nwork = n;
+
+	    /* the templates are taken before end_group() modifies the nodes */
+	    for (wp = Work_list.head, i = 0; wp; wp = wp->next, i++)
+	    {
+		g->work[i] = wp;
+		g->tmpl[i] = *wp;
+	    } /* endfor */
+
+	    rc = end_group(rcs, nrcs);
+
+	    for (i = 0; i < n && g->work[i]->cp; i++)
+		;
+
+	    if (i < n)
+	    {
+		/* a channel could not be created; rc has been set */
+		release_work_list_channels();
+	    }
+	    else
+	    {
+		for (i = 0; i < n; i++)
+		{
+		    wp = g->work[i];
+
+		    /* the template takes over the channel reference */
+		    g->tmpl[i].cp = wp->cp;
+		    g->tmpl[i].cp->nhandles++;
+		    g->tmpl[i].next = (struct work *) NULL;
+		    g->tmpl[i].pvname = (char *) NULL;
+		    g->tmpl[i].aux_error_msg = (char *) NULL;
+		    wp->cp = (struct channel *) NULL;
+
+		    if (wp->pvname)
+		    {
+			work_free(wp, wp->pvname);
+			wp->pvname = (char *) NULL;
+		    } /* endif */
+		} /* endfor */
+
+		Work_list_group = g;
+		g->attached = Ctx;
+		*pg = g;
+		g = (EzcaGroup) NULL;
+	    } /* endif */
+	}
+	else
+	{
+	    /* abandoning the group; nothing was executed */
+	    for (wp = Work_list.head; wp; wp = wp->next)
+	    {
+		if ((wp->worktype == PUT || wp->worktype == PUTOLDCA) && wp->pval)
+		{
+		    work_free(wp, wp->pval);
+		    wp->pval = (void *) NULL;
+		} /* endif */
+	    } /* endfor */
+
+	    release_work_list_channels();
+
+	    ErrorLocation = LISTWORK;
+	    ListPrint = WHOLELIST;
+	    InGroup = FALSE;
+
+	    if (nrcs)
+		*nrcs = -1;
+
+	    if (rcs)
+		*rcs = (int *) NULL;
+	} /* endif */
+
+	if (g)
+	{
+	    ezcafree((char *) g->work);
+	    ezcafree((char *) g->tmpl);
+	    ezcafree((char *) g);
+	} /* endif */
+    }
+    else
+    {
+	/* not in a group */
+	rc = EZCA_NOTINGROUP;
+
+	if (nrcs)
+	    *nrcs = -1;
+
+	if (rcs)
+	    *rcs = (int *) NULL;
+
+	if (AutoErrorMessage)
+	    printf("%s\n", NOTINGROUP_MSG);
+    } /* endif */
+
+    epilogue();
+    return rc;
+
+} /* end ezcaPrepareGroup() */
+
+/****************************************************************
+*
+* Runs a prepared group again.  Results go to the same user
+* buffers that were passed when the group was built; errors are
+* reported like for ezcaEndGroupWithReport().
+*
+****************************************************************/
+
+int epicsShareAPI ezcaExecuteGroup(EzcaGroup g, int **rcs, int *nrcs)
+{
+
+struct work *wp, *gwp;
+BOOL executed = FALSE;
+int i;
+int rc;
+
+    prologue();
+
+    if ((wp = get_work_single()))
+    {
+	ErrorLocation = SINGLEWORK;
+
+	/* filling work */
+	wp->worktype = EXECUTEGROUP;
+
+	if (!g)
+	{
+	    wp->rc = EZCA_INVALIDARG;
+	    wp->error_msg = ErrorMsgs[INVALID_ARG_MSG_IDX];
+
+	    if (AutoErrorMessage)
+		print_error(wp);
+	}
+	else if (InGroup)
+	{
+	    /* already in a group */
+	    wp->rc = EZCA_INGROUP;
+	    wp->error_msg = ErrorMsgs[INGROUP_MSG_IDX];
+
+	    if (AutoErrorMessage)
+		print_error(wp);
+	}
+	else if (g->attached && g->attached->in_group)
+	{
+	    /* another thread is waiting for it */
+	    wp->rc = EZCA_INGROUP;
+	    wp->error_msg = ErrorMsgs[GROUP_BUSY_MSG_IDX];
+
+	    if (AutoErrorMessage)
+		print_error(wp);
+	}
+	else
+	{
+	    /* also gives back the nodes of a previously executed group */
+	    empty_work_list();
+	    /* the nodes may still be on another thread's list */
+	    if (g->attached)
+		detach_group(g);
+
+	    /* replace nodes that had to be trashed */
+	    for (i = 0; i < g->nwork; i++)
+	    {
+		if (!g->work[i] && !(g->work[i] = pop_work()))
+		    break;
+	    } /* endfor */
+
+	    if (i < g->nwork)
+	    {
+		wp->rc = EZCA_FAILEDMALLOC;
+		wp->error_msg = ErrorMsgs[FAILED_MALLOC_MSG_IDX];
+
+		if (AutoErrorMessage)
+		    print_error(wp);
+	    }
+	    else
+	    {
+		for (i = 0; i < g->nwork; i++)
+		{
+		    gwp = g->work[i];
+
+		    if (gwp->aux_error_msg)
+			work_free(gwp, gwp->aux_error_msg);
+
+		    *gwp = g->tmpl[i];
+		    use_handle(g->tmpl[i].cp, &gwp->cp);
+		    append_to_work_list(gwp);
+		} /* endfor */
+
+		Work_list_group = g;
+		g->attached = Ctx;
+		InGroup = TRUE;
+
+		rc = end_group(rcs, nrcs);
+		executed = TRUE;
+
+		release_work_list_channels();
+	    } /* endif */
+	} /* endif */
+
+	if (!executed)
+	    rc = wp->rc;
+    }
+    else
+    {
+	rc = EZCA_FAILEDMALLOC;
+
+	if (AutoErrorMessage)
+	    printf("%s\n", FAILED_MALLOC_MSG);
+    } /* endif */
+
+    if (!executed)
+    {
+	if (nrcs)
+	    *nrcs = -1;
+
+	if (rcs)
+	    *rcs = (int *) NULL;
+    } /* endif */
+
+    epilogue();
+    return rc;
+
+} /* end ezcaExecuteGroup() */
+
+/****************************************************************
+*
+*
+****************************************************************/
+
+int epicsShareAPI ezcaFreeGroup(EzcaGroup g)
+{
+
+struct work *wp;
+int rc;
+
+    prologue();
+
+    if ((wp = get_work_single()))
+    {
+	ErrorLocation = SINGLEWORK;
+
+	/* filling work */
+	wp->worktype = FREEGROUP;
+
+	if (!g)
+	{
+	    wp->rc = EZCA_INVALIDARG;
+	    wp->error_msg = ErrorMsgs[INVALID_ARG_MSG_IDX];
+
+	    if (AutoErrorMessage)
+		print_error(wp);
+	}
+	else if (g->attached && g->attached->in_group)
+	{
+	    /* another thread is waiting for it */
+	    wp->rc = EZCA_INGROUP;
+	    wp->error_msg = ErrorMsgs[GROUP_BUSY_MSG_IDX];
+
+	    if (AutoErrorMessage)
+		print_error(wp);
+	}
+	else
+	{
+	    if (g->attached)
+		detach_group(g);
+
+	    free_group(g);
+
+	    wp->rc = EZCA_OK;
+	} /* endif */
+
+	rc = wp->rc;
+    }
+    else
+    {
+	rc = EZCA_FAILEDMALLOC;
+
+	if (AutoErrorMessage)
+	    printf("%s\n", FAILED_MALLOC_MSG);
+    } /* endif */
+
+    epilogue();
+    return rc;
+
+} /* end ezcaFreeGroup() */
+
+/****************************************************************
+*
+* Ends the current group like ezcaEndGroupWithReport() but does
+* not wait: the requests are issued and the group is handed over
+* to a ticket which ezcaGroupTest(), ezcaGroupWait() and
+* ezcaGroupWaitAny() check and ezcaGroupCollect() finally turns
+* into the rcs of the group. Results go to the user buffers as
+* they arrive. If no memory is available the group stays open.
+*
+****************************************************************/
+
+int epicsShareAPI ezcaEndGroupAsync(EzcaTicket *pt)
+{
+
+struct work *wp, *gwp;
+EzcaTicket t;
+int rc;
+
+    prologue();
+
+    if (pt)
+	*pt = (EzcaTicket) NULL;
+
+    if ((wp = get_work_single()))
+    {
+	ErrorLocation = SINGLEWORK;
+
+	/* filling work */
+	wp->worktype = ENDGROUPASYNC;
+
+	if (!pt)
+	{
+	    wp->rc = EZCA_INVALIDARG;
+	    wp->error_msg = ErrorMsgs[INVALID_ARG_MSG_IDX];
+
+	    if (AutoErrorMessage)
+		print_error(wp);
+	}
+	else if (!InGroup)
+	{
+	    /* not in a group */
+	    wp->rc = EZCA_NOTINGROUP;
+	    wp->error_msg = ErrorMsgs[NOTINGROUP_MSG_IDX];
+
+	    if (AutoErrorMessage)
+		print_error(wp);
+	}
+	else if (!(t = (EzcaTicket) ezcacalloc(1, sizeof(*t))))
+	{
+	    wp->rc = EZCA_FAILEDMALLOC;
+	    wp->error_msg = ErrorMsgs[FAILED_MALLOC_MSG_IDX];
+
+	    if (AutoErrorMessage)
+		print_error(wp);
+	}
+	else
+	{
+	    /* the ticket takes over the work list and its strings */
+	    t->work = Work_list;
+	    Work_list.head = (struct work *) NULL;
+	    Work_list.tail = (struct work *) NULL;
+
+	    t->arena = Group_arena;
+	    Group_arena.blks = (struct arena_blk *) NULL;
+	    Group_arena.total = 0;
+
+	    for (gwp = t->work.head; gwp; gwp = gwp->next)
+		gwp->ticket = t;
+
+	    if (Trace || Debug)
+		printf("ezcaEndGroupAsync() about to process work list\n");
+
+	    /* callbacks may count down before we know the total */
+	    ticket_issued(t, issue_group(t->work.head));
+	    ca_flush_io();
+
+	    set_deadline(&t->deadline, (double) TimeoutSeconds * (RetryCount + 1));
+
+	    t->next = Tickets;
+	    Tickets = t;
+
+	    InGroup = FALSE;
+
+	    *pt = t;
+	    wp->rc = EZCA_OK;
+	} /* endif */
+
+	rc = wp->rc;
+    }
+    else
+    {
+	rc = EZCA_FAILEDMALLOC;
+
+	if (AutoErrorMessage)
+	    printf("%s\n", FAILED_MALLOC_MSG);
+    } /* endif */
+
+    epilogue();
+    return rc;
+
+} /* end ezcaEndGroupAsync() */
+
+/****************************************************************
+*
+* Returns 1 if an async group is over (all requests reported or
+* the deadline passed), 0 if it is still in progress and < 0 if
+* 't' is not a valid ticket.
+*
+****************************************************************/
+
+int epicsShareAPI ezcaGroupTest(EzcaTicket t)
+{
+
+int rc;
+
+    prologue();
+
+    if (find_ticket(t))
+    {
+	rc = (test_ticket(t) ? 1 : 0);
+    }
+    else
+    {
+	rc = -1;
+
+	if (AutoErrorMessage)
+	    printf("%s\n", INVALID_ARG_MSG);
+    } /* endif */
+
+    epilogue();
+    return rc;
+
+} /* end ezcaGroupTest() */
+
+/****************************************************************
+*
+* Waits up to 'timeout' seconds (until the group's deadline if
+* < 0) for an async group to be over. Returns like ezcaGroupTest().
+*
+****************************************************************/
+
+int epicsShareAPI ezcaGroupWait(EzcaTicket t, float timeout)
+{
+
+int rc;
+
+    prologue();
+
+    if (find_ticket(t))
+    {
+	rc = (wait_tickets(&t, 1, timeout) < 0 ? 0 : 1);
+    }
+    else
+    {
+	rc = -1;
+
+	if (AutoErrorMessage)
+	    printf("%s\n", INVALID_ARG_MSG);
+    } /* endif */
+
+    epilogue();
+    return rc;
+
+} /* end ezcaGroupWait() */
+
+/****************************************************************
+*
+* Waits up to 'timeout' seconds (until the last deadline if < 0)
+* for any of the async groups in ts[0..n-1] to be over. NULL
+* entries are skipped (e.g., tickets already collected).
+* Returns the index of a group that is over, -1 if none is and
+* -2 if an argument is invalid.
+*
+****************************************************************/
+
+int epicsShareAPI ezcaGroupWaitAny(EzcaTicket *ts, int n, float timeout)
+{
+
+int rc;
+int i;
+
+    prologue();
+
+    for (i = 0; ts && i < n; i++)
+    {
+	if (ts[i] && !find_ticket(ts[i]))
+	    break;
+    } /* endfor */
+
+    if (ts && n > 0 && i == n)
+    {
+	rc = wait_tickets(ts, n, timeout);
+    }
+    else
+    {
+	rc = -2;
+
+	if (AutoErrorMessage)
+	    printf("%s\n", INVALID_ARG_MSG);
+    } /* endif */
+
+    epilogue();
+    return rc;
+
+} /* end ezcaGroupWaitAny() */
+
+/****************************************************************
+*
+* Waits for an async group to be over (up to its deadline) and
+* returns its rcs exactly like ezcaEndGroupWithReport(). The
+* ticket is invalid afterwards. Unless a new group has been
+* started in the meantime, the errors of the group are reported
+* by ezcaPerror() and ezcaGetErrorString().
+*
+****************************************************************/
+
+int epicsShareAPI ezcaGroupCollect(EzcaTicket t, int **rcs, int *nrcs)
+{
+
+struct work *wp;
+struct arena a;
+int rc;
+
+    prologue();
+
+    if (find_ticket(t))
+    {
+	if (wait_tickets(&t, 1, -1.) < 0 && !t->finished)
+	{
+	    /* aborted */
+	    t->finished = TRUE;
+	    finish_group(t->work.head, ECA_TIMEOUT);
+	} /* endif */
+
+	rc = report_group(t->work.head, rcs, nrcs);
+
+	if (!InGroup)
+	{
+	    /* the list replaces that of the last group */
+	    empty_work_list();
+
+	    Work_list = t->work;
+	    t->work.head = (struct work *) NULL;
+	    t->work.tail = (struct work *) NULL;
+
+	    a = Group_arena;
+	    Group_arena = t->arena;
+	    t->arena = a;
+
+	    /* the collecting thread may differ from the issuing one */
+	    for (wp = Work_list.head; wp; wp = wp->next)
+	    {
+		wp->ticket = (EzcaTicket) NULL;
+		wp->ctx = Ctx;
+	    } /* endfor */
+
+	    release_work_list_channels();
+
+	    ErrorLocation = LISTWORK;
+	    ListPrint = WHOLELIST;
+	} /* endif */
+
+	free_ticket(t);
+    }
+    else
+    {
+	rc = EZCA_INVALIDARG;
+
+	if (nrcs)
+	    *nrcs = -1;
+
+	if (rcs)
+	    *rcs = (int *) NULL;
+
+	if (AutoErrorMessage)
+	    printf("%s\n", INVALID_ARG_MSG);
+    } /* endif */
+
+    epilogue();
+    return rc;
+
+} /* end ezcaGroupCollect() */
+
+/****************************************************************
+*
+* if there are no errors to report (no work done) retuns NULL in **buff
+* with EZCA_OK.
+*
+****************************************************************/
+
+int epicsShareAPI ezcaGetErrorString(char *prefix, char **buff)
+{
+
+struct work *wp;
+char *wtm;
+char *cp;
+size_t nbytes;
+int rc;
+
+    prologue();
+
+    if (buff)
+    {
+	/* calculating size of buffer */
+
+	nbytes = 0;
+
+	if (ErrorLocation == SINGLEWORK)
+	{
+	    /* using Workp */
+
+	    if (Debug)
+		printf("ezcaGetErrorString() using SINGLEWORK (Workp)\n");
+		
+	    if (Workp)
+	    {
+		wp = Workp;
+		wtm = worktype_msg(wp, "ezcaGetErrorString");
+
+		nbytes = nbytes 
+			    + (prefix ? strlen(prefix) : 0) + 1
+			    + strlen(wtm) + 2
+			    + (wp->rc == EZCA_OK 
+				? strlen(OKMSG) 
+				: (strlen(wp->error_msg) 
+				    + (wp->aux_error_msg 
+					? strlen(wp->aux_error_msg)+3 
+					: 0)))
+			    + 1; /* for <CR> or NULL character */
+
+	    } /* endif */
+	}
+	else
+	{
+	    /* using Work_list */
+
+	    if (Debug)
+		printf("ezcaGetErrorString() using LISTWORK (Work_list)\n");
+
+	    for (wp = (ListPrint == WHOLELIST ? Work_list.head: Work_list.tail); 
+		    wp; wp = wp->next)
+	    {
+		wtm = worktype_msg(wp, "ezcaGetErrorString");
+
+		nbytes = nbytes 
+			    + (prefix ? strlen(prefix) : 0) + 1
+			    + strlen(wtm) + 2
+			    + (wp->rc == EZCA_OK 
+				? strlen(OKMSG) 
+				: (strlen(wp->error_msg)
+				    + (wp->aux_error_msg 
+					? strlen(wp->aux_error_msg)+3 
+					: 0)))
+			    + 1; /* for <CR> or NULL character */
+
+	    } /* endfor */
+	} /* endif */
+
+	if (nbytes > 0)
+	{
+	    if ((*buff = ezcacalloc(nbytes, 1)))
+	    {
+		if (Debug)
+	    printf("ezcaGetErrorString() just allocated %ld bytes\n", 
+		    (long)nbytes);
+
+		/* filling the buffer */
+
+		if (ErrorLocation == SINGLEWORK)
+		{
+		    /* using Workp */
+		    if (Workp)
+		    {
+			wp = Workp;
+			cp = *buff;
+
+			wtm = worktype_msg(wp, "ezcaGetErrorString");
+
+			if (prefix)
+			{
+			    strcat(cp, prefix);
+			    cp += strlen(prefix);
+			} /* endif */
+
+			strcat(cp, " ");
+			cp ++;
+
+			strcat(cp, wtm);
+			cp += strlen(wtm);
+
+			strcat(cp, ": ");
+			cp += 2;
+
+			if (wp->rc == EZCA_OK)
+			{
+			    strcat(cp, OKMSG);
+			    cp += strlen(OKMSG);
+			}
+			else
+			{
+			    strcat(cp, wp->error_msg);
+			    cp += strlen(wp->error_msg);
+			    if (wp->aux_error_msg)
+			    {
+				strcat(cp, " : ");
+				cp += 3;
+
+				strcat(cp, wp->aux_error_msg);
+				cp += strlen(wp->aux_error_msg);
+			    } /* endif */
+			} /* endif */
+
+			*cp = '\0';
+		    }
+		    else
+		    {
+			fprintf(stderr, 
+"EZCA FATAL ERROR: ezcaGetErrorString() found NULL Workp when known to be non-NULL\n");
+			exit(1);
+		    } /* endif */
+		}
+		else
+		{
+		    /* using Work_list */
+		    for (cp = *buff, 
+		wp = (ListPrint == WHOLELIST ? Work_list.head : Work_list.tail);
+			wp; wp = wp->next)
+		    {
+			wtm = worktype_msg(wp, "ezcaGetErrorString");
+
+			if (prefix)
+			{
+			    strcat(cp, prefix);
+			    cp += strlen(prefix);
+			} /* endif */
+
+			strcat(cp, " ");
+			cp ++;
+
+			strcat(cp, wtm);
+			cp += strlen(wtm);
+
+			strcat(cp, ": ");
+			cp += 2;
+
+			if (wp->rc == EZCA_OK)
+			{
+			    strcat(cp, OKMSG);
+			    cp += strlen(OKMSG);
+			}
+			else
+			{
+			    strcat(cp, wp->error_msg);
+			    cp += strlen(wp->error_msg);
+
+			    if (wp->aux_error_msg)
+			    {
+				strcat(cp, " : ");
+				cp += 3;
+
+				strcat(cp, wp->aux_error_msg);
+				cp += strlen(wp->aux_error_msg);
+
+			    } /* endif */
+			} /* endif */
+
+			if (wp->next)
+			{
+			    *cp = '\n';
+			    cp ++;
+			} 
+			else
+			{
+			    *cp = '\0';
+			    cp ++;
+			} /* endif */
+
+		    } /* endfor */
+		} /* endif */
+
+		rc = EZCA_OK;
+	    }
+	    else
+	    {
+		rc = EZCA_FAILEDMALLOC;
+
+		if (AutoErrorMessage)
+		    printf("%s\n", FAILED_MALLOC_MSG);
+	    } /* endif */
+	}
+	else
+	{
+
+	    rc = EZCA_OK;
+
+	    *buff = (char *) NULL;
+
+	    if (Trace || Debug)
+		printf("ezcaGetErrorString() found no work\n");
+	} /* endif */
+    }
+    else
+    {
+	rc = EZCA_INVALIDARG;
+
+	if (AutoErrorMessage)
+	    printf("%s\n", INVALID_ARG_MSG);
+    } /* endif */
+
+    epilogue();
+    return rc;
+
+} /* end ezcaGetErrorString() */
+
+/****************************************************************
+*
+* because this function returns TRUE/FALSE, it does not conform to
+* the normal error message scheme of the rest of the functions.
+* for this reason it does not get a work node and is therefore
+* classified as an immediate function (rather than a non-groupable
+* work function).
+*
+* the user wishes to know if he needs to read the value that he
+* presumably set a monitor on.  this function returns TRUE (needs 
+* reading) or FALSE.
+*
+* It always error towards forcing the read ... if anything goes wrong,
+* it returns -1.
+*
+* It returns FALSE iff there is an existing monitor that does not 
+* need reading ... otherwise returns TRUE (no channel, invalid args, ...)
+*
+****************************************************************/
+
+int epicsShareAPI ezcaNewMonitorValue(char *pvname, char type)
+{
+
+struct channel *cp;
+struct monitor *mp;
+BOOL found;
+int rc;
+
+    prologue();
+
+    if (pvname)
+    {
+	if (VALID_EZCA_DATA_TYPE(type))
+	{
+	    if ((cp = find_channel(pvname)))
+	    {
+		mp = cp->monitor_list;
+		found = FALSE;
+		while (mp && !found)
+		    if (!(found = (type == mp->ezcadatatype)))
+			mp = mp->right;
+
+		if (found)
+		    rc = (int) mp->needs_reading;
+		else
+		{
+		    /* no monitor */
+
+		    if (Trace || Debug)
+	printf("ezcaNewMonitorValue() found no monitor name >%s< type %d\n",
+			pvname, type);
+
+		    rc = -1;
+		} /* endif */
+		release_channel(&cp);
+	    }
+	    else
+	    {
+		/* no channel */
+		rc = -2;
+
+		if (Trace || Debug)
+	printf("ezcaNewMonitorValue() found no channel name >%s< type %d\n",
+			pvname, type);
+	    } /* endif */
+	}
+	else
+	{
+	    /* invalid type */
+	    rc = -3;
+
+	    if (AutoErrorMessage)
+		printf("%s\n", INVALID_TYPE_MSG);
+	} /* endif */
+    }
+    else
+    {
+	/* invalid pvname */
+	rc = -4;
+
+	if (AutoErrorMessage)
+	    printf("%s\n", INVALID_PVNAME_MSG);
+
+    } /* endif */
+
+    epilogue();
+    return rc;
+
+} /* end ezcaNewMonitorValue() */
+
+/****************************************************************
+*
+* returns the number of updates waiting in the queue of a monitor
+* established by ezcaSetMonitorQueued() or, like
+* ezcaNewMonitorValue(), < 0 if there is no such (queued) monitor
+* or another error.
+*
+****************************************************************/
+
+int epicsShareAPI ezcaGetQueuedCount(char *pvname, char type)
+{
+
+struct channel *cp;
+struct monitor *mp;
+int rc;
+
+    prologue();
+
+    if (pvname)
+    {
+	if (VALID_EZCA_DATA_TYPE(type))
+	{
+	    if ((cp = find_channel(pvname)))
+	    {
+		for (mp = cp->monitor_list; mp; mp = mp->right)
+		    if (type == mp->ezcadatatype)
+			break;
+
+		if (mp && mp->src->queue)
+		{
+		    CHAN_LOCK(cp);
+		    rc = (int) mp->src->queue->count;
+		    CHAN_UNLOCK(cp);
+		}
+		else
+		{
+		    /* no queued monitor */
+
+		    if (Trace || Debug)
+	printf("ezcaGetQueuedCount() found no queued monitor name >%s< type %d\n",
+			pvname, type);
+
+		    rc = -1;
+		} /* endif */
+		release_channel(&cp);
+	    }
+	    else
+	    {
+		/* no channel */
+		rc = -2;
+	    } /* endif */
+	}
+	else
+	{
+	    /* invalid type */
+	    rc = -3;
+
+	    if (AutoErrorMessage)
+		printf("%s\n", INVALID_TYPE_MSG);
+	} /* endif */
+    }
+    else
+    {
+	/* invalid pvname */
+	rc = -4;
+
+	if (AutoErrorMessage)
+	    printf("%s\n", INVALID_PVNAME_MSG);
+
+    } /* endif */
+
+    epilogue();
+    return rc;
+
+} /* end ezcaGetQueuedCount() */
+
+/****************************************************************
+*
+* if there is no outstanding work, this function is a no-op.
+*
+****************************************************************/
+
+void epicsShareAPI ezcaPerror(char *prefix)
+{
+
+struct work *wp;
+char *wtm;
+
+    prologue();
+
+    if (ErrorLocation == SINGLEWORK)
+    {
+	/* using Workp */
+
+	if (Workp)
+	{
+	    wp = Workp;
+
+	    wtm = worktype_msg(wp, "ezcaPerror");
+
+	    printf("%s %s: ", (prefix ? prefix : ""), wtm);
+	    print_error(wp);
+	} /* endif */
+    }
+    else
+    {
+	/* using Work_list */
+
+	for (wp = (ListPrint == WHOLELIST ? Work_list.head : Work_list.tail); 
+	    wp; wp = wp->next)
+	{
+	    wtm = worktype_msg(wp, "ezcaPerror");
+
+	    printf("%s %s: ", (prefix ? prefix : ""), wtm);
+	    print_error(wp);
+	} /* endfor */
+    } /* endif */
+
+    epilogue();
+} /* end ezcaPerror() */
+
+/**************************************************************/
+/*                                                            */
+/* Non-Groupable Work Functions                               */
+/*                                                            */
+/* These allocate work,so they store error msgs.  They do not */
+/* change ErrorLocation.                                      */
+/* These are executed immediately, without respect to InGroup */
+/* context.                                                   */
+/*                                                            */
+/**************************************************************/
+
+/****************************************************************
+*
+*
+****************************************************************/
+
+void epicsShareAPI ezcaAutoErrorMessageOff()
+{
+
+struct work *wp;
+
+    prologue();
+
+    if ((wp = get_work_single()))
+    {
+	ErrorLocation = SINGLEWORK;
+
+	/* filling work */
+	wp->worktype = AUTOERRORMESSAGEOFF;
+
+	wp->rc = EZCA_OK;
+
+	AutoErrorMessage = FALSE;
+
+	if (Trace || Debug)
+	    printf("clearing AutoErrorMessage\n");
+    }
+    else
+    {
+	if (AutoErrorMessage)
+	    printf("%s\n", FAILED_MALLOC_MSG);
+    } /* endif */
+
+    epilogue();
+} /* end ezcaAutoErrorMessageOff() */
+
+/****************************************************************
+*
+*
+****************************************************************/
+
+void epicsShareAPI ezcaAutoErrorMessageOn()
+{
+
+struct work *wp;
+
+    prologue();
+
+    if ((wp = get_work_single()))
+    {
+	ErrorLocation = SINGLEWORK;
+
+	/* filling work */
+	wp->worktype = AUTOERRORMESSAGEON;
+	wp->rc = EZCA_OK;
+
+	AutoErrorMessage = TRUE;
+
+	if (Trace || Debug)
+	    printf("setting AutoErrorMessage\n");
+    }
+    else
+    {
+	if (AutoErrorMessage)
+	    printf("%s\n", FAILED_MALLOC_MSG);
+    } /* endif */
+
+    epilogue();
+} /* end ezcaAutoErrorMessageOn() */
+
+/****************************************************************
+*
+*
+****************************************************************/
+
+int epicsShareAPI ezcaClearMonitor(char *pvname, char type)
+{
+
+struct channel *cp;
+struct monitor *mp;
+struct work *wp;
+BOOL found;
+int rc;
+
+    prologue();
+
+    if ((wp = get_work_single()))
+    {
+	ErrorLocation = SINGLEWORK;
+
+	/* filling work */
+	wp->worktype = CLEARMONITOR;
+	wp->ezcadatatype = type;
+
+	/* checking input args */
+
+	if (!pvname)
+	{
+	    wp->rc = EZCA_INVALIDARG;
+	    wp->error_msg = ErrorMsgs[INVALID_PVNAME_MSG_IDX];
+
+	    if (AutoErrorMessage)
+		print_error(wp);
+	} 
+	else if (!(wp->pvname = work_strdup(wp, pvname)))
+	{
+	    wp->rc = EZCA_FAILEDMALLOC;
+	    wp->error_msg = ErrorMsgs[FAILED_MALLOC_MSG_IDX];
+
+	    if (AutoErrorMessage)
+		print_error(wp);
+	} 
+	else if (!VALID_EZCA_DATA_TYPE(wp->ezcadatatype))
+	{
+	    wp->rc = EZCA_INVALIDARG;
+	    wp->error_msg = ErrorMsgs[INVALID_TYPE_MSG_IDX];
+
+	    if (AutoErrorMessage)
+		print_error(wp);
+	} 
+	else
+	{
+	    /* arguments are valid */
+	    wp->rc = EZCA_OK;
+	} /* endif */
+
+	if (wp->rc == EZCA_OK)
+	{
+	    /* all input args OK */
+	    if ((cp = find_channel(wp->pvname)))
+	    {
+		/* everything OK so far ... otherwise something */
+		/* went wrong and it is already explained in wp */
+
+		/* loop to check monitor list for monitor of the same type */
+		mp = cp->monitor_list;
+		found = FALSE;
+		while (mp && !found)
+		if (!(found = (wp->ezcadatatype == mp->ezcadatatype)))
+		    mp = mp->right;
+
+		if (found)
+		{
+		    if (Trace || Debug)
+		printf("ezcaClearMonitor(): found monitor ... clearing now\n");
+
+		    /* removing monitor from this channel's list,   */
+		    /* clearing event (unless still shared), freeing */
+		    /* memory, and taking this monitor out of service */
+
+		    remove_monitor(mp);
+
+		    wp->rc = EZCA_OK;
+		}
+		else
+		{
+		    /* no monitor to clear */
+
+		    wp->rc = EZCA_OK;
+
+		    if (Trace || Debug)
+		printf("ezcaClearMonitor(): found channel but no monitor\n");
+
+		} /* endif */
+		release_channel(&cp);
+	    } 
+	    else
+	    {
+		wp->rc = EZCA_OK;
+
+		if (Trace || Debug)
+		    printf("ezcaClearMonitor: found no channel\n");
+	    } /* endif */
+	} /* endif */
+
+	rc = wp->rc;
+	    
+    }
+    else
+    {
+	rc = EZCA_FAILEDMALLOC;
+
+	if (AutoErrorMessage)
+	    printf("%s\n", FAILED_MALLOC_MSG);
+    } /* endif */
+
+    epilogue();
+    return rc;
+
+} /* end ezcaClearMonitor() */
+
+/****************************************************************
+*
+* Available, but not advertised.
+*
+****************************************************************/
+
+void epicsShareAPI ezcaDebugOff()
+{
+
+struct work *wp;
+
+    prologue();
+
+    if ((wp = get_work_single()))
+    {
+	ErrorLocation = SINGLEWORK;
+
+	/* filling work */
+	wp->worktype = DEBUGOFF;
+	wp->rc = EZCA_OK;
+
+	if (Trace || Debug)
+	    printf("clearing Debug\n");
+
+	Debug = FALSE;
+    }
+    else
+    {
+	if (AutoErrorMessage)
+	    printf("%s\n", FAILED_MALLOC_MSG);
+    } /* endif */
+
+    epilogue();
+} /* end ezcaDebugOff() */
+
+/****************************************************************
+*
+* Available, but not advertised.
+*
+****************************************************************/
+
+void epicsShareAPI ezcaDebugOn()
+{
+
+struct work *wp;
+
+    prologue();
+
+    if ((wp = get_work_single()))
+    {
+	ErrorLocation = SINGLEWORK;
+
+	/* filling work */
+	wp->worktype = DEBUGON;
+	wp->rc = EZCA_OK;
+
+	Debug = TRUE;
+
+	if (Trace || Debug)
+	    printf("setting Debug\n");
+    }
+    else
+    {
+	if (AutoErrorMessage)
+	    printf("%s\n", FAILED_MALLOC_MSG);
+    } /* endif */
+
+    epilogue();
+} /* end ezcaDebugOn() */
+
+/****************************************************************
+*
+* This is a function that we provide for users that use ezcaSetMonitor().
+* If they set a monitor and go a long time without calling another 
+* ezca function, they could lose important values.  
+*
+* Now all they have to do is call this function which allows us to check
+* the monitors.
+*
+****************************************************************/
+
+int epicsShareAPI ezcaDelay(float sec)
+{
+
+struct work *wp;
+int status;
+int rc;
+unsigned   attempt;
+
+    prologue();
+
+    if ((wp = get_work_single()))
+    {
+	ErrorLocation = SINGLEWORK;
+
+	/* filling work */
+	wp->worktype = DELAY;
+
+	if (sec > 0.)
+	{
+		RetryCount = (unsigned)(sec/TimeoutSeconds);
+		if ( RetryCount * TimeoutSeconds < sec )
+			RetryCount++;
+		for ( attempt=0, status = ECA_TIMEOUT;
+		     ECA_TIMEOUT == status && attempt<RetryCount && sec > 0;
+		     attempt++, sec-=TimeoutSeconds ) {
+	    	status = EzcaPendEvent((struct work *) NULL, sec > TimeoutSeconds ? TimeoutSeconds : sec, TRUE);
+			if ( ECA_TIMEOUT != status )
+				break;
+		}
+
+	    if (status == ECA_TIMEOUT)
+		{
+			/* normal return code */
+			if ( (wp->rc = RetryCount ? EZCA_OK : EZCA_ABORTED) )
+			{
+				wp->error_msg = ErrorMsgs[ABORTED_MSG_IDX];
+			}
+		}
+	    else
+	    {
+		wp->rc = EZCA_CAFAILURE;
+		wp->error_msg = ErrorMsgs[CAPENDEVENT_MSG_IDX];
+		wp->aux_error_msg = work_strdup(wp, ca_message(status));
+		if (AutoErrorMessage)
+		    print_error(wp);
+	    } /* endif */
+	}
+	else
+	{
+	    wp->rc = EZCA_INVALIDARG;
+	    wp->error_msg = ErrorMsgs[INVALID_ARG_MSG_IDX];
+
+	    if (AutoErrorMessage)
+		print_error(wp);
+	} /* endif */
+
+	rc = wp->rc;
+    }
+    else
+    {
+	rc = EZCA_FAILEDMALLOC;
+
+	if (AutoErrorMessage)
+	    printf("%s\n", FAILED_MALLOC_MSG);
+    } /* endif */
+
+    epilogue();
+    return rc;
+
+} /* end ezcaDelay() */
+
+/****************************************************************
+*
+*
+****************************************************************/
+
+void epicsShareAPI ezcaFree(void *buff)
+{
+
+struct work *wp;
+
+    prologue();
+
+    if ((wp = get_work_single()))
+    {
+	ErrorLocation = SINGLEWORK;
+
+	/* filling work */
+	wp->worktype = FREEMEM;
+	wp->rc = EZCA_OK;
+
+	if (buff)
+	    ezcafree(buff);
+
+	if (Debug)
+	    printf("ezcaFree() just freed starting\n");
+    }
+    else
+    {
+	if (AutoErrorMessage)
+	    printf("%s\n", FAILED_MALLOC_MSG);
+    } /* endif */
+
+    epilogue();
+} /* end ezcaFree() */
+
+/****************************************************************
+*
+*
+****************************************************************/
+
+int epicsShareAPI ezcaGetRetryCount()
+{
+
+struct work *wp;
+int rc;
+
+    prologue();
+
+    if ((wp = get_work_single()))
+    {
+	ErrorLocation = SINGLEWORK;
+
+	/* filling work */
+	wp->worktype = GETRETRYCOUNT;
+	wp->rc = EZCA_OK;
+
+	rc  = (int) SavedRetryCount;
+    }
+    else
+    {
+	if (AutoErrorMessage)
+	    printf("%s\n", FAILED_MALLOC_MSG);
+
+	rc = UNDEFINED;
+
+    } /* endif */
+
+    epilogue();
+    return rc;
+
+} /* end ezcaGetRetryCount() */
+
+/****************************************************************
+*
+*
+****************************************************************/
+
+float epicsShareAPI ezcaGetTimeout()
+{
+
+struct work *wp;
+float rc;
+
+    prologue();
+
+    if ((wp = get_work_single()))
+    {
+	ErrorLocation = SINGLEWORK;
+
+	/* filling work */
+	wp->worktype = GETTIMEOUT;
+	wp->rc = EZCA_OK;
+
+	rc  = TimeoutSeconds;
+    }
+    else
+    {
+	if (AutoErrorMessage)
+	    printf("%s\n", FAILED_MALLOC_MSG);
+
+	rc = UNDEFINED;
+
+    } /* endif */
+
+    epilogue();
+    return rc;
+
+} /* end ezcaGetTimeout() */
+
+/****************************************************************
+*
+*
+****************************************************************/
+
+int epicsShareAPI ezcaPvToChid(char *pvname, chid **cid)
+{
+
+struct channel *cp;
+struct work *wp;
+int rc;
+
+    prologue();
+
+    if ((wp = get_work_single()))
+    {
+	ErrorLocation = SINGLEWORK;
+
+	/* filling work */
+	wp->worktype = PVTOCHID;
+
+	if (cid)
+	{
+	    if (pvname)
+	    {
+		/* arguments are valid */
+
+		if ((wp->pvname = work_strdup(wp, pvname)))
+		{
+
+		    get_channel(wp, &cp);
+
+		    if (cp)
+		    {
+			/* everything OK */
+
+			/* wp->rc set by get_channel() if something went bad */
+			/* NOTE:  error message printed by get_channel()     */
+			/*        also if AutoErrorMessage is set.           */
+
+			wp->rc = EZCA_OK;
+			*cid = &(cp->cid);
+		    } /* endif */
+
+			release_channel( &cp );
+		}
+		else
+		{
+		    wp->rc = EZCA_FAILEDMALLOC;
+		    wp->error_msg = ErrorMsgs[FAILED_MALLOC_MSG_IDX];
+
+		    if (AutoErrorMessage)
+			print_error(wp);
+		} /* endif */
+	    }
+	    else
+	    {
+		wp->rc = EZCA_INVALIDARG;
+		wp->error_msg = ErrorMsgs[INVALID_PVNAME_MSG_IDX];
+
+		if (AutoErrorMessage)
+		    print_error(wp);
+	    } /* endif */
+	}
+	else
+	{
+	    wp->rc = EZCA_INVALIDARG;
+	    wp->error_msg = ErrorMsgs[INVALID_PBUFF_MSG_IDX];
+
+	    if (AutoErrorMessage)
+		print_error(wp);
+	} /* endif */
+
+	rc = wp->rc;
+    }
+    else
+    {
+	rc = EZCA_FAILEDMALLOC;
+
+	if (AutoErrorMessage)
+	    printf("%s\n", FAILED_MALLOC_MSG);
+    } /* endif */
+
+    epilogue();
+    return rc;
+
+} /* end ezcaPvToChid() */
+
+/****************************************************************
+*
+* Resolve a PV name into a handle which refers directly to the
+* channel (connecting it if necessary).  The handle holds a
+* reference to the channel: it stays cached (and is exempt from
+* ezcaPurge()) until the handle is given back with
+* ezcaReleaseHandle().  Handles may be used with the ...H()
+* variants of the groupable functions, also inside a group.
+*
+****************************************************************/
+
+int epicsShareAPI ezcaResolve(char *pvname, EzcaHandle *ph)
+{
+
+struct channel *cp;
+struct work *wp;
+EzcaHandle h;
+int rc;
+
+    prologue();
+
+    if ((wp = get_work_single()))
+    {
+	ErrorLocation = SINGLEWORK;
+
+	/* filling work */
+	wp->worktype = RESOLVE;
+
+	if (!ph)
+	{
+	    wp->rc = EZCA_INVALIDARG;
+	    wp->error_msg = ErrorMsgs[INVALID_PBUFF_MSG_IDX];
+
+	    if (AutoErrorMessage)
+		print_error(wp);
+	}
+	else if (InGroup)
+	{
+	    /* already in a group */
+	    wp->rc = EZCA_INGROUP;
+	    wp->error_msg = ErrorMsgs[INGROUP_MSG_IDX];
+
+	    if (AutoErrorMessage)
+		print_error(wp);
+	}
+	else if (check_target(wp, (struct channel *) NULL, pvname))
+	{
+	    get_channel(wp, &cp);
+
+	    if (cp)
+	    {
+		if ((h = Handle_avail_hdr))
+		    Handle_avail_hdr = h->next;
+		else
+		    h = (EzcaHandle) ezcamalloc(sizeof(*h));
+
+		if (h)
+		{
+		    /* keep the reference obtained by get_channel() */
+		    cp->nhandles++;
+		    h->cp = cp;
+		    h->next = (EzcaHandle) NULL;
+		    *ph = h;
+		    wp->rc = EZCA_OK;
+		}
+		else
+		{
+		    release_channel(&cp);
+		    wp->rc = EZCA_FAILEDMALLOC;
+		    wp->error_msg = ErrorMsgs[FAILED_MALLOC_MSG_IDX];
+
+		    if (AutoErrorMessage)
+			print_error(wp);
+		} /* endif */
+	    } /* endif */
+	}
+	else
+	{
+	    if (AutoErrorMessage)
+		print_error(wp);
+	} /* endif */
+
+	rc = wp->rc;
+    }
+    else
+    {
+	rc = EZCA_FAILEDMALLOC;
+
+	if (AutoErrorMessage)
+	    printf("%s\n", FAILED_MALLOC_MSG);
+    } /* endif */
+
+    epilogue();
+    return rc;
+
+} /* end ezcaResolve() */
+
+/****************************************************************
+*
+*
+****************************************************************/
+
+int epicsShareAPI ezcaReleaseHandle(EzcaHandle h)
+{
+
+struct channel *cp;
+struct work *wp;
+int rc;
+
+    prologue();
+
+    cp = H2CHANNEL(h);
+
+    if ((wp = get_work_single()))
+    {
+	ErrorLocation = SINGLEWORK;
+
+	/* filling work */
+	wp->worktype = RELEASEHANDLE;
+
+	if (cp->nhandles <= 0)
+	{
+	    wp->rc = EZCA_INVALIDARG;
+	    wp->error_msg = ErrorMsgs[INVALID_HANDLE_MSG_IDX];
+
+	    if (AutoErrorMessage)
+		print_error(wp);
+	}
+	else
+	{
+	    /* the channel remains cached like any other */
+	    cp->nhandles--;
+	    release_channel(&cp);
+	    h->cp = (struct channel *) NULL;
+	    h->next = Handle_avail_hdr;
+	    Handle_avail_hdr = h;
+	    wp->rc = EZCA_OK;
+	} /* endif */
+
+	rc = wp->rc;
+    }
+    else
+    {
+	rc = EZCA_FAILEDMALLOC;
+
+	if (AutoErrorMessage)
+	    printf("%s\n", FAILED_MALLOC_MSG);
+    } /* endif */
+
+    epilogue();
+    return rc;
+
+} /* end ezcaReleaseHandle() */
+
+/****************************************************************
+*
+* see connect_many()
+*
+****************************************************************/
+
+int epicsShareAPI ezcaConnectMany(char **pvnames, int n)
+{
+
+struct work *wp;
+int rc;
+
+    prologue();
+
+    if ((wp = get_work_single()))
+    {
+	ErrorLocation = SINGLEWORK;
+
+	/* filling work */
+	wp->worktype = CONNECTMANY;
+
+	if (!pvnames || n < 0)
+	{
+	    wp->rc = EZCA_INVALIDARG;
+	    wp->error_msg = ErrorMsgs[INVALID_ARG_MSG_IDX];
+
+	    if (AutoErrorMessage)
+		print_error(wp);
+	}
+	else if (InGroup)
+	{
+	    /* already in a group */
+	    wp->rc = EZCA_INGROUP;
+	    wp->error_msg = ErrorMsgs[INGROUP_MSG_IDX];
+
+	    if (AutoErrorMessage)
+		print_error(wp);
+	}
+	else
+	    connect_many(wp, pvnames, n);
+
+	rc = wp->rc;
+    }
+    else
+    {
+	rc = EZCA_FAILEDMALLOC;
+
+	if (AutoErrorMessage)
+	    printf("%s\n", FAILED_MALLOC_MSG);
+    } /* endif */
+
+    epilogue();
+    return rc;
+
+} /* end ezcaConnectMany() */
+
+/****************************************************************
+*
+* Warm start: ezcaSaveChannels() writes the channels which have
+* been connected (one per line: name, native DBF type and element
+* count as last seen) to a file; ezcaLoadChannels() reads such a
+* file and queues the searches (like ezcaConnectMany()). Lines
+* starting with '#' are comments; only the name is required.
+*
+****************************************************************/
+
+int epicsShareAPI ezcaSaveChannels(char *file)
+{
+
+struct channel *cp;
+struct work *wp;
+FILE *f;
+unsigned long i;
+int cs, rc;
+
+    prologue();
+
+    if ((wp = get_work_single()))
+    {
+	ErrorLocation = SINGLEWORK;
+
+	/* filling work */
+	wp->worktype = SAVECHANNELS;
+
+	if (!file)
+	{
+	    wp->rc = EZCA_INVALIDARG;
+	    wp->error_msg = ErrorMsgs[INVALID_ARG_MSG_IDX];
+	}
+	else if (!(f = fopen(file, "w")))
+	{
+	    wp->rc = EZCA_INVALIDARG;
+	    wp->error_msg = ErrorMsgs[FILE_ACCESS_MSG_IDX];
+	    wp->aux_error_msg = work_strdup(wp, file);
+	}
+	else
+	{
+	    wp->rc = EZCA_OK;
+
+	    fprintf(f, "# ezca warm start: <pvname> <native DBF type> <element count>\n");
+
+	    for (i = 0; i < ezcaRegBuckets(Channels); i++)
+	    {
+		for (cp = REG2CHANNEL(ezcaRegBucket(Channels, i)); cp; 
+			cp = REG2CHANNEL(cp->reg.chain))
+		{
+		    cs = connection_state(cp);
+
+		    if (EZCA_CS_CONNECTED != cs && EZCA_CS_DISCONNECTED != cs)
+			continue;
+
+		    fprintf(f, "%s %d %lu\n", cp->pvname, 
+			EZCA_CS_CONNECTED == cs ? EzcaNativeType(cp) : -1,
+			EZCA_CS_CONNECTED == cs ? (unsigned long) EzcaElementCount(cp) : 0UL);
+		} /* endfor */
+	    } /* endfor */
+
+	    if (fclose(f))
+	    {
+		wp->rc = EZCA_INVALIDARG;
+		wp->error_msg = ErrorMsgs[FILE_ACCESS_MSG_IDX];
+		wp->aux_error_msg = work_strdup(wp, file);
+	    } /* endif */
+	} /* endif */
+
+	if (wp->rc != EZCA_OK && AutoErrorMessage)
+	    print_error(wp);
+
+	rc = wp->rc;
+    }
+    else
+    {
+	rc = EZCA_FAILEDMALLOC;
+
+	if (AutoErrorMessage)
+	    printf("%s\n", FAILED_MALLOC_MSG);
+    } /* endif */
+
+    epilogue();
+    return rc;
+
+} /* end ezcaSaveChannels() */
+
+int epicsShareAPI ezcaLoadChannels(char *file)
+{
+
+struct work *wp;
+FILE *f;
+char line[512], *nm, *p, **nms, **tmp;
+int n, max, rc;
+
+    prologue();
+
+    if ((wp = get_work_single()))
+    {
+	ErrorLocation = SINGLEWORK;
+
+	/* filling work */
+	wp->worktype = LOADCHANNELS;
+
+	nms = (char **) NULL;
+	n = max = 0;
+
+	if (!file)
+	{
+	    wp->rc = EZCA_INVALIDARG;
+	    wp->error_msg = ErrorMsgs[INVALID_ARG_MSG_IDX];
+	}
+	else if (InGroup)
+	{
+	    /* already in a group */
+	    wp->rc = EZCA_INGROUP;
+	    wp->error_msg = ErrorMsgs[INGROUP_MSG_IDX];
+	}
+	else if (!(f = fopen(file, "r")))
+	{
+	    wp->rc = EZCA_INVALIDARG;
+	    wp->error_msg = ErrorMsgs[FILE_ACCESS_MSG_IDX];
+	    wp->aux_error_msg = work_strdup(wp, file);
+	}
+	else
+	{
+	    wp->rc = EZCA_OK;
+
+	    while (wp->rc == EZCA_OK && fgets(line, sizeof(line), f))
+	    {
+		/* first word of the line is the name */
+		for (nm = line; ' ' == *nm || '\t' == *nm; nm++)
+		    /* skip */;
+		for (p = nm; *p && !isspace((unsigned char) *p); p++)
+		    /* find end */;
+		*p = '\0';
+
+		if (!*nm || '#' == *nm)
+		    continue;
+
+		if (n == max)
+		{
+		    max = max ? 2*max : 1024;
+		    if (!(tmp = (char **) realloc(nms, max * sizeof(*nms))))
+		    {
+			wp->rc = EZCA_FAILEDMALLOC;
+			wp->error_msg = ErrorMsgs[FAILED_MALLOC_MSG_IDX];
+			break;
+		    } /* endif */
+		    nms = tmp;
+		} /* endif */
+
+		if (!(nms[n] = strdup(nm)))
+		{
+		    wp->rc = EZCA_FAILEDMALLOC;
+		    wp->error_msg = ErrorMsgs[FAILED_MALLOC_MSG_IDX];
+		}
+		else
+		    n++;
+	    } /* endwhile */
+
+	    fclose(f);
+
+	    if (Trace || Debug)
+		printf("ezcaLoadChannels(): %d channels from >%s<\n", n, file);
+	} /* endif */
+
+	if (wp->rc != EZCA_OK)
+	{
+	    if (AutoErrorMessage)
+		print_error(wp);
+	}
+	else
+	    connect_many(wp, nms, n);
+
+	while (n > 0)
+	    free(nms[--n]);
+	free(nms);
+
+	rc = wp->rc;
+    }
+    else
+    {
+	rc = EZCA_FAILEDMALLOC;
+
+	if (AutoErrorMessage)
+	    printf("%s\n", FAILED_MALLOC_MSG);
+    } /* endif */
+
+    epilogue();
+    return rc;
+
+} /* end ezcaLoadChannels() */
+
+/****************************************************************
+*
+* Store the cached connection state (EZCA_CS_XXX) of 'n' PVs (or
+* handles) in states[] and return the number of connected ones
+* (-1 on invalid arguments). Nothing is sent over the network.
+*
+****************************************************************/
+
+int epicsShareAPI ezcaConnectionState(char **pvnames, int n, int *states)
+{
+
+int i, rc;
+
+    if (!pvnames || !states || n < 0)
+	return -1;
+
+    prologue();
+
+    for (i = rc = 0; i < n; i++)
+    {
+	states[i] = connection_state(pvnames[i] 
+	    ? REG2CHANNEL(ezcaRegFindN(Channels, pvnames[i], chan_name_len(pvnames[i]))) 
+	    : (struct channel *) NULL);
+
+	if (EZCA_CS_CONNECTED == states[i])
+	    rc++;
+    } /* endfor */
+
+    epilogue();
+    return rc;
+
+} /* end ezcaConnectionState() */
+
+int epicsShareAPI ezcaConnectionStateH(EzcaHandle *hs, int n, int *states)
+{
+
+int i, rc;
+
+    if (!hs || !states || n < 0)
+	return -1;
+
+    prologue();
+
+    for (i = rc = 0; i < n; i++)
+    {
+	states[i] = connection_state(H2CHANNEL(hs[i]));
+
+	if (EZCA_CS_CONNECTED == states[i])
+	    rc++;
+    } /* endfor */
+
+    epilogue();
+    return rc;
+
+} /* end ezcaConnectionStateH() */
+
+/****************************************************************
+*
+* element counts of connected channels (-1 for others) as CA
+* reported them with the last connection; no network traffic.
+*
+****************************************************************/
+
+int epicsShareAPI ezcaElementCountH(EzcaHandle *hs, int n, int *nelem)
+{
+
+struct channel *cp;
+int i, rc;
+
+    if (!hs || !nelem || n < 0)
+	return -1;
+
+    prologue();
+
+    for (i = rc = 0; i < n; i++)
+    {
+	cp = H2CHANNEL(hs[i]);
+
+	if (EZCA_CS_CONNECTED == connection_state(cp))
+	{
+	    nelem[i] = (int) EzcaElementCount(cp);
+	    rc++;
+	}
+	else
+	    nelem[i] = -1;
+    } /* endfor */
+
+    epilogue();
+    return rc;
+
+} /* end ezcaElementCountH() */
+
+/****************************************************************
+*
+* Collects the counters of a channel (and of its subscriptions)
+* in 'sp'; a NULL cp yields an empty record.
+*
+****************************************************************/
+
+static void channel_stats(struct channel *cp, EzcaStatsRec *sp)
+{
+
+struct monitor *mp;
+unsigned long nintervals = 0;
+double interval_sum = 0., age;
+int i;
+
+    memset(sp, 0, sizeof(*sp));
+    sp->connect_time = -1.;
+    sp->latency_avg = sp->latency_max = -1.;
+    sp->monitor_interval_avg = sp->monitor_interval_max = -1.;
+    sp->last_update_age = -1.;
+
+    if (!cp)
+	return;
+
+    CHAN_LOCK(cp);
+    sp->connect_time = cp->stats.connect_time;
+    sp->reconnects = cp->stats.connects > 1 ? cp->stats.connects - 1 : 0;
+    sp->gets = cp->stats.gets;
+    sp->puts = cp->stats.puts;
+    sp->bytes_in = cp->stats.bytes_in;
+    sp->bytes_out = cp->stats.bytes_out;
+    for (i = 0; i < EZCA_STATS_NBINS; i++)
+	sp->latency[i] = cp->stats.latency[i];
+    if (cp->stats.nlatency)
+    {
+	sp->latency_avg = cp->stats.latency_sum / (double) cp->stats.nlatency;
+	sp->latency_max = cp->stats.latency_max;
+    } /* endif */
+
+    /* only the sources own a subscription */
+    for (mp = cp->monitor_list; mp; mp = mp->right)
+    {
+	if (mp->src != mp || !mp->nupdates)
+	    continue;
+
+	sp->monitor_updates += mp->nupdates;
+	sp->bytes_in += mp->bytes;
+	nintervals += mp->nupdates - 1;
+	interval_sum += mp->interval_sum;
+	if (mp->nupdates > 1 && mp->interval_max > sp->monitor_interval_max)
+	    sp->monitor_interval_max = mp->interval_max;
+	age = -time_left(&mp->last_update);
+	if (sp->last_update_age < 0. || age < sp->last_update_age)
+	    sp->last_update_age = age;
+    } /* endfor */
+    CHAN_UNLOCK(cp);
+
+    if (nintervals)
+	sp->monitor_interval_avg = interval_sum / (double) nintervals;
+
+} /* end channel_stats() */
+
+/****************************************************************
+*
+* Store the counters of 'n' PVs in stats[] and return the number
+* of PVs which are cached (-1 on invalid arguments). Nothing is
+* sent over the network.
+*
+****************************************************************/
+
+int epicsShareAPI ezcaGetStats(char **pvnames, int n, EzcaStatsRec *stats)
+{
+
+struct channel *cp;
+int i, rc;
+
+    if (!pvnames || !stats || n < 0)
+	return -1;
+
+    DO_INIT_ONCE();
+
+    /* no need for ezcaMutex; holding the registry lock keeps */
+    /* the channel from being cleared while we read it        */
+    for (i = rc = 0; i < n; i++)
+    {
+	REG_LOCK();
+	cp = pvnames[i] 
+	    ? REG2CHANNEL(ezcaRegFindN(Channels, pvnames[i], chan_name_len(pvnames[i]))) 
+	    : (struct channel *) NULL;
+
+	channel_stats(cp, &stats[i]);
+	REG_UNLOCK();
+
+	if (cp)
+	    rc++;
+    } /* endfor */
+
+    return rc;
+
+} /* end ezcaGetStats() */
+
+/****************************************************************
+*
+* Contention statistics of ezcaMutex per EZCA_LOCK() call site
+* (API calls are booked on the calling function). Switching them
+* on resets them. ezcaGetLockStats() copies up to 'n' sites and
+* returns the number of sites which have been used while the
+* statistics were on.
+*
+****************************************************************/
+
+void epicsShareAPI ezcaLockStatsOn()
+{
+
+#ifdef EPICS_THREE_FOURTEEN
+struct lock_site *sp;
+
+    prologue();
+
+    for (sp = LockSites; sp; sp = sp->next)
+    {
+	sp->count = sp->contended = sp->holds = 0;
+	sp->wait_sum = sp->wait_max = 0.;
+	sp->hold_sum = sp->hold_max = 0.;
+    } /* endfor */
+
+    LockStats = TRUE;
+
+    epilogue();
+#endif
+
+} /* end ezcaLockStatsOn() */
+
+void epicsShareAPI ezcaLockStatsOff()
+{
+
+#ifdef EPICS_THREE_FOURTEEN
+    LockStats = FALSE;
+#endif
+
+} /* end ezcaLockStatsOff() */
+
+int epicsShareAPI ezcaGetLockStats(EzcaLockStatsRec *stats, int n)
+{
+
+int rc = 0;
+#ifdef EPICS_THREE_FOURTEEN
+struct lock_site *sp;
+
+    if ((!stats && n > 0) || n < 0)
+	return -1;
+
+    prologue();
+
+    for (sp = LockSites; sp; sp = sp->next, rc++)
+    {
+	if (rc >= n)
+	    continue;
+
+	stats[rc].func = sp->func;
+	stats[rc].line = sp->line;
+	stats[rc].count = sp->count;
+	stats[rc].contended = sp->contended;
+	stats[rc].wait_sum = sp->wait_sum;
+	stats[rc].wait_max = sp->wait_max;
+	stats[rc].holds = sp->holds;
+	stats[rc].hold_sum = sp->hold_sum;
+	stats[rc].hold_max = sp->hold_max;
+    } /* endfor */
+
+    epilogue();
+#endif
+
+    return rc;
+
+} /* end ezcaGetLockStats() */
+
+/****************************************************************
+*
+* links mp into (or out of) the monitor list of its channel. The
+* CA thread walks this list (under CHAN_LOCK) to find the monitors
+* sharing a subscription, hence the lock.
+*
+****************************************************************/
+
+static void link_monitor(struct monitor *mp)
+{
+
+struct channel *cp = mp->cp;
+
+    CHAN_LOCK(cp);
+    if ((mp->right = cp->monitor_list))
+	(cp->monitor_list)->left = mp;
+    mp->left = (struct monitor *) NULL;
+    cp->monitor_list = mp;
+    CHAN_UNLOCK(cp);
+
+    if (Debug)
+    {
+	printf("link_monitor() channels after pushing monitor onto channel\n");
+	print_channels();
+    } /* endif */
+
+} /* end link_monitor() */
+
+static void unlink_monitor(struct monitor *mp)
+{
+    CHAN_LOCK(mp->cp);
+    if (mp->left)
+	/* mp is NOT leftmost */
+	(mp->left)->right = mp->right;
+    else
+	/* mp is leftmost */
+	(mp->cp)->monitor_list = mp->right;
+
+    if (mp->right)
+	/* mp is NOT rightmost */
+	(mp->right)->left = mp->left;
+
+    mp->left = mp->right = (struct monitor *) NULL;
+    CHAN_UNLOCK(mp->cp);
+
+} /* end unlink_monitor() */
+
+/****************************************************************
+*
+* maps an ezca data type to the DBR_TIME_XXX type used for
+* transferring it.
+*
+****************************************************************/
+
+static int ezca2dbrtime(char ezcatype)
+{
+
+int rc;
+
+    switch (ezcatype)
+    {
+	case ezcaByte:   rc = DBR_TIME_CHAR;   break;
+	case ezcaString: rc = DBR_TIME_STRING; break;
+	case ezcaShort:  rc = DBR_TIME_SHORT;  break;
+	case ezcaLong:   rc = DBR_TIME_LONG;   break;
+	case ezcaFloat:  rc = DBR_TIME_FLOAT;  break;
+	case ezcaDouble: rc = DBR_TIME_DOUBLE; break;
+	default: 
+	    fprintf(stderr, 
+    "EZCA FATAL ERROR: ezca2dbrtime() got unrecognizable ezca data type %d\n", 
+		ezcatype);
+	    exit(1);
+	    break;
+    } /* end switch() */
+
+    return rc;
+
+} /* end ezca2dbrtime() */
+
+/****************************************************************
+*
+* copies n values from a monitor buffer of 'dbr_type' into the
+* user's buffer of 'ezcatype', converting numeric types the way
+* a C cast does (that is what CA's own conversions do, too).
+*
+****************************************************************/
+
+static void convert_values(void *dst, char ezcatype, void *src, int dbr_type, int n)
+{
+
+double v;
+int i;
+
+    if (ezca2dbrtime(ezcatype) == dbr_type)
+    {
+	memcpy((char *) dst, (char *) src, n*dbr_value_size[dbr_type]);
+	return;
+    } /* endif */
+
+    if (ezcaString == ezcatype || DBR_TIME_STRING == dbr_type)
+    {
+	fprintf(stderr, 
+	"EZCA FATAL ERROR: convert_values() cannot convert dbr type %d to ezca type %d\n",
+	    dbr_type, ezcatype);
+	exit(1);
+    } /* endif */
+
+    for (i = 0; i < n; i++)
+    {
+	switch (dbr_type)
+	{
+	    case DBR_TIME_CHAR:   v = ((dbr_char_t *) src)[i];   break;
+	    case DBR_TIME_ENUM:   v = ((dbr_enum_t *) src)[i];   break;
+	    case DBR_TIME_SHORT:  v = ((dbr_short_t *) src)[i];  break;
+	    case DBR_TIME_LONG:   v = ((dbr_long_t *) src)[i];   break;
+	    case DBR_TIME_FLOAT:  v = ((dbr_float_t *) src)[i];  break;
+	    case DBR_TIME_DOUBLE: v = ((dbr_double_t *) src)[i]; break;
+	    default:
+		fprintf(stderr, 
+	"EZCA FATAL ERROR: convert_values() got unrecognizable dbr type %d\n",
+		    dbr_type);
+		exit(1);
+		break;
+	} /* end switch() */
+
+	switch (ezcatype)
+	{
+	    case ezcaByte:   ((dbr_char_t *) dst)[i] = (dbr_char_t) (long) v;   break;
+	    case ezcaShort:  ((dbr_short_t *) dst)[i] = (dbr_short_t) (long) v; break;
+	    case ezcaLong:   ((dbr_long_t *) dst)[i] = (dbr_long_t) v;          break;
+	    case ezcaFloat:  ((dbr_float_t *) dst)[i] = (dbr_float_t) v;        break;
+	    case ezcaDouble: ((dbr_double_t *) dst)[i] = v;                     break;
+	    default:
+		fprintf(stderr, 
+	"EZCA FATAL ERROR: convert_values() got unrecognizable ezca type %d\n",
+		    ezcatype);
+		exit(1);
+		break;
+	} /* end switch() */
+    } /* endfor */
+
+} /* end convert_values() */
+
+/****************************************************************
+*
+* establishes a CA subscription of 'dbr_type' (and optionally a
+* queue) on cp. The new monitor owns the subscription (mp->src is
+* mp itself) and is linked to the channel. On failure wp->rc and 
+* wp->error_msg are set and NULL is returned.
+*
+****************************************************************/
+
+static struct monitor *add_subscription(struct work *wp, struct channel *cp, char ezcatype, int dbr_type, unsigned long count, unsigned depth)
+{
+
+struct monitor *mp;
+double need;
+
+    /* monitors are never evicted; the cap is enforced here: the */
+    /* three buffers and the queue as they will be when full     */
+    need = (double) (3 + depth) * dbr_value_size[dbr_type]
+	* (double) (count ? count : ca_element_count(cp->cid));
+
+    if (MonitorMemCap > 0. && monitor_mem() + need > MonitorMemCap)
+    {
+	wp->rc = EZCA_FAILEDMALLOC;
+	wp->error_msg = ErrorMsgs[MONITOR_CAP_MSG_IDX];
+
+	if (AutoErrorMessage)
+	    print_error(wp);
+
+	return (struct monitor *) NULL;
+    } /* endif */
+
+    if ((mp = pop_monitor()) && depth 
+	&& !(mp->queue = create_queue(dbr_type, 
+	    (count ? count : ca_element_count(cp->cid)), depth)))
+    {
+	push_monitor(mp, &Monitor_avail_hdr);
+	mp = (struct monitor *) NULL;
+    } /* endif */
+
+    if (!mp)
+    {
+	wp->rc = EZCA_FAILEDMALLOC;
+	wp->error_msg = ErrorMsgs[FAILED_MALLOC_MSG_IDX];
+
+	if (AutoErrorMessage)
+	    print_error(wp);
+
+	return (struct monitor *) NULL;
+    } /* endif */
+
+    /* filling the mp here because ca_pend_io() could   */
+    /* cause my_monitor_callback() go be executed and   */
+    /* we need a full mp there in order for it to work. */
+
+    mp->ezcadatatype = ezcatype;
+    mp->dbr_type = dbr_type;
+    mp->count = count;
+    mp->cp = cp;
+    mp->src = mp;
+    mp->nviews = (SHARED_SOURCE == ezcatype ? 0 : 1);
+
+    link_monitor(mp);
+
+    if (EzcaAddArrayEvent(wp, mp, count) == ECA_NORMAL)
+    {
+	mp->active = TRUE;
+
+	if (EzcaPendIO(wp, SHORT_TIME) == ECA_NORMAL)
+	{
+	    wp->rc = EZCA_OK;
+	    return mp;
+	} /* endif */
+
+	/* something went wrong ... rc and */
+	/* error msg have already been set */
+
+	mp->active = FALSE;
+    } /* endif */
+
+    /* something went wrong ... rc and */
+    /* error msg have already been set */
+
+    unlink_monitor(mp);
+    clean_and_push_monitor(mp);
+
+    return (struct monitor *) NULL;
+
+} /* end add_subscription() */
+
+/****************************************************************
+*
+* adds a monitor of 'ezcatype' reading from the shared subscription
+* 'src' (a SHARED_SOURCE in the channel's native type). Such views
+* own no CA resources; their data are converted when read.
+*
+****************************************************************/
+
+static struct monitor *add_view(struct work *wp, struct monitor *src, char ezcatype)
+{
+
+struct monitor *mp;
+
+    if (!(mp = pop_monitor()))
+    {
+	wp->rc = EZCA_FAILEDMALLOC;
+	wp->error_msg = ErrorMsgs[FAILED_MALLOC_MSG_IDX];
+
+	if (AutoErrorMessage)
+	    print_error(wp);
+
+	return (struct monitor *) NULL;
+    } /* endif */
+
+    mp->ezcadatatype = ezcatype;
+    mp->dbr_type = src->dbr_type;
+    mp->count = src->count;
+    mp->cp = src->cp;
+    mp->src = src;
+    mp->active = src->active;
+    src->nviews++;
+
+    /* the subscription won't send anything new; */
+    /* what it has is new to this monitor        */
+    CHAN_LOCK(src->cp);
+    mp->needs_reading = src->needs_reading 
+	|| (src->fresh ? src->mid : src->front)->nelem != UNDEFINED;
+    CHAN_UNLOCK(src->cp);
+
+    link_monitor(mp);
+
+    wp->rc = EZCA_OK;
+
+    return mp;
+
+} /* end add_view() */
+
+/****************************************************************
+*
+* takes a monitor out of service: views are simply recycled and
+* the shared subscription is cleared along with its last view.
+*
+****************************************************************/
+
+static void remove_monitor(struct monitor *mp)
+{
+
+struct monitor *src = mp->src;
+
+    unlink_monitor(mp);
+
+    mp->active = FALSE;
+
+    if (src && src != mp)
+    {
+	/* a view; the callback only looks at it under */
+	/* CHAN_LOCK, i.e., not after unlink_monitor() */
+	push_monitor(mp, &Monitor_avail_hdr);
+
+	if (0 == --src->nviews)
+	{
+	    unlink_monitor(src);
+	    src->active = FALSE;
+	    clean_and_push_monitor(src);
+	} /* endif */
+    }
+    else
+	clean_and_push_monitor(mp);
+
+} /* end remove_monitor() */
+
+/****************************************************************
+*
+* returns the shared subscription on cp which can serve a monitor
+* of 'count' elements, if any.
+*
+****************************************************************/
+
+static struct monitor *find_source(struct channel *cp, unsigned long count)
+{
+
+struct monitor *mp;
+
+    for (mp = cp->monitor_list; mp; mp = mp->right)
+    {
+	if (SHARED_SOURCE != mp->ezcadatatype || !mp->active)
+	    continue;
+
+	/* must deliver at least as many elements */
+	if (mp->count && (!count || count > mp->count))
+	    continue;
+
+	return mp;
+    } /* endfor */
+
+    return (struct monitor *) NULL;
+
+} /* end find_source() */
+
+/****************************************************************
+*
+* ezcaSetMonitor() and ezcaSetMonitorQueued()
+*
+* Numeric monitors share a single subscription in the channel's
+* native DBR_TIME type (unless that is a string); they are converted
+* on the client when read. String monitors (and numeric ones on
+* string PVs) use a subscription of their own since the server's
+* conversion (e.g., enum state names) cannot be reproduced here.
+* Queued monitors, too, keep their own: reading drains the queue.
+*
+****************************************************************/
+
+static int set_monitor(char *pvname, char type, unsigned long count, unsigned depth, int worktype)
+{
+
+struct channel *cp;
+struct monitor *mp, *src;
+struct work *wp;
+BOOL found;
+int native;
+int rc;
+
+    prologue();
+
+    if ((wp = get_work_single()))
+    {
+	ErrorLocation = SINGLEWORK;
+
+	/* filling work */
+
+	wp->worktype = worktype;
+	wp->ezcadatatype = type;
+
+	/* checking input args */
+
+        if (!pvname)
+        {
+            wp->rc = EZCA_INVALIDARG;
+            wp->error_msg = ErrorMsgs[INVALID_PVNAME_MSG_IDX];
+
+            if (AutoErrorMessage)
+		print_error(wp);
+        } 
+        else if (!(wp->pvname = work_strdup(wp, pvname)))
+        {
+            wp->rc = EZCA_FAILEDMALLOC;
+            wp->error_msg = ErrorMsgs[FAILED_MALLOC_MSG_IDX];
+
+            if (AutoErrorMessage)
+		print_error(wp);
+        } 
+	else if (!VALID_EZCA_DATA_TYPE(wp->ezcadatatype))
+	{
+	    wp->rc = EZCA_INVALIDARG;
+	    wp->error_msg = ErrorMsgs[INVALID_TYPE_MSG_IDX];
+
+	    if (AutoErrorMessage)
+		print_error(wp);
+	} 
+	else
+	{
+	    /* arguments are valid */
+	    wp->rc = EZCA_OK;
+	} /* endif */
+
+	if (wp->rc == EZCA_OK)
+	{
+	    /* all input args OK */
+	    get_channel(wp, &cp);
+
+	    if (cp)
+	    {
+		/* everything OK so far ... otherwise something */
+		/* went wrong and it is already explained in wp */
+
+		/* loop to check monitor list for monitor of the same type */
+		mp = cp->monitor_list;
+		found = FALSE;
+		while (mp && !found)
+		    if (!(found = (wp->ezcadatatype == mp->ezcadatatype)))
+			mp = mp->right;
+
+		if (found)
+		{
+		    if (Trace || Debug)
+		printf("ezcaSetMonitor(): found monitor already existed\n");
+
+		    if (depth && !(mp->src->queue && mp->src->queue->depth == depth))
+		    {
+			/* the queue cannot be changed while the */
+			/* callback may be using it              */
+			wp->rc = EZCA_INVALIDARG;
+			wp->error_msg = ErrorMsgs[QUEUE_CONFLICT_MSG_IDX];
+
+			if (AutoErrorMessage)
+			    print_error(wp);
+		    }
+		    else
+			wp->rc = EZCA_OK;
+		}
+		else
+		{
+		    /* was not in the monitor list ... need to */
+		    /* place it there and start the monitor    */
+
+		    if (Trace || Debug)
+    printf("ezcaSetMonitor(): monitor did not exist. establishing one now\n");
+
+		    native = EzcaNativeType(cp);
+
+		    if (!depth && ezcaString != type && DBF_STRING != native
+			&& native >= 0 && native < DBF_NO_ACCESS)
+		    {
+			if ((src = find_source(cp, count)))
+			{
+			    if (Trace || Debug)
+		printf("ezcaSetMonitor(): sharing existing subscription\n");
+			}
+			else
+			    src = add_subscription(wp, cp, SHARED_SOURCE, 
+				    dbf_type_to_DBR_TIME(native), count, 0);
+
+			if (src && !add_view(wp, src, type) && !src->nviews)
+			    remove_monitor(src);
+		    }
+		    else
+			(void) add_subscription(wp, cp, type, 
+				ezca2dbrtime(type), count, depth);
+		} /* endif */
+		release_channel(&cp);
+	    } /* endif */
+	} /* endif */
+
+	rc = wp->rc;
+	    
+    }
+    else
+    {
+	rc = EZCA_FAILEDMALLOC;
+
+	if (AutoErrorMessage)
+	    printf("%s\n", FAILED_MALLOC_MSG);
+    } /* endif */
+
+    epilogue();
+    return rc;
+
+} /* end set_monitor() */
+
+/****************************************************************
+*
+*
+****************************************************************/
+
+int epicsShareAPI ezcaSetMonitor(char *pvname, char type, unsigned long count)
+{
+    return set_monitor(pvname, type, count, 0, SETMONITOR);
+} /* end ezcaSetMonitor() */
+
+/****************************************************************
+*
+* like ezcaSetMonitor() but additionally keeps up to 'depth'
+* updates (of 'count' elements) in a queue which is drained by
+* ezcaGetQueued().
+*
+****************************************************************/
+
+int epicsShareAPI ezcaSetMonitorQueued(char *pvname, char type, unsigned long count, unsigned depth)
+{
+    return set_monitor(pvname, type, count, depth, SETMONITORQUEUED);
+} /* end ezcaSetMonitorQueued() */
+
+/****************************************************************
+*
+* removes up to 'maxupd' of the oldest updates from the queue of
+* a monitor established by ezcaSetMonitorQueued(). Update 'k' is
+* stored at element 'k*nelem' of 'buff' (elements the update did
+* not provide are zeroed) and, if the respective pointers are
+* non-NULL, at index 'k' of nvals (# of valid elements), ts,
+* status and severity. The number of updates stored is returned
+* in *nupd; *ndropped (if non-NULL) returns the number of updates
+* lost because the queue was full since the last call.
+*
+****************************************************************/
+
+int epicsShareAPI ezcaGetQueued(char *pvname, char type, int nelem, int maxupd, void *buff, int *nvals, epicsTimeStamp *ts, short *status, short *severity, int *nupd, unsigned long *ndropped)
+{
+
+struct channel *cp;
+struct monitor *mp;
+struct monq *q;
+struct work *wp;
+unsigned n, k, slot;
+unsigned long dropped;
+int nv;
+int rc;
+
+    prologue();
+
+    if ((wp = get_work_single()))
+    {
+	ErrorLocation = SINGLEWORK;
+
+	/* filling work */
+
+	wp->worktype = GETQUEUED;
+	wp->ezcadatatype = type;
+
+	if (nupd)
+	    *nupd = 0;
+
+	/* checking input args */
+
+	if (!pvname)
+	{
+	    wp->rc = EZCA_INVALIDARG;
+	    wp->error_msg = ErrorMsgs[INVALID_PVNAME_MSG_IDX];
+	}
+	else if (!(wp->pvname = work_strdup(wp, pvname)))
+	{
+	    wp->rc = EZCA_FAILEDMALLOC;
+	    wp->error_msg = ErrorMsgs[FAILED_MALLOC_MSG_IDX];
+	}
+	else if (!VALID_EZCA_DATA_TYPE(wp->ezcadatatype))
+	{
+	    wp->rc = EZCA_INVALIDARG;
+	    wp->error_msg = ErrorMsgs[INVALID_TYPE_MSG_IDX];
+	}
+	else if (nelem <= 0 || maxupd < 0)
+	{
+	    wp->rc = EZCA_INVALIDARG;
+	    wp->error_msg = ErrorMsgs[INVALID_NELEM_MSG_IDX];
+	}
+	else if (!nupd || (maxupd > 0 && !buff))
+	{
+	    wp->rc = EZCA_INVALIDARG;
+	    wp->error_msg = ErrorMsgs[INVALID_PBUFF_MSG_IDX];
+	}
+	else
+	{
+	    /* arguments are valid */
+	    wp->rc = EZCA_OK;
+	} /* endif */
+
+	if (wp->rc == EZCA_OK)
+	{
+	    q = (struct monq *) NULL;
+
+	    if ((cp = find_channel(wp->pvname)))
+	    {
+		for (mp = cp->monitor_list; mp; mp = mp->right)
+		    if (type == mp->ezcadatatype && mp->active)
+		    {
+			q = mp->src->queue;
+			break;
+		    } /* endif */
+	    } /* endif */
+
+	    if (!q)
+	    {
+		wp->rc = EZCA_INVALIDARG;
+		wp->error_msg = ErrorMsgs[NOT_QUEUED_MSG_IDX];
+	    }
+	    else
+	    {
+		CHAN_LOCK(cp);
+		n = q->count;
+		if (n > (unsigned) maxupd)
+		    n = maxupd;
+		dropped = q->dropped;
+		if (ndropped)
+		    q->dropped = 0;
+		CHAN_UNLOCK(cp);
+
+		/* the 'n' oldest slots are ours until 'count' drops */
+		for (k = 0; k < n; k++)
+		{
+		    slot = (q->head + k) % q->depth;
+		    if ((nv = q->nvals[slot]) > nelem)
+			nv = nelem;
+
+		    memcpy((char *) buff + k * nelem * q->esize,
+			q->data + slot * q->nelem * q->esize, nv * q->esize);
+		    memset((char *) buff + (k * nelem + nv) * q->esize, 0,
+			(nelem - nv) * q->esize);
+
+		    if (nvals)
+			nvals[k] = nv;
+		    if (ts)
+			copy_time_stamp(&ts[k], &q->time_stamp[slot]);
+		    if (status)
+			status[k] = q->status[slot];
+		    if (severity)
+			severity[k] = q->severity[slot];
+		} /* endfor */
+
+		CHAN_LOCK(cp);
+		q->head = (q->head + n) % q->depth;
+		q->count -= n;
+		CHAN_UNLOCK(cp);
+
+		if (Trace || Debug)
+		    printf("ezcaGetQueued(): drained %u updates (%lu dropped)\n",
+			n, dropped);
+
+		*nupd = n;
+		if (ndropped)
+		    *ndropped = dropped;
+	    } /* endif */
+
+	    release_channel(&cp);
+	} /* endif */
+
+	if (wp->rc != EZCA_OK && AutoErrorMessage)
+	    print_error(wp);
+
+	rc = wp->rc;
+    }
+    else
+    {
+	rc = EZCA_FAILEDMALLOC;
+
+	if (AutoErrorMessage)
+	    printf("%s\n", FAILED_MALLOC_MSG);
+    } /* endif */
+
+    epilogue();
+    return rc;
+
+} /* end ezcaGetQueued() */
+
+/****************************************************************
+*
+* ezcaAddMonitorCallback() and ezcaRemoveMonitorCallback()
+*
+* 'fn' is called with every update of a subscription of its own
+* (see struct moncb); a (type, fn, arg) triple is registered at
+* most once per channel. See ezca.h for the threading rules.
+*
+****************************************************************/
+
+static int monitor_callback(char *pvname, char type, unsigned long count, EzcaMonitorCallback fn, void *arg, int worktype)
+{
+
+struct channel *cp;
+struct moncb *ucp, **pp;
+struct work *wp;
+int rc;
+
+    prologue();
+
+    if ((wp = get_work_single()))
+    {
+	ErrorLocation = SINGLEWORK;
+
+	/* filling work */
+
+	wp->worktype = worktype;
+	wp->ezcadatatype = type;
+
+	/* checking input args */
+
+	if (!pvname)
+	{
+	    wp->rc = EZCA_INVALIDARG;
+	    wp->error_msg = ErrorMsgs[INVALID_PVNAME_MSG_IDX];
+	}
+	else if (!(wp->pvname = work_strdup(wp, pvname)))
+	{
+	    wp->rc = EZCA_FAILEDMALLOC;
+	    wp->error_msg = ErrorMsgs[FAILED_MALLOC_MSG_IDX];
+	}
+	else if (!VALID_EZCA_DATA_TYPE(wp->ezcadatatype))
+	{
+	    wp->rc = EZCA_INVALIDARG;
+	    wp->error_msg = ErrorMsgs[INVALID_TYPE_MSG_IDX];
+	}
+	else if (!fn)
+	{
+	    wp->rc = EZCA_INVALIDARG;
+	    wp->error_msg = ErrorMsgs[INVALID_ARG_MSG_IDX];
+	}
+	else
+	{
+	    /* arguments are valid */
+	    wp->rc = EZCA_OK;
+	} /* endif */
+
+	if (wp->rc != EZCA_OK)
+	{
+	    if (AutoErrorMessage)
+		print_error(wp);
+	}
+	else if (REMOVEMONITORCALLBACK == worktype)
+	{
+	    if ((cp = find_channel(wp->pvname)))
+	    {
+		for (pp = &cp->callbacks; (ucp = *pp); pp = &ucp->next)
+		    if (type == ucp->ezcadatatype && fn == ucp->fn && arg == ucp->arg)
+			break;
+
+		if (ucp)
+		{
+		    if (Trace || Debug)
+		printf("ezcaRemoveMonitorCallback(): found callback ... clearing now\n");
+
+		    remove_callback(ucp);
+		    EzcaPendIO((struct work *) NULL, SHORT_TIME);
+		} /* endif */
+		release_channel(&cp);
+	    } /* endif */
+
+	    /* like ezcaClearMonitor(): nothing to remove is fine */
+	    wp->rc = EZCA_OK;
+	}
+	else
+	{
+	    get_channel(wp, &cp);
+
+	    if (cp)
+	    {
+		for (ucp = cp->callbacks; ucp; ucp = ucp->next)
+		    if (type == ucp->ezcadatatype && fn == ucp->fn && arg == ucp->arg)
+			break;
+
+		if (ucp)
+		{
+		    if (Trace || Debug)
+		printf("ezcaAddMonitorCallback(): found callback already existed\n");
+		}
+		else if (!(ucp = (struct moncb *) ezcacalloc(1, sizeof(*ucp))))
+		{
+		    wp->rc = EZCA_FAILEDMALLOC;
+		    wp->error_msg = ErrorMsgs[FAILED_MALLOC_MSG_IDX];
+
+		    if (AutoErrorMessage)
+			print_error(wp);
+		}
+		else
+		{
+		    ucp->cp = cp;
+		    ucp->ezcadatatype = type;
+		    ucp->dbr_type = ezca2dbrtime(type);
+		    ucp->fn = fn;
+		    ucp->arg = arg;
+		    /* updates may arrive before ca_add_array_event() returns */
+		    ucp->active = TRUE;
+
+		    if (Trace || Debug)
+			printf("ca_add_array_event(ezcatype (%d)->dbrtype (%d) >%s<) for callback\n", 
+			    type, ucp->dbr_type, cp->pvname); 
+
+		    rc = ca_add_array_event(ucp->dbr_type, count, cp->cid,
+			    my_user_monitor_callback, (void *) ucp,
+			    (float) 0, (float) 0, (float) 0, &(ucp->evd));
+
+		    if (rc != ECA_NORMAL)
+		    {
+			ucp->active = FALSE;
+			ezcafree((char *) ucp);
+
+			wp->rc = EZCA_CAFAILURE;
+			wp->error_msg = ErrorMsgs[CAADDARRAYEVENT_MSG_IDX];
+			wp->aux_error_msg = work_strdup(wp, ca_message(rc));
+
+			if (AutoErrorMessage)
+			    print_error(wp);
+		    }
+		    else
+		    {
+			ucp->next = cp->callbacks;
+			cp->callbacks = ucp;
+
+			/* rc and error msg are set on failure */
+			if (EzcaPendIO(wp, SHORT_TIME) != ECA_NORMAL)
+			    remove_callback(ucp);
+		    } /* endif */
+		} /* endif */
+		release_channel(&cp);
+	    } /* endif */
+	} /* endif */
+
+	rc = wp->rc;
+    }
+    else
+    {
+	rc = EZCA_FAILEDMALLOC;
+
+	if (AutoErrorMessage)
+	    printf("%s\n", FAILED_MALLOC_MSG);
+    } /* endif */
+
+    epilogue();
+    return rc;
+
+} /* end monitor_callback() */
+
+int epicsShareAPI ezcaAddMonitorCallback(char *pvname, char type, unsigned long count, EzcaMonitorCallback fn, void *arg)
+{
+    return monitor_callback(pvname, type, count, fn, arg, ADDMONITORCALLBACK);
+} /* end ezcaAddMonitorCallback() */
+
+int epicsShareAPI ezcaRemoveMonitorCallback(char *pvname, char type, EzcaMonitorCallback fn, void *arg)
+{
+    return monitor_callback(pvname, type, 0, fn, arg, REMOVEMONITORCALLBACK);
+} /* end ezcaRemoveMonitorCallback() */
+
+/****************************************************************
+*
+*
+****************************************************************/
+
+int epicsShareAPI ezcaSetRetryCount(int retry)
+{
+
+struct work *wp;
+int rc;
+
+    prologue();
+
+    if ((wp = get_work_single()))
+    {
+	ErrorLocation = SINGLEWORK;
+
+	/* filling work */
+	wp->worktype = SETRETRYCOUNT;
+
+	if (retry >= 0)
+	{
+	    RetryCount = SavedRetryCount = (unsigned) retry;
+
+	    wp->rc = EZCA_OK;
+	}
+	else
+	{
+	    wp->rc = EZCA_INVALIDARG;
+	    wp->error_msg = ErrorMsgs[INVALID_ARG_MSG_IDX];
+
+	    if (AutoErrorMessage)
+		print_error(wp);
+	} /* endif */
+
+	rc = wp->rc;
+    }
+    else
+    {
+	rc = EZCA_FAILEDMALLOC;
+
+	if (AutoErrorMessage)
+	    printf("%s\n", FAILED_MALLOC_MSG);
+    } /* endif */
+
+    epilogue();
+    return rc;
+
+} /* end ezcaSetRetryCount() */
+
+/****************************************************************
+*
+*
+****************************************************************/
+
+int epicsShareAPI ezcaSetTimeout(float sec)
+{
+
+struct work *wp;
+int rc;
+
+    prologue();
+
+    if ((wp = get_work_single()))
+    {
+	ErrorLocation = SINGLEWORK;
+
+	/* filling work */
+	wp->worktype = SETTIMEOUT;
+
+	if (sec > 0)
+	{
+	    TimeoutSeconds = sec;
+
+	    wp->rc = EZCA_OK;
+	}
+	else
+	{
+	    wp->rc = EZCA_INVALIDARG;
+	    wp->error_msg = ErrorMsgs[INVALID_ARG_MSG_IDX];
+
+	    if (AutoErrorMessage)
+		print_error(wp);
+	} /* endif */
+
+	rc = wp->rc;
+    }
+    else
+    {
+	rc = EZCA_FAILEDMALLOC;
+
+	if (AutoErrorMessage)
+	    printf("%s\n", FAILED_MALLOC_MSG);
+    } /* endif */
+
+    epilogue();
+    return rc;
+
+} /* end ezcaSetTimeout() */
+
+/****************************************************************
+*
+* PVs that could not be found fail immediately (EZCA_NOTFOUND)
+* for 'sec' seconds; sec <= 0 disables the negative cache.
+*
+****************************************************************/
+
+int epicsShareAPI ezcaSetNotFoundHoldoff(float sec)
+{
+
+struct work *wp;
+int rc;
+
+    prologue();
+
+    if ((wp = get_work_single()))
+    {
+	ErrorLocation = SINGLEWORK;
+
+	/* filling work */
+	wp->worktype = SETNOTFOUNDHOLDOFF;
+
+	NotFoundHoldoff = sec > 0. ? sec : (float)0.;
+
+	wp->rc = EZCA_OK;
+
+	rc = wp->rc;
+    }
+    else
+    {
+	rc = EZCA_FAILEDMALLOC;
+
+	if (AutoErrorMessage)
+	    printf("%s\n", FAILED_MALLOC_MSG);
+    } /* endif */
+
+    epilogue();
+    return rc;
+
+} /* end ezcaSetNotFoundHoldoff() */
+
+/****************************************************************
+*
+*
+****************************************************************/
+
+float epicsShareAPI ezcaGetNotFoundHoldoff()
+{
+
+struct work *wp;
+float rc;
+
+    prologue();
+
+    if ((wp = get_work_single()))
+    {
+	ErrorLocation = SINGLEWORK;
+
+	/* filling work */
+	wp->worktype = GETNOTFOUNDHOLDOFF;
+	wp->rc = EZCA_OK;
+
+	rc  = NotFoundHoldoff;
+    }
+    else
+    {
+	if (AutoErrorMessage)
+	    printf("%s\n", FAILED_MALLOC_MSG);
+
+	rc = UNDEFINED;
+
+    } /* endif */
+
+    epilogue();
+    return rc;
+
+} /* end ezcaGetNotFoundHoldoff() */
+
+/****************************************************************
+*
+* # of nodes allocated at once when a node list runs empty; 
+* applies to slabs allocated from now on.
+*
+****************************************************************/
+
+int epicsShareAPI ezcaSetNodesPerSlab(int n)
+{
+
+struct work *wp;
+int rc;
+
+    prologue();
+
+    if ((wp = get_work_single()))
+    {
+	ErrorLocation = SINGLEWORK;
+
+	/* filling work */
+	wp->worktype = SETNODESPERSLAB;
+
+	if (n > 0)
+	{
+	    NodesPerSlab = n;
+	    wp->rc = EZCA_OK;
+	}
+	else
+	{
+	    wp->rc = EZCA_INVALIDARG;
+	    wp->error_msg = ErrorMsgs[INVALID_ARG_MSG_IDX];
+
+	    if (AutoErrorMessage)
+		print_error(wp);
+	} /* endif */
+
+	rc = wp->rc;
+    }
+    else
+    {
+	rc = EZCA_FAILEDMALLOC;
+
+	if (AutoErrorMessage)
+	    printf("%s\n", FAILED_MALLOC_MSG);
+    } /* endif */
+
+    epilogue();
+    return rc;
+
+} /* end ezcaSetNodesPerSlab() */
+
+/****************************************************************
+*
+* occupancy of the channel, monitor or work node slabs. 
+* Any of the pointers may be NULL.
+*
+****************************************************************/
+
+int epicsShareAPI ezcaGetNodeStats(int kind, unsigned long *nslabs, unsigned long *nnodes, unsigned long *ninuse, unsigned long *ndiscarded)
+{
+
+struct node_pool *pp;
+struct work *wp;
+int rc;
+
+    prologue();
+
+    if ((wp = get_work_single()))
+    {
+	ErrorLocation = SINGLEWORK;
+
+	/* filling work */
+	wp->worktype = GETNODESTATS;
+
+	switch (kind)
+	{
+	    case EZCA_NODE_CHANNEL: pp = &ChannelPool; break;
+	    case EZCA_NODE_MONITOR: pp = &MonitorPool; break;
+	    case EZCA_NODE_WORK:    pp = &WorkPool;    break;
+	    default:                pp = (struct node_pool *) NULL; break;
+	} /* end switch() */
+
+	if (pp)
+	{
+	    if (nslabs)
+		*nslabs = pp->nslabs;
+	    if (nnodes)
+		*nnodes = pp->nnodes;
+	    if (ninuse)
+		*ninuse = pp->nnodes - pp->navail - pp->ndiscarded;
+	    if (ndiscarded)
+		*ndiscarded = pp->ndiscarded;
+
+	    wp->rc = EZCA_OK;
+	}
+	else
+	{
+	    wp->rc = EZCA_INVALIDARG;
+	    wp->error_msg = ErrorMsgs[INVALID_ARG_MSG_IDX];
+
+	    if (AutoErrorMessage)
+		print_error(wp);
+	} /* endif */
+
+	rc = wp->rc;
+    }
+    else
+    {
+	rc = EZCA_FAILEDMALLOC;
+
+	if (AutoErrorMessage)
+	    printf("%s\n", FAILED_MALLOC_MSG);
+    } /* endif */
+
+    epilogue();
+    return rc;
+
+} /* end ezcaGetNodeStats() */
+
+/****************************************************************
+*
+* # of heap allocations made so far for the names, error strings
+* and PUT data of work requests (grouped work uses Group_arena).
+*
+****************************************************************/
+
+unsigned long epicsShareAPI ezcaGetWorkAllocs()
+{
+
+struct work *wp;
+unsigned long rc;
+
+    prologue();
+
+    if ((wp = get_work_single()))
+    {
+	ErrorLocation = SINGLEWORK;
+
+	/* filling work */
+	wp->worktype = GETWORKALLOCS;
+	wp->rc = EZCA_OK;
+    }
+    else
+    {
+	if (AutoErrorMessage)
+	    printf("%s\n", FAILED_MALLOC_MSG);
+    } /* endif */
+
+    rc = WorkAllocs;
+
+    epilogue();
+    return rc;
+
+} /* end ezcaGetWorkAllocs() */
+
+/****************************************************************
+*
+*
+****************************************************************/
+
+int epicsShareAPI ezcaStartGroup()
+{
+
+struct work *wp;
+int rc;
+
+    prologue();
+
+    if ((wp = get_work_single()))
+    {
+	ErrorLocation = SINGLEWORK;
+
+	/* filling work */
+	wp->worktype = STARTGROUP;
+
+	if (InGroup)
+	{
+	    /* already in a group */
+	    wp->rc = EZCA_INGROUP;
+	    wp->error_msg = ErrorMsgs[INGROUP_MSG_IDX];
+
+	    if (AutoErrorMessage)
+		print_error(wp);
+	}
+	else
+	{
+	    /* not in a group */
+
+	    if (Trace || Debug)
+	printf("ezcaStartGroup() about to empty_work_list() and set InGroup\n");
+
+	    empty_work_list();
+
+	    InGroup = TRUE;
+
+	    wp->rc = EZCA_OK;
+
+	} /* endif */
+
+	rc = wp->rc;
+    }
+    else
+    {
+	rc = EZCA_FAILEDMALLOC;
+
+	if (AutoErrorMessage)
+	    printf("%s\n", FAILED_MALLOC_MSG);
+
+    } /* endif */
+
+    epilogue();
+    return rc;
+
+} /* end ezcaStartGroup() */
+
+int epicsShareAPI ezcaClearChannel(char *pvname)
+{
+
+struct channel *cp = 0;
+struct work *wp;
+int rc;
+
+    prologue();
+
+    if ((wp = get_work_single()))
+    {
+	ErrorLocation = SINGLEWORK;
+
+	/* filling work */
+	wp->worktype = CLEARCHANNEL;
+
+    if (!pvname || !(cp=find_channel(pvname)))
+    {
+        wp->rc = EZCA_INVALIDARG;
+        wp->error_msg = ErrorMsgs[INVALID_PVNAME_MSG_IDX];
+
+        if (AutoErrorMessage)
+			print_error(wp);
+    }
+	else if (InGroup)
+	{
+	    /* already in a group */
+	    wp->rc = EZCA_INGROUP;
+	    wp->error_msg = ErrorMsgs[INGROUP_MSG_IDX];
+
+	    if (AutoErrorMessage)
+			print_error(wp);
+	}
+	else
+	{
+	    /* not in a group */
+
+
+		if ( cp ) {
+	    if (Trace || Debug)
+	printf("ezcaClearChannel() about to call clean_and_push_channel()\n");
+			clean_and_push_channel( &cp );
+	    	wp->rc = EZCA_OK;
 		}
-		else
-		{
-		    /* using Work_list */
-		    for (cp = *buff, 
-		wp = (ListPrint == WHOLELIST ? Work_list.head : Work_list.tail);
-			wp; wp = wp->next)
-		    {
-			switch (wp->worktype)
-			{
-			    case GET:              
-				wtm = GET_MSG;                 break;
-			    case PUT:              
-				wtm = PUT_MSG;                 break;
-			    case PUTOLDCA:         
-				wtm = PUTOLDCA_MSG;            break;
-			    case GETUNITS:         
-				wtm = GETUNITS_MSG;            break;
-			    case GETENUMSTATES:         
-				wtm = GETENUMSTATES_MSG;       break;
-			    case GETNELEM:         
-				wtm = GETNELEM_MSG;            break;
-			    case GETPRECISION:     
-				wtm = GETPRECISION_MSG;        break;
-			    case GETGRAPHICLIMITS: 
-				wtm = GETGRAPHICLIMITS_MSG;    break;
-			    case GETCONTROLLIMITS: 
-				wtm = GETCONTROLLIMITS_MSG;    break;
-		    	case GETWARNLIMITS:
-				wtm = GETWARNLIMITS_MSG;       break;
-			    case GETALARMLIMITS:
-				wtm = GETALARMLIMITS_MSG;      break;
-			    case GETSTATUS:        
-				wtm = GETSTATUS_MSG;           break;
-			    case GETWITHSTATUS:    
-				wtm = GETWITHSTATUS_MSG;       break;
-			    case SETMONITOR:       
-				wtm = SETMONITOR_MSG;          break;
-			    case CLEARMONITOR:     
-				wtm = CLEARMONITOR_MSG;        break;
-			    case AUTOERRORMESSAGEOFF: 
-				wtm = AUTOERRORMESSAGEOFF_MSG; break;
-			    case AUTOERRORMESSAGEON:     
-				wtm = AUTOERRORMESSAGEON_MSG;  break;
-			    case DEBUGOFF:         
-				wtm = DEBUGOFF_MSG;            break;
-			    case DEBUGON:          
-				wtm = DEBUGON_MSG;             break;
-			    case DELAY:               
-				wtm = DELAY_MSG;               break;
-			    case FREEMEM:  
-				wtm = FREEMEM_MSG;             break;
-			    case PVTOCHID:         
-				wtm = PVTOCHID_MSG;            break;
-			    case SETTIMEOUT:       
-				wtm = SETTIMEOUT_MSG;          break;
-			    case STARTGROUP:       
-				wtm = STARTGROUP_MSG;          break;
-		    	case CLEARCHANNEL:
-			    wtm = CLEARCHANNEL_MSG;        break;
-		    	case MONBLOCK:
-				wtm = MONBLOCK_MSG;            break;
-			    case TRACEOFF:         
-				wtm = TRACEOFF_MSG;            break;
-			    case TRACEON:          
-				wtm = TRACEON_MSG;             break;
-			    case SETRETRYCOUNT:    
-				wtm = SETRETRYCOUNT_MSG;       break;
-			    case GETRETRYCOUNT:    
-				wtm = GETRETRYCOUNT_MSG;       break;
-			    case GETTIMEOUT:       
-				wtm = GETTIMEOUT_MSG;          break;
-			    default:
-				fprintf(stderr, 
-	"EZCA FATAL ERROR: ezcaGetErrorString() found invalid worktype %d\n", 
-				    wp->worktype);
-				exit(1);
-				break;
-			} /* end switch() */
+	} /* endif */
 
-			if (prefix)
-			{
-			    strcat(cp, prefix);
-			    cp += strlen(prefix);
-			} /* endif */
+	rc = wp->rc;
+    }
+    else
+    {
+	rc = EZCA_FAILEDMALLOC;
 
-			strcat(cp, " ");
-			cp ++;
+	if (AutoErrorMessage)
+	    printf("%s\n", FAILED_MALLOC_MSG);
 
-			strcat(cp, wtm);
-			cp += strlen(wtm);
+    } /* endif */
 
-			strcat(cp, ": ");
-			cp += 2;
+	/* if clean_and_push_channel() was successful, cp is NULL at this point */
+	release_channel( &cp );
 
-			if (wp->rc == EZCA_OK)
-			{
-			    strcat(cp, OKMSG);
-			    cp += strlen(OKMSG);
-			}
-			else
-			{
-			    strcat(cp, wp->error_msg);
-			    cp += strlen(wp->error_msg);
+    epilogue();
+    return rc;
 
-			    if (wp->aux_error_msg)
-			    {
-				strcat(cp, " : ");
-				cp += 3;
+} /* end ezcaClearChannel() */
 
-				strcat(cp, wp->aux_error_msg);
-				cp += strlen(wp->aux_error_msg);
+/****************************************************************
+*
+* clears all channels (or the disconnected ones) except those held
+* by handles or in use by a request of another thread. One pass
+* over the Lru list; see clear_victims().
+*
+****************************************************************/
 
-			    } /* endif */
-			} /* endif */
+int epicsShareAPI ezcaPurge(int disconnectedOnly)
+{
 
-			if (wp->next)
-			{
-			    *cp = '\n';
-			    cp ++;
-			} 
-			else
-			{
-			    *cp = '\0';
-			    cp ++;
-			} /* endif */
+struct channel *cp;
+struct channel *victims = (struct channel *) NULL;
+struct work *wp;
+int rc;
 
-		    } /* endfor */
-		} /* endif */
+    prologue();
 
-		rc = EZCA_OK;
-	    }
-	    else
-	    {
-		rc = EZCA_FAILEDMALLOC;
+    if ((wp = get_work_single()))
+    {
+	ErrorLocation = SINGLEWORK;
 
-		if (AutoErrorMessage)
-		    printf("%s\n", FAILED_MALLOC_MSG);
-	    } /* endif */
+	/* filling work */
+	wp->worktype = CLEARCHANNEL;
+
+	if (InGroup)
+	{
+	    /* already in a group */
+	    wp->rc = EZCA_INGROUP;
+	    wp->error_msg = ErrorMsgs[INGROUP_MSG_IDX];
+
+	    if (AutoErrorMessage)
+			print_error(wp);
 	}
 	else
 	{
+	    /* not in a group */
+	    for (cp = LruHead; cp; cp = cp->lru_next)
+	    {
+		if (cp->nhandles || cp->refcnt)
+		    continue;
 
-	    rc = EZCA_OK;
+		if (!disconnectedOnly || !EzcaConnected(cp))
+		{
+		    cp->refcnt++;
+		    cp->next = victims;
+		    victims = cp;
+		} /* endif */
+	    } /* endfor */
 
-	    *buff = (char *) NULL;
+	    (void) clear_victims(victims);
 
-	    if (Trace || Debug)
-		printf("ezcaGetErrorString() found no work\n");
+	   	wp->rc = EZCA_OK;
 	} /* endif */
+
+	rc = wp->rc;
     }
     else
     {
-	rc = EZCA_INVALIDARG;
+	rc = EZCA_FAILEDMALLOC;
 
 	if (AutoErrorMessage)
-	    printf("%s\n", INVALID_ARG_MSG);
+	    printf("%s\n", FAILED_MALLOC_MSG);
+
     } /* endif */
 
     epilogue();
     return rc;
 
-} /* end ezcaGetErrorString() */
+} /* end ezcaPurge() */
 
 /****************************************************************
 *
-* because this function returns TRUE/FALSE, it does not conform to
-* the normal error message scheme of the rest of the functions.
-* for this reason it does not get a work node and is therefore
-* classified as an immediate function (rather than a non-groupable
-* work function).
-*
-* the user wishes to know if he needs to read the value that he
-* presumably set a monitor on.  this function returns TRUE (needs 
-* reading) or FALSE.
-*
-* It always error towards forcing the read ... if anything goes wrong,
-* it returns -1.
-*
-* It returns FALSE iff there is an existing monitor that does not 
-* need reading ... otherwise returns TRUE (no channel, invalid args, ...)
+* sets the eviction policy of the channel cache and the cap on
+* monitor memory (see ezca.h). With preemptive callbacks the
+* passes run in a thread of their own which is started on first
+* use and stopped (waiting for it to exit) when the limits are
+* all switched off; otherwise prologue() runs them.
 *
 ****************************************************************/
 
-int epicsShareAPI ezcaNewMonitorValue(char *pvname, char type)
+int epicsShareAPI ezcaSetCachePolicy(unsigned long maxChannels, float maxIdle, double maxMonitorBytes)
 {
 
-struct channel *cp;
-struct monitor *mp;
-BOOL found;
+struct work *wp;
 int rc;
+#ifdef EPICS_THREE_FOURTEEN
+BOOL stopping = FALSE;
+#endif
 
     prologue();
 
-    if (pvname)
+    if ((wp = get_work_single()))
     {
-	if (VALID_EZCA_DATA_TYPE(type))
-	{
-	    if ((cp = find_channel(pvname)))
-	    {
-		mp = cp->monitor_list;
-		found = FALSE;
-		while (mp && !found)
-		    if (!(found = (type == mp->ezcadatatype)))
-			mp = mp->right;
+	ErrorLocation = SINGLEWORK;
 
-		if (found)
-		    rc = (int) mp->needs_reading;
-		else
-		{
-		    /* no monitor */
+	/* filling work */
+	wp->worktype = SETCACHEPOLICY;
 
-		    if (Trace || Debug)
-	printf("ezcaNewMonitorValue() found no monitor name >%s< type %d\n",
-			pvname, type);
+	if (maxIdle < 0. || maxMonitorBytes < 0.)
+	{
+	    wp->rc = EZCA_INVALIDARG;
+	    wp->error_msg = ErrorMsgs[INVALID_ARG_MSG_IDX];
 
-		    rc = -1;
+	    if (AutoErrorMessage)
+		print_error(wp);
+	}
+	else
+	{
+	    CacheMaxChannels = maxChannels;
+	    CacheMaxIdle = maxIdle;
+	    MonitorMemCap = maxMonitorBytes;
+
+#ifdef EPICS_THREE_FOURTEEN
+	    if (EVICTING() && !EvictInBackground && PreemptiveCallbacks)
+	    {
+		if (!EvictWake)
+		{
+		    EvictWake = epicsEventMustCreate(epicsEventEmpty);
+		    EvictDone = epicsEventMustCreate(epicsEventEmpty);
 		} /* endif */
-		release_channel(&cp);
+		EvictStop = FALSE;
+		EvictInBackground = epicsThreadCreate("ezcaEvict",
+		    epicsThreadPriorityLow,
+		    epicsThreadGetStackSize(epicsThreadStackSmall),
+		    evict_thread, 0) ? TRUE : FALSE;
 	    }
-	    else
+	    else if (!EVICTING() && EvictInBackground && !EvictStop)
 	    {
-		/* no channel */
-		rc = -2;
-
-		if (Trace || Debug)
-	printf("ezcaNewMonitorValue() found no channel name >%s< type %d\n",
-			pvname, type);
+		/* no more eviction; wait for the thread below */
+		EvictStop = TRUE;
+		stopping = TRUE;
 	    } /* endif */
-	}
-	else
-	{
-	    /* invalid type */
-	    rc = -3;
 
-	    if (AutoErrorMessage)
-		printf("%s\n", INVALID_TYPE_MSG);
+	    /* apply the new limits (or stop) now */
+	    if (EvictWake)
+		epicsEventSignal(EvictWake);
+#endif
+	    set_deadline(&EvictDue, 0.);
+
+	    wp->rc = EZCA_OK;
 	} /* endif */
+
+	rc = wp->rc;
     }
     else
     {
-	/* invalid pvname */
-	rc = -4;
+	rc = EZCA_FAILEDMALLOC;
 
 	if (AutoErrorMessage)
-	    printf("%s\n", INVALID_PVNAME_MSG);
-
+	    printf("%s\n", FAILED_MALLOC_MSG);
     } /* endif */
 
     epilogue();
+
+#ifdef EPICS_THREE_FOURTEEN
+    /* it needs the lock to get out */
+    if (stopping)
+	epicsEventMustWait(EvictDone);
+#endif
+
     return rc;
 
-} /* end ezcaNewMonitorValue() */
+} /* end ezcaSetCachePolicy() */
 
 /****************************************************************
 *
-* if there is no outstanding work, this function is a no-op.
+* # of cached channels, # evicted so far and monitor memory in
+* use. Any of the pointers may be NULL.
 *
 ****************************************************************/
 
-void epicsShareAPI ezcaPerror(char *prefix)
+int epicsShareAPI ezcaGetCacheStats(unsigned long *nchannels, unsigned long *nevicted, double *monitorBytes)
 {
 
 struct work *wp;
-char *wtm;
+int rc;
 
     prologue();
 
-    if (ErrorLocation == SINGLEWORK)
+    if ((wp = get_work_single()))
     {
-	/* using Workp */
+	ErrorLocation = SINGLEWORK;
 
-	if (Workp)
-	{
-	    wp = Workp;
+	/* filling work */
+	wp->worktype = GETCACHESTATS;
 
-	    switch (wp->worktype)
-	    {
-		case GET:              wtm = GET_MSG;              break;
-		case PUT:              wtm = PUT_MSG;              break;
-		case PUTOLDCA:         wtm = PUTOLDCA_MSG;         break;
-		case GETUNITS:         wtm = GETUNITS_MSG;         break;
-	    case GETENUMSTATES:    wtm = GETENUMSTATES_MSG;    break;
-		case GETNELEM:         wtm = GETNELEM_MSG;         break;
-		case GETPRECISION:     wtm = GETPRECISION_MSG;     break;
-		case GETGRAPHICLIMITS: wtm = GETGRAPHICLIMITS_MSG; break;
-		case GETCONTROLLIMITS: wtm = GETCONTROLLIMITS_MSG; break;
-		case GETWARNLIMITS:    wtm = GETWARNLIMITS_MSG;    break;
-		case GETALARMLIMITS:   wtm = GETALARMLIMITS_MSG;   break;
-		case GETSTATUS:        wtm = GETSTATUS_MSG;        break;
-		case GETWITHSTATUS:    wtm = GETWITHSTATUS_MSG;    break;
-		case SETMONITOR:       wtm = SETMONITOR_MSG;       break;
-		case CLEARMONITOR:     wtm = CLEARMONITOR_MSG;     break;
-		case AUTOERRORMESSAGEOFF: 
-		    wtm = AUTOERRORMESSAGEOFF_MSG;                 break;
-		case AUTOERRORMESSAGEON:     
-		    wtm = AUTOERRORMESSAGEON_MSG;                  break;
-		case DEBUGOFF:         wtm = DEBUGOFF_MSG;         break;
-		case DEBUGON:          wtm = DEBUGON_MSG;          break;
-		case DELAY:            wtm = DELAY_MSG;            break;
-		case FREEMEM:          wtm = FREEMEM_MSG;          break;
-		case PVTOCHID:         wtm = PVTOCHID_MSG;         break;
-		case SETTIMEOUT:       wtm = SETTIMEOUT_MSG;       break;
-		case STARTGROUP:       wtm = STARTGROUP_MSG;       break;
-		case CLEARCHANNEL:     wtm = CLEARCHANNEL_MSG;     break;
-		case MONBLOCK:         wtm = MONBLOCK_MSG;         break;
-		case TRACEOFF:         wtm = TRACEOFF_MSG;         break;
-		case TRACEON:          wtm = TRACEON_MSG;          break;
-		case SETRETRYCOUNT:    wtm = SETRETRYCOUNT_MSG;    break;
-		case GETRETRYCOUNT:    wtm = GETRETRYCOUNT_MSG;    break;
-		case GETTIMEOUT:       wtm = GETTIMEOUT_MSG;       break;
-		default:
-		    fprintf(stderr, 
-		"EZCA FATAL ERROR: ezcaPerror() found invalid worktype %d\n", 
-			wp->worktype);
-		    exit(1);
-		    break;
-	    } /* end switch() */
+	if (nchannels)
+	    *nchannels = ezcaRegCount(Channels);
+	if (nevicted)
+	    *nevicted = Evictions;
+	if (monitorBytes)
+	    *monitorBytes = monitor_mem();
 
-	    printf("%s %s: ", (prefix ? prefix : ""), wtm);
-	    print_error(wp);
-	} /* endif */
+	wp->rc = EZCA_OK;
+
+	rc = wp->rc;
     }
     else
     {
-	/* using Work_list */
-
-	for (wp = (ListPrint == WHOLELIST ? Work_list.head : Work_list.tail); 
-	    wp; wp = wp->next)
-	{
-	    switch (wp->worktype)
-	    {
-		case GET:              wtm = GET_MSG;              break;
-		case PUT:              wtm = PUT_MSG;              break;
-		case PUTOLDCA:         wtm = PUTOLDCA_MSG;         break;
-		case GETUNITS:         wtm = GETUNITS_MSG;         break;
-	    case GETENUMSTATES:    wtm = GETENUMSTATES_MSG;    break;
-		case GETNELEM:         wtm = GETNELEM_MSG;         break;
-		case GETPRECISION:     wtm = GETPRECISION_MSG;     break;
-		case GETGRAPHICLIMITS: wtm = GETGRAPHICLIMITS_MSG; break;
-		case GETCONTROLLIMITS: wtm = GETCONTROLLIMITS_MSG; break;
-		case GETWARNLIMITS:    wtm = GETWARNLIMITS_MSG;    break;
-		case GETALARMLIMITS:   wtm = GETALARMLIMITS_MSG;   break;
-		case GETSTATUS:        wtm = GETSTATUS_MSG;        break;
-		case GETWITHSTATUS:    wtm = GETWITHSTATUS_MSG;    break;
-		case SETMONITOR:       wtm = SETMONITOR_MSG;       break;
-		case CLEARMONITOR:     wtm = CLEARMONITOR_MSG;     break;
-		case AUTOERRORMESSAGEOFF: 
-		    wtm = AUTOERRORMESSAGEOFF_MSG;                 break;
-		case AUTOERRORMESSAGEON:     
-		    wtm = AUTOERRORMESSAGEON_MSG;                  break;
-		case DEBUGOFF:         wtm = DEBUGOFF_MSG;         break;
-		case DEBUGON:          wtm = DEBUGON_MSG;          break;
-		case DELAY:            wtm = DELAY_MSG;            break;
-		case FREEMEM:          wtm = FREEMEM_MSG;          break;
-		case PVTOCHID:         wtm = PVTOCHID_MSG;         break;
-		case SETTIMEOUT:       wtm = SETTIMEOUT_MSG;       break;
-		case STARTGROUP:       wtm = STARTGROUP_MSG;       break;
-		case CLEARCHANNEL:     wtm = CLEARCHANNEL_MSG;     break;
-		case MONBLOCK:         wtm = MONBLOCK_MSG;         break;
-		case TRACEOFF:         wtm = TRACEOFF_MSG;         break;
-		case TRACEON:          wtm = TRACEON_MSG;          break;
-		case SETRETRYCOUNT:    wtm = SETRETRYCOUNT_MSG;    break;
-		case GETRETRYCOUNT:    wtm = GETRETRYCOUNT_MSG;    break;
-		case GETTIMEOUT:       wtm = GETTIMEOUT_MSG;       break;
-		default:
-		    fprintf(stderr, 
-		"EZCA FATAL ERROR: ezcaPerror() found invalid worktype %d\n", 
-			wp->worktype);
-		    exit(1);
-		    break;
-	    } /* end switch() */
+	rc = EZCA_FAILEDMALLOC;
 
-	    printf("%s %s: ", (prefix ? prefix : ""), wtm);
-	    print_error(wp);
-	} /* endfor */
+	if (AutoErrorMessage)
+	    printf("%s\n", FAILED_MALLOC_MSG);
     } /* endif */
 
-    epilogue();
-} /* end ezcaPerror() */
-
-/**************************************************************/
-/*                                                            */
-/* Non-Groupable Work Functions                               */
-/*                                                            */
-/* These allocate work,so they store error msgs.  They do not */
-/* change ErrorLocation.                                      */
-/* These are executed immediately, without respect to InGroup */
-/* context.                                                   */
-/*                                                            */
-/**************************************************************/
+    epilogue();
+    return rc;
+
+} /* end ezcaGetCacheStats() */
+
 
 /****************************************************************
 *
+* Available, but not advertised.
 *
 ****************************************************************/
 
-void epicsShareAPI ezcaAutoErrorMessageOff()
+void epicsShareAPI ezcaTraceOff()
 {
 
 struct work *wp;
@@ -1844,14 +5981,13 @@ struct work *wp;
 	ErrorLocation = SINGLEWORK;
 
 	/* filling work */
-	wp->worktype = AUTOERRORMESSAGEOFF;
-
+	wp->worktype = TRACEOFF;
 	wp->rc = EZCA_OK;
 
-	AutoErrorMessage = FALSE;
-
 	if (Trace || Debug)
-	    printf("clearing AutoErrorMessage\n");
+	    printf("clearing Trace\n");
+
+	Trace = FALSE;
     }
     else
     {
@@ -1860,14 +5996,15 @@ struct work *wp;
     } /* endif */
 
     epilogue();
-} /* end ezcaAutoErrorMessageOff() */
+} /* end ezcaTraceOff() */
 
 /****************************************************************
 *
+* Available, but not advertised.
 *
 ****************************************************************/
 
-void epicsShareAPI ezcaAutoErrorMessageOn()
+void epicsShareAPI ezcaTraceOn()
 {
 
 struct work *wp;
@@ -1879,13 +6016,13 @@ struct work *wp;
 	ErrorLocation = SINGLEWORK;
 
 	/* filling work */
-	wp->worktype = AUTOERRORMESSAGEON;
+	wp->worktype = TRACEON;
 	wp->rc = EZCA_OK;
 
-	AutoErrorMessage = TRUE;
+	Trace = TRUE;
 
 	if (Trace || Debug)
-	    printf("setting AutoErrorMessage\n");
+	    printf("setting Trace\n");
     }
     else
     {
@@ -1894,128 +6031,150 @@ struct work *wp;
     } /* endif */
 
     epilogue();
-} /* end ezcaAutoErrorMessageOn() */
+} /* end ezcaTraceOn() */
+
+/**************************************************************/
+/*                                                            */
+/* Groupable Work Functions                                   */
+/*                                                            */
+/* These allocate work,so they store error msgs.  They may    */
+/* change ErrorLocation.                                      */
+/* These are executed with respect to InGroup context.        */
+/*                                                            */
+/**************************************************************/
 
 /****************************************************************
 *
 *
 ****************************************************************/
 
-int epicsShareAPI ezcaClearMonitor(char *pvname, char type)
+/* ezcaGet() and ezcaGetWithStatus() for PV names and handles;
+ * exactly one of 'hcp' or 'pvname' is used (hcp if non-NULL).
+ */
+static int
+getValue(struct channel *hcp, char *pvname, char worktype, char type, int nelem,
+	void *buff, epicsTimeStamp *timestamp, short *status, short *severity)
 {
 
 struct channel *cp;
-struct monitor *mp;
 struct work *wp;
-BOOL found;
 int rc;
 
     prologue();
 
-    if ((wp = get_work_single()))
+    if ((wp = get_work()))
     {
-	ErrorLocation = SINGLEWORK;
+
+	ErrorLocation = (InGroup ? LISTWORK : SINGLEWORK);
+	ListPrint = (InGroup ? LASTONLY : ListPrint);
 
 	/* filling work */
-	wp->worktype = CLEARMONITOR;
+	wp->worktype = worktype;
 	wp->ezcadatatype = type;
+	wp->nelem = nelem;
+	wp->pval = buff;
+	wp->tsp = timestamp;
+	wp->status = status;
+	wp->severity = severity;
 
 	/* checking input args */
-
-	if (!pvname)
+	if (!check_target(wp, hcp, pvname))
+	{
+	    if (AutoErrorMessage)
+		print_error(wp);
+	}
+	else if (!VALID_EZCA_DATA_TYPE(wp->ezcadatatype))
 	{
 	    wp->rc = EZCA_INVALIDARG;
-	    wp->error_msg = ErrorMsgs[INVALID_PVNAME_MSG_IDX];
+	    wp->error_msg = ErrorMsgs[INVALID_TYPE_MSG_IDX];
 
 	    if (AutoErrorMessage)
 		print_error(wp);
 	} 
-	else if (!(wp->pvname = strdup(pvname)))
+	else if (wp->nelem <= 0)
 	{
-	    wp->rc = EZCA_FAILEDMALLOC;
-	    wp->error_msg = ErrorMsgs[FAILED_MALLOC_MSG_IDX];
+	    wp->rc = EZCA_INVALIDARG;
+	    wp->error_msg = ErrorMsgs[INVALID_NELEM_MSG_IDX];
 
 	    if (AutoErrorMessage)
 		print_error(wp);
-	} 
-	else if (!VALID_EZCA_DATA_TYPE(wp->ezcadatatype))
+	}
+	else if (!(wp->pval)
+		|| (GETWITHSTATUS == worktype 
+			&& (!(wp->tsp) || !(wp->status) || !(wp->severity))))
 	{
 	    wp->rc = EZCA_INVALIDARG;
-	    wp->error_msg = ErrorMsgs[INVALID_TYPE_MSG_IDX];
+	    wp->error_msg = ErrorMsgs[INVALID_PBUFF_MSG_IDX];
 
 	    if (AutoErrorMessage)
 		print_error(wp);
-	} 
+	}
 	else
 	{
 	    /* arguments are valid */
 	    wp->rc = EZCA_OK;
 	} /* endif */
 
-	if (wp->rc == EZCA_OK)
+	if (InGroup)
+	{
+	    if (hcp && wp->rc == EZCA_OK)
+		use_handle(hcp, &wp->cp);
+	    append_to_work_list(wp);
+	}
+	else if (wp->rc == EZCA_OK)
 	{
 	    /* all input args OK */
-	    if ((cp = find_channel(wp->pvname)))
+
+	    if (hcp)
+		use_handle(hcp, &cp);
+	    else
+		get_channel(wp, &cp);
+
+	    if (cp)
 	    {
 		/* everything OK so far ... otherwise something */
 		/* went wrong and it is already explained in wp */
 
-		/* loop to check monitor list for monitor of the same type */
-		mp = cp->monitor_list;
-		found = FALSE;
-		while (mp && !found)
-		if (!(found = (wp->ezcadatatype == mp->ezcadatatype)))
-		    mp = mp->right;
-
-		if (found)
+		if (EzcaConnected(cp))
 		{
-		    if (Trace || Debug)
-		printf("ezcaClearMonitor(): found monitor ... clearing now\n");
-
-		    /* removing monitor from this channel's list */
-		    if (mp->left)
-			/* mp is NOT leftmost */
-			(mp->left)->right = mp->right;
-		    else
-			/* mp is leftmost */
-			cp->monitor_list = mp->right;
-
-		    if (mp->right)
-			/* mp is NOT rightmost */
-			(mp->right)->left = mp->left;
-
-		    /* clearing event, freeing memory, and */
-		    /* taking this monitor out of service  */
-
-		    mp->active = FALSE;
+		    /* channel is currently connected */
+		    if (!get_from_monitor(wp, cp))
+		    {
+			/* did not find an active   */
+			/* monitor that had a value */
+			/* need to do explicit get  */
 
-		    clean_and_push_monitor(mp);
+			if (Trace || Debug)
+	    printf("%s: did not find an active monitor with a value\n",
+		worktype_msg(wp, "getValue"));
 
-		    wp->rc = EZCA_OK;
+			if (issue_get(wp, cp))
+			{
+			    /* a EzcaArrayGetCallback() */
+			    /* was successfully  issued */
+			    issue_wait(wp);
+			    if (AutoErrorMessage && wp->rc != EZCA_OK)
+				print_error(wp);
+			} /* endif */
+		    } /* endif */
 		}
 		else
 		{
-		    /* no monitor to clear */
-
-		    wp->rc = EZCA_OK;
+		    /* channel is not connected */
 
-		    if (Trace || Debug)
-		printf("ezcaClearMonitor(): found channel but no monitor\n");
+		    wp->rc = EZCA_NOTCONNECTED;
+		    wp->error_msg = ErrorMsgs[NOT_CONNECTED_MSG_IDX];
 
+		    if (AutoErrorMessage)
+			print_error(wp);
 		} /* endif */
-		release_channel(&cp);
-	    } 
-	    else
-	    {
-		wp->rc = EZCA_OK;
-
-		if (Trace || Debug)
-		    printf("ezcaClearMonitor: found no channel\n");
 	    } /* endif */
+
+		release_channel( &cp );
+
 	} /* endif */
 
 	rc = wp->rc;
-	    
     }
     else
     {
@@ -2028,343 +6187,539 @@ int rc;
     epilogue();
     return rc;
 
-} /* end ezcaClearMonitor() */
+} /* end getValue() */
 
 /****************************************************************
 *
-* Available, but not advertised.
 *
 ****************************************************************/
 
-void epicsShareAPI ezcaDebugOff()
+int epicsShareAPI ezcaGet(char *pvname, char type, int nelem, void *buff)
 {
+	return getValue((struct channel *) NULL, pvname, GET, type, nelem, buff,
+		(epicsTimeStamp *) NULL, (short *) NULL, (short *) NULL);
+} /* end ezcaGet() */
 
-struct work *wp;
-
-    prologue();
-
-    if ((wp = get_work_single()))
-    {
-	ErrorLocation = SINGLEWORK;
-
-	/* filling work */
-	wp->worktype = DEBUGOFF;
-	wp->rc = EZCA_OK;
-
-	if (Trace || Debug)
-	    printf("clearing Debug\n");
-
-	Debug = FALSE;
-    }
-    else
-    {
-	if (AutoErrorMessage)
-	    printf("%s\n", FAILED_MALLOC_MSG);
-    } /* endif */
-
-    epilogue();
-} /* end ezcaDebugOff() */
+int epicsShareAPI ezcaGetH(EzcaHandle h, char type, int nelem, void *buff)
+{
+	return getValue(H2CHANNEL(h), (char *) NULL, GET, type, nelem, buff,
+		(epicsTimeStamp *) NULL, (short *) NULL, (short *) NULL);
+} /* end ezcaGetH() */
 
 /****************************************************************
 *
-* Available, but not advertised.
 *
 ****************************************************************/
 
-void epicsShareAPI ezcaDebugOn()
+static int
+getInfo(char *pvname, char worktype, ...)
 {
 
 struct work *wp;
+struct channel *cp;
+int rc;
+va_list ap;
+void    **ptrs[4];
+int     nptrs = 0;
+int     i;
+int     canGetFromMon = 0;
+
 
     prologue();
 
-    if ((wp = get_work_single()))
+    if ((wp = get_work()))
     {
-	ErrorLocation = SINGLEWORK;
+
+	ErrorLocation = (InGroup ? LISTWORK : SINGLEWORK);
+	ListPrint = (InGroup ? LASTONLY : ListPrint);
 
 	/* filling work */
-	wp->worktype = DEBUGON;
-	wp->rc = EZCA_OK;
 
-	Debug = TRUE;
+	wp->worktype = worktype;
+	wp->rc       = EZCA_OK;
 
-	if (Trace || Debug)
-	    printf("setting Debug\n");
-    }
-    else
+	/* checking input args */
+    if (!pvname)
     {
-	if (AutoErrorMessage)
-	    printf("%s\n", FAILED_MALLOC_MSG);
-    } /* endif */
-
-    epilogue();
-} /* end ezcaDebugOn() */
-
-/****************************************************************
-*
-* This is a function that we provide for users that use ezcaSetMonitor().
-* If they set a monitor and go a long time without calling another 
-* ezca function, they could lose important values.  
-*
-* Now all they have to do is call this function which allows us to check
-* the monitors.
-*
-****************************************************************/
+        wp->rc = EZCA_INVALIDARG;
+        wp->error_msg = ErrorMsgs[INVALID_PVNAME_MSG_IDX];
+    } 
+    else if (!(wp->pvname = work_strdup(wp, pvname)))
+    {
+        wp->rc = EZCA_FAILEDMALLOC;
+        wp->error_msg = ErrorMsgs[FAILED_MALLOC_MSG_IDX];
+    }
+	else
+	{
 
-int epicsShareAPI ezcaDelay(float sec)
-{
+		switch ( worktype ) {
+			default:
+				wp->rc        = EZCA_INTERNALERR;
+				wp->error_msg = ErrorMsgs[INTERNALERR_MSG_IDX];
+			break;
 
-struct work *wp;
-int status;
-int rc;
-unsigned   attempt;
+			case GETCONTROLLIMITS:
+			case GETGRAPHICLIMITS:
+			case GETALARMLIMITS:
+			case GETWARNLIMITS:
+				ptrs[nptrs++] = (void*)&wp->d1p;
+				ptrs[nptrs++] = (void*)&wp->d2p;
+			break;
 
-    prologue();
+			case GETPRECISION:
+				ptrs[nptrs++] = (void*)&wp->s1p;
+			break;
 
-    if ((wp = get_work_single()))
-    {
-	ErrorLocation = SINGLEWORK;
+			case GETUNITS:
+			case GETENUMSTATES:
+				ptrs[nptrs++] = (void*)&wp->strp;
+			break;
 
-	/* filling work */
-	wp->worktype = DELAY;
+			case GETNELEM:
+				ptrs[nptrs++] = (void*)&wp->intp;
+			break;
 
-	if (sec > 0.)
-	{
-		RetryCount = (unsigned)(sec/TimeoutSeconds);
-		if ( RetryCount * TimeoutSeconds < sec )
-			RetryCount++;
-		for ( attempt=0, status = ECA_TIMEOUT;
-		     ECA_TIMEOUT == status && attempt<RetryCount && sec > 0;
-		     attempt++, sec-=TimeoutSeconds ) {
-	    	status = EzcaPendEvent((struct work *) NULL, sec > TimeoutSeconds ? TimeoutSeconds : sec, TRUE);
-			if ( ECA_TIMEOUT != status )
-				break;
+			case GETMETADATA:
+				ptrs[nptrs++] = (void*)&wp->pval;
+			break;
+
+			case GETSTATUS:
+				ptrs[nptrs++] = (void*)&wp->tsp;
+				ptrs[nptrs++] = (void*)&wp->status;
+				ptrs[nptrs++] = (void*)&wp->severity;
+				canGetFromMon = 1;
+			break;
 		}
 
-	    if (status == ECA_TIMEOUT)
-		{
-			/* normal return code */
-			if ( (wp->rc = RetryCount ? EZCA_OK : EZCA_ABORTED) )
-			{
-				wp->error_msg = ErrorMsgs[ABORTED_MSG_IDX];
+		va_start( ap, worktype );
+			for (i = 0; i<nptrs; i++ ) {
+				if ( ! (*ptrs[i] = va_arg(ap, void*)) ) {
+	    			wp->rc        = EZCA_INVALIDARG;
+	    			wp->error_msg = ErrorMsgs[INVALID_PBUFF_MSG_IDX];
+					break;
+				}
 			}
-		}
-	    else
-	    {
-		wp->rc = EZCA_CAFAILURE;
-		wp->error_msg = ErrorMsgs[CAPENDEVENT_MSG_IDX];
-		wp->aux_error_msg = strdup(ca_message(status));
-		if (AutoErrorMessage)
-		    print_error(wp);
-	    } /* endif */
+		va_end( ap );
 	}
-	else
-	{
-	    wp->rc = EZCA_INVALIDARG;
-	    wp->error_msg = ErrorMsgs[INVALID_ARG_MSG_IDX];
 
-	    if (AutoErrorMessage)
+	if ( wp->rc != EZCA_OK && AutoErrorMessage )
 		print_error(wp);
-	} /* endif */
 
-	rc = wp->rc;
-    }
-    else
-    {
-	rc = EZCA_FAILEDMALLOC;
+	if (InGroup)
+	    append_to_work_list(wp);
+	else if (wp->rc == EZCA_OK)
+	{
+	    /* all input args OK */
 
-	if (AutoErrorMessage)
-	    printf("%s\n", FAILED_MALLOC_MSG);
-    } /* endif */
+	    get_channel(wp, &cp);
 
-    epilogue();
-    return rc;
+	    if (cp)
+		{
+			/* everything OK so far ... otherwise something */
+			/* went wrong and it is already explained in wp */
+			if (EzcaConnected(cp))
+			{
+				/* channel is currently connected */
 
-} /* end ezcaDelay() */
+				if ( GETNELEM == worktype )
+				{
+					/* we dont have to do more; the info is already available
+					 * with the channel...
+					 */
+					*(wp->intp) = EzcaElementCount(cp);
+				}
+				else if ( GETENUMSTATES == worktype && DBF_ENUM != EzcaNativeType(cp) )
+				{
+					wp->strp[0] = 0;
+				}
+				else if ( GETMETADATA == worktype && DBF_STRING == EzcaNativeType(cp) )
+				{
+					meta_clear( (EzcaMetadataRec*)wp->pval );
+				}
+				else
+				{
 
-/****************************************************************
-*
-*
-****************************************************************/
+				    if ( !canGetFromMon || !get_from_monitor(wp, cp))
+					{
+						/* could not use or did not find an active   */
+						/* monitor that had a value                  */
+						/* need to do explicit get                   */
 
-void epicsShareAPI ezcaFree(void *buff)
-{
+						if ( canGetFromMon && (Trace || Debug) )
+							printf("%s: did not find an active monitor with a value\n", pvname);
 
-struct work *wp;
+						/* we are not really interested in the actual data,
+						 * just the sideband info. Request minimum of elements...
+						 */
+						wp->nelem = 1;
 
-    prologue();
+						if (issue_get(wp, cp))
+						{
+							/* a EzcaArrayGetCallback() */
+							/* was successfully  issued */
+							issue_wait(wp);
+							if (AutoErrorMessage && wp->rc != EZCA_OK)
+								print_error(wp);
+						} /* endif */
+					}
+				}
+			}
+			else
+			{
+				/* channel is not connected */
 
-    if ((wp = get_work_single()))
-    {
-	ErrorLocation = SINGLEWORK;
+				wp->rc = EZCA_NOTCONNECTED;
+				wp->error_msg = ErrorMsgs[NOT_CONNECTED_MSG_IDX];
 
-	/* filling work */
-	wp->worktype = FREEMEM;
-	wp->rc = EZCA_OK;
+				if (AutoErrorMessage)
+					print_error(wp);
+			} /* endif */
+		} /* endif */
 
-	if (buff)
-	    ezcafree(buff);
+		release_channel( &cp );
 
-	if (Debug)
-	    printf("ezcaFree() just freed starting\n");
+	} /* endif */
+
+	rc = wp->rc;
+	    
     }
     else
     {
+	rc = EZCA_FAILEDMALLOC;
+
 	if (AutoErrorMessage)
 	    printf("%s\n", FAILED_MALLOC_MSG);
     } /* endif */
 
     epilogue();
-} /* end ezcaFree() */
+    return rc;
 
-/****************************************************************
-*
-*
-****************************************************************/
+} /* end getInfo() */
 
-int epicsShareAPI ezcaGetRetryCount()
+int epicsShareAPI ezcaGetControlLimits(char *pvname, double *low, double *high)
 {
+	return getInfo(pvname, GETCONTROLLIMITS, low, high);
+}
 
-struct work *wp;
-int rc;
+int epicsShareAPI ezcaGetGraphicLimits(char *pvname, double *low, double *high)
+{
+	return getInfo(pvname, GETGRAPHICLIMITS, low, high);
+}
 
-    prologue();
+int epicsShareAPI ezcaGetWarnLimits(char *pvname, double *low, double *high)
+{
+	return getInfo(pvname, GETWARNLIMITS, low, high);
+}
 
-    if ((wp = get_work_single()))
-    {
-	ErrorLocation = SINGLEWORK;
+int epicsShareAPI ezcaGetAlarmLimits(char *pvname, double *low, double *high)
+{
+	return getInfo(pvname, GETALARMLIMITS, low, high);
+}
 
-	/* filling work */
-	wp->worktype = GETRETRYCOUNT;
-	wp->rc = EZCA_OK;
+int epicsShareAPI ezcaGetPrecision(char *pvname, short *precision)
+{
+	return getInfo(pvname, GETPRECISION, precision);
+}
 
-	rc  = (int) SavedRetryCount;
-    }
-    else
-    {
-	if (AutoErrorMessage)
-	    printf("%s\n", FAILED_MALLOC_MSG);
+int epicsShareAPI ezcaGetUnits(char *pvname, char *units)
+{
+	return getInfo(pvname, GETUNITS, units);
+}
 
-	rc = UNDEFINED;
+int epicsShareAPI ezcaGetNelem(char *pvname, int *nelem)
+{
+	return getInfo(pvname, GETNELEM, nelem);
+}
 
-    } /* endif */
+int epicsShareAPI ezcaGetStatus(char *pvname, epicsTimeStamp *timestamp, 
+    short *status, short *severity)
+{
+	return getInfo(pvname, GETSTATUS, timestamp, status, severity);
+}
 
-    epilogue();
-    return rc;
+int epicsShareAPI ezcaGetEnumStrings(char *pvname, char states[EZCA_ENUM_STATES][EZCA_ENUM_STRING_SIZE])
+{
+	return getInfo(pvname, GETENUMSTATES, states);
+}
 
-} /* end ezcaGetRetryCount() */
+int epicsShareAPI ezcaGetMetadata(char *pvname, EzcaMetadataRec *md)
+{
+	return getInfo(pvname, GETMETADATA, md);
+}
 
 /****************************************************************
 *
 *
 ****************************************************************/
 
-float epicsShareAPI ezcaGetTimeout()
+int epicsShareAPI ezcaGetWithStatus(char *pvname, char type, int nelem, 
+	void *buff, epicsTimeStamp *timestamp, short *status, short *severity)
 {
+	return getValue((struct channel *) NULL, pvname, GETWITHSTATUS, type,
+		nelem, buff, timestamp, status, severity);
+} /* end ezcaGetWithStatus() */
 
-struct work *wp;
-float rc;
-
-    prologue();
-
-    if ((wp = get_work_single()))
-    {
-	ErrorLocation = SINGLEWORK;
-
-	/* filling work */
-	wp->worktype = GETTIMEOUT;
-	wp->rc = EZCA_OK;
-
-	rc  = TimeoutSeconds;
-    }
-    else
-    {
-	if (AutoErrorMessage)
-	    printf("%s\n", FAILED_MALLOC_MSG);
-
-	rc = UNDEFINED;
-
-    } /* endif */
-
-    epilogue();
-    return rc;
-
-} /* end ezcaGetTimeout() */
+int epicsShareAPI ezcaGetWithStatusH(EzcaHandle h, char type, int nelem, 
+	void *buff, epicsTimeStamp *timestamp, short *status, short *severity)
+{
+	return getValue(H2CHANNEL(h), (char *) NULL, GETWITHSTATUS, type,
+		nelem, buff, timestamp, status, severity);
+} /* end ezcaGetWithStatusH() */
 
 /****************************************************************
 *
 *
 ****************************************************************/
 
-int epicsShareAPI ezcaPvToChid(char *pvname, chid **cid)
+/* ezcaPut() for PV names and handles (hcp is used if non-NULL) */
+static int
+putValue(struct channel *hcp, char *pvname, char type, int nelem, void *buff)
 {
 
 struct channel *cp;
 struct work *wp;
+int nbytes;
+unsigned attempts;
+BOOL reported, error;
 int rc;
 
     prologue();
 
-    if ((wp = get_work_single()))
+    if ((wp = get_work()))
     {
-	ErrorLocation = SINGLEWORK;
+
+	ErrorLocation = (InGroup ? LISTWORK : SINGLEWORK);
+	ListPrint = (InGroup ? LASTONLY : ListPrint);
 
 	/* filling work */
-	wp->worktype = PVTOCHID;
 
-	if (cid)
+	wp->worktype = PUT;
+	wp->ezcadatatype = type;
+	wp->nelem = nelem;
+
+	/* NOTE: must make a copy of the user's buffer here, not  */
+	/*       just point to what was given to us.  we must do  */
+	/*       this because this routine might have been called */
+	/*       inside a group and the user might want to re-use */
+	/*       the buffer immediately after our call.           */
+	/* NOTE ALSO: that this allocated memory must be free'd   */
+	/*            in ezcaEndGroup() and NOT in push_work()    */
+	/*            because in push_work() we cannot be sure    */
+	/*            that this was malloc'd by us.               */
+
+	if (buff && wp->nelem > 0)
 	{
-	    if (pvname)
+	    switch (wp->ezcadatatype)
 	    {
-		/* arguments are valid */
+		case ezcaByte: 
+		    nbytes = wp->nelem*dbr_value_size[DBR_CHAR];   break;
+		case ezcaString:
+		    nbytes = wp->nelem*dbr_value_size[DBR_STRING]; break;
+		case ezcaShort:
+		    nbytes = wp->nelem*dbr_value_size[DBR_SHORT];  break;
+		case ezcaLong:
+		    nbytes = wp->nelem*dbr_value_size[DBR_LONG];   break;
+		case ezcaFloat:
+		    nbytes = wp->nelem*dbr_value_size[DBR_FLOAT];  break;
+		case ezcaDouble:
+		    nbytes = wp->nelem*dbr_value_size[DBR_DOUBLE]; break;
+		default:
+		    /* error message printed later in ezcaEndGroup() */
+		    nbytes = 0;                                    break;
+	    } /* end switch() */
 
-		if ((wp->pvname = strdup(pvname)))
-		{
+	} 
+	else
+	    nbytes = 0;
 
-		    get_channel(wp, &cp);
+	if (nbytes > 0)
+	{
+	    if ((wp->pval = work_alloc(wp, (size_t) nbytes)))
+		memcpy((char *) (wp->pval), (char *) buff, nbytes);
+	}
+	else
+	    wp->pval = (void *) NULL;
 
-		    if (cp)
+	/* checking input args */
+	if (!check_target(wp, hcp, pvname))
+	{
+	    if (AutoErrorMessage)
+		print_error(wp);
+	}
+	else if (!VALID_EZCA_DATA_TYPE(wp->ezcadatatype))
+	{
+	    wp->rc = EZCA_INVALIDARG;
+	    wp->error_msg = ErrorMsgs[INVALID_TYPE_MSG_IDX];
+
+	    if (AutoErrorMessage)
+		print_error(wp);
+	} 
+	else if (wp->nelem <= 0)
+	{
+	    wp->rc = EZCA_INVALIDARG;
+	    wp->error_msg = ErrorMsgs[INVALID_NELEM_MSG_IDX];
+
+	    if (AutoErrorMessage)
+		print_error(wp);
+	}
+	else if (!(wp->pval))
+	{
+	    wp->rc = EZCA_INVALIDARG;
+	    wp->error_msg = ErrorMsgs[INVALID_PBUFF_MSG_IDX];
+
+	    if (AutoErrorMessage)
+		print_error(wp);
+	}
+	else
+	{
+	    /* arguments are valid */
+	    wp->rc = EZCA_OK;
+	} /* endif */
+
+	if (InGroup)
+	{
+	    if (hcp && wp->rc == EZCA_OK)
+		use_handle(hcp, &wp->cp);
+	    append_to_work_list(wp);
+	}
+	else if (wp->rc == EZCA_OK)
+	{
+	    /* all input args OK */
+	    if (hcp)
+		use_handle(hcp, &cp);
+	    else
+		get_channel(wp, &cp);
+
+	    if (cp)
+	    {
+		/* everything OK so far ... otherwise something */
+		/* went wrong and it is already explained in wp */
+
+		if (EzcaConnected(cp))
+		{
+		    /* channel is currently connected */
+
+		    if (wp->nelem <= (int)EzcaElementCount(cp))
 		    {
-			/* everything OK */
+			wp->reported = FALSE;
 
-			/* wp->rc set by get_channel() if something went bad */
-			/* NOTE:  error message printed by get_channel()     */
-			/*        also if AutoErrorMessage is set.           */
+			if (EzcaArrayPutCallback(wp, cp) == ECA_NORMAL)
+			{
+				MARK_OUTSTANDING(1);
 
-			wp->rc = EZCA_OK;
-			*cid = &(cp->cid);
-		    } /* endif */
+			    for (reported = error = FALSE, attempts = 0;
+				!reported && !error && attempts<=RetryCount;
+				    attempts ++)
+			    {
 
-			release_channel( &cp );
+				if (Trace || Debug)
+				    printf("ezcaPut(): attempt %d of %d\n", 
+					attempts+1, RetryCount+1);
+
+				if (EzcaPendEvent(wp, TimeoutSeconds, FALSE) 
+					== ECA_TIMEOUT)
+				    reported = wp->reported;
+				else
+				{
+				    /* something went wrong ... rc and */
+				    /* error msg have already been set */
+
+				    /* need to trash this wp so it's */
+				    /* never used again in case the  */
+				    /* callback fires off later      */
+
+				    error = TRUE;
+
+				    trash_work(wp);
+				} /* endif */
+			    } /* endfor */
+
+			    /* the callback may have come in just now */
+			    if (!reported && !error && !trash_unreported(wp))
+				reported = TRUE;
+
+			    if (reported)
+			    {
+				if (AutoErrorMessage && wp->rc != EZCA_OK)
+				    print_error(wp);
+			    }
+			    else
+			    {
+				if (!error)
+				{
+				    /* callback did not respond back */
+				    /* int time no value received    */
+
+				    /* need to trash this wp so it's */
+				    /* never used again in case the  */
+				    /* callback fires off later      */
+
+					if ( RetryCount )
+					{
+				    	wp->rc = EZCA_NOTIMELYRESPONSE;
+				    	wp->error_msg =
+						ErrorMsgs[NO_RESPONSE_IN_TIME_MSG_IDX];
+					}
+					else
+					{
+	            		wp->rc = EZCA_ABORTED;
+	            		wp->error_msg = ErrorMsgs[ABORTED_MSG_IDX];
+					}
+
+				    if (AutoErrorMessage)
+					print_error(wp);
+				} /* endif */
+			    } /* endif */
+			}
+			else
+			{
+			    /* something went wrong ... rc and */
+			    /* error msg have already been set */
+
+			    /* need to trash this wp so it's */
+			    /* never used again in case the  */
+			    /* callback fires off later      */
+
+			    wp->trashme = trashed;
+			    if (Debug)
+				printf("trashing wp\n");
+			} /* endif */
+		    }
+		    else
+		    {
+			/* too many elements requested */
+			wp->rc = EZCA_INVALIDARG;
+			wp->error_msg = ErrorMsgs[TOO_MANY_NELEM_MSG_IDX];
+
+			if (AutoErrorMessage)
+			    print_error(wp);
+		    } /* endif */
 		}
 		else
 		{
-		    wp->rc = EZCA_FAILEDMALLOC;
-		    wp->error_msg = ErrorMsgs[FAILED_MALLOC_MSG_IDX];
+		    /* channel is not connected */
+
+		    wp->rc = EZCA_NOTCONNECTED;
+		    wp->error_msg = ErrorMsgs[NOT_CONNECTED_MSG_IDX];
 
 		    if (AutoErrorMessage)
 			print_error(wp);
 		} /* endif */
-	    }
-	    else
-	    {
-		wp->rc = EZCA_INVALIDARG;
-		wp->error_msg = ErrorMsgs[INVALID_PVNAME_MSG_IDX];
-
-		if (AutoErrorMessage)
-		    print_error(wp);
 	    } /* endif */
-	}
-	else
-	{
-	    wp->rc = EZCA_INVALIDARG;
-	    wp->error_msg = ErrorMsgs[INVALID_PBUFF_MSG_IDX];
 
-	    if (AutoErrorMessage)
-		print_error(wp);
+		release_channel( &cp );
+
+	    /* no matter what happened ... */
+	    /* freeing malloc'd memory */
+	    if (wp->pval)
+	    {
+		work_free(wp, wp->pval);
+		wp->pval = (void *) NULL;
+	    } /* endif */
 	} /* endif */
 
 	rc = wp->rc;
+	    
     }
     else
     {
@@ -2377,35 +6732,94 @@ int rc;
     epilogue();
     return rc;
 
-} /* end ezcaPvToChid() */
+} /* end putValue() */
 
 /****************************************************************
 *
 *
 ****************************************************************/
 
-int epicsShareAPI ezcaSetMonitor(char *pvname, char type, unsigned long count)
+int epicsShareAPI ezcaPut(char *pvname, char type, int nelem, void *buff)
+{
+	return putValue((struct channel *) NULL, pvname, type, nelem, buff);
+} /* end ezcaPut() */
+
+int epicsShareAPI ezcaPutH(EzcaHandle h, char type, int nelem, void *buff)
+{
+	return putValue(H2CHANNEL(h), (char *) NULL, type, nelem, buff);
+} /* end ezcaPutH() */
+
+/****************************************************************
+*
+*
+****************************************************************/
+
+int epicsShareAPI ezcaPutOldCa(char *pvname, char type, int nelem, void *buff)
 {
 
 struct channel *cp;
-struct monitor *mp;
 struct work *wp;
-BOOL found;
+int nbytes;
 int rc;
 
     prologue();
 
-    if ((wp = get_work_single()))
+    if ((wp = get_work()))
     {
-	ErrorLocation = SINGLEWORK;
+
+	ErrorLocation = (InGroup ? LISTWORK : SINGLEWORK);
+	ListPrint = (InGroup ? LASTONLY : ListPrint);
 
 	/* filling work */
 
-	wp->worktype = SETMONITOR;
+	wp->worktype = PUTOLDCA;
 	wp->ezcadatatype = type;
+	wp->nelem = nelem;
 
-	/* checking input args */
+	/* NOTE: must make a copy of the user's buffer here, not  */
+	/*       just point to what was given to us.  we must do  */
+	/*       this because this routine might have been called */
+	/*       inside a group and the user might want to re-use */
+	/*       the buffer immediately after our call.           */
+	/* NOTE ALSO: that this allocated memory must be free'd   */
+	/*            in ezcaEndGroup() and NOT in push_work()    */
+	/*            because in push_work() we cannot be sure    */
+	/*            that this was malloc'd by us.               */
+
+	if (buff && wp->nelem > 0)
+	{
+	    switch (wp->ezcadatatype)
+	    {
+		case ezcaByte: 
+		    nbytes = wp->nelem*dbr_value_size[DBR_CHAR];   break;
+		case ezcaString:
+		    nbytes = wp->nelem*dbr_value_size[DBR_STRING]; break;
+		case ezcaShort:
+		    nbytes = wp->nelem*dbr_value_size[DBR_SHORT];  break;
+		case ezcaLong:
+		    nbytes = wp->nelem*dbr_value_size[DBR_LONG];   break;
+		case ezcaFloat:
+		    nbytes = wp->nelem*dbr_value_size[DBR_FLOAT];  break;
+		case ezcaDouble:
+		    nbytes = wp->nelem*dbr_value_size[DBR_DOUBLE]; break;
+		default:
+		    /* error message printed later in ezcaEndGroup() */
+		    nbytes = 0;                                    break;
+	    } /* end switch() */
+
+	} 
+	else
+	    nbytes = 0;
+
+	if (nbytes > 0)
+	{
+	    if ((wp->pval = work_alloc(wp, (size_t) nbytes)))
+		memcpy((char *) (wp->pval), (char *) buff, nbytes);
+	}
+	else
+	    wp->pval = (void *) NULL;
 
+	/* checking input args */
         if (!pvname)
         {
             wp->rc = EZCA_INVALIDARG;
@@ -2414,7 +6828,7 @@ int rc;
             if (AutoErrorMessage)
 		print_error(wp);
         } 
-        else if (!(wp->pvname = strdup(pvname)))
+        else if (!(wp->pvname = work_strdup(wp, pvname)))
         {
             wp->rc = EZCA_FAILEDMALLOC;
             wp->error_msg = ErrorMsgs[FAILED_MALLOC_MSG_IDX];
@@ -2430,13 +6844,31 @@ int rc;
 	    if (AutoErrorMessage)
 		print_error(wp);
 	} 
+	else if (wp->nelem <= 0)
+	{
+	    wp->rc = EZCA_INVALIDARG;
+	    wp->error_msg = ErrorMsgs[INVALID_NELEM_MSG_IDX];
+
+	    if (AutoErrorMessage)
+		print_error(wp);
+	}
+	else if (!(wp->pval))
+	{
+	    wp->rc = EZCA_INVALIDARG;
+	    wp->error_msg = ErrorMsgs[INVALID_PBUFF_MSG_IDX];
+
+	    if (AutoErrorMessage)
+		print_error(wp);
+	}
 	else
 	{
 	    /* arguments are valid */
 	    wp->rc = EZCA_OK;
 	} /* endif */
 
-	if (wp->rc == EZCA_OK)
+	if (InGroup)
+	    append_to_work_list(wp);
+	else if (wp->rc == EZCA_OK)
 	{
 	    /* all input args OK */
 	    get_channel(wp, &cp);
@@ -2446,151 +6878,46 @@ int rc;
 		/* everything OK so far ... otherwise something */
 		/* went wrong and it is already explained in wp */
 
-		/* loop to check monitor list for monitor of the same type */
-		mp = cp->monitor_list;
-		found = FALSE;
-		while (mp && !found)
-		    if (!(found = (wp->ezcadatatype == mp->ezcadatatype)))
-			mp = mp->right;
-
-		if (found)
-		{
-		    if (Trace || Debug)
-		printf("ezcaSetMonitor(): found monitor already existed\n");
-
-		    wp->rc = EZCA_OK;
-		}
-		else
+		if (EzcaConnected(cp))
 		{
-		    /* was not in the monitor list ... need to */
-		    /* place it there and start the monitor    */
+		    /* channel is currently connected */
 
-		    if (Trace || Debug)
-    printf("ezcaSetMonitor(): monitor did not exist. establishing one now\n");
-		    if ((mp = pop_monitor()))
+		    if (wp->nelem <= (int)EzcaElementCount(cp))
 		    {
-			/* filling the mp here because ca_pend_io() could   */
-			/* cause my_monitor_callback() go be executed and   */
-			/* we need a full mp there in order for it to work. */
-
-			mp->ezcadatatype = wp->ezcadatatype;
-
-			mp->cp = cp;
-
-			if (Debug)
-			{
-    printf("ezcaSetMonitor() channels before pushing monitor onto channel\n");
-			    print_channels();
-			} /* endif */
-
-			/* pushing the monitor onto the monitor list */
-			if (cp->monitor_list)
-			{
-			    /* non-empty list */
-			    mp->right = cp->monitor_list;
-			    (cp->monitor_list)->left = mp;
-			}
-			else
-			    /* empty list */
-			    mp->right = (struct monitor *) NULL;
-
-			mp->left = (struct monitor *) NULL;
-			cp->monitor_list = mp;
-
-			if (Debug)
-			{
-    printf("ezcaSetMonitor() channels after pushing monitor onto channel\n");
-			    print_channels();
-			} /* endif */
-
-			if (EzcaAddArrayEvent(wp, mp, count) == ECA_NORMAL)
-			{
-			    mp->active = TRUE;
-
-			    if (EzcaPendIO(wp, SHORT_TIME) == ECA_NORMAL)
-				wp->rc = EZCA_OK;
-			    else
-			    {
-				/* something went wrong ... rc and */
-				/* error msg have already been set */
-
-				mp->active = FALSE;
-
-				/* need to take mp off of cp->monitor_list */
-				/* should be on top.                       */
-				if (cp->monitor_list)
-				{
-				    if ((cp->monitor_list)->right)
-				    {
-					/* more than one in the list */
-					cp->monitor_list = 
-					    (cp->monitor_list)->right;
-					(cp->monitor_list)->left = 
-					    (struct monitor *) NULL;
-				    }
-				    else
-					/* only one in the list */
-					cp->monitor_list = 
-					    (struct monitor *) NULL;
-				}
-				else
-				{
-				    /* cannot be NULL ... just pushed      */
-				    /* a monitor something has gone wrong. */
-
-				    fprintf(stderr,
-	    "EZCA FATAL ERROR: ezcaSetMonitor() found NULL cp->monitor_list\n");
-				    exit(1);
-				} /* endif */
-
-				clean_and_push_monitor(mp);
-			    } /* endif */
-			}
-			else
-			{
-			    /* something went wrong ... rc and */
-			    /* error msg have already been set */
-
-			    /* need to take mp off of cp->monitor_list */
-			    /* should be on top.                       */
-			    if (cp->monitor_list)
-			    {
-				if ((cp->monitor_list)->right)
-				{
-				    /* more than one in the list */
-				    cp->monitor_list = 
-					(cp->monitor_list)->right;
-				    (cp->monitor_list)->left = 
-					(struct monitor *) NULL;
-				}
-				else
-				    /* only one in the list */
-				    cp->monitor_list = (struct monitor *) NULL;
-			    }
-			    else
-			    {
-				/* cannot be NULL ... just pushed a monitor */
-				/* something has gone wrong.                */
-
-				fprintf(stderr, 
-	"EZCA FATAL ERROR: ezcaSetMonitor() found NULL cp->monitor_list\n");
-				exit(1);
-			    } /* endif */
-
-			    clean_and_push_monitor(mp);
-
-			} /* endif */
+			if (EzcaArrayPut(wp, cp) == ECA_NORMAL)
+			    EzcaPendIO(wp, SHORT_TIME);
 		    }
 		    else
 		    {
-			wp->rc = EZCA_FAILEDMALLOC;
-			wp->error_msg = ErrorMsgs[FAILED_MALLOC_MSG_IDX];
+			/* too many elements requested */
+			wp->rc = EZCA_INVALIDARG;
+			wp->error_msg = ErrorMsgs[TOO_MANY_NELEM_MSG_IDX];
 
 			if (AutoErrorMessage)
 			    print_error(wp);
 		    } /* endif */
+		}
+		else
+		{
+		    /* channel is not connected */
+
+		    wp->rc = EZCA_NOTCONNECTED;
+		    wp->error_msg  = ErrorMsgs[NOT_CONNECTED_MSG_IDX];
+
+		    if (AutoErrorMessage)
+			print_error(wp);
 		} /* endif */
-		release_channel(&cp);
+	    } /* endif */
+
+
+		release_channel( &cp );
+
+	    /* no matter what happened ... */
+	    /* freeing malloc'd memory */
+	    if (wp->pval)
+	    {
+		work_free(wp, wp->pval);
+		wp->pval = (void *) NULL;
 	    } /* endif */
 	} /* endif */
 
@@ -2608,44 +6935,126 @@ int rc;
     epilogue();
     return rc;
 
-} /* end ezcaSetMonitor() */
+} /* end ezcaPutOldCa() */
 
 /****************************************************************
 *
 *
 ****************************************************************/
 
-int epicsShareAPI ezcaSetRetryCount(int retry)
-{
 
+int epicsShareAPI ezcaNewMonitorWait(char *pvname, char type)
+{
+struct channel *cp;
+struct monitor *mp;
 struct work *wp;
 int rc;
 
     prologue();
 
-    if ((wp = get_work_single()))
+    if ((wp = get_work()))
     {
-	ErrorLocation = SINGLEWORK;
+
+	ErrorLocation = (InGroup ? LISTWORK : SINGLEWORK);
+	ListPrint = (InGroup ? LASTONLY : ListPrint);
 
 	/* filling work */
-	wp->worktype = SETRETRYCOUNT;
 
-	if (retry >= 0)
+	wp->worktype = MONBLOCK;
+	wp->ezcadatatype = type;
+
+
+	/* checking input args */
+    if (!pvname)
 	{
-	    RetryCount = SavedRetryCount = (unsigned) retry;
+		wp->rc = EZCA_INVALIDARG;
+		wp->error_msg = ErrorMsgs[INVALID_PVNAME_MSG_IDX];
+	} 
+    else if (!(wp->pvname = work_strdup(wp, pvname)))
+	{
+		wp->rc = EZCA_FAILEDMALLOC;
+		wp->error_msg = ErrorMsgs[FAILED_MALLOC_MSG_IDX];
+	} 
+	else if (!VALID_EZCA_DATA_TYPE(wp->ezcadatatype))
+	{
+	    wp->rc = EZCA_INVALIDARG;
+	    wp->error_msg = ErrorMsgs[INVALID_TYPE_MSG_IDX];
+	} 
+	else
+	{
+	    /* arguments are valid */
+	    wp->rc = EZCA_OK;
+	} /* endif */
+
+	if (InGroup)
+	    append_to_work_list(wp);
+	else if (wp->rc == EZCA_OK)
+	{
+		if ((cp = find_channel(wp->pvname)))
+		{
+			mp = cp->monitor_list;
+			while (mp && ( ! (type == mp->ezcadatatype) || !mp->active))
+					mp = mp->right;
+
+			if (mp)
+			{
+				CHAN_LOCK(cp);
+				if ( !mp->needs_reading ) {
+					wp->reported = FALSE;
+	
+					if( mp->waiter ) {
+						fprintf(stderr,"EZCA FATAL ERROR: mp->waiter is already set\n");
+						exit(1);
+					}
+					mp->waiter   = wp;
+					CHAN_UNLOCK(cp);
+#ifdef DEBUG
+					printf("TSILL issueing wait\n");
+#endif
+					issue_wait(wp);
+#ifdef DEBUG
+					printf("DONE\n");
+#endif
+					CHAN_LOCK(cp);
+					mp->waiter   = (struct work *)NULL;
+					CHAN_UNLOCK(cp);
+				} else {
+					CHAN_UNLOCK(cp);
+#ifdef DEBUG
+				printf("TSILL no need to wait\n");
+#endif
+				}
+			}
+			else
+			{
+				/* no monitor */
+				wp->rc = EZCA_INVALIDARG;
+				wp->error_msg = ErrorMsgs[NO_MONITOR_MSG_IDX];
+
+				if (Trace || Debug)
+					printf("add_wait() found no monitor name >%s< type %d\n",
+							wp->pvname, type);
 
-	    wp->rc = EZCA_OK;
-	}
-	else
-	{
-	    wp->rc = EZCA_INVALIDARG;
-	    wp->error_msg = ErrorMsgs[INVALID_ARG_MSG_IDX];
+			} /* endif */
+			release_channel(&cp);
+		}
+		else
+		{
+			/* no channel */
+			wp->rc = EZCA_INVALIDARG;
+			wp->error_msg = ErrorMsgs[INVALID_PVNAME_MSG_IDX];
 
-	    if (AutoErrorMessage)
-		print_error(wp);
+			if (Trace || Debug)
+				printf("add_wait() found no channel name >%s< type %d\n",
+						pvname, type);
+		} /* endif */
 	} /* endif */
 
 	rc = wp->rc;
+
+	if ( AutoErrorMessage && EZCA_OK != wp->rc )
+		print_error(wp);
+	    
     }
     else
     {
@@ -2658,2281 +7067,2246 @@ int rc;
     epilogue();
     return rc;
 
-} /* end ezcaSetRetryCount() */
+} /* end ezcaNewMonitorWait() */
+
+/*******************/
+/*                 */
+/* Local Functions */
+/*                 */
+/*******************/
+
+/*************/
+/*           */
+/* Utilities */
+/*           */
+/*************/
 
 /****************************************************************
 *
 *
 ****************************************************************/
 
-int epicsShareAPI ezcaSetTimeout(float sec)
+static void append_to_work_list(struct work *wp)
 {
 
-struct work *wp;
-int rc;
-
-    prologue();
-
-    if ((wp = get_work_single()))
+    if (wp)
     {
-	ErrorLocation = SINGLEWORK;
-
-	/* filling work */
-	wp->worktype = SETTIMEOUT;
-
-	if (sec > 0)
+	if (Work_list.tail)
 	{
-	    TimeoutSeconds = sec;
-
-	    wp->rc = EZCA_OK;
+	    /* non-empty list */
+	    Work_list.tail->next = wp;
+	    Work_list.tail = wp;
 	}
 	else
 	{
-	    wp->rc = EZCA_INVALIDARG;
-	    wp->error_msg = ErrorMsgs[INVALID_ARG_MSG_IDX];
-
-	    if (AutoErrorMessage)
-		print_error(wp);
+	    /* empty list */
+	    Work_list.head = wp;
+	    Work_list.tail = wp;
 	} /* endif */
-
-	rc = wp->rc;
-    }
-    else
-    {
-	rc = EZCA_FAILEDMALLOC;
-
-	if (AutoErrorMessage)
-	    printf("%s\n", FAILED_MALLOC_MSG);
     } /* endif */
 
-    epilogue();
-    return rc;
-
-} /* end ezcaSetTimeout() */
+} /* end append_to_work_list() */
 
 /****************************************************************
 *
+* really should be in tsDefs.h
 *
 ****************************************************************/
 
-int epicsShareAPI ezcaStartGroup()
+static void copy_time_stamp(epicsTimeStamp *dest, epicsTimeStamp *src)
 {
 
-struct work *wp;
-int rc;
-
-    prologue();
-
-    if ((wp = get_work_single()))
-    {
-	ErrorLocation = SINGLEWORK;
-
-	/* filling work */
-	wp->worktype = STARTGROUP;
-
-	if (InGroup)
-	{
-	    /* already in a group */
-	    wp->rc = EZCA_INGROUP;
-	    wp->error_msg = ErrorMsgs[INGROUP_MSG_IDX];
-
-	    if (AutoErrorMessage)
-		print_error(wp);
-	}
-	else
-	{
-	    /* not in a group */
-
-	    if (Trace || Debug)
-	printf("ezcaStartGroup() about to empty_work_list() and set InGroup\n");
-
-	    empty_work_list();
-
-	    InGroup = TRUE;
-
-	    wp->rc = EZCA_OK;
-
-	} /* endif */
-
-	rc = wp->rc;
-    }
-    else
+    if (dest && src)
     {
-	rc = EZCA_FAILEDMALLOC;
-
-	if (AutoErrorMessage)
-	    printf("%s\n", FAILED_MALLOC_MSG);
-
+	dest->secPastEpoch = src->secPastEpoch;
+	dest->nsec = src->nsec;
     } /* endif */
 
-    epilogue();
-    return rc;
+} /* end copy_time_stamp() */
 
-} /* end ezcaStartGroup() */
+/****************************************************************
+*
+* returns 'n' bytes (aligned for any basic type) from arena 'a'
+* or NULL if no memory is available. Blocks grow geometrically
+* so that filling an arena takes O(log(size)) allocations.
+*
+****************************************************************/
 
-int epicsShareAPI ezcaClearChannel(char *pvname)
+static void *arena_alloc(struct arena *a, size_t n)
 {
 
-struct channel *cp = 0;
-struct work *wp;
-int rc;
-
-    prologue();
-
-    if ((wp = get_work_single()))
-    {
-	ErrorLocation = SINGLEWORK;
+struct arena_blk *b = a->blks;
+size_t sz;
+void *rval;
 
-	/* filling work */
-	wp->worktype = CLEARCHANNEL;
+    n = ARENA_ROUND(n);
 
-    if (!pvname || !(cp=find_channel(pvname)))
+    if (!b || b->size - b->used < n)
     {
-        wp->rc = EZCA_INVALIDARG;
-        wp->error_msg = ErrorMsgs[INVALID_PVNAME_MSG_IDX];
-
-        if (AutoErrorMessage)
-			print_error(wp);
-    }
-	else if (InGroup)
-	{
-	    /* already in a group */
-	    wp->rc = EZCA_INGROUP;
-	    wp->error_msg = ErrorMsgs[INGROUP_MSG_IDX];
-
-	    if (AutoErrorMessage)
-			print_error(wp);
-	}
-	else
-	{
-	    /* not in a group */
-
-
-		if ( cp ) {
-	    if (Trace || Debug)
-	printf("ezcaClearChannel() about to call clean_and_push_channel()\n");
-			clean_and_push_channel( &cp );
-	    	wp->rc = EZCA_OK;
-		}
-	} /* endif */
+	/* the first block of a group may be sized to last time's needs */
+	sz = (b ? a->total : a->hint);
+	if (sz < ARENA_BLKSIZE)
+	    sz = ARENA_BLKSIZE;
+	if (sz < n)
+	    sz = n;
 
-	rc = wp->rc;
-    }
-    else
-    {
-	rc = EZCA_FAILEDMALLOC;
+	if (!(b = (struct arena_blk *) ezcamalloc((unsigned) (ARENA_HDR + sz))))
+	    return (void *) NULL;
 
-	if (AutoErrorMessage)
-	    printf("%s\n", FAILED_MALLOC_MSG);
+	WorkAllocs++;
 
+	b->next = a->blks;
+	b->size = sz;
+	b->used = 0;
+	a->blks = b;
+	a->total += sz;
     } /* endif */
 
-	/* if clean_and_push_channel() was successful, cp is NULL at this point */
-	release_channel( &cp );
-
-    epilogue();
-    return rc;
+    rval = (char *) b + ARENA_HDR + b->used;
+    b->used += n;
 
-} /* end ezcaClearChannel() */
+    return rval;
 
-/* clear all channels */
-int epicsShareAPI ezcaPurge(int disconnectedOnly)
-{
+} /* end arena_alloc() */
 
-struct channel *cp;
-struct work *wp;
-int rc,i;
+/****************************************************************
+*
+* releases everything allocated from 'a'. A single block is kept
+* for the next group (unless it is huge); several blocks are
+* freed and replaced by one of their total size when next needed.
+*
+****************************************************************/
 
-    prologue();
+static void arena_reset(struct arena *a)
+{
 
-    if ((wp = get_work_single()))
+    if (a->blks && !a->blks->next && a->total <= ARENA_KEEP)
     {
-	ErrorLocation = SINGLEWORK;
-
-	/* filling work */
-	wp->worktype = CLEARCHANNEL;
+	a->blks->used = 0;
+	return;
+    } /* endif */
 
-	if (InGroup)
-	{
-	    /* already in a group */
-	    wp->rc = EZCA_INGROUP;
-	    wp->error_msg = ErrorMsgs[INGROUP_MSG_IDX];
+    a->hint = (a->total <= ARENA_KEEP ? a->total : 0);
 
-	    if (AutoErrorMessage)
-			print_error(wp);
-	}
-	else
-	{
-	    /* not in a group */
-		for ( i = 0; i < HASHTABLESIZE; i++ ) {
-			for ( cp = Channels[i]; cp; ) {
-				if ( !disconnectedOnly || !EzcaConnected(cp) ) {
-					if ( cp->refcnt ) {
-						fprintf(stderr,"EZCA FATAL ERROR: ezcaClearChannel() -- refcnt is not 0\n");
-						exit(1);
-					}
-					/* normal get_channel() or find_channel() increment the
-					 * refcnt...
-					 */
-					cp->refcnt++;
-					clean_and_push_channel(&cp);
-					/* start over */
-					cp = Channels[i];
-				} else {
-					cp = cp->next;
-				}
-			}
-		}
+    arena_free(a);
 
-	   	wp->rc = EZCA_OK;
-	} /* endif */
+} /* end arena_reset() */
 
-	rc = wp->rc;
-    }
-    else
-    {
-	rc = EZCA_FAILEDMALLOC;
+/****************************************************************
+*
+* gives all blocks of 'a' back to the heap
+*
+****************************************************************/
 
-	if (AutoErrorMessage)
-	    printf("%s\n", FAILED_MALLOC_MSG);
+static void arena_free(struct arena *a)
+{
 
-    } /* endif */
+struct arena_blk *b;
 
-    epilogue();
-    return rc;
+    while ((b = a->blks))
+    {
+	a->blks = b->next;
+	ezcafree((char *) b);
+    } /* endwhile */
 
-} /* end ezcaClearChannel() */
+    a->total = 0;
 
+} /* end arena_free() */
 
 /****************************************************************
 *
-* Available, but not advertised.
+* memory and strings hanging off a work node; those of grouped
+* work come from Group_arena (or the arena of the async group
+* owning the node) and are never freed individually.
 *
 ****************************************************************/
 
-void epicsShareAPI ezcaTraceOff()
+static void *work_alloc(struct work *wp, size_t n)
 {
 
-struct work *wp;
+void *rval;
+
+    if (wp->in_arena)
+	return arena_alloc(wp->ticket ? &wp->ticket->arena : &wp->ctx->group_arena, n);
+
+    if ((rval = (void *) ezcamalloc((unsigned) n)))
+	WorkAllocs++;
+
+    return rval;
 
-    prologue();
+} /* end work_alloc() */
 
-    if ((wp = get_work_single()))
-    {
-	ErrorLocation = SINGLEWORK;
+static char *work_strdup(struct work *wp, const char *str)
+{
 
-	/* filling work */
-	wp->worktype = TRACEOFF;
-	wp->rc = EZCA_OK;
+size_t n = strlen(str) + 1;
+char *rval;
 
-	if (Trace || Debug)
-	    printf("clearing Trace\n");
+    if ((rval = (char *) work_alloc(wp, n)))
+	memcpy(rval, str, n);
 
-	Trace = FALSE;
-    }
-    else
-    {
-	if (AutoErrorMessage)
-	    printf("%s\n", FAILED_MALLOC_MSG);
-    } /* endif */
+    return rval;
 
-    epilogue();
-} /* end ezcaTraceOff() */
+} /* end work_strdup() */
+
+static void work_free(struct work *wp, void *p)
+{
+    if (!wp->in_arena)
+	ezcafree((char *) p);
+} /* end work_free() */
 
 /****************************************************************
 *
-* Available, but not advertised.
 *
 ****************************************************************/
 
-void epicsShareAPI ezcaTraceOn()
+static void empty_work_list()
 {
 
 struct work *wp;
 
-    prologue();
+    if (Debug)
+    {
+	printf("entering empty_work_list()\n");
+	print_state();
+    } /* endif */
 
-    if ((wp = get_work_single()))
+    if (Work_list_group)
     {
-	ErrorLocation = SINGLEWORK;
+	/* the nodes belong to a prepared group */
+	detach_group(Work_list_group);
+    }
+    else
+    {
+	wp = Work_list.head;
+	while (wp)
+	{
+	    Work_list.head = wp->next;
+	    /* group was never ended; drop references taken from handles */
+	    release_channel(&wp->cp);
+	    push_work(wp);
+	    wp = Work_list.head;
+	} /* endwhile */
 
-	/* filling work */
-	wp->worktype = TRACEON;
-	wp->rc = EZCA_OK;
+	Work_list.head = (struct work *) NULL;
+	Work_list.tail = (struct work *) NULL;
+    } /* endif */
 
-	Trace = TRUE;
+    /* all strings of the list's nodes at once */
+    arena_reset(&Group_arena);
 
-	if (Trace || Debug)
-	    printf("setting Trace\n");
-    }
-    else
+    if (Debug)
     {
-	if (AutoErrorMessage)
-	    printf("%s\n", FAILED_MALLOC_MSG);
+	printf("work_list and work_avail after\n");
+	print_state();
     } /* endif */
 
-    epilogue();
-} /* end ezcaTraceOn() */
-
-/**************************************************************/
-/*                                                            */
-/* Groupable Work Functions                                   */
-/*                                                            */
-/* These allocate work,so they store error msgs.  They may    */
-/* change ErrorLocation.                                      */
-/* These are executed with respect to InGroup context.        */
-/*                                                            */
-/**************************************************************/
+} /* end empty_work_list() */
 
 /****************************************************************
 *
+* absolute deadlines for async groups and for waiting for them
 *
 ****************************************************************/
 
-int epicsShareAPI ezcaGet(char *pvname, char type, int nelem, void *buff)
+static void set_deadline(Deadline_t *d, double sec)
 {
 
-struct work *wp;
-struct channel *cp;
-int rc;
+#ifdef EPICS_THREE_FOURTEEN
+    epicsTimeGetCurrent(d);
+    epicsTimeAddSeconds(d, sec);
+#else
+time_t whole = (time_t) sec;
 
-    prologue();
+    /* round up; we only have a resolution of one second */
+    *d = time( (time_t *) NULL ) + whole + (sec > (double) whole ? 1 : 0);
+#endif
 
-    if ((wp = get_work()))
-    {
+} /* end set_deadline() */
 
-	ErrorLocation = (InGroup ? LISTWORK : SINGLEWORK);
-	ListPrint = (InGroup ? LASTONLY : ListPrint);
+static double time_left(Deadline_t *d)
+{
 
-	/* filling work */
-	wp->worktype = GET;
+#ifdef EPICS_THREE_FOURTEEN
+epicsTimeStamp now;
 
-	wp->ezcadatatype = type;
-	wp->nelem = nelem;
-	wp->pval = buff;
+    epicsTimeGetCurrent(&now);
+    return epicsTimeDiffInSeconds(d, &now);
+#else
+    return difftime(*d, time( (time_t *) NULL ));
+#endif
 
-	/* checking input args */
-        if (!pvname)
-        {
-            wp->rc = EZCA_INVALIDARG;
-            wp->error_msg = ErrorMsgs[INVALID_PVNAME_MSG_IDX];
+} /* end time_left() */
 
-            if (AutoErrorMessage)
-		print_error(wp);
-        } 
-        else if (!(wp->pvname = strdup(pvname)))
-        {
-            wp->rc = EZCA_FAILEDMALLOC;
-            wp->error_msg = ErrorMsgs[FAILED_MALLOC_MSG_IDX];
+static double time_diff(Deadline_t *later, Deadline_t *earlier)
+{
 
-            if (AutoErrorMessage)
-		print_error(wp);
-        } 
-	else if (!VALID_EZCA_DATA_TYPE(wp->ezcadatatype))
-	{
-	    wp->rc = EZCA_INVALIDARG;
-            wp->error_msg = ErrorMsgs[INVALID_TYPE_MSG_IDX];
+#ifdef EPICS_THREE_FOURTEEN
+    return epicsTimeDiffInSeconds(later, earlier);
+#else
+    return difftime(*later, *earlier);
+#endif
 
-	    if (AutoErrorMessage)
-		print_error(wp);
-	} 
-	else if (wp->nelem <= 0)
-	{
-	    wp->rc = EZCA_INVALIDARG;
-            wp->error_msg = ErrorMsgs[INVALID_NELEM_MSG_IDX];
+} /* end time_diff() */
 
-	    if (AutoErrorMessage)
-		print_error(wp);
-	}
-	else if (!(wp->pval))
-	{
-	    wp->rc = EZCA_INVALIDARG;
-            wp->error_msg = ErrorMsgs[INVALID_PBUFF_MSG_IDX];
+/****************************************************************
+*
+* Books the round trip of a request issued at 'issued' (stamped
+* with set_deadline(&issued, 0.)) in the latency histogram of
+* the channel. Called with the channel lock held.
+*
+****************************************************************/
 
-	    if (AutoErrorMessage)
-		print_error(wp);
-	}
-	else
-	{
-	    /* arguments are valid ... EZCA_OK for now */
-	    wp->rc = EZCA_OK;
-	} /* endif */
+static void record_round_trip(struct channel *cp, Deadline_t *issued)
+{
 
-	if (InGroup)
-	    append_to_work_list(wp);
-	else if (wp->rc == EZCA_OK)
-	{
-	    /* all input args OK */
+struct chanstats *sp = &cp->stats;
+double dt = -time_left(issued);
+double lim = EZCA_STATS_BIN0;
+int i;
 
-	    get_channel(wp, &cp);
+    for (i = 0; i < EZCA_STATS_NBINS - 1 && dt >= lim; i++)
+	lim *= 2.;
 
-	    if (cp)
-	    {
-		/* everything OK so far ... otherwise something */
-		/* went wrong and it is already explained in wp */
+    sp->latency[i]++;
+    sp->nlatency++;
+    sp->latency_sum += dt;
+    if (dt > sp->latency_max)
+	sp->latency_max = dt;
 
-		if (EzcaConnected(cp))
-		{
-		    /* channel is currently connected */
-		    if (!get_from_monitor(wp, cp))
-		    {
-			/* did not find an active   */
-			/* monitor that had a value */
-			/* need to do explicit get  */
+} /* end record_round_trip() */
 
-			if (Trace || Debug)
-	    printf("ezcaGet(): did not find an active monitor with a value\n");
+/****************************************************************
+*
+* returns 't' if it is a ticket which has not been collected
+* yet, NULL otherwise
+*
+****************************************************************/
 
-			if (issue_get(wp, cp))
-			{
-			    /* a EzcaArrayGetCallback() */
-			    /* was successfully  issued */
-			    issue_wait(wp);
-			    if (AutoErrorMessage && wp->rc != EZCA_OK)
-				print_error(wp);
-			} /* endif */
-		    } /* endif */
-		}
-		else
-		{
-		    /* channel is not connected */
+static EzcaTicket find_ticket(EzcaTicket t)
+{
 
-		    wp->rc = EZCA_NOTCONNECTED;
-		    wp->error_msg = ErrorMsgs[NOT_CONNECTED_MSG_IDX];
+EzcaTicket p;
 
-		    if (AutoErrorMessage)
-			print_error(wp);
-		} /* endif */
-	    } /* endif */
+    for (p = Tickets; p && p != t; p = p->next)
+	;
 
-		release_channel( &cp );
+    return p;
 
-	} /* endif */
+} /* end find_ticket() */
 
-	rc = wp->rc;
-    }
-    else
-    {
-	rc = EZCA_FAILEDMALLOC;
+/****************************************************************
+*
+* called when a request of an async group has reported; get and
+* put callbacks don't hold the library mutex (the count may go
+* negative until ticket_issued() has added the total)
+*
+****************************************************************/
 
-	if (AutoErrorMessage)
-	    printf("%s\n", FAILED_MALLOC_MSG);
-    } /* endif */
+static void ticket_done(EzcaTicket t)
+{
 
-    epilogue();
-    return rc;
+#ifdef EPICS_THREE_FOURTEEN
+    epicsMutexLock(ezcaCountMutex);
+    if (0 == --t->outstanding)
+	epicsEventSignal(ezcaTicketDone);
+    epicsMutexUnlock(ezcaCountMutex);
+#else
+    t->outstanding--;
+#endif
 
-} /* end ezcaGet() */
+} /* end ticket_done() */
 
 /****************************************************************
 *
+* adds the # of requests issued for an async group
 *
 ****************************************************************/
 
-static int
-getInfo(char *pvname, char worktype, ...)
+static void ticket_issued(EzcaTicket t, int n)
 {
 
-struct work *wp;
-struct channel *cp;
-int rc;
-va_list ap;
-void    **ptrs[4];
-int     nptrs = 0;
-int     i;
-int     canGetFromMon = 0;
-
+#ifdef EPICS_THREE_FOURTEEN
+    epicsMutexLock(ezcaCountMutex);
+    if (0 == (t->outstanding += n) && n)
+	epicsEventSignal(ezcaTicketDone);
+    epicsMutexUnlock(ezcaCountMutex);
+#else
+    t->outstanding += n;
+#endif
 
-    prologue();
+} /* end ticket_issued() */
 
-    if ((wp = get_work()))
-    {
+/****************************************************************
+*
+* An async group is over once all its requests have reported or
+* its deadline has passed; the final rcs are then assigned right
+* away (so that late callbacks are ignored). Returns TRUE if the
+* group is over.
+*
+****************************************************************/
 
-	ErrorLocation = (InGroup ? LISTWORK : SINGLEWORK);
-	ListPrint = (InGroup ? LASTONLY : ListPrint);
+static BOOL test_ticket(EzcaTicket t)
+{
 
-	/* filling work */
+    if (!t->finished && (t->outstanding <= 0 || time_left(&t->deadline) <= 0.))
+    {
+	/* finish_group() may release the library mutex */
+	t->finished = TRUE;
+	finish_group(t->work.head, ECA_TIMEOUT);
+    } /* endif */
 
-	wp->worktype = worktype;
-	wp->rc       = EZCA_OK;
+    return t->finished;
 
-	/* checking input args */
-    if (!pvname)
-    {
-        wp->rc = EZCA_INVALIDARG;
-        wp->error_msg = ErrorMsgs[INVALID_PVNAME_MSG_IDX];
-    } 
-    else if (!(wp->pvname = strdup(pvname)))
-    {
-        wp->rc = EZCA_FAILEDMALLOC;
-        wp->error_msg = ErrorMsgs[FAILED_MALLOC_MSG_IDX];
-    }
-	else
-	{
+} /* end test_ticket() */
 
-		switch ( worktype ) {
-			default:
-				wp->rc        = EZCA_INTERNALERR;
-				wp->error_msg = ErrorMsgs[INTERNALERR_MSG_IDX];
-			break;
+/****************************************************************
+*
+* Wait until one of the (non-NULL) tickets in ts[0..n-1] is over
+* but no longer than 'timeout' seconds (forever if < 0 - i.e.,
+* until the deadline of the tickets). Returns the index of a
+* ticket that is over or -1 if none is (timeout or ezcaAbort()).
+*
+****************************************************************/
 
-			case GETCONTROLLIMITS:
-			case GETGRAPHICLIMITS:
-			case GETALARMLIMITS:
-			case GETWARNLIMITS:
-				ptrs[nptrs++] = (void*)&wp->d1p;
-				ptrs[nptrs++] = (void*)&wp->d2p;
-			break;
+static int wait_tickets(EzcaTicket *ts, int n, float timeout)
+{
 
-			case GETPRECISION:
-				ptrs[nptrs++] = (void*)&wp->s1p;
-			break;
+Deadline_t until;
+unsigned attempts;
+double left, l;
+float sec;
+int i;
 
-			case GETUNITS:
-			case GETENUMSTATES:
-				ptrs[nptrs++] = (void*)&wp->strp;
-			break;
+    if (timeout >= 0.)
+	set_deadline(&until, (double) timeout);
 
-			case GETNELEM:
-				ptrs[nptrs++] = (void*)&wp->intp;
-			break;
+    for (attempts = 0; ; attempts++)
+    {
+	left = 0.;
 
-			case GETSTATUS:
-				ptrs[nptrs++] = (void*)&wp->tsp;
-				ptrs[nptrs++] = (void*)&wp->status;
-				ptrs[nptrs++] = (void*)&wp->severity;
-				canGetFromMon = 1;
-			break;
-		}
+	for (i = 0; i < n; i++)
+	{
+	    if (!ts[i])
+		continue;
 
-		va_start( ap, worktype );
-			for (i = 0; i<nptrs; i++ ) {
-				if ( ! (*ptrs[i] = va_arg(ap, void*)) ) {
-	    			wp->rc        = EZCA_INVALIDARG;
-	    			wp->error_msg = ErrorMsgs[INVALID_PBUFF_MSG_IDX];
-					break;
-				}
-			}
-		va_end( ap );
-	}
+	    if (test_ticket(ts[i]))
+		return i;
 
-	if ( wp->rc != EZCA_OK && AutoErrorMessage )
-		print_error(wp);
+	    if ((l = time_left(&ts[i]->deadline)) > left)
+		left = l;
+	} /* endfor */
 
-	if (InGroup)
-	    append_to_work_list(wp);
-	else if (wp->rc == EZCA_OK)
-	{
-	    /* all input args OK */
+	if (timeout >= 0. && (l = time_left(&until)) < left)
+	    left = l;
 
-	    get_channel(wp, &cp);
+	/* ezcaAbort() zeroes RetryCount; the first slice always runs */
+	if (left <= 0. || (attempts && !RetryCount))
+	    break;
 
-	    if (cp)
-		{
-			/* everything OK so far ... otherwise something */
-			/* went wrong and it is already explained in wp */
-			if (EzcaConnected(cp))
-			{
-				/* channel is currently connected */
+	if ( pollCb && pollCb() )
+	    continue;
 
-				if ( GETNELEM == worktype )
-				{
-					/* we dont have to do more; the info is already available
-					 * with the channel...
-					 */
-					*(wp->intp) = EzcaElementCount(cp);
-				}
-				else if ( DBF_ENUM != EzcaNativeType(wp->cp) )
-				{
-					wp->strp[0] = 0;
-				}
-				else
-				{
+	/* wait in slices so that ezcaAbort() is honored */
+	sec = (left < TimeoutSeconds ? (float) left : TimeoutSeconds);
 
-				    if ( !canGetFromMon || !get_from_monitor(wp, cp))
-					{
-						/* could not use or did not find an active   */
-						/* monitor that had a value                  */
-						/* need to do explicit get                   */
+	if (Trace || Debug)
+	    printf("wait_tickets(): waiting %f s\n", sec);
 
-						if ( canGetFromMon && (Trace || Debug) )
-							printf("%s: did not find an active monitor with a value\n", pvname);
+#ifdef EPICS_THREE_FOURTEEN
+EZCA_UNLOCK();
+	/* we may wake up early (stale 'ezcaTicketDone'); we just recheck */
+	EZCA_TRACE(EZCA_EV_WAIT_START, ezcaTicketDone, 0, sec * 1000.);
+	epicsEventWaitWithTimeout(ezcaTicketDone, sec);
+	EZCA_TRACE(EZCA_EV_WAIT_END, ezcaTicketDone, 0, 0);
+EZCA_LOCK();
+#else
+	if (sec > TICKET_POLL_TIME)
+	    sec = TICKET_POLL_TIME;
+EZCA_UNLOCK();
+	ca_pend_event(sec);
+EZCA_LOCK();
+#endif
+    } /* endfor */
 
-						/* we are not really interested in the actual data,
-						 * just the sideband info. Request minimum of elements...
-						 */
-						wp->nelem = 1;
+    return -1;
 
-						if (issue_get(wp, cp))
-						{
-							/* a EzcaArrayGetCallback() */
-							/* was successfully  issued */
-							issue_wait(wp);
-							if (AutoErrorMessage && wp->rc != EZCA_OK)
-								print_error(wp);
-						} /* endif */
-					}
-				}
-			}
-			else
-			{
-				/* channel is not connected */
+} /* end wait_tickets() */
 
-				wp->rc = EZCA_NOTCONNECTED;
-				wp->error_msg = ErrorMsgs[NOT_CONNECTED_MSG_IDX];
+/****************************************************************
+*
+* Gives back the work nodes (and their channel references) and
+* the memory of an async group.
+*
+****************************************************************/
 
-				if (AutoErrorMessage)
-					print_error(wp);
-			} /* endif */
-		} /* endif */
+static void free_ticket(EzcaTicket t)
+{
 
-		release_channel( &cp );
+EzcaTicket *pp;
+struct work *wp;
 
+    for (pp = &Tickets; *pp; pp = &(*pp)->next)
+    {
+	if (*pp == t)
+	{
+	    *pp = t->next;
+	    break;
 	} /* endif */
+    } /* endfor */
 
-	rc = wp->rc;
-	    
-    }
-    else
+    while ((wp = t->work.head))
     {
-	rc = EZCA_FAILEDMALLOC;
+	t->work.head = wp->next;
+	release_channel(&wp->cp);
+	push_work(wp);
+    } /* endwhile */
 
-	if (AutoErrorMessage)
-	    printf("%s\n", FAILED_MALLOC_MSG);
-    } /* endif */
+    arena_free(&t->arena);
 
-    epilogue();
-    return rc;
+    ezcafree((char *) t);
 
-} /* end getInfo() */
+} /* end free_ticket() */
 
-int epicsShareAPI ezcaGetControlLimits(char *pvname, double *low, double *high)
-{
-	return getInfo(pvname, GETCONTROLLIMITS, low, high);
-}
+/****************************************************************
+*
+* takes the work nodes of a prepared group off the work list of
+* the context it is attached to and gives them back to the group.
+* Trashed nodes (a callback might still fire for them) go to
+* Discarded_work and are replaced by the next ezcaExecuteGroup().
+*
+****************************************************************/
 
-int epicsShareAPI ezcaGetGraphicLimits(char *pvname, double *low, double *high)
+static void detach_group(EzcaGroup g)
 {
-	return getInfo(pvname, GETGRAPHICLIMITS, low, high);
-}
 
-int epicsShareAPI ezcaGetWarnLimits(char *pvname, double *low, double *high)
-{
-	return getInfo(pvname, GETWARNLIMITS, low, high);
-}
+struct context *cx = g->attached;
+int i;
 
-int epicsShareAPI ezcaGetAlarmLimits(char *pvname, double *low, double *high)
-{
-	return getInfo(pvname, GETALARMLIMITS, low, high);
-}
+    for (i = 0; i < g->nwork; i++)
+    {
+	if (g->work[i] && trashed == g->work[i]->trashme)
+	{
+	    if (Debug)
+		printf("detach_group() discarding trashed wp %p\n", g->work[i]);
 
-int epicsShareAPI ezcaGetPrecision(char *pvname, short *precision)
-{
-	return getInfo(pvname, GETPRECISION, precision);
-}
+	    push_work(g->work[i]);
+	    g->work[i] = (struct work *) NULL;
+	}
+	else if (g->work[i])
+	{
+	    /* about to go with the arena */
+	    g->work[i]->aux_error_msg = (char *) NULL;
+	} /* endif */
+    } /* endfor */
 
-int epicsShareAPI ezcaGetUnits(char *pvname, char *units)
-{
-	return getInfo(pvname, GETUNITS, units);
-}
+    cx->work_list.head = (struct work *) NULL;
+    cx->work_list.tail = (struct work *) NULL;
+    cx->work_list_group = (EzcaGroup) NULL;
+    g->attached = (struct context *) NULL;
 
-int epicsShareAPI ezcaGetNelem(char *pvname, int *nelem)
+} /* end detach_group() */
+
+/****************************************************************
+*
+*
+****************************************************************/
+
+static void release_work_list_channels()
 {
-	return getInfo(pvname, GETNELEM, nelem);
-}
 
-int epicsShareAPI ezcaGetStatus(char *pvname, epicsTimeStamp *timestamp, 
-    short *status, short *severity)
+struct work *wp;
+
+    for (wp = Work_list.head; wp; wp = wp->next)
+	release_channel(&wp->cp);
+
+} /* end release_work_list_channels() */
+
+/****************************************************************
+*
+* only work which merely stores into user buffers may be
+* executed repeatedly.  Puts copy the user's data when they are
+* queued and blocking on monitors has side-effects.
+*
+****************************************************************/
+
+static BOOL preparable(struct work *wp)
 {
-	return getInfo(pvname, GETSTATUS, timestamp, status, severity);
-}
 
-int epicsShareAPI ezcaGetEnumStrings(char *pvname, char states[EZCA_ENUM_STATES][EZCA_ENUM_STRING_SIZE])
+BOOL rc;
+
+    switch (wp->worktype)
+    {
+	case GET:
+	case GETWITHSTATUS:
+	case GETSTATUS:
+	case GETNELEM:
+	case GETUNITS:
+	case GETPRECISION:
+	case GETENUMSTATES:
+	case GETGRAPHICLIMITS:
+	case GETCONTROLLIMITS:
+	case GETWARNLIMITS:
+	case GETALARMLIMITS:
+	case GETMETADATA:
+	    rc = TRUE;  break;
+	default:
+	    rc = FALSE; break;
+    } /* end switch() */
+
+    return rc;
+
+} /* end preparable() */
+
+/****************************************************************
+*
+* gives back the nodes and the channel references of a prepared
+* group and frees it.  The group must not be on the Work_list.
+*
+****************************************************************/
+
+static void free_group(EzcaGroup g)
 {
-	return getInfo(pvname, GETENUMSTATES, states);
-}
+
+int i;
+
+    for (i = 0; i < g->nwork; i++)
+    {
+	if (g->work[i])
+	    push_work(g->work[i]);
+
+	if (g->tmpl[i].cp)
+	{
+	    g->tmpl[i].cp->nhandles--;
+	    release_channel(&g->tmpl[i].cp);
+	} /* endif */
+    } /* endfor */
+
+    ezcafree((char *) g->work);
+    ezcafree((char *) g->tmpl);
+    ezcafree((char *) g);
+
+} /* end free_group() */
 
 /****************************************************************
 *
+* attempts to find channel in Channels by pvname
 *
 ****************************************************************/
 
-int epicsShareAPI ezcaGetWithStatus(char *pvname, char type, int nelem, 
-	void *buff, epicsTimeStamp *timestamp, short *status, short *severity)
+static struct channel *find_channel(char *pvname)
 {
 
-struct channel *cp;
-struct work *wp;
-int rc;
+struct channel *rc;
 
-    prologue();
+    if (pvname)
+    {
+	if ((rc = REG2CHANNEL(ezcaRegFindN(Channels, pvname, chan_name_len(pvname)))))
+	{
+	    rc->refcnt++;
+	    touch_channel(rc);
+	} /* endif */
+    }
+    else
+	rc = (struct channel *) NULL;
 
-    if ((wp = get_work()))
+    if (Trace || Debug)
     {
+	if (rc)
+	    printf("find_channel() found >%s<\n", pvname);
+	else
+	    /* do not attempt to print pvname here ... may not be printable */
+	    printf("find_channel() did not find channel\n");
+    } /* endif */
 
-	ErrorLocation = (InGroup ? LISTWORK : SINGLEWORK);
-	ListPrint = (InGroup ? LASTONLY : ListPrint);
+    return rc;
 
-	/* filling work */
-	wp->worktype = GETWITHSTATUS;
-	wp->ezcadatatype = type;
-	wp->nelem = nelem;
-	wp->pval = buff;
-	wp->tsp = timestamp;
-	wp->status = status;
-	wp->severity = severity;
+} /* end find_channel() */
 
-	/* checking input args */
-        if (!pvname)
-        {
-            wp->rc = EZCA_INVALIDARG;
-            wp->error_msg = ErrorMsgs[INVALID_PVNAME_MSG_IDX];
+/****************************************************************
+*
+* "rec" and "rec.VAL" name the same channel: the registry (and CA)
+* only ever see the short form. chan_name_len() is the length of
+* the short form of 'pvname', chan_name_dup() returns a copy of it
+* (or NULL if no memory).
+*
+****************************************************************/
 
-            if (AutoErrorMessage)
-		print_error(wp);
-        } 
-        else if (!(wp->pvname = strdup(pvname)))
-        {
-            wp->rc = EZCA_FAILEDMALLOC;
-            wp->error_msg = ErrorMsgs[FAILED_MALLOC_MSG_IDX];
+#define VAL_SUFFIX ".VAL"
 
-            if (AutoErrorMessage)
-		print_error(wp);
-        } 
-	else if (!VALID_EZCA_DATA_TYPE(wp->ezcadatatype))
-	{
-	    wp->rc = EZCA_INVALIDARG;
-	    wp->error_msg = ErrorMsgs[INVALID_TYPE_MSG_IDX];
+static size_t chan_name_len(const char *pvname)
+{
 
-	    if (AutoErrorMessage)
-		print_error(wp);
-	} 
-	else if (wp->nelem <= 0)
-	{
-	    wp->rc = EZCA_INVALIDARG;
-	    wp->error_msg = ErrorMsgs[INVALID_NELEM_MSG_IDX];
+size_t len = strlen(pvname);
+size_t sfx = sizeof(VAL_SUFFIX) - 1;
 
-	    if (AutoErrorMessage)
-		print_error(wp);
-	}
-	else if (!(wp->pval))
-	{
-	    wp->rc = EZCA_INVALIDARG;
-	    wp->error_msg = ErrorMsgs[INVALID_PBUFF_MSG_IDX];
+    if (len > sfx && 0 == strcmp(pvname + len - sfx, VAL_SUFFIX))
+	len -= sfx;
 
-	    if (AutoErrorMessage)
-		print_error(wp);
-	}
-	else if (!(wp->tsp))
-	{
-	    wp->rc = EZCA_INVALIDARG;
-	    wp->error_msg = ErrorMsgs[INVALID_PBUFF_MSG_IDX];
+    return len;
 
-	    if (AutoErrorMessage)
-		print_error(wp);
-	} 
-	else if (!(wp->status))
-	{
-	    wp->rc = EZCA_INVALIDARG;
-	    wp->error_msg = ErrorMsgs[INVALID_PBUFF_MSG_IDX];
+} /* end chan_name_len() */
 
-	    if (AutoErrorMessage)
-		print_error(wp);
-	}
-	else if (!(wp->severity))
-	{
-	    wp->rc = EZCA_INVALIDARG;
-	    wp->error_msg = ErrorMsgs[INVALID_PBUFF_MSG_IDX];
+static char *chan_name_dup(const char *pvname)
+{
 
-	    if (AutoErrorMessage)
-		print_error(wp);
-	}
-	else
-	{
-	    /* arguments are valid */
-	    wp->rc = EZCA_OK;
-	} /* endif */
+size_t len = chan_name_len(pvname);
+char *rc;
 
-	if (InGroup)
-	    append_to_work_list(wp);
-	else if (wp->rc == EZCA_OK)
-	{
-	    /* all input args OK */
+    if ((rc = (char *) ezcamalloc((unsigned) (len + 1))))
+    {
+	memcpy(rc, pvname, len);
+	rc[len] = 0;
+    } /* endif */
 
-	    get_channel(wp, &cp);
+    return rc;
 
-	    if (cp)
-	    {
-		/* everything OK so far ... otherwise something */
-		/* went wrong and it is already explained in wp */
+} /* end chan_name_dup() */
 
-		if (EzcaConnected(cp))
-		{
-		    /* channel is currently connected */
-		    if (!get_from_monitor(wp, cp))
-		    {
-			/* did not find an active   */
-			/* monitor that had a value */
-			/* need to do explicit get  */
+/****************************************************************
+*
+* The cached channels are kept on a list in the order of their
+* last use (LruHead is the least recently used one). A channel is
+* used when a request finds it by name or through a handle;
+* touch_channel() stamps it and moves it to the tail. All of this
+* is done under ezcaMutex.
+*
+****************************************************************/
 
-			if (Trace || Debug)
-printf("ezcaGetWithStatus(): did not find an active monitor with a value\n");
+static void register_channel(struct channel *cp)
+{
 
-			if (issue_get(wp, cp))
-			{
-			    /* a EzcaArrayGetCallback() */
-			    /* was successfully  issued */
-			    issue_wait(wp);
-			    if (AutoErrorMessage && wp->rc != EZCA_OK)
-				print_error(wp);
-			} /* endif */
-		    } /* endif */
-		}
-		else
-		{
-		    /* channel is not connected */
+    REG_LOCK();
+    ezcaRegInsert(Channels, &cp->reg, cp->pvname);
+    REG_UNLOCK();
 
-		    wp->rc = EZCA_NOTCONNECTED;
-		    wp->error_msg = ErrorMsgs[NOT_CONNECTED_MSG_IDX];
+    touch_channel(cp);
 
-		    if (AutoErrorMessage)
-			print_error(wp);
-		} /* endif */
-	    } /* endif */
+} /* end register_channel() */
 
-		release_channel( &cp );
+static void touch_channel(struct channel *cp)
+{
 
-	} /* endif */
+    set_deadline(&cp->last_used, 0.);
 
-	rc = wp->rc;
-	    
-    }
-    else
+    if (cp != LruTail)
     {
-	rc = EZCA_FAILEDMALLOC;
+	lru_unlink(cp);
 
-	if (AutoErrorMessage)
-	    printf("%s\n", FAILED_MALLOC_MSG);
+	cp->lru_prev = LruTail;
+	cp->lru_next = (struct channel *) NULL;
+	if (LruTail)
+	    LruTail->lru_next = cp;
+	else
+	    LruHead = cp;
+	LruTail = cp;
     } /* endif */
 
-    epilogue();
-    return rc;
+} /* end touch_channel() */
 
-} /* end ezcaGetWithStatus() */
+static void lru_unlink(struct channel *cp)
+{
+
+    /* no-op unless on the list */
+    if (cp->lru_prev)
+	cp->lru_prev->lru_next = cp->lru_next;
+    else if (LruHead == cp)
+	LruHead = cp->lru_next;
+    else
+	return;
+
+    if (cp->lru_next)
+	cp->lru_next->lru_prev = cp->lru_prev;
+    else
+	LruTail = cp->lru_prev;
+
+    cp->lru_prev = (struct channel *) NULL;
+    cp->lru_next = (struct channel *) NULL;
+
+} /* end lru_unlink() */
 
 /****************************************************************
 *
+* evicts up to 'budget' channels, least recently used first, while
+* there are more than CacheMaxChannels or as long as they have not
+* been used for CacheMaxIdle seconds. Channels with monitors,
+* monitor callbacks or handles (including prepared groups), work
+* waiting for them or a reference held by a request in progress
+* are skipped. The list is walked once and the walk stops at the
+* first channel that is young enough once the count is within the
+* limit. Returns the # of channels cleared.
 *
 ****************************************************************/
 
-int epicsShareAPI ezcaPut(char *pvname, char type, int nelem, void *buff)
+static int evict_channels(int budget)
 {
 
 struct channel *cp;
-struct work *wp;
-int nbytes;
-unsigned attempts;
-BOOL reported, error;
+struct channel *victims = (struct channel *) NULL;
+unsigned long n = ezcaRegCount(Channels);
 int rc;
 
-    prologue();
-
-    if ((wp = get_work()))
+    for (cp = LruHead; cp && budget > 0; cp = cp->lru_next)
     {
+	if (!(CacheMaxChannels && n > CacheMaxChannels)
+	    && !(CacheMaxIdle > 0. && -time_left(&cp->last_used) > CacheMaxIdle))
+	    break;
 
-	ErrorLocation = (InGroup ? LISTWORK : SINGLEWORK);
-	ListPrint = (InGroup ? LASTONLY : ListPrint);
+	if (cp->refcnt || cp->nhandles || cp->monitor_list
+	    || cp->callbacks || cp->pending)
+	    continue;
 
-	/* filling work */
+	cp->refcnt++;
+	cp->next = victims;
+	victims = cp;
+	n--;
+	budget--;
+    } /* endfor */
 
-	wp->worktype = PUT;
-	wp->ezcadatatype = type;
-	wp->nelem = nelem;
+    rc = clear_victims(victims);
+    Evictions += rc;
 
-	/* NOTE: must make a copy of the user's buffer here, not  */
-	/*       just point to what was given to us.  we must do  */
-	/*       this because this routine might have been called */
-	/*       inside a group and the user might want to re-use */
-	/*       the buffer immediately after our call.           */
-	/* NOTE ALSO: that this allocated memory must be free'd   */
-	/*            in ezcaEndGroup() and NOT in push_work()    */
-	/*            because in push_work() we cannot be sure    */
-	/*            that this was malloc'd by us.               */
+    return rc;
 
-	if (buff && wp->nelem > 0)
-	{
-	    switch (wp->ezcadatatype)
-	    {
-		case ezcaByte: 
-		    nbytes = wp->nelem*dbr_value_size[DBR_CHAR];   break;
-		case ezcaString:
-		    nbytes = wp->nelem*dbr_value_size[DBR_STRING]; break;
-		case ezcaShort:
-		    nbytes = wp->nelem*dbr_value_size[DBR_SHORT];  break;
-		case ezcaLong:
-		    nbytes = wp->nelem*dbr_value_size[DBR_LONG];   break;
-		case ezcaFloat:
-		    nbytes = wp->nelem*dbr_value_size[DBR_FLOAT];  break;
-		case ezcaDouble:
-		    nbytes = wp->nelem*dbr_value_size[DBR_DOUBLE]; break;
-		default:
-		    /* error message printed later in ezcaEndGroup() */
-		    nbytes = 0;                                    break;
-	    } /* end switch() */
+} /* end evict_channels() */
 
-	} 
-	else
-	    nbytes = 0;
+/****************************************************************
+*
+* clears the channels chained through 'next', each of which holds
+* a reference taken by the caller. The lock is released while a
+* channel is cleared (see EzcaClearChannel()), so the victims are
+* collected first and every one is pinned by its reference: one
+* that a request picked up in the meantime merely drops it and
+* stays cached. Returns the # of channels actually cleared.
+*
+****************************************************************/
 
-	if (nbytes > 0)
-	{
-	    if ((wp->pval = (void *) ezcamalloc ((unsigned) nbytes)))
-		memcpy((char *) (wp->pval), (char *) buff, nbytes);
-	}
-	else
-	    wp->pval = (void *) NULL;
+static int clear_victims(struct channel *victims)
+{
 
-	/* checking input args */
-        if (!pvname)
-        {
-            wp->rc = EZCA_INVALIDARG;
-            wp->error_msg = ErrorMsgs[INVALID_PVNAME_MSG_IDX];
+struct channel *cp;
+int rc = 0;
 
-            if (AutoErrorMessage)
-		print_error(wp);
-        } 
-        else if (!(wp->pvname = strdup(pvname)))
-        {
-            wp->rc = EZCA_FAILEDMALLOC;
-            wp->error_msg = ErrorMsgs[FAILED_MALLOC_MSG_IDX];
+    while ((cp = victims))
+    {
+	victims = cp->next;
+	cp->next = (struct channel *) NULL;
 
-            if (AutoErrorMessage)
-		print_error(wp);
-        } 
-	else if (!VALID_EZCA_DATA_TYPE(wp->ezcadatatype))
-	{
-	    wp->rc = EZCA_INVALIDARG;
-	    wp->error_msg = ErrorMsgs[INVALID_TYPE_MSG_IDX];
+	if (1 == cp->refcnt)
+	    rc++;
 
-	    if (AutoErrorMessage)
-		print_error(wp);
-	} 
-	else if (wp->nelem <= 0)
-	{
-	    wp->rc = EZCA_INVALIDARG;
-	    wp->error_msg = ErrorMsgs[INVALID_NELEM_MSG_IDX];
+	if (Trace || Debug)
+	    printf("clear_victims() clearing >%s< (refcnt %d)\n",
+		cp->pvname, cp->refcnt);
 
-	    if (AutoErrorMessage)
-		print_error(wp);
-	}
-	else if (!(wp->pval))
-	{
-	    wp->rc = EZCA_INVALIDARG;
-	    wp->error_msg = ErrorMsgs[INVALID_PBUFF_MSG_IDX];
+	clean_and_push_channel(&cp);
+    } /* endwhile */
 
-	    if (AutoErrorMessage)
-		print_error(wp);
-	}
-	else
-	{
-	    /* arguments are valid */
-	    wp->rc = EZCA_OK;
-	} /* endif */
+    return rc;
 
-	if (InGroup)
-	    append_to_work_list(wp);
-	else if (wp->rc == EZCA_OK)
-	{
-	    /* all input args OK */
-	    get_channel(wp, &cp);
+} /* end clear_victims() */
 
-	    if (cp)
-	    {
-		/* everything OK so far ... otherwise something */
-		/* went wrong and it is already explained in wp */
+#ifdef EPICS_THREE_FOURTEEN
+/****************************************************************
+*
+* runs eviction passes once a second (or right away after a pass
+* which used up its budget) with the library lock released
+* between passes. Started by ezcaSetCachePolicy() which also
+* stops it (EvictStop) when eviction is switched off, e.g.,
+* before the CA context is destroyed.
+*
+****************************************************************/
 
-		if (EzcaConnected(cp))
-		{
-		    /* channel is currently connected */
+static void evict_thread(void *unused)
+{
 
-		    if (wp->nelem <= (int)EzcaElementCount(cp))
-		    {
-			wp->reported = FALSE;
+int n;
 
-			if (EzcaArrayPutCallback(wp, cp) == ECA_NORMAL)
-			{
-				MARK_OUTSTANDING(1);
+    /* only started with a preemptive context */
+    ca_attach_context(CaContext);
 
-			    for (reported = error = FALSE, attempts = 0;
-				!reported && !error && attempts<=RetryCount;
-				    attempts ++)
-			    {
+	EZCA_LOCK();
+
+    while (!EvictStop)
+    {
+	n = EVICTING() ? evict_channels(EVICT_BUDGET) : 0;
+
+	EZCA_UNLOCK();
+
+	if (n)
+	    ca_flush_io();
 
-				if (Trace || Debug)
-				    printf("ezcaPut(): attempt %d of %d\n", 
-					attempts+1, RetryCount+1);
+	if (n < EVICT_BUDGET)
+	    epicsEventWaitWithTimeout(EvictWake, EVICT_PERIOD);
 
-				if (EzcaPendEvent(wp, TimeoutSeconds, FALSE) 
-					== ECA_TIMEOUT)
-				    reported = wp->reported;
-				else
-				{
-				    /* something went wrong ... rc and */
-				    /* error msg have already been set */
+	EZCA_LOCK();
+    } /* endwhile */
 
-				    /* need to trash this wp so it's */
-				    /* never used again in case the  */
-				    /* callback fires off later      */
+    EvictInBackground = FALSE;
 
-				    error = TRUE;
+	EZCA_UNLOCK();
 
-				    wp->trashme = trashed;
+    epicsEventSignal(EvictDone);
 
-				    if (Debug)
-					printf("trashing wp\n");
-				} /* endif */
-			    } /* endfor */
+} /* end evict_thread() */
+#endif
 
-			    if (reported)
-			    {
-				if (AutoErrorMessage && wp->rc != EZCA_OK)
-				    print_error(wp);
-			    }
-			    else
-			    {
-				if (!error)
-				{
-				    /* callback did not respond back */
-				    /* int time no value received    */
+/****************************************************************
+*
+* attempts to find channel in Channels by pvname
+* if not found, creates it and places it there.
+*
+* peforms all the necessary ca calls.  
+*
+* if everything went OK, * leaves wp unchanged and places pointer 
+* to channel in cpp.
+*
+* if something went wrong, cpp gets NULL and wp->rc set with
+* appropriate error message placed into wp->error_msg.
+*
+****************************************************************/
 
-				    /* need to trash this wp so it's */
-				    /* never used again in case the  */
-				    /* callback fires off later      */
+static void get_channel(struct work *wp, struct channel **cpp)
+{
 
-					if ( RetryCount )
-					{
-				    	wp->rc = EZCA_NOTIMELYRESPONSE;
-				    	wp->error_msg =
-						ErrorMsgs[NO_RESPONSE_IN_TIME_MSG_IDX];
-					}
-					else
-					{
-	            		wp->rc = EZCA_ABORTED;
-	            		wp->error_msg = ErrorMsgs[ABORTED_MSG_IDX];
-					}
+    if (!wp || !cpp)
+    {
+	fprintf(stderr, 
+	    "EZCA FATAL ERROR: get_channel() got wp %p cpp %p\n", wp, cpp);
+	exit(1);
+    } /* endif */
 
-				    if (AutoErrorMessage)
-					print_error(wp);
-				    wp->trashme = trashed;
+    if (Debug)
+    {
+	printf("entering get_channel()\n");
+	print_state();
+    } /* endif */
 
-				    if (Debug)
-					printf("trashing wp\n");
-				} /* endif */
-			    } /* endif */
-			}
-			else
-			{
-			    /* something went wrong ... rc and */
-			    /* error msg have already been set */
+    if (wp->pvname)
+    {
+	if ((*cpp = find_channel(wp->pvname)))
+	{
+	    if (Trace || Debug)
+		printf("get_channel(): was able to find_channel()\n");
 
-			    /* need to trash this wp so it's */
-			    /* never used again in case the  */
-			    /* callback fires off later      */
+	    if ( negative_cached(wp, *cpp) )
+		release_channel( cpp );
+	    else if ( ca_puser((*cpp)->cid) 
+		|| (!EzcaConnected(*cpp) && await_connection(*cpp)) )
+		/* negative cache entry expired or still connecting */
+		wait_connected(wp, cpp);
+	}
+	else
+	{
+	    /* not in Channels ... must ca_search_and_connect() and add */
+	    if (Trace || Debug)
+printf("get_channel(): could not find_channel(). must ca_search_and_connect() and add\n");
 
-			    wp->trashme = trashed;
-			    if (Debug)
-				printf("trashing wp\n");
-			} /* endif */
-		    }
+	    if ((*cpp = pop_channel()))
+	    {
+		if (((*cpp)->pvname = chan_name_dup(wp->pvname)))
+		{
+
+		    if (EzcaQueueSearchAndConnect(wp, *cpp) == ECA_NORMAL)
+		    {
+			/* adding to Channels */
+			register_channel(*cpp);
+
+			wait_connected(wp, cpp);
+	    	} /* endif */
 		    else
 		    {
-			/* too many elements requested */
-			wp->rc = EZCA_INVALIDARG;
-			wp->error_msg = ErrorMsgs[TOO_MANY_NELEM_MSG_IDX];
+			/* something went wrong ... rc and */
+			/* error msg have already been set */
 
-			if (AutoErrorMessage)
-			    print_error(wp);
+			clean_and_push_channel( cpp );
 		    } /* endif */
 		}
 		else
 		{
-		    /* channel is not connected */
-
-		    wp->rc = EZCA_NOTCONNECTED;
-		    wp->error_msg = ErrorMsgs[NOT_CONNECTED_MSG_IDX];
+		    wp->rc = EZCA_FAILEDMALLOC;
+		    wp->error_msg = ErrorMsgs[FAILED_MALLOC_MSG_IDX];
 
 		    if (AutoErrorMessage)
 			print_error(wp);
 		} /* endif */
-	    } /* endif */
-
-		release_channel( &cp );
-
-	    /* no matter what happened ... */
-	    /* freeing malloc'd memory */
-	    if (wp->pval)
+	    } 
+	    else
 	    {
-		ezcafree((char *) wp->pval);
-		wp->pval = (void *) NULL;
+		wp->rc = EZCA_FAILEDMALLOC;
+		wp->error_msg = ErrorMsgs[FAILED_MALLOC_MSG_IDX];
+
+		if (AutoErrorMessage)
+		    print_error(wp);
 	    } /* endif */
 	} /* endif */
-
-	rc = wp->rc;
-	    
     }
     else
     {
-	rc = EZCA_FAILEDMALLOC;
+	*cpp = (struct channel *) NULL;
+	wp->rc = EZCA_INVALIDARG;
+	wp->error_msg = ErrorMsgs[INVALID_PVNAME_MSG_IDX];
 
 	if (AutoErrorMessage)
-	    printf("%s\n", FAILED_MALLOC_MSG);
+	    print_error(wp);
     } /* endif */
 
-    epilogue();
-    return rc;
+    if (Debug)
+    {
+	printf("channels and channel_avail after\n");
+	print_state();
+    } /* endif */
 
-} /* end ezcaPut() */
+} /* end get_channel() */
 
 /****************************************************************
 *
+* Wait for a channel marked for reporting (puser) to connect.
+* On failure wp->rc is set and *cpp is NULL.
 *
 ****************************************************************/
 
-int epicsShareAPI ezcaPutOldCa(char *pvname, char type, int nelem, void *buff)
+static void wait_connected(struct work *wp, struct channel **cpp)
 {
 
-struct channel *cp;
-struct work *wp;
-int nbytes;
-int rc;
+unsigned attempts;
+BOOL done;
 
-    prologue();
+    /* post_connected() counts down */
+    Ctx->awaiting = *cpp;
+    MARK_OUTSTANDING(1);
 
-    if ((wp = get_work()))
+    for (done = FALSE, attempts = 0; 
+	!done && attempts <= RetryCount; attempts ++)
     {
+	if (Trace || Debug)
+	    printf("get_channel(): attempt %d of %d\n", 
+		attempts+1, RetryCount+1);
 
-	ErrorLocation = (InGroup ? LISTWORK : SINGLEWORK);
-	ListPrint = (InGroup ? LASTONLY : ListPrint);
+	if (EzcaPendEvent(wp,TimeoutSeconds,FALSE) == ECA_TIMEOUT)
+	    done = EzcaConnected(*cpp);
+    } /* endfor */
 
-	/* filling work */
+    /* whether or not we were counted down */
+    Ctx->awaiting = (struct channel *) NULL;
+    RESET_OUTSTANDING();
 
-	wp->worktype = PUTOLDCA;
-	wp->ezcadatatype = type;
-	wp->nelem = nelem;
+    /* an async group may still be waiting for the channel */
+    if ( !(*cpp)->pending )
+	ca_set_puser((*cpp)->cid, 0);
 
-	/* NOTE: must make a copy of the user's buffer here, not  */
-	/*       just point to what was given to us.  we must do  */
-	/*       this because this routine might have been called */
-	/*       inside a group and the user might want to re-use */
-	/*       the buffer immediately after our call.           */
-	/* NOTE ALSO: that this allocated memory must be free'd   */
-	/*            in ezcaEndGroup() and NOT in push_work()    */
-	/*            because in push_work() we cannot be sure    */
-	/*            that this was malloc'd by us.               */
+    if ( !done ) {
+	search_failed( wp, cpp );
 
-	if (buff && wp->nelem > 0)
-	{
-	    switch (wp->ezcadatatype)
-	    {
-		case ezcaByte: 
-		    nbytes = wp->nelem*dbr_value_size[DBR_CHAR];   break;
-		case ezcaString:
-		    nbytes = wp->nelem*dbr_value_size[DBR_STRING]; break;
-		case ezcaShort:
-		    nbytes = wp->nelem*dbr_value_size[DBR_SHORT];  break;
-		case ezcaLong:
-		    nbytes = wp->nelem*dbr_value_size[DBR_LONG];   break;
-		case ezcaFloat:
-		    nbytes = wp->nelem*dbr_value_size[DBR_FLOAT];  break;
-		case ezcaDouble:
-		    nbytes = wp->nelem*dbr_value_size[DBR_DOUBLE]; break;
-		default:
-		    /* error message printed later in ezcaEndGroup() */
-		    nbytes = 0;                                    break;
-	    } /* end switch() */
+	wp->aux_error_msg = work_strdup(wp, wp->pvname);
 
-	} 
-	else
-	    nbytes = 0;
+	if (AutoErrorMessage)
+	    print_error(wp);
+    }
 
-	if (nbytes > 0)
-	{
-	    if ((wp->pval = (void *) ezcamalloc ((unsigned) nbytes)))
-		memcpy((char *) (wp->pval), (char *) buff, nbytes);
-	}
-	else
-	    wp->pval = (void *) NULL;
+} /* end wait_connected() */
 
-	/* checking input args */
-        if (!pvname)
-        {
-            wp->rc = EZCA_INVALIDARG;
-            wp->error_msg = ErrorMsgs[INVALID_PVNAME_MSG_IDX];
+/* release a reference to a channel struct; decrement refcnt and
+ * set referring pointer to NULL
+ */
 
-            if (AutoErrorMessage)
-		print_error(wp);
-        } 
-        else if (!(wp->pvname = strdup(pvname)))
-        {
-            wp->rc = EZCA_FAILEDMALLOC;
-            wp->error_msg = ErrorMsgs[FAILED_MALLOC_MSG_IDX];
+static void
+release_channel( struct channel **cpp )
+{
+	if ( ! (*cpp) )
+		return;
 
-            if (AutoErrorMessage)
-		print_error(wp);
-        } 
-	else if (!VALID_EZCA_DATA_TYPE(wp->ezcadatatype))
-	{
-	    wp->rc = EZCA_INVALIDARG;
-	    wp->error_msg = ErrorMsgs[INVALID_TYPE_MSG_IDX];
+	if ( (*cpp)->refcnt <= 0 ) {
+		fprintf(stderr,"EZCA FATAL ERROR: release_channel() called with refcnt <= 0\n");
+		exit(1);
+	}
+	(*cpp)->refcnt--;
+	*cpp = 0;
+}
 
-	    if (AutoErrorMessage)
-		print_error(wp);
-	} 
-	else if (wp->nelem <= 0)
-	{
-	    wp->rc = EZCA_INVALIDARG;
-	    wp->error_msg = ErrorMsgs[INVALID_NELEM_MSG_IDX];
+/****************************************************************
+*
+* validates the target of a groupable work function: either a
+* handle (if hcp is non-NULL) or a PV name which is copied into
+* wp.  Returns TRUE if OK, otherwise sets wp->rc and wp->error_msg
+* and returns FALSE.
+*
+****************************************************************/
 
-	    if (AutoErrorMessage)
-		print_error(wp);
-	}
-	else if (!(wp->pval))
+static BOOL check_target(struct work *wp, struct channel *hcp, char *pvname)
+{
+    if (hcp)
+    {
+	if (hcp->nhandles <= 0)
 	{
 	    wp->rc = EZCA_INVALIDARG;
-	    wp->error_msg = ErrorMsgs[INVALID_PBUFF_MSG_IDX];
-
-	    if (AutoErrorMessage)
-		print_error(wp);
-	}
-	else
-	{
-	    /* arguments are valid */
-	    wp->rc = EZCA_OK;
+	    wp->error_msg = ErrorMsgs[INVALID_HANDLE_MSG_IDX];
+	    return FALSE;
 	} /* endif */
+    }
+    else if (!pvname)
+    {
+	wp->rc = EZCA_INVALIDARG;
+	wp->error_msg = ErrorMsgs[INVALID_PVNAME_MSG_IDX];
+	return FALSE;
+    }
+    else if (!(wp->pvname = work_strdup(wp, pvname)))
+    {
+	wp->rc = EZCA_FAILEDMALLOC;
+	wp->error_msg = ErrorMsgs[FAILED_MALLOC_MSG_IDX];
+	return FALSE;
+    } /* endif */
 
-	if (InGroup)
-	    append_to_work_list(wp);
-	else if (wp->rc == EZCA_OK)
-	{
-	    /* all input args OK */
-	    get_channel(wp, &cp);
+    return TRUE;
 
-	    if (cp)
-	    {
-		/* everything OK so far ... otherwise something */
-		/* went wrong and it is already explained in wp */
+} /* end check_target() */
 
-		if (EzcaConnected(cp))
-		{
-		    /* channel is currently connected */
+/* acquire a reference to the channel behind a (valid) handle;
+ * this is the counterpart of get_channel() for handles and is
+ * balanced by release_channel().
+ */
 
-		    if (wp->nelem <= (int)EzcaElementCount(cp))
-		    {
-			if (EzcaArrayPut(wp, cp) == ECA_NORMAL)
-			    EzcaPendIO(wp, SHORT_TIME);
-		    }
-		    else
-		    {
-			/* too many elements requested */
-			wp->rc = EZCA_INVALIDARG;
-			wp->error_msg = ErrorMsgs[TOO_MANY_NELEM_MSG_IDX];
+static void
+use_handle( struct channel *hcp, struct channel **cpp )
+{
+	hcp->refcnt++;
+	touch_channel(hcp);
+	*cpp = hcp;
+}
 
-			if (AutoErrorMessage)
-			    print_error(wp);
-		    } /* endif */
-		}
-		else
-		{
-		    /* channel is not connected */
+/****************************************************************
+*
+* name of the ezca function which created a work node (for
+* error messages).
+*
+****************************************************************/
 
-		    wp->rc = EZCA_NOTCONNECTED;
-		    wp->error_msg  = ErrorMsgs[NOT_CONNECTED_MSG_IDX];
+static char *worktype_msg(struct work *wp, char *caller)
+{
 
-		    if (AutoErrorMessage)
-			print_error(wp);
-		} /* endif */
-	    } /* endif */
+char *wtm;
 
+    switch (wp->worktype)
+    {
+	case GET:              wtm = GET_MSG;              break;
+	case PUT:              wtm = PUT_MSG;              break;
+	case PUTOLDCA:         wtm = PUTOLDCA_MSG;         break;
+	case GETUNITS:         wtm = GETUNITS_MSG;         break;
+	case GETENUMSTATES:    wtm = GETENUMSTATES_MSG;    break;
+	case GETNELEM:         wtm = GETNELEM_MSG;         break;
+	case GETPRECISION:     wtm = GETPRECISION_MSG;     break;
+	case GETGRAPHICLIMITS: wtm = GETGRAPHICLIMITS_MSG; break;
+	case GETCONTROLLIMITS: wtm = GETCONTROLLIMITS_MSG; break;
+	case GETWARNLIMITS:    wtm = GETWARNLIMITS_MSG;    break;
+	case GETALARMLIMITS:   wtm = GETALARMLIMITS_MSG;   break;
+	case GETSTATUS:        wtm = GETSTATUS_MSG;        break;
+	case GETWITHSTATUS:    wtm = GETWITHSTATUS_MSG;    break;
+	case SETMONITOR:       wtm = SETMONITOR_MSG;       break;
+	case CLEARMONITOR:     wtm = CLEARMONITOR_MSG;     break;
+	case AUTOERRORMESSAGEOFF: 
+	    wtm = AUTOERRORMESSAGEOFF_MSG;                 break;
+	case AUTOERRORMESSAGEON:     
+	    wtm = AUTOERRORMESSAGEON_MSG;                  break;
+	case DEBUGOFF:         wtm = DEBUGOFF_MSG;         break;
+	case DEBUGON:          wtm = DEBUGON_MSG;          break;
+	case DELAY:            wtm = DELAY_MSG;            break;
+	case FREEMEM:          wtm = FREEMEM_MSG;          break;
+	case PVTOCHID:         wtm = PVTOCHID_MSG;         break;
+	case SETTIMEOUT:       wtm = SETTIMEOUT_MSG;       break;
+	case STARTGROUP:       wtm = STARTGROUP_MSG;       break;
+	case CLEARCHANNEL:     wtm = CLEARCHANNEL_MSG;     break;
+	case MONBLOCK:         wtm = MONBLOCK_MSG;         break;
+	case TRACEOFF:         wtm = TRACEOFF_MSG;         break;
+	case TRACEON:          wtm = TRACEON_MSG;          break;
+	case SETRETRYCOUNT:    wtm = SETRETRYCOUNT_MSG;    break;
+	case GETRETRYCOUNT:    wtm = GETRETRYCOUNT_MSG;    break;
+	case GETTIMEOUT:       wtm = GETTIMEOUT_MSG;       break;
+	case RESOLVE:          wtm = RESOLVE_MSG;          break;
+	case RELEASEHANDLE:    wtm = RELEASEHANDLE_MSG;    break;
+	case PREPAREGROUP:     wtm = PREPAREGROUP_MSG;     break;
+	case EXECUTEGROUP:     wtm = EXECUTEGROUP_MSG;     break;
+	case FREEGROUP:        wtm = FREEGROUP_MSG;        break;
+	case SETNOTFOUNDHOLDOFF: wtm = SETNOTFOUNDHOLDOFF_MSG; break;
+	case GETNOTFOUNDHOLDOFF: wtm = GETNOTFOUNDHOLDOFF_MSG; break;
+	case SETMONITORQUEUED: wtm = SETMONITORQUEUED_MSG; break;
+	case GETQUEUED:        wtm = GETQUEUED_MSG;        break;
+	case SETNODESPERSLAB:  wtm = SETNODESPERSLAB_MSG;  break;
+	case GETNODESTATS:     wtm = GETNODESTATS_MSG;     break;
+	case GETWORKALLOCS:    wtm = GETWORKALLOCS_MSG;    break;
+	case ENDGROUPASYNC:    wtm = ENDGROUPASYNC_MSG;    break;
+	case ADDMONITORCALLBACK: wtm = ADDMONITORCALLBACK_MSG; break;
+	case REMOVEMONITORCALLBACK: wtm = REMOVEMONITORCALLBACK_MSG; break;
+	case CONNECTMANY:      wtm = CONNECTMANY_MSG;      break;
+	case SAVECHANNELS:     wtm = SAVECHANNELS_MSG;     break;
+	case LOADCHANNELS:     wtm = LOADCHANNELS_MSG;     break;
+	case SETCACHEPOLICY:   wtm = SETCACHEPOLICY_MSG;   break;
+	case GETCACHESTATS:    wtm = GETCACHESTATS_MSG;    break;
+	case GETMETADATA:      wtm = GETMETADATA_MSG;      break;
+	default:
+	    fprintf(stderr, 
+	"EZCA FATAL ERROR: %s() found invalid worktype %d\n", 
+		caller, wp->worktype);
+	    exit(1);
+	    break;
+    } /* end switch() */
 
-		release_channel( &cp );
+    return wtm;
 
-	    /* no matter what happened ... */
-	    /* freeing malloc'd memory */
-	    if (wp->pval)
-	    {
-		ezcafree((char *) wp->pval);
-		wp->pval = (void *) NULL;
-	    } /* endif */
-	} /* endif */
+} /* end worktype_msg() */
 
-	rc = wp->rc;
-	    
-    }
-    else
-    {
-	rc = EZCA_FAILEDMALLOC;
+/****************************************************************
+*
+* makes the most recently published data of a monitor the reader's
+* (i.e., mp->front) and returns it. The caller must hold ezcaMutex
+* (which makes it the only reader); the callback is never blocked
+* for longer than the pointer swap.
+*
+****************************************************************/
 
-	if (AutoErrorMessage)
-	    printf("%s\n", FAILED_MALLOC_MSG);
+static struct monbuf *latch_monitor(struct monitor *mp)
+{
+
+struct monbuf *bp;
+
+    CHAN_LOCK(mp->cp);
+    if (mp->fresh)
+    {
+	bp = mp->front;
+	mp->front = mp->mid;
+	mp->mid = bp;
+	mp->fresh = FALSE;
     } /* endif */
+    CHAN_UNLOCK(mp->cp);
 
-    epilogue();
-    return rc;
+    return mp->front;
 
-} /* end ezcaPutOldCa() */
+} /* end latch_monitor() */
 
 /****************************************************************
 *
+* A user is doing some kind of get (ezcaGet, ezcaGetStatus, ezcaGetWithStatus).
+* This function checks the channel for a monitor of the type specified in wp.
+* If it finds one, it copies the appropriate value(s) to wp and return TRUE.
+* Any other condition it returns FALSE.
+*
+* The only way wp->rc and wp->error_msg get affected is if the user
+* wants to read the value and wants more values than are available.
+* That is only possible if the monitor was found (i.e. returns TRUE).
+*
+* NOTE: This function does not care whether or not the channel is 
+*       currently connected ... that is the responsibility of the caller.
 *
 ****************************************************************/
 
-
-int epicsShareAPI ezcaNewMonitorWait(char *pvname, char type)
+static BOOL get_from_monitor(struct work *wp, struct channel *cp)
 {
-struct channel *cp;
-struct monitor *mp;
-struct work *wp;
-int rc;
 
-    prologue();
+struct monitor *mp;
+struct monbuf *bp;
+BOOL found_error;
+BOOL rc;
 
-    if ((wp = get_work()))
+    if (wp && cp)
     {
+	/* loop to check monitor list for */
+	/* monitor of the same type       */
+	mp = cp->monitor_list;
+	rc = FALSE;
+	bp = (struct monbuf *) NULL;
+	while (mp && !rc)
+	    if (!(rc = ((wp->ezcadatatype == mp->ezcadatatype)
+			    && mp->active 
+			    && (bp = latch_monitor(mp->src))->nelem != UNDEFINED)))
+		mp = mp->right;
 
-	ErrorLocation = (InGroup ? LISTWORK : SINGLEWORK);
-	ListPrint = (InGroup ? LASTONLY : ListPrint);
+	if (rc)
+	{
+	    if (Trace || Debug)
+		printf("get_from_monitor(): found active monitor with value\n");
 
-	/* filling work */
+	    found_error = FALSE;
 
-	wp->worktype = MONBLOCK;
-	wp->ezcadatatype = type;
+	    if (wp->pval)
+	    {
+		/* wants the value from the monitor */
 
+		if (wp->nelem <= bp->nelem)
+		{
+		    /* time to copy (and convert) the data */
+		    convert_values(wp->pval, wp->ezcadatatype, bp->pval, 
+			mp->src->dbr_type, wp->nelem);
 
-	/* checking input args */
-    if (!pvname)
-	{
-		wp->rc = EZCA_INVALIDARG;
-		wp->error_msg = ErrorMsgs[INVALID_PVNAME_MSG_IDX];
-	} 
-    else if (!(wp->pvname = strdup(pvname)))
-	{
-		wp->rc = EZCA_FAILEDMALLOC;
-		wp->error_msg = ErrorMsgs[FAILED_MALLOC_MSG_IDX];
-	} 
-	else if (!VALID_EZCA_DATA_TYPE(wp->ezcadatatype))
-	{
-	    wp->rc = EZCA_INVALIDARG;
-	    wp->error_msg = ErrorMsgs[INVALID_TYPE_MSG_IDX];
-	} 
-	else
-	{
-	    /* arguments are valid */
-	    wp->rc = EZCA_OK;
-	} /* endif */
+		    if (Trace || Debug)
+	    printf("get_from_monitor() just copied %d elements from %p to %p\n",
+			    wp->nelem, bp->pval, wp->pval);
+
+		    /* unless something newer came in meanwhile */
+		    CHAN_LOCK(mp->cp);
+		    if (!mp->src->fresh)
+			mp->needs_reading = FALSE;
+		    CHAN_UNLOCK(mp->cp);
+		}
+		else
+		{
+		    /* too many requested elements */
+		    found_error = TRUE;
 
-	if (InGroup)
-	    append_to_work_list(wp);
-	else if (wp->rc == EZCA_OK)
-	{
-		if ((cp = find_channel(wp->pvname)))
+		    wp->rc = EZCA_INVALIDARG;
+		    wp->error_msg = ErrorMsgs[TOO_MANY_NELEM_MSG_IDX];
+
+		    if (AutoErrorMessage)
+			print_error(wp);
+		} /* endif */
+	    } /* endif */
+
+	    if (!found_error)
+	    {
+		if (wp->status)
 		{
-			mp = cp->monitor_list;
-			while (mp && ( ! (type == mp->ezcadatatype) || !mp->active))
-					mp = mp->right;
+		    /* wants the status from the monitor */
 
-			if (mp)
-			{
-				if ( !mp->needs_reading ) {
-					wp->reported = FALSE;
-	
-					if( mp->waiter ) {
-						fprintf(stderr,"EZCA FATAL ERROR: mp->waiter is already set\n");
-						exit(1);
-					}
-					mp->waiter   = wp;
-#ifdef DEBUG
-					printf("TSILL issueing wait\n");
-#endif
-					issue_wait(wp);
-#ifdef DEBUG
-					printf("DONE\n");
-#endif
-					mp->waiter   = (struct work *)NULL;
-				} else {
-#ifdef DEBUG
-				printf("TSILL no need to wait\n");
-#endif
-				}
-			}
-			else
-			{
-				/* no monitor */
-				wp->rc = EZCA_INVALIDARG;
-				wp->error_msg = ErrorMsgs[NO_MONITOR_MSG_IDX];
+		    *(wp->status) = bp->status;
 
-				if (Trace || Debug)
-					printf("add_wait() found no monitor name >%s< type %d\n",
-							wp->pvname, type);
+		    if (Trace || Debug)
+			printf("get_from_monitor() just copied status %d\n", 
+			    *(wp->status));
+		} /* endif */
 
-			} /* endif */
-			release_channel(&cp);
-		}
-		else
+		if (wp->severity)
 		{
-			/* no channel */
-			wp->rc = EZCA_INVALIDARG;
-			wp->error_msg = ErrorMsgs[INVALID_PVNAME_MSG_IDX];
+		    /* wants the severity from the monitor */
 
-			if (Trace || Debug)
-				printf("add_wait() found no channel name >%s< type %d\n",
-						pvname, type);
+		    *(wp->severity) = bp->severity;
+
+		    if (Trace || Debug)
+			printf("get_from_monitor() just copied severity %d\n",
+			    *(wp->severity));
 		} /* endif */
-	} /* endif */
 
-	rc = wp->rc;
+		if (wp->tsp)
+		{
+		    /* wants the time from the monitor */
 
-	if ( AutoErrorMessage && EZCA_OK != wp->rc )
-		print_error(wp);
-	    
+		    copy_time_stamp(wp->tsp, &(bp->time_stamp));
+
+		    if (Trace || Debug)
+			printf("get_from_monitor() just copied time\n");
+		} /* endif */
+	    } /* endif */
+	} /* endif */
     }
     else
     {
-	rc = EZCA_FAILEDMALLOC;
-
-	if (AutoErrorMessage)
-	    printf("%s\n", FAILED_MALLOC_MSG);
+	fprintf(stderr, 
+	    "EZCA FATAL ERROR: get_from_monitor() got wp %p cp %p\n", wp, cp);
+	exit(1);
     } /* endif */
 
-    epilogue();
     return rc;
 
-} /* end ezcaNewMonitorWait() */
-
-/*******************/
-/*                 */
-/* Local Functions */
-/*                 */
-/*******************/
-
-/*************/
-/*           */
-/* Utilities */
-/*           */
-/*************/
+} /* end get_from_monitor() */
 
 /****************************************************************
 *
+* Presumably an ezcaXXXX() function has just been called.  It was
+* either called in the context of InGroup or not.  If InGroup,
+* then need a work node that can be placed onto the WorkList,
+* otherwise, need to get a good one for Workp;
 *
 ****************************************************************/
 
-static void append_to_work_list(struct work *wp)
+static struct work *get_work()
 {
 
-    if (wp)
-    {
-	if (Work_list.tail)
-	{
-	    /* non-empty list */
-	    Work_list.tail->next = wp;
-	    Work_list.tail = wp;
-	}
-	else
-	{
-	    /* empty list */
-	    Work_list.head = wp;
-	    Work_list.tail = wp;
-	} /* endif */
-    } /* endif */
-
-} /* end append_to_work_list() */
-
-/****************************************************************
-*
-* really should be in tsDefs.h
-*
-****************************************************************/
-
-static void copy_time_stamp(epicsTimeStamp *dest, epicsTimeStamp *src)
-{
+struct work *rc;
 
-    if (dest && src)
+    if (InGroup)
     {
-	dest->secPastEpoch = src->secPastEpoch;
-	dest->nsec = src->nsec;
-    } /* endif */
+	/* need to pop_work() for list; its strings */
+	/* live as long as the list does            */
+	if ((rc = pop_work()))
+	    rc->in_arena = TRUE;
+    }
+    else
+	/* need to use Workp */
+	rc = get_work_single();
 
-} /* end copy_time_stamp() */
+    return rc;
+
+} /* end get_work() */
 
 /****************************************************************
 *
+* It has been determined that we need to use Workp.  It may
+* be NULL or it may need to be trashed.  This function takes
+* care of all that and returns a clean and initialized Workp,
+* or it returns NULL if it cannot get one.
 *
 ****************************************************************/
 
-static void empty_work_list()
+static struct work *get_work_single()
 {
 
-struct work *wp;
+struct work *rc;
 
-    if (Debug)
+    if (Workp)
     {
-	printf("entering empty_work_list()\n");
-	print_state();
-    } /* endif */
+	if (usable != Workp->trashme)
+	{
+	    /* must trash this one and get a new one */
 
-    wp = Work_list.head;
-    while (wp)
-    {
-	Work_list.head = wp->next;
-	push_work(wp);
-	wp = Work_list.head;
-    } /* endwhile */
+	    push_work(Workp);
 
-    Work_list.head = (struct work *) NULL;
-    Work_list.tail = (struct work *) NULL;
+	    rc = Workp = pop_work();
 
-    if (Debug)
-    {
-	printf("work_list and work_avail after\n");
-	print_state();
-    } /* endif */
+	}
+	else
+	{
+	    rc = Workp;
+	    init_work(rc);
+	} /* endif */
+    }
+    else
+	/* no Workp available */
+	rc = Workp = pop_work();
 
-} /* end empty_work_list() */
+    return rc;
+
+} /* end get_work_single() */
 
 /****************************************************************
 *
-* attempts to find channel in Channels by pvname
 *
 ****************************************************************/
 
-static struct channel *find_channel(char *pvname)
+static void init(void *unused)
 {
 
-unsigned char hi;
-BOOL found;
-struct channel *rc;
 
-    if (pvname)
-    {
-	hi = hash(pvname);
+#ifdef EPICS_THREE_FOURTEEN
+	ezcaMutex = epicsMutexMustCreate();
+	ezcaCountMutex = epicsMutexMustCreate();
+	ezcaRegMutex = epicsMutexMustCreate();
+	ezcaTicketDone = epicsEventMustCreate(epicsEventEmpty);
+	ezcaCtxKey = epicsThreadPrivateCreate();
+#else
+    Initialized = TRUE;
+    /* the one and only thread */
+    Ctx = new_context();
+#endif
 
-	rc = Channels[hi];
-	found = FALSE;
-	while (rc && !found)
-	    if (!(found = !strcmp(rc->pvname, pvname)))
-		rc = rc->next;
-		else
-		rc->refcnt++;
-    }
-    else
-	rc = (struct channel *) NULL;
+    EzcaInitializeChannelAccess();
 
-    if (Trace || Debug)
+    Channel_avail_hdr = (struct channel *) NULL;
+    Monitor_avail_hdr = (struct monitor *) NULL;
+    Work_avail_hdr = (struct work *) NULL;
+
+    Discarded_channels = (struct channel *) NULL;
+    Discarded_monitors = (struct monitor *) NULL;
+    Discarded_work = (struct work *) NULL;
+
+    WorkAllocs = 0;
+
+    init_pool(&ChannelPool, sizeof(struct channel));
+    init_pool(&MonitorPool, sizeof(struct monitor));
+    init_pool(&WorkPool, sizeof(struct work));
+
+    if (!(Channels = ezcaRegCreate(CHANNEL_BUCKETS)))
     {
-	if (rc)
-	    printf("find_channel() found >%s<\n", pvname);
-	else
-	    /* do not attempt to print pvname here ... may not be printable */
-	    printf("find_channel() did not find channel\n");
+	fprintf(stderr, "EZCA FATAL ERROR: init() unable to create channel registry\n");
+	exit(1);
     } /* endif */
 
-    return rc;
+    /* Default Values for User Configurable Global Parameters */
+    AutoErrorMessage = TRUE;
+    TimeoutSeconds = (float)0.2;
+    SavedRetryCount = RetryCount = 75;
+    NotFoundHoldoff = (float)30.0;
 
-} /* end find_channel() */
+    Debug = FALSE;
+    Trace = FALSE;
+
+} /* end init() */
 
 /****************************************************************
 *
-* attempts to find channel in Channels by pvname
-* if not found, creates it and places it there.
-*
-* peforms all the necessary ca calls.  
-*
-* if everything went OK, * leaves wp unchanged and places pointer 
-* to channel in cpp.
+* Returns TRUE iff actually issued EzcaArrayGetCallback() and it
+* returned successfully.
 *
-* if something went wrong, cpp gets NULL and wp->rc set with
-* appropriate error message placed into wp->error_msg.
+* If something went wrong, then changes wp->rc and wp->error_msg, 
+* otherwise they're left alone.
 *
 ****************************************************************/
 
-static void get_channel(struct work *wp, struct channel **cpp)
+static BOOL issue_get(struct work *wp, struct channel *cp)
 {
 
-unsigned char hi;
-unsigned attempts;
-BOOL done;
-
-    if (!wp || !cpp)
-    {
-	fprintf(stderr, 
-	    "EZCA FATAL ERROR: get_channel() got wp %p cpp %p\n", wp, cpp);
-	exit(1);
-    } /* endif */
-
-    if (Debug)
-    {
-	printf("entering get_channel()\n");
-	print_state();
-    } /* endif */
+BOOL rc;
 
-    if (wp->pvname)
+    if (wp && cp)
     {
-	if ((*cpp = find_channel(wp->pvname)))
-	{
-	    if (Trace || Debug)
-		printf("get_channel(): was able to find_channel()\n");
-	}
-	else
+	if (EzcaConnected(cp))
 	{
-	    /* not in Channels ... must ca_search_and_connect() and add */
-	    if (Trace || Debug)
-printf("get_channel(): could not find_channel(). must ca_search_and_connect() and add\n");
-
-	    if ((*cpp = pop_channel()))
+	    if (wp->nelem <= (int)EzcaElementCount(cp))
 	    {
-		if (((*cpp)->pvname = strdup(wp->pvname)))
-		{
-
-		    if (EzcaQueueSearchAndConnect(wp, *cpp) == ECA_NORMAL)
-		    {
-			/* adding to Channels */
-			hi = hash((*cpp)->pvname);
-			(*cpp)->next = Channels[hi];
-			Channels[hi] = *cpp;
-
-			MARK_OUTSTANDING(1);
-
-			for (done = FALSE, attempts = 0; 
-			    !done && attempts <= RetryCount; attempts ++)
-			{
-			    if (Trace || Debug)
-				printf("get_channel(): attempt %d of %d\n", 
-				    attempts+1, RetryCount+1);
-
-			    if (EzcaPendEvent(wp,TimeoutSeconds,FALSE) == ECA_TIMEOUT)
-				done = EzcaConnected(*cpp);
-			} /* endfor */
-
-			ca_set_puser((*cpp)->cid, 0);
-
-			if ( !done ) {
-		    	clean_and_push_channel( cpp );
-		
-				if ( RetryCount )
-				{
-					wp->rc = EZCA_NOTIMELYRESPONSE;
-					wp->error_msg = ErrorMsgs[NO_PVAR_FOUND_MSG_IDX];
-				}
-				else
-				{
-	           		wp->rc = EZCA_ABORTED;
-	           		wp->error_msg = ErrorMsgs[ABORTED_MSG_IDX];
-				}
-				wp->aux_error_msg = strdup(wp->pvname);
-	
-				if (AutoErrorMessage)
-		    		print_error(wp);
-			}
-	    	} /* endif */
-		    else
-		    {
-			/* something went wrong ... rc and */
-			/* error msg have already been set */
+		wp->reported = FALSE;
 
-			clean_and_push_channel( cpp );
-		    } /* endif */
-		}
+		if (meta_from_cache(wp, cp))
+		    /* served locally; nothing to wait for */
+		    rc = FALSE;
+		else if (EzcaArrayGetCallback(wp, cp) == ECA_NORMAL)
+		    rc = TRUE;
 		else
 		{
-		    wp->rc = EZCA_FAILEDMALLOC;
-		    wp->error_msg = ErrorMsgs[FAILED_MALLOC_MSG_IDX];
+		    /* something went wrong ... rc and */
+		    /* error msg have already been set */
 
-		    if (AutoErrorMessage)
-			print_error(wp);
+		    /* need to trash this wp so it's */
+		    /* never used again in case the  */
+		    /* callback fires off later      */
+
+		    rc = FALSE;
+
+		    wp->trashme = trashed;
+		    if (Debug)
+			printf("trashing wp %p\n", wp);
 		} /* endif */
-	    } 
+	    }
 	    else
 	    {
-		wp->rc = EZCA_FAILEDMALLOC;
-		wp->error_msg = ErrorMsgs[FAILED_MALLOC_MSG_IDX];
+		/* too many requested elements */
+		rc = FALSE;
+
+		wp->rc = EZCA_INVALIDARG;
+		wp->error_msg = ErrorMsgs[TOO_MANY_NELEM_MSG_IDX];
 
 		if (AutoErrorMessage)
 		    print_error(wp);
 	    } /* endif */
-	} /* endif */
+	} 
+	else
+	    rc = FALSE;
     }
     else
     {
-	*cpp = (struct channel *) NULL;
-	wp->rc = EZCA_INVALIDARG;
-	wp->error_msg = ErrorMsgs[INVALID_PVNAME_MSG_IDX];
-
-	if (AutoErrorMessage)
-	    print_error(wp);
-    } /* endif */
-
-    if (Debug)
-    {
-	printf("channels and channel_avail after\n");
-	print_state();
+	fprintf(stderr, "EZCA FATAL ERROR: issue_get() got wp %p cp %p\n", 
+	    wp, cp);
+	exit(1);
     } /* endif */
 
-} /* end get_channel() */
-
-/* release a reference to a channel struct; decrement refcnt and
- * set referring pointer to NULL
- */
-
-static void
-release_channel( struct channel **cpp )
-{
-	if ( ! (*cpp) )
-		return;
+    return rc;
 
-	if ( (*cpp)->refcnt <= 0 ) {
-		fprintf(stderr,"EZCA FATAL ERROR: release_channel() called with refcnt <= 0\n");
-		exit(1);
-	}
-	(*cpp)->refcnt--;
-	*cpp = 0;
-}
+} /* end issue_get() */
 
 /****************************************************************
 *
-* A user is doing some kind of get (ezcaGet, ezcaGetStatus, ezcaGetWithStatus).
-* This function checks the channel for a monitor of the type specified in wp.
-* If it finds one, it copies the appropriate value(s) to wp and return TRUE.
-* Any other condition it returns FALSE.
-*
-* The only way wp->rc and wp->error_msg get affected is if the user
-* wants to read the value and wants more values than are available.
-* That is only possible if the monitor was found (i.e. returns TRUE).
-*
-* NOTE: This function does not care whether or not the channel is 
-*       currently connected ... that is the responsibility of the caller.
+* assumed upon entry that wp->rc is already = EZCA_OK
 *
 ****************************************************************/
 
-static BOOL get_from_monitor(struct work *wp, struct channel *cp)
+static void issue_wait(struct work *wp)
 {
 
-struct monitor *mp;
-BOOL found_error;
-BOOL rc;
+BOOL reported, error;
+unsigned attempts;
 
-    if (wp && cp)
+    if (wp)
     {
-	/* loop to check monitor list for */
-	/* monitor of the same type       */
-	mp = cp->monitor_list;
-	rc = FALSE;
-	while (mp && !rc)
-	    if (!(rc = ((wp->ezcadatatype == mp->ezcadatatype)
-			    && mp->active && mp->pval)))
-		mp = mp->right;
+	MARK_OUTSTANDING(1);
 
-	if (rc)
+	for (reported = FALSE, error = FALSE, attempts = 0;
+	    !reported && !error && attempts <= RetryCount; 
+		attempts ++)
 	{
 	    if (Trace || Debug)
-		printf("get_from_monitor(): found active monitor with value\n");
-
-	    found_error = FALSE;
+		printf("issue_wait(): attempt %d of %d\n", 
+		    attempts+1, RetryCount+1);
 
-	    if (wp->pval)
+	    if (EzcaPendEvent(wp, TimeoutSeconds, FALSE) == ECA_TIMEOUT)
+		reported = wp->reported;
+	    else
 	    {
-		/* wants the value from the monitor */
+		/* something went wrong ... rc and */
+		/* error msg have already been set */
 
-		if (wp->nelem <= mp->last_nelem)
-		{
-		    /* time to copy the data */
-		    switch (wp->ezcadatatype)
-		    {
-			case ezcaByte:
-			    memcpy((char *) (wp->pval), 
-				(char *) (mp->pval),
-				wp->nelem*dbr_value_size[DBR_TIME_CHAR]);
+		/* need to trash this wp so it's */
+		/* never used again in case the  */
+		/* callback fires off later      */
 
-			    if (Trace || Debug)
-	    printf("get_from_monitor() just memcpy %d bytes from %p to %p\n",
-				wp->nelem*dbr_value_size[DBR_TIME_CHAR],
-				mp->pval, wp->pval);
+		error = TRUE;
 
-			    break;
-			case ezcaString:
-			    memcpy((char *) (wp->pval), 
-				(char *) (mp->pval),
-			    wp->nelem*dbr_value_size[DBR_TIME_STRING]);
+		trash_work(wp);
+	    } /* endif */
+	} /* endfor */
 
-			    if (Trace || Debug)
-	    printf("get_from_monitor() just memcpy %d bytes from %p to %p\n",
-			    wp->nelem*dbr_value_size[DBR_TIME_STRING], 
-				mp->pval, wp->pval);
+	/* the callback may have come in just now */
+	if (!reported && !error && !trash_unreported(wp))
+	    reported = TRUE;
 
-			    break;
-			case ezcaShort:
-			    memcpy((char *) (wp->pval), 
-				(char *) (mp->pval),
-			    wp->nelem*dbr_value_size[DBR_TIME_SHORT]);
+	if (!reported && !error)
+	{
+	    /* callback did not respond back */
+	    /* int time no value received    */
 
-			    if (Trace || Debug)
-	    printf("get_from_monitor() just memcpy %d bytes from %p to %p\n",
-			    wp->nelem*dbr_value_size[DBR_TIME_SHORT], 
-				mp->pval, wp->pval);
+	    /* need to trash this wp so it's */
+	    /* never used again in case the  */
+	    /* callback fires off later      */
 
-			    break;
-			case ezcaLong:
-			    memcpy((char *) (wp->pval), 
-				(char *) (mp->pval),
-			    wp->nelem*dbr_value_size[DBR_TIME_LONG]);
+		if ( RetryCount )
+		{
+	    	wp->rc = EZCA_NOTIMELYRESPONSE;
+	    	wp->error_msg = ErrorMsgs[NO_RESPONSE_IN_TIME_MSG_IDX];
+		}
+		else
+		{
+			wp->rc = EZCA_ABORTED;
+			wp->error_msg = ErrorMsgs[ABORTED_MSG_IDX];
+		}
 
-			if (Trace || Debug)
-	    printf("get_from_monitor() just memcpy %d bytes from %p to %p\n",
-				wp->nelem*dbr_value_size[DBR_TIME_LONG],
-				mp->pval, wp->pval);
+	    if (AutoErrorMessage)
+		print_error(wp);
+	} /* endif */
+    } 
+    else
+    {
+	fprintf(stderr, "EZCA FATAL ERROR: issue_wait() got NULL wp\n");
+	exit(1);
+    } /* endif */
 
-			    break;
-			case ezcaFloat:
-			    memcpy((char *) (wp->pval), (char *) (mp->pval),
-				wp->nelem*dbr_value_size[DBR_TIME_FLOAT]);
+} /* end issue_wait() */
 
-			    if (Trace || Debug)
-	    printf("get_from_monitor() just memcpy %d bytes from %p to %p\n",
-				wp->nelem*dbr_value_size[DBR_TIME_FLOAT], 
-				mp->pval, wp->pval);
+/****************************************************************
+*
+* Gives up on work whose get/put callback may still fire. The
+* callback fills in the results and sets 'reported' holding the
+* lock of the channel it was issued on (wp->cbcp) but not
+* ezcaMutex, hence the node is trashed under that lock, too.
+* trash_unreported() leaves work which has reported meanwhile
+* alone and returns FALSE then. Gets which joined the request
+* are detached (see detach_joined()); those of other owners get
+* a request of their own (reissue_get()).
+*
+****************************************************************/
 
-			    break;
-			case ezcaDouble:
-			    memcpy((char *) (wp->pval), (char *) (mp->pval),
-				wp->nelem*dbr_value_size[DBR_TIME_DOUBLE]);
+static void trash_work(struct work *wp)
+{
 
-			    if (Trace || Debug)
-	    printf("get_from_monitor() just memcpy %d bytes from %p to %p\n",
-				wp->nelem*dbr_value_size[DBR_TIME_DOUBLE], 
-				mp->pval, wp->pval);
+struct channel *cp = wp->cbcp;
+struct work *lp = (struct work *) NULL;
 
-			    break;
-			default:
-			    fprintf(stderr, 
-"EZCA FATAL ERROR: get_from_monitor() found unrecognizable ezcadatatype %d\n",
-				wp->ezcadatatype);
-			    exit(1);
-			    break;
-		    } /* end switch() */
+    if (cp)
+	CHAN_LOCK(cp);
+    wp->trashme = trashed;
+    if (cp)
+    {
+	lp = detach_joined(cp, wp);
+	CHAN_UNLOCK(cp);
+    } /* endif */
 
-		    mp->needs_reading = FALSE;
-		}
-		else
-		{
-		    /* too many requested elements */
-		    found_error = TRUE;
+    if (lp)
+	reissue_get(cp, lp);
 
-		    wp->rc = EZCA_INVALIDARG;
-		    wp->error_msg = ErrorMsgs[TOO_MANY_NELEM_MSG_IDX];
+    if (Debug)
+	printf("trashing wp %p\n", wp);
 
-		    if (AutoErrorMessage)
-			print_error(wp);
-		} /* endif */
-	    } /* endif */
+} /* end trash_work() */
 
-	    if (!found_error)
-	    {
-		if (wp->status)
-		{
-		    /* wants the status from the monitor */
+static BOOL trash_unreported(struct work *wp)
+{
 
-		    *(wp->status) = mp->status;
+struct channel *cp = wp->cbcp;
+struct work *lp = (struct work *) NULL;
+BOOL rc;
 
-		    if (Trace || Debug)
-			printf("get_from_monitor() just copied status %d\n", 
-			    *(wp->status));
-		} /* endif */
+    if (cp)
+	CHAN_LOCK(cp);
+    if ((rc = !wp->reported))
+    {
+	wp->trashme = trashed;
+	if (cp)
+	    lp = detach_joined(cp, wp);
+    } /* endif */
+    if (cp)
+	CHAN_UNLOCK(cp);
 
-		if (wp->severity)
-		{
-		    /* wants the severity from the monitor */
+    if (lp)
+	reissue_get(cp, lp);
 
-		    *(wp->severity) = mp->severity;
+    if (rc && Debug)
+	printf("trashing wp %p\n", wp);
 
-		    if (Trace || Debug)
-			printf("get_from_monitor() just copied severity %d\n",
-			    *(wp->severity));
-		} /* endif */
+    return rc;
 
-		if (wp->tsp)
-		{
-		    /* wants the time from the monitor */
+} /* end trash_unreported() */
 
-		    copy_time_stamp(wp->tsp, &(mp->time_stamp));
+/****************************************************************
+*
+* Single-flight gets: a get of the same kind (worktype) for the
+* same DBR type and count as one in flight on the channel joins it
+* instead of issuing a request of its own; my_get_callback() hands
+* the reply to all the nodes.
+* Returns TRUE if wp joined, otherwise wp is now in flight itself.
+* Called with ezcaMutex held (so nobody joins before the request
+* is actually issued).
+*
+****************************************************************/
 
-		    if (Trace || Debug)
-			printf("get_from_monitor() just copied time\n");
-		} /* endif */
-	    } /* endif */
-	} /* endif */
+static BOOL join_get(struct work *wp, struct channel *cp)
+{
+
+struct work *lp, **pp;
+
+    CHAN_LOCK(cp);
+
+    for (lp = cp->inflight; lp; lp = lp->next_inflight)
+    {
+	if (lp->worktype == wp->worktype
+	    && lp->dbr_type == wp->dbr_type && lp->nelem == wp->nelem)
+	    break;
+    } /* endfor */
+
+    wp->joined = (struct work *) NULL;
+
+    if (lp)
+    {
+	/* served in the order they came */
+	for (pp = &lp->joined; *pp; pp = &(*pp)->joined)
+	    ;
+	*pp = wp;
     }
     else
     {
-	fprintf(stderr, 
-	    "EZCA FATAL ERROR: get_from_monitor() got wp %p cp %p\n", wp, cp);
-	exit(1);
+	wp->next_inflight = cp->inflight;
+	cp->inflight = wp;
     } /* endif */
 
-    return rc;
+    CHAN_UNLOCK(cp);
 
-} /* end get_from_monitor() */
+    if (lp && (Trace || Debug))
+	printf("join_get() >%s< joined wp %p\n", WORK_PVNAME(wp), lp);
+
+    return (lp != (struct work *) NULL);
+
+} /* end join_get() */
 
 /****************************************************************
 *
-* Presumably an ezcaXXXX() function has just been called.  It was
-* either called in the context of InGroup or not.  If InGroup,
-* then need a work node that can be placed onto the WorkList,
-* otherwise, need to get a good one for Workp;
+* takes wp off the list of joinable gets of the channel (if it is
+* still there); called with the lock of the channel held
 *
 ****************************************************************/
 
-static struct work *get_work()
+static void leave_inflight(struct channel *cp, struct work *wp)
 {
 
-struct work *rc;
+struct work **pp;
 
-    if (InGroup)
-	/* need to pop_work() for list */
-	rc = pop_work();
-    else
-	/* need to use Workp */
-	rc = get_work_single();
+    for (pp = &cp->inflight; *pp; pp = &(*pp)->next_inflight)
+    {
+	if (*pp == wp)
+	{
+	    *pp = wp->next_inflight;
+	    break;
+	} /* endif */
+    } /* endfor */
+
+    wp->next_inflight = (struct work *) NULL;
+
+} /* end leave_inflight() */
+
+/* work of the same thread (group or single request) or of the */
+/* same async group                                              */
+#define SAME_OWNER(a, b) \
+	((a)->ticket ? (a)->ticket == (b)->ticket \
+		     : (!(b)->ticket && (a)->ctx == (b)->ctx))
+
+/****************************************************************
+*
+* the request of wp is given up on (wp is being trashed): nobody
+* may join it any more and the nodes which joined it won't get
+* its reply.
+*  - trashed joiners are recycled (no reply reaches them now);
+*  - those of wp's owner are completed with a failure - that of
+*    wp if it has one, otherwise no (timely) response - and
+*    counted down;
+*  - those of other owners still wait by their own deadlines;
+*    they are chained (through 'joined') behind the first of
+*    them which is returned for reissue_get().
+* Called with ezcaMutex and the lock of the channel held.
+*
+****************************************************************/
+
+static struct work *detach_joined(struct channel *cp, struct work *wp)
+{
+
+struct work *jp;
+struct work *lead = (struct work *) NULL;
+struct work **tail = &lead;
+
+    leave_inflight(cp, wp);
+
+    while ((jp = wp->joined))
+    {
+	wp->joined = jp->joined;
+	jp->joined = (struct work *) NULL;
+
+	if (usable != jp->trashme)
+	{
+	    recycle_work(jp);
+	    continue;
+	} /* endif */
+
+	if (jp->reported)
+	    continue;
+
+	if (!SAME_OWNER(wp, jp))
+	{
+	    *tail = jp;
+	    tail = &jp->joined;
+	    continue;
+	} /* endif */
+
+	if (wp->rc != EZCA_OK)
+	{
+	    jp->rc = wp->rc;
+	    jp->error_msg = wp->error_msg;
+	}
+	else if (RetryCount)
+	{
+	    jp->rc = EZCA_NOTIMELYRESPONSE;
+	    jp->error_msg = ErrorMsgs[NO_RESPONSE_IN_TIME_MSG_IDX];
+	}
+	else
+	{
+	    jp->rc = EZCA_ABORTED;
+	    jp->error_msg = ErrorMsgs[ABORTED_MSG_IDX];
+	} /* endif */
+
+	if (Trace || Debug)
+	    printf("detach_joined() wp %p gives up on %p\n", jp, wp);
 
-    return rc;
+	jp->reported = TRUE;
+	WORK_DONE(jp);
+    } /* endwhile */
 
-} /* end get_work() */
+    return lead;
+
+} /* end detach_joined() */
 
 /****************************************************************
 *
-* It has been determined that we need to use Workp.  It may
-* be NULL or it may need to be trashed.  This function takes
-* care of all that and returns a clean and initialized Workp,
-* or it returns NULL if it cannot get one.
+* issues the get which 'lp' and the nodes chained to it (see
+* detach_joined()) had joined once more, on behalf of lp. If
+* that fails they all are completed with the failure. Called
+* with ezcaMutex held (so nobody joins before the request is
+* issued) but not the lock of the channel.
 *
 ****************************************************************/
 
-static struct work *get_work_single()
+static void reissue_get(struct channel *cp, struct work *lp)
 {
 
-struct work *rc;
+struct work *jp;
+int rc;
 
-    if (Workp)
-    {
-	if (usable != Workp->trashme)
-	{
-	    /* must trash this one and get a new one */
+    if (Trace || Debug)
+	printf("reissue_get() >%s< wp %p takes over\n", WORK_PVNAME(lp), lp);
 
-	    push_work(Workp);
+    set_deadline(&lp->issued, 0.);
 
-	    rc = Workp = pop_work();
+    EZCA_TRACE(EZCA_EV_ISSUE_GET, lp, lp->dbr_type, lp->nelem);
 
-	}
-	else
-	{
-	    rc = Workp;
-	    init_work(rc);
-	} /* endif */
+    rc = ca_array_get_callback(lp->dbr_type, (unsigned long) lp->nelem,
+		cp->cid, my_get_callback, (void *) lp);
+
+    CHAN_LOCK(cp);
+
+    if (rc == ECA_NORMAL)
+    {
+	/* joinable again */
+	lp->next_inflight = cp->inflight;
+	cp->inflight = lp;
     }
     else
-	/* no Workp available */
-	rc = Workp = pop_work();
+    {
+	for (; lp; lp = jp)
+	{
+	    jp = lp->joined;
+	    lp->joined = (struct work *) NULL;
+
+	    lp->rc = EZCA_CAFAILURE;
+	    lp->error_msg = ErrorMsgs[CAARRAYGETCALL_MSG_IDX];
+	    lp->reported = TRUE;
+	    /* the owner may reuse lp from here on */
+	    WORK_DONE(lp);
+	} /* endfor */
+    } /* endif */
 
-    return rc;
+    CHAN_UNLOCK(cp);
 
-} /* end get_work_single() */
+    if (rc == ECA_NORMAL)
+	ca_flush_io();
+
+} /* end reissue_get() */
 
 /****************************************************************
 *
-* The hash algorithm is the algorithm described in:                 
-* "Fast Hashing of Variable Length Text Strings", Peter K. Pearson,
-* Communications of the ACM, June 1990.                           
+* a put was issued on the channel; gets in flight may have been
+* read before it so later gets must not join them. Called with
+* the lock of the channel held.
 *
 ****************************************************************/
 
-static unsigned char hash(char *pvname)
+static void close_inflight(struct channel *cp)
 {
 
-unsigned char rc;
+struct work *wp;
 
-    for (rc = 0; *pvname; pvname ++)
-	rc = RandomNumbers[rc^*pvname];
+    while ((wp = cp->inflight))
+    {
+	cp->inflight = wp->next_inflight;
+	wp->next_inflight = (struct work *) NULL;
+    } /* endwhile */
 
-    return rc;
+} /* end close_inflight() */
+
+/****************************************************************
+*
+*
+****************************************************************/
+
+static void print_error(struct work *wp)
+{
+
+    if (wp)
+    {
+	if (wp->rc == EZCA_OK)
+	    printf("%s\n", OKMSG);
+	else
+	{
+	    if (wp->error_msg || wp->aux_error_msg)
+	    {
+		if (wp->error_msg)
+		    printf("%s", wp->error_msg);
+		if (wp->aux_error_msg)
+		    printf(" : %s", wp->aux_error_msg);
+		printf("\n");
+	    } /* endif */
+	} /* endif */
+    } /* endif */
 
-} /* end hash() */
+} /* end print_error() */
 
 /****************************************************************
 *
+* this gets called at the beginning of all the ezca routines.
+* since there is no work node to place the return code from
+* ca_pend_event(), we must print error messages directly from 
+* here when a non-ok rc (ok means ECA_TIMEOUT) comes from ca_pend_event().
 *
 ****************************************************************/
 
-static void init(void *unused)
+static void prologue_at(struct lock_site *sp)
 {
 
-int i;
+int rc;
+
+	DO_INIT_ONCE();
 
 #ifdef EPICS_THREE_FOURTEEN
-	ezcaMutex = epicsMutexMustCreate();
-	ezcaDone  = epicsEventMustCreate(epicsEventEmpty);
-#else
-    Initialized = TRUE;
+	/* the context may have been created by another thread */
+	/* (e.g., a warm start in the background)              */
+	if ( !ca_current_context() && CaContext )
+		ca_attach_context(CaContext);
 #endif
 
-    EzcaInitializeChannelAccess();
+	EZCA_LOCK_AT(sp);
 
-    Channel_avail_hdr = (struct channel *) NULL;
-    Monitor_avail_hdr = (struct monitor *) NULL;
-    Work_avail_hdr = (struct work *) NULL;
-    Workp = (struct work *) NULL;
+    /* restore retry count in case they aborted */
+    RetryCount = SavedRetryCount;
 
-    Discarded_channels = (struct channel *) NULL;
-    Discarded_monitors = (struct monitor *) NULL;
-    Discarded_work = (struct work *) NULL;
+    /* requests we gave up on (trashed) were never counted down */
+    RESET_OUTSTANDING();
+
+    {
+	/* with preemptive callbacks there is nothing to pend for; */
+	/* calls that don't talk to CA (e.g. on cached channels)   */
+	/* then never leave the library                             */
+	if (!InGroup && !PreemptiveCallbacks)
+	{
+	    /* whole purpose of being InGroup is so that ca_pend_event() */
+	    /* can be done at ezcaEndGroup() */
 
-    Work_list.head = (struct work *) NULL;
-    Work_list.tail = (struct work *) NULL;
+	    rc = EzcaPendEvent((struct work *) NULL, SHORT_TIME, TRUE);
 
-    for (i = 0; i < HASHTABLESIZE; i ++)
-	Channels[i] = (struct channel *) NULL;
+	    if (rc != ECA_TIMEOUT)
+		fprintf(stderr, "%s: %s", PROLOGUE_MSG, ca_message(rc));
+	} /* endif */
+    } /* endif */
 
-    ErrorLocation = SINGLEWORK;
-    ListPrint = LASTONLY;
+    /* without evict_thread() the calls evict, a pass per EVICT_PERIOD; */
+    /* only every EVICT_CALLS-th call looks at the clock                */
+    if (!EvictInBackground && EVICTING()
+	&& 0 == (++EvictCalls & (EVICT_CALLS - 1))
+	&& !InGroup && time_left(&EvictDue) <= 0.)
+    {
+	(void) evict_channels(EVICT_BUDGET);
+	set_deadline(&EvictDue, EVICT_PERIOD);
+    } /* endif */
 
-    /* Default Values for User Configurable Global Parameters */
-    AutoErrorMessage = TRUE;
-    InGroup = FALSE;
-    TimeoutSeconds = (float)0.2;
-    SavedRetryCount = RetryCount = 75;
+    if (Debug)
+    {
+	printf("--start end-of-prologue() report\n");
+	print_state();
+	printf("--end end-of-prologue() report\n");
+    } /* endif */
 
-    Debug = FALSE;
-    Trace = FALSE;
+} /* end prologue_at() */
 
-} /* end init() */
+static void epilogue()
+{
+	EZCA_UNLOCK();
+}
 
 /****************************************************************
 *
-* Returns TRUE iff actually issued EzcaArrayGetCallback() and it
-* returned successfully.
-*
-* If something went wrong, then changes wp->rc and wp->error_msg, 
-* otherwise they're left alone.
+* creates a thread's context (see struct context) or reuses that
+* of an exited thread; called with ezcaMutex held
 *
 ****************************************************************/
 
-static BOOL issue_get(struct work *wp, struct channel *cp)
+static struct context *new_context()
 {
 
-BOOL rc;
+struct context *cx;
 
-    if (wp && cp)
+    if ((cx = Context_avail_hdr))
     {
-	if (EzcaConnected(cp))
-	{
-	    if (wp->nelem <= (int)EzcaElementCount(cp))
-	    {
-		wp->reported = FALSE;
+	Context_avail_hdr = cx->next;
+    }
+    else if (!(cx = (struct context *) ezcacalloc(1, sizeof(*cx))))
+    {
+	fprintf(stderr, "EZCA FATAL ERROR: new_context() unable to allocate a thread context\n");
+	exit(1);
+    }
+    else
+    {
+#ifdef EPICS_THREE_FOURTEEN
+	cx->done = epicsEventMustCreate(epicsEventEmpty);
+#endif
+    } /* endif */
 
-		if (EzcaArrayGetCallback(wp, cp) == ECA_NORMAL)
-		    rc = TRUE;
-		else
-		{
-		    /* something went wrong ... rc and */
-		    /* error msg have already been set */
+    cx->work_list.head = (struct work *) NULL;
+    cx->work_list.tail = (struct work *) NULL;
+    cx->workp = (struct work *) NULL;
+    cx->work_list_group = (EzcaGroup) NULL;
+    cx->group_arena.blks = (struct arena_blk *) NULL;
+    cx->group_arena.total = 0;
+    cx->group_arena.hint = 0;
+    cx->error_location = SINGLEWORK;
+    cx->list_print = LASTONLY;
+    cx->in_group = FALSE;
+    cx->awaiting = (struct channel *) NULL;
+    cx->outstanding = 0;
 
-		    /* need to trash this wp so it's */
-		    /* never used again in case the  */
-		    /* callback fires off later      */
+    cx->next = Contexts;
+    Contexts = cx;
 
-		    rc = FALSE;
+    return cx;
 
-		    wp->trashme = trashed;
-		    if (Debug)
-			printf("trashing wp %p\n", wp);
-		} /* endif */
-	    }
-	    else
-	    {
-		/* too many requested elements */
-		rc = FALSE;
+} /* end new_context() */
 
-		wp->rc = EZCA_INVALIDARG;
-		wp->error_msg = ErrorMsgs[TOO_MANY_NELEM_MSG_IDX];
+#ifdef EPICS_THREE_FOURTEEN
+/****************************************************************
+*
+* the context of the calling thread (what 'Ctx' stands for);
+* created on first use, which is always with ezcaMutex held
+*
+****************************************************************/
 
-		if (AutoErrorMessage)
-		    print_error(wp);
-	    } /* endif */
-	} 
-	else
-	    rc = FALSE;
-    }
-    else
+static struct context *ctx_self()
+{
+
+struct context *cx;
+
+    if (!(cx = (struct context *) epicsThreadPrivateGet(ezcaCtxKey)))
     {
-	fprintf(stderr, "EZCA FATAL ERROR: issue_get() got wp %p cp %p\n", 
-	    wp, cp);
-	exit(1);
+	cx = new_context();
+	epicsThreadPrivateSet(ezcaCtxKey, cx);
+#ifdef EZCA_CTX_AT_EXIT
+	(void) epicsAtThreadExit(ctx_exit, (void *) cx);
+#endif
     } /* endif */
 
-    return rc;
+    return cx;
 
-} /* end issue_get() */
+} /* end ctx_self() */
+#endif
 
+#ifdef EZCA_CTX_AT_EXIT
 /****************************************************************
 *
-* assumed upon entry that wp->rc is already = EZCA_OK
+* the thread owning context 'arg' exits: gives back its work
+* nodes (trashed ones are discarded as usual) and group memory
+* and keeps the context for the next new thread. Anything the
+* thread issued has been reported or trashed by the time its
+* API call returned, except for async groups which count down
+* their tickets.
 *
 ****************************************************************/
 
-static void issue_wait(struct work *wp)
+static void epicsShareAPI ctx_exit(void *arg)
 {
 
-BOOL reported, error;
-unsigned attempts;
-
-    if (wp)
-    {
-	MARK_OUTSTANDING(1);
-
-	for (reported = FALSE, error = FALSE, attempts = 0;
-	    !reported && !error && attempts <= RetryCount; 
-		attempts ++)
-	{
-	    if (Trace || Debug)
-		printf("issue_wait(): attempt %d of %d\n", 
-		    attempts+1, RetryCount+1);
+struct context *cx = (struct context *) arg;
+struct context **pp;
 
-	    if (EzcaPendEvent(wp, TimeoutSeconds, FALSE) == ECA_TIMEOUT)
-		reported = wp->reported;
-	    else
-	    {
-		/* something went wrong ... rc and */
-		/* error msg have already been set */
+	EZCA_LOCK();
 
-		/* need to trash this wp so it's */
-		/* never used again in case the  */
-		/* callback fires off later      */
+    /* 'Ctx' must still be this context while we clean up */
+    epicsThreadPrivateSet(ezcaCtxKey, cx);
 
-		error = TRUE;
+    empty_work_list();
+    InGroup = FALSE;
 
-		wp->trashme = trashed;
+    if (Workp)
+    {
+	push_work(Workp);
+	Workp = (struct work *) NULL;
+    } /* endif */
 
-		if (Debug)
-		    printf("trashing wp %p\n", wp);
-	    } /* endif */
-	} /* endfor */
+    arena_free(&Group_arena);
 
-	if (!reported && !error)
-	{
-	    /* callback did not respond back */
-	    /* int time no value received    */
+    cx->awaiting = (struct channel *) NULL;
+    epicsMutexLock(ezcaCountMutex);
+    cx->outstanding = 0;
+    epicsMutexUnlock(ezcaCountMutex);
 
-	    /* need to trash this wp so it's */
-	    /* never used again in case the  */
-	    /* callback fires off later      */
+    for (pp = &Contexts; *pp && *pp != cx; pp = &(*pp)->next)
+	;
+    if (*pp)
+	*pp = cx->next;
 
-		if ( RetryCount )
-		{
-	    	wp->rc = EZCA_NOTIMELYRESPONSE;
-	    	wp->error_msg = ErrorMsgs[NO_RESPONSE_IN_TIME_MSG_IDX];
-		}
-		else
-		{
-			wp->rc = EZCA_ABORTED;
-			wp->error_msg = ErrorMsgs[ABORTED_MSG_IDX];
-		}
+    cx->next = Context_avail_hdr;
+    Context_avail_hdr = cx;
 
-	    if (AutoErrorMessage)
-		print_error(wp);
-	    wp->trashme = trashed;
+    epicsThreadPrivateSet(ezcaCtxKey, (void *) NULL);
 
-	    if (Debug)
-		printf("trashing wp %p\n", wp);
-	} /* endif */
-    } 
-    else
-    {
-	fprintf(stderr, "EZCA FATAL ERROR: issue_wait() got NULL wp\n");
-	exit(1);
-    } /* endif */
+	EZCA_UNLOCK();
 
-} /* end issue_wait() */
+} /* end ctx_exit() */
+#endif
 
 /****************************************************************
 *
+* a channel marked for reporting has connected; counts down for
+* the threads waiting in wait_connected()
 *
 ****************************************************************/
 
-static void print_error(struct work *wp)
+static void post_connected(struct channel *cp)
 {
 
-    if (wp)
-    {
-	if (wp->rc == EZCA_OK)
-	    printf("%s\n", OKMSG);
-	else
+struct context *cx;
+
+    for (cx = Contexts; cx; cx = cx->next)
+    {
+	if (cx->awaiting == cp)
 	{
-	    if (wp->error_msg || wp->aux_error_msg)
-	    {
-		if (wp->error_msg)
-		    printf("%s", wp->error_msg);
-		if (wp->aux_error_msg)
-		    printf(" : %s", wp->aux_error_msg);
-		printf("\n");
-	    } /* endif */
+	    cx->awaiting = (struct channel *) NULL;
+	    POST_DONE(cx);
 	} /* endif */
-    } /* endif */
+    } /* endfor */
 
-} /* end print_error() */
+} /* end post_connected() */
 
+#ifdef EPICS_THREE_FOURTEEN
 /****************************************************************
 *
-* this gets called at the beginning of all the ezca routines.
-* since there is no work node to place the return code from
-* ca_pend_event(), we must print error messages directly from 
-* here when a non-ok rc (ok means ECA_TIMEOUT) comes from ca_pend_event().
+* EZCA_LOCK()/EZCA_UNLOCK(). With the statistics on, a failing
+* trylock counts as contention and the wait for the lock is timed;
+* the outermost acquisition is also timed until its release and
+* booked on its site. The nesting depth is always kept so that
+* switching the statistics on or off at any time is safe.
 *
 ****************************************************************/
 
-static void prologue()
+static void lock_enter(struct lock_site *sp)
 {
 
-int rc;
-
-	DO_INIT_ONCE();
+epicsTimeStamp t0, t1;
+double dt;
+BOOL contended = FALSE;
 
-	EZCA_LOCK();
+    if (!LockStats)
+    {
+	epicsMutexLock(ezcaMutex);
+	LockDepth++;
+	return;
+    } /* endif */
 
-    /* restore retry count in case they aborted */
-    RetryCount = SavedRetryCount;
+    if (epicsMutexTryLock(ezcaMutex) != epicsMutexLockOK)
+    {
+	contended = TRUE;
+	epicsTimeGetCurrent(&t0);
+	epicsMutexLock(ezcaMutex);
+	epicsTimeGetCurrent(&t1);
+    } /* endif */
 
+    /* we own the statistics now */
+    if (!sp->registered)
     {
-	if (!InGroup)
-	{
-	    /* whole purpose of being InGroup is so that ca_pend_event() */
-	    /* can be done at ezcaEndGroup() */
+	sp->registered = TRUE;
+	sp->next = LockSites;
+	LockSites = sp;
+    } /* endif */
 
-	    rc = EzcaPendEvent((struct work *) NULL, SHORT_TIME, TRUE);
+    sp->count++;
 
-	    if (rc != ECA_TIMEOUT)
-		fprintf(stderr, "%s: %s", PROLOGUE_MSG, ca_message(rc));
-	} /* endif */
+    if (contended)
+    {
+	dt = epicsTimeDiffInSeconds(&t1, &t0);
+	sp->contended++;
+	sp->wait_sum += dt;
+	if (dt > sp->wait_max)
+	    sp->wait_max = dt;
     } /* endif */
 
-    if (Debug)
+    if (0 == LockDepth++)
     {
-	printf("--start end-of-prologue() report\n");
-	print_state();
-	printf("--end end-of-prologue() report\n");
+	LockHolder = sp;
+	if (contended)
+	    LockHeldSince = t1;
+	else
+	    epicsTimeGetCurrent(&LockHeldSince);
     } /* endif */
 
-} /* end prologue() */
+} /* end lock_enter() */
 
-static void epilogue()
+static void lock_leave()
 {
-	EZCA_UNLOCK();
-}
+
+epicsTimeStamp now;
+double dt;
+
+    if (0 == --LockDepth && LockHolder)
+    {
+	if (LockStats)
+	{
+	    epicsTimeGetCurrent(&now);
+	    dt = epicsTimeDiffInSeconds(&now, &LockHeldSince);
+	    LockHolder->holds++;
+	    LockHolder->hold_sum += dt;
+	    if (dt > LockHolder->hold_max)
+		LockHolder->hold_max = dt;
+	} /* endif */
+	LockHolder = (struct lock_site *) NULL;
+    } /* endif */
+
+    epicsMutexUnlock(ezcaMutex);
+
+} /* end lock_leave() */
+#endif
 
 /**************************************/
 /*                                    */
@@ -4962,21 +9336,7 @@ int rc;
 	exit(1);
     } /* endif */
 
-    switch (mp->ezcadatatype)
-    {
-	case ezcaByte:   mp->dbr_type = DBR_TIME_CHAR;   break;
-	case ezcaString: mp->dbr_type = DBR_TIME_STRING; break;
-	case ezcaShort:  mp->dbr_type = DBR_TIME_SHORT;  break;
-	case ezcaLong:   mp->dbr_type = DBR_TIME_LONG;   break;
-	case ezcaFloat:  mp->dbr_type = DBR_TIME_FLOAT;  break;
-	case ezcaDouble: mp->dbr_type = DBR_TIME_DOUBLE; break;
-	default: 
-	    fprintf(stderr, 
-    "EZCA FATAL ERROR: EzcaAddEvent() got unrecognizable ezca data type %d\n", 
-		mp->ezcadatatype);
-	    exit(1);
-	    break;
-    } /* end switch() */
+    /* mp->dbr_type was filled in by the caller */
 
     if (Trace || Debug)
     {
@@ -4996,7 +9356,7 @@ int rc;
 	wp->rc = EZCA_CAFAILURE;
 
 	wp->error_msg = ErrorMsgs[CAADDARRAYEVENT_MSG_IDX];
-	wp->aux_error_msg = strdup(ca_message(rc));
+	wp->aux_error_msg = work_strdup(wp, ca_message(rc));
 
 	if (AutoErrorMessage)
 	    print_error(wp);
@@ -5100,12 +9460,14 @@ BOOL rc;
 *	     or GETWITHSTATUS(val, time,stat, sevr)
 *        here a DBR_TIME_XXXX based on wp->dbr_type
 *     Type 2: GETUNITS, GETGRAPHICLIMITS, GETCONTROLLIMITS, 
-*        GETWARNLIMITS, GETALARMLIMITS or GETPRECISION, GETENUMSTATES
+*        GETWARNLIMITS, GETALARMLIMITS or GETPRECISION, GETENUMSTATES,
+*        GETMETADATA
 *        here a DBR_CTRL_XXXX based on native type
 *        Note: native type = DBR_STRING, none of these wortype
 *              requests are defined.
 *        Note: GETPRECISION defined for native type DBR_FLOAT or DBR_DOUBLE
 *        Note: GETENUMSTATES defined for native type DBR_ENUM
+*        Note: GETMETADATA defined for all but DBR_STRING
 *
 * if evertything goes ok, then wp is unchanged.
 *
@@ -5178,7 +9540,7 @@ int rc;
 	{
 	    rc = wp->rc = EZCA_CAFAILURE;
 	    wp->error_msg = ErrorMsgs[CAARRAYGETCALL_MSG_IDX];
-	    wp->aux_error_msg = strdup(ECA_BADCHID_MSG);
+	    wp->aux_error_msg = work_strdup(wp, ECA_BADCHID_MSG);
 
 	    if (AutoErrorMessage)
 		print_error(wp);
@@ -5187,7 +9549,7 @@ int rc;
     else if (wp->worktype == GETUNITS || wp->worktype == GETGRAPHICLIMITS 
 	|| wp->worktype == GETWARNLIMITS || wp->worktype == GETALARMLIMITS
 	|| wp->worktype == GETCONTROLLIMITS || wp->worktype == GETPRECISION
-	|| wp->worktype == GETENUMSTATES)
+	|| wp->worktype == GETENUMSTATES || wp->worktype == GETMETADATA)
     {
 	/* requesting dbr_ctrl_xxxx based on native type */
 	if (EzcaConnected(cp))
@@ -5195,7 +9557,7 @@ int rc;
 	    switch (EzcaNativeType(cp))
 	    {
 		case DBF_ENUM:
-			if ( GETENUMSTATES == wp->worktype )
+			if ( GETENUMSTATES == wp->worktype || GETMETADATA == wp->worktype )
 			{
 				wp->dbr_type = DBR_CTRL_ENUM;
 				break;
@@ -5209,7 +9571,7 @@ int rc;
 		    rc = wp->rc = EZCA_UDFREQ;
 
 		    wp->error_msg = ErrorMsgs[CAARRAYGETCALL_MSG_IDX];
-		    wp->aux_error_msg = strdup(UDFREQ_MSG);
+		    wp->aux_error_msg = work_strdup(wp, UDFREQ_MSG);
 
 		    if (AutoErrorMessage)
 			print_error(wp);
@@ -5223,7 +9585,7 @@ int rc;
 			/* precision undefined */
 			rc = wp->rc = EZCA_UDFREQ;
 			wp->error_msg = ErrorMsgs[CAARRAYGETCALL_MSG_IDX];
-			wp->aux_error_msg = strdup(UDFREQ_MSG);
+			wp->aux_error_msg = work_strdup(wp, UDFREQ_MSG);
 
 			if (AutoErrorMessage)
 			    print_error(wp);
@@ -5240,7 +9602,7 @@ int rc;
 			/* precision undefined */
 			rc = wp->rc = EZCA_UDFREQ;
 			wp->error_msg = ErrorMsgs[CAARRAYGETCALL_MSG_IDX];
-			wp->aux_error_msg = strdup(UDFREQ_MSG);
+			wp->aux_error_msg = work_strdup(wp, UDFREQ_MSG);
 
 			if (AutoErrorMessage)
 			    print_error(wp);
@@ -5254,7 +9616,7 @@ int rc;
 			/* precision undefined */
 			rc = wp->rc = EZCA_UDFREQ;
 			wp->error_msg = ErrorMsgs[CAARRAYGETCALL_MSG_IDX];
-			wp->aux_error_msg = strdup(UDFREQ_MSG);
+			wp->aux_error_msg = work_strdup(wp, UDFREQ_MSG);
 
 			if (AutoErrorMessage)
 			    print_error(wp);
@@ -5275,7 +9637,7 @@ int rc;
 	{
 	    rc = wp->rc = EZCA_CAFAILURE;
 	    wp->error_msg = ErrorMsgs[CAARRAYGETCALL_MSG_IDX];
-	    wp->aux_error_msg = strdup(ECA_BADCHID_MSG);
+	    wp->aux_error_msg = work_strdup(wp, ECA_BADCHID_MSG);
 
 	    if (AutoErrorMessage)
 		print_error(wp);
@@ -5294,20 +9656,37 @@ int rc;
 	if (Trace || Debug)
 	{
 	    printf("ca_array_get_callback(dbrtype (%d) >%s<)\n", 
-		wp->dbr_type, wp->pvname); 
+		wp->dbr_type, WORK_PVNAME(wp)); 
 
 	    if (Debug)
 		print_state();
 	} /* endif */
 
+	set_deadline(&wp->issued, 0.);
+	wp->cbcp = cp;
+
+	if (META_WORK(wp->worktype))
+	    meta_subscribe(cp, wp->dbr_type);
+
+	/* an identical request in flight brings our reply, too */
+	if (join_get(wp, cp))
+	    return ECA_NORMAL;
+
+	EZCA_TRACE(EZCA_EV_ISSUE_GET, wp, wp->dbr_type, wp->nelem);
+
 	rc = ca_array_get_callback(wp->dbr_type, (unsigned long) wp->nelem,
 		    cp->cid, my_get_callback, (void *) wp);
 
 	if (rc != ECA_NORMAL)
 	{
+	    /* nobody joined; that takes ezcaMutex which we hold */
+	    CHAN_LOCK(cp);
+	    leave_inflight(cp, wp);
+	    CHAN_UNLOCK(cp);
+
 	    wp->rc = EZCA_CAFAILURE;
 	    wp->error_msg = ErrorMsgs[CAARRAYGETCALL_MSG_IDX];
-	    wp->aux_error_msg = strdup(ca_message(rc));
+	    wp->aux_error_msg = work_strdup(wp, ca_message(rc));
 
 	    if (AutoErrorMessage)
 		print_error(wp);
@@ -5359,20 +9738,32 @@ int rc;
     if (Trace || Debug)
     {
 printf("ca_array_put_callback(ezcatype (%d)->dbrtype (%d), nelem %d, >%s<, wp->pval %p)\n", 
-	    wp->ezcadatatype, wp->dbr_type, wp->nelem, wp->pvname, wp->pval); 
+	    wp->ezcadatatype, wp->dbr_type, wp->nelem, WORK_PVNAME(wp), wp->pval); 
 
 	if (Debug)
 	    print_state();
     } /* endif */
 
+    set_deadline(&wp->issued, 0.);
+    wp->cbcp = cp;
+    EZCA_TRACE(EZCA_EV_ISSUE_PUT, wp, wp->dbr_type, wp->nelem);
+
     rc = ca_array_put_callback(wp->dbr_type, (unsigned long) wp->nelem,
 		cp->cid, wp->pval, my_put_callback, (void *) wp);
 
-    if (rc != ECA_NORMAL)
+    if (rc == ECA_NORMAL)
+    {
+	CHAN_LOCK(cp);
+	close_inflight(cp);
+	cp->stats.puts++;
+	cp->stats.bytes_out += (double) wp->nelem * dbr_value_size[(int) wp->dbr_type];
+	CHAN_UNLOCK(cp);
+    }
+    else
     {
 	wp->rc = EZCA_CAFAILURE;
 	wp->error_msg = ErrorMsgs[CAARRAYPUTCALL_MSG_IDX];
-	wp->aux_error_msg = strdup(ca_message(rc));
+	wp->aux_error_msg = work_strdup(wp, ca_message(rc));
 
 	if (AutoErrorMessage)
 	    print_error(wp);
@@ -5422,20 +9813,30 @@ int rc;
     if (Trace || Debug)
     {
 printf("ca_array_put(ezcatype (%d)->dbrtype (%d), nelem %d, >%s<, wp->pval %p)\n", 
-	    wp->ezcadatatype, wp->dbr_type, wp->nelem, wp->pvname, wp->pval); 
+	    wp->ezcadatatype, wp->dbr_type, wp->nelem, WORK_PVNAME(wp), wp->pval); 
 
 	if (Debug)
 	    print_state();
     } /* endif */
 
+    EZCA_TRACE(EZCA_EV_ISSUE_PUT, wp, wp->dbr_type, wp->nelem);
+
     rc = ca_array_put(wp->dbr_type, (unsigned long) wp->nelem,
 	    cp->cid, wp->pval);
 
-    if (rc != ECA_NORMAL)
+    if (rc == ECA_NORMAL)
+    {
+	CHAN_LOCK(cp);
+	close_inflight(cp);
+	cp->stats.puts++;
+	cp->stats.bytes_out += (double) wp->nelem * dbr_value_size[(int) wp->dbr_type];
+	CHAN_UNLOCK(cp);
+    }
+    else
     {
 	wp->rc = EZCA_CAFAILURE;
 	wp->error_msg = ErrorMsgs[CAARRAYPUT_MSG_IDX];
-	wp->aux_error_msg = strdup(ca_message(rc));
+	wp->aux_error_msg = work_strdup(wp, ca_message(rc));
 
 	if (AutoErrorMessage)
 	    print_error(wp);
@@ -5479,6 +9880,10 @@ static void EzcaInitializeChannelAccess()
 
 #ifdef EPICS_THREE_FOURTEEN
     ca_context_create(ca_enable_preemptive_callback);
+    /* there might already be a non-preemptive context in this thread */
+    PreemptiveCallbacks = ca_preemtive_callback_is_enabled() ? TRUE : FALSE;
+    /* other threads attach to it (see prologue()) */
+    CaContext = ca_current_context();
 #else
     ca_task_initialize();
 #endif
@@ -5524,6 +9929,10 @@ static int EzcaPendEvent(struct work *wp, float sec, BOOL realPend)
 {
 
 int rc;
+#ifdef EPICS_THREE_FOURTEEN
+/* looked up once; we don't hold the lock while pending */
+struct context *cx = Ctx;
+#endif
 
     if (Trace || Debug)
 	printf("ca_pend_event(%f)\n", (sec > 0 ? sec : SHORT_TIME));
@@ -5532,15 +9941,16 @@ int rc;
 		rc = ECA_TIMEOUT;
 	} else {
 		if ( realPend )
-			MARK_OUTSTANDING(0);
+			RESET_OUTSTANDING();
     	if (sec <= 0.)
 			sec = SHORT_TIME;
 EZCA_UNLOCK();
 #ifdef EPICS_THREE_FOURTEEN
+		EZCA_TRACE(EZCA_EV_WAIT_START, cx->done, cx->outstanding, sec * 1000.);
 		if ( realPend )
 			rc = ca_pend_event(sec);
 		else {
-			switch (epicsEventWaitWithTimeout(ezcaDone, sec)) {
+			switch (epicsEventWaitWithTimeout(cx->done, sec)) {
 				case epicsEventWaitOK:
 				case epicsEventWaitTimeout:
 					rc = ECA_TIMEOUT;
@@ -5549,6 +9959,7 @@ EZCA_UNLOCK();
 					rc = ECA_INTERNAL;
 			}
 		}
+		EZCA_TRACE(EZCA_EV_WAIT_END, cx->done, cx->outstanding, rc);
 #else
 		rc =  ca_pend_event(sec);
 #endif
@@ -5561,7 +9972,7 @@ EZCA_LOCK();
 	{
 	    wp->rc = EZCA_CAFAILURE;
 	    wp->error_msg = ErrorMsgs[CAPENDEVENT_MSG_IDX];
-	    wp->aux_error_msg = strdup(ca_message(rc));
+	    wp->aux_error_msg = work_strdup(wp, ca_message(rc));
 
 	    if (AutoErrorMessage)
 		print_error(wp);
@@ -5572,6 +9983,65 @@ EZCA_LOCK();
 
 } /* end EzcaPendEvent() */
 
+/****************************************************************
+*
+* Wait until all requests marked with MARK_OUTSTANDING() have
+* reported (callbacks count them down with POST_DONE()) or until
+* an absolute deadline of (RetryCount+1)*TimeoutSeconds expires.
+*
+* We still wait in slices of TimeoutSeconds so that ezcaAbort()
+* and the poll callback are honored; in between only the counter
+* is checked - the work list is never scanned.
+*
+* Returns ECA_TIMEOUT on normal completion (whether or not all
+* requests reported) or the ca_pend_event() error.
+*
+****************************************************************/
+
+static int EzcaWaitOutstanding()
+{
+
+int      rc = ECA_TIMEOUT;
+unsigned attempts;
+float    sec;
+#ifdef EPICS_THREE_FOURTEEN
+epicsTimeStamp deadline, now;
+double         left;
+
+    epicsTimeGetCurrent(&deadline);
+    epicsTimeAddSeconds(&deadline, (double)TimeoutSeconds * (RetryCount + 1));
+#endif
+
+    for (attempts = 0; Ctx->outstanding > 0; attempts++)
+    {
+	/* ezcaAbort() zeroes RetryCount; the first slice always runs */
+	if (attempts && !RetryCount)
+	    break;
+
+	sec = TimeoutSeconds;
+#ifdef EPICS_THREE_FOURTEEN
+	/* we may wake up early (stale 'done'); only the deadline counts */
+	epicsTimeGetCurrent(&now);
+	if ((left = epicsTimeDiffInSeconds(&deadline, &now)) <= 0.)
+	    break;
+	if (left < sec)
+	    sec = (float)left;
+#else
+	if (attempts > RetryCount)
+	    break;
+#endif
+
+	if (Trace || Debug)
+	    printf("EzcaWaitOutstanding(): %d outstanding\n", Ctx->outstanding);
+
+	if ((rc = EzcaPendEvent((struct work *) NULL, sec, FALSE)) != ECA_TIMEOUT)
+	    break;
+    } /* endfor */
+
+    return rc;
+
+} /* end EzcaWaitOutstanding() */
+
 /****************************************************************
 *
 * if not passed a wp, then just being called to flush the buffer
@@ -5597,10 +10067,12 @@ int rc;
 		rc = ECA_TIMEOUT;
 	} else {
 EZCA_UNLOCK();
+    EZCA_TRACE(EZCA_EV_WAIT_START, 0, 0, (sec > 0 ? sec : SHORT_TIME) * 1000.);
     if (sec > 0)
 	rc = ca_pend_io(sec);
     else
 	rc = ca_pend_io(SHORT_TIME);
+    EZCA_TRACE(EZCA_EV_WAIT_END, 0, 0, rc);
 EZCA_LOCK();
 	}
 
@@ -5610,7 +10082,7 @@ EZCA_LOCK();
 	{
 	    wp->rc = EZCA_CAFAILURE;
 	    wp->error_msg = ErrorMsgs[CAPENDIO_MSG_IDX];
-	    wp->aux_error_msg = strdup(ca_message(rc));
+	    wp->aux_error_msg = work_strdup(wp, ca_message(rc));
 
 	    if (AutoErrorMessage)
 		print_error(wp);
@@ -5643,13 +10115,18 @@ int rc;
     } /* endif */
 
     if (Trace || Debug)
-	printf("ca_search_and_connect(>%s<)\n", wp->pvname);
+	printf("ca_search_and_connect(>%s<)\n", cp->pvname);
 
 	/* Mark this CHID as 'not-reported' by setting puser
-	 * to non-null (we use 'wp' as a marker)
+	 * to non-null (we use 'cp' as a marker so the connection
+	 * callback can find work pending on the channel)
 	 */
-    rc = ca_search_and_connect(wp->pvname, &(cp->cid), 
-	    my_connection_callback, (void *) wp);
+    set_deadline(&cp->stats.searched, 0.);
+
+    rc = ca_search_and_connect(cp->pvname, &(cp->cid), 
+	    my_connection_callback, (void *) cp);
+
+    EZCA_TRACE(EZCA_EV_SEARCH, cp->cid, rc, 0);
 
     if (rc == ECA_NORMAL)
 	{
@@ -5660,7 +10137,7 @@ int rc;
     {
 	wp->rc = EZCA_CAFAILURE;
 	wp->error_msg = ErrorMsgs[CASEARCHANDCONNECT_MSG_IDX];
-	wp->aux_error_msg = strdup(ca_message(rc));
+	wp->aux_error_msg = work_strdup(wp, ca_message(rc));
 
 	if (AutoErrorMessage)
 	    print_error(wp);
@@ -5703,7 +10180,9 @@ int rc;
 
 static void my_connection_callback(struct connection_handler_args arg)
 {
-EZCA_LOCK();
+struct channel *cp;
+
+EZCA_TRACE(CA_OP_CONN_UP == arg.op ? EZCA_EV_CONN_UP : EZCA_EV_CONN_DOWN, arg.chid, 0, 0);
 /* TODO: should we try to recycle trashed work nodes
  *       referring to disconnected channels here?
  */
@@ -5717,10 +10196,41 @@ if ( Trace || Debug ) {
 	}
 	printf("my_connection_callback: %s\n", msg);
 }
+	/* on a disconnect only the metadata are forgotten (they may */
+	/* differ when the PV comes back); don't wait for the library */
+	/* lock. A connect takes it: it may issue a group's pending   */
+	/* work and report to waiting threads.                        */
+	if ( CA_OP_CONN_UP != arg.op ) {
+		REG_LOCK();
+		if ( (cp = REG2CHANNEL(ezcaRegFind(Channels, ca_name(arg.chid))))
+			&& cp->cid == arg.chid ) {
+			CHAN_LOCK(cp);
+			if ( cp->meta )
+				cp->meta->valid = FALSE;
+			CHAN_UNLOCK(cp);
+		}
+		REG_UNLOCK();
+		return;
+	}
+EZCA_LOCK();
+	/* puser is cleared once reported; find the channel by name */
+	if ( (cp = REG2CHANNEL(ezcaRegFind(Channels, ca_name(arg.chid))))
+		&& cp->cid == arg.chid ) {
+		CHAN_LOCK(cp);
+		if ( 0 == cp->stats.connects++ )
+			cp->stats.connect_time = -time_left(&cp->stats.searched);
+		CHAN_UNLOCK(cp);
+		/* showed up after all; promote from the negative cache */
+		cp->not_found_at = 0;
+	}
 	/* should we report ? */
-	if ( ca_puser(arg.chid) && CA_OP_CONN_UP == arg.op  ) {
+	if ( (cp = (struct channel *) ca_puser(arg.chid)) ) {
 		ca_set_puser(arg.chid, 0);
-		POST_DONE();	
+		if ( cp->pending ) {
+			/* a group is waiting; issue its work right away */
+			issue_pending(cp);
+		}
+		post_connected(cp);
 	}
 EZCA_UNLOCK();
 } /* end my_connection_callback() */
@@ -5742,8 +10252,8 @@ EZCA_UNLOCK();
 * named this routine as the callback.  The request type was either
 * DBR_TIME_XXXX (GET, GETSTATUS, GETWITHSTATUS) where XXXX is the
 * user-specified request type or DBR_CTRL_XXXX (GETUNITS, GETPRECISION, 
-* GETGRAPHICLIMITS, GETCONTROLLIMITS, GETWARNLIMITS, GETALARMLIMITS, GETENUMSTATES)
-* where XXXX is the native data type.
+* GETGRAPHICLIMITS, GETCONTROLLIMITS, GETWARNLIMITS, GETALARMLIMITS, GETENUMSTATES,
+* GETMETADATA) where XXXX is the native data type.
 *
 * Presumably, wp that is passed here has been set up properly based upon
 * the work type ... sometimes we copy values, sometimes status and severity, ...
@@ -5758,19 +10268,332 @@ EZCA_UNLOCK();
 static void my_get_callback(struct event_handler_args arg)
 {
 
-struct work *wp;
-int nbytes;
+struct work *wp, *jp;
+struct channel *cp;
+BOOL slow;
 
-EZCA_LOCK();
+EZCA_TRACE(EZCA_EV_CB_GET, arg.usr, arg.status, arg.count);
     if (Trace || Debug)
 	printf("entering my_get_callback()\n");
 
     if ((wp = (struct work *) arg.usr))
     {
+	/* A good reply for live work only needs the lock of the */
+	/* channel (see trash_work()) so that callbacks for      */
+	/* different channels run in parallel. Errors and nodes  */
+	/* to be recycled touch the library's lists and strings. */
+	cp = wp->cbcp;
+	CHAN_LOCK(cp);
+
+	/* nobody may join any more */
+	leave_inflight(cp, wp);
+
+	slow = (arg.status != ECA_NORMAL);
+	for (jp = wp; jp && !slow; jp = jp->joined)
+	    slow = (usable != jp->trashme);
+
+	if (slow)
+	{
+	    CHAN_UNLOCK(cp);
+	    EZCA_LOCK();
+	    CHAN_LOCK(cp);
+	} /* endif */
+
+	if (arg.status == ECA_NORMAL)
+	{
+	    /* one request however many nodes share it */
+	    cp->stats.gets++;
+	    cp->stats.bytes_in += dbr_size_n(arg.type, arg.count);
+	    record_round_trip(cp, &wp->issued);
+
+	    if (META_WORK(wp->worktype))
+		meta_store(cp, arg.type, arg.dbr);
+	} /* endif */
+
+	/* the owners may reuse the nodes once they are served */
+	for (; wp; wp = jp)
+	{
+	    jp = wp->joined;
+	    wp->joined = (struct work *) NULL;
+	    get_reply(wp, arg);
+	} /* endfor */
+
+	CHAN_UNLOCK(cp);
+	if (slow)
+	    EZCA_UNLOCK();
+    }
+    else
+    {
+        fprintf(stderr, "EZCA FATAL ERROR: my_get_callback() got NULL wp\n");
+        exit(1);
+    } /* endif */
+
+    if (Trace || Debug)
+	printf("exiting my_get_callback()\n");
+
+} /* end my_get_callback() */
+
+/****************************************************************
+*
+* Control metadata cache (see struct chanmeta).
+*
+* The first metadata request on a channel also subscribes to
+* DBE_PROPERTY events of the same DBR_CTRL_xxx; servers send one
+* update right away (and after every reconnect) and another one
+* whenever units, limits, precision or enum strings change. Only
+* while that subscription exists are the data trusted, so without
+* DBE_PROPERTY (EPICS < 3.14.11) nothing is served from the cache.
+*
+****************************************************************/
+
+static void meta_subscribe(struct channel *cp, int dbr_type)
+{
+
+#ifdef DBE_PROPERTY
+evid evd = (evid) NULL;
+int rc;
+
+    /* the first update may come in before CA returns; meta_store() */
+    /* takes it while 'meta_subscribing' is set                      */
+    CHAN_LOCK(cp);
+    if (cp->meta_evd || cp->meta_subscribing)
+    {
+	CHAN_UNLOCK(cp);
+	return;
+    } /* endif */
+    cp->meta_subscribing = TRUE;
+    CHAN_UNLOCK(cp);
+
+    rc = ca_add_masked_array_event(dbr_type, 1, cp->cid,
+	    my_meta_callback, (void *) cp, (float) 0, (float) 0, (float) 0,
+	    &evd, DBE_PROPERTY);
+
+    if (ECA_NORMAL == rc && (Trace || Debug))
+	printf("meta_subscribe() >%s< dbrtype %d\n", cp->pvname, dbr_type);
+
+    CHAN_LOCK(cp);
+    cp->meta_subscribing = FALSE;
+    if (ECA_NORMAL == rc)
+	cp->meta_evd = evd;
+    else if (cp->meta)
+	/* nothing keeps the data up to date */
+	cp->meta->valid = FALSE;
+    CHAN_UNLOCK(cp);
+#endif
+
+} /* end meta_subscribe() */
+
+static void my_meta_callback(struct event_handler_args arg)
+{
+
+struct channel *cp = (struct channel *) arg.usr;
+
+    if (ECA_NORMAL == arg.status)
+    {
+	CHAN_LOCK(cp);
+	meta_store(cp, arg.type, arg.dbr);
+	CHAN_UNLOCK(cp);
+    } /* endif */
+
+} /* end my_meta_callback() */
+
+#define META_NUMERIC(md, d) \
+	do { \
+	    strncpy((md)->units, (d)->units, EZCA_UNITS_SIZE); \
+	    (md)->units[EZCA_UNITS_SIZE-1] = '\0'; \
+	    (md)->disp_lo  = (d)->lower_disp_limit; \
+	    (md)->disp_hi  = (d)->upper_disp_limit; \
+	    (md)->ctrl_lo  = (d)->lower_ctrl_limit; \
+	    (md)->ctrl_hi  = (d)->upper_ctrl_limit; \
+	    (md)->warn_lo  = (d)->lower_warning_limit; \
+	    (md)->warn_hi  = (d)->upper_warning_limit; \
+	    (md)->alarm_lo = (d)->lower_alarm_limit; \
+	    (md)->alarm_hi = (d)->upper_alarm_limit; \
+	} while (0)
+
+static void meta_clear(EzcaMetadataRec *md)
+{
+
+    memset(md, 0, sizeof(*md));
+    md->precision = UNDEFINED;
+
+} /* end meta_clear() */
+
+/* fills md from a DBR_CTRL_xxx; FALSE if 'type' is none of them */
+/* (or DBR_CTRL_STRING which carries no metadata)                */
+static BOOL meta_decode(EzcaMetadataRec *md, long type, const void *dbr)
+{
+
+const struct dbr_ctrl_enum *ep;
+int i;
+
+    meta_clear(md);
+
+    switch (type)
+    {
+	case DBR_CTRL_CHAR:
+	    META_NUMERIC(md, (const struct dbr_ctrl_char *) dbr);
+	    break;
+	/* case DBR_CTRL_INT = DBR_CTRL_SHORT: */
+	case DBR_CTRL_SHORT:
+	    META_NUMERIC(md, (const struct dbr_ctrl_short *) dbr);
+	    break;
+	case DBR_CTRL_LONG:
+	    META_NUMERIC(md, (const struct dbr_ctrl_long *) dbr);
+	    break;
+	case DBR_CTRL_FLOAT:
+	    META_NUMERIC(md, (const struct dbr_ctrl_float *) dbr);
+	    md->precision = ((const struct dbr_ctrl_float *) dbr)->precision;
+	    break;
+	case DBR_CTRL_DOUBLE:
+	    META_NUMERIC(md, (const struct dbr_ctrl_double *) dbr);
+	    md->precision = ((const struct dbr_ctrl_double *) dbr)->precision;
+	    break;
+	case DBR_CTRL_ENUM:
+	    ep = (const struct dbr_ctrl_enum *) dbr;
+	    md->no_str = ep->no_str < EZCA_ENUM_STATES ? ep->no_str : EZCA_ENUM_STATES;
+	    for (i = 0; i < md->no_str; i++)
+	    {
+		strncpy(md->strs[i], ep->strs[i], EZCA_ENUM_STRING_SIZE);
+		md->strs[i][EZCA_ENUM_STRING_SIZE-1] = '\0';
+	    } /* endfor */
+	    break;
+	default:
+	    return FALSE;
+    } /* end switch() */
+
+    return TRUE;
+
+} /* end meta_decode() */
+
+/* called with the channel lock held; data are only kept while */
+/* the subscription exists or is being set up                   */
+static void meta_store(struct channel *cp, long type, const void *dbr)
+{
+
+struct chanmeta *mp;
+
+    if (!cp->meta_evd && !cp->meta_subscribing)
+	return;
+
+    if (!(mp = cp->meta))
+    {
+	if (!(mp = (struct chanmeta *) ezcacalloc(1, sizeof(*mp))))
+	    return;
+	cp->meta = mp;
+    } /* endif */
+
+    mp->dbr_type = (int) type;
+    mp->valid = meta_decode(&mp->md, type, dbr);
+
+} /* end meta_store() */
+
+/****************************************************************
+*
+* completes metadata work from the cache if it holds what the
+* request would have fetched. Returns FALSE if the request must
+* go to the server (also when it is undefined for the native
+* type; EzcaArrayGetCallback() reports that).
+*
+****************************************************************/
+
+static BOOL meta_from_cache(struct work *wp, struct channel *cp)
+{
+
+struct chanmeta *mp;
+BOOL rc;
+char *p;
+int i, t;
+
+    if (!META_WORK(wp->worktype) || !cp->meta)
+	return FALSE;
+
+    t = dbf_type_to_DBR_CTRL(EzcaNativeType(cp));
+
+    CHAN_LOCK(cp);
+
+    mp = cp->meta;
+
+    if (!mp->valid || mp->dbr_type != t)
+	rc = FALSE;
+    else if (GETENUMSTATES == wp->worktype)
+	rc = (DBR_CTRL_ENUM == t);
+    else if (GETPRECISION == wp->worktype)
+	rc = (DBR_CTRL_FLOAT == t || DBR_CTRL_DOUBLE == t);
+    else if (GETMETADATA == wp->worktype)
+	rc = TRUE;
+    else
+	rc = (DBR_CTRL_ENUM != t && DBR_CTRL_STRING != t);
+
+    if (rc)
+    {
+	switch (wp->worktype)
+	{
+	    case GETUNITS:
+		strncpy(wp->strp, mp->md.units, EZCA_UNITS_SIZE);
+		wp->strp[EZCA_UNITS_SIZE-1] = '\0';
+		break;
+	    case GETPRECISION:
+		*(wp->s1p) = mp->md.precision;
+		break;
+	    case GETGRAPHICLIMITS:
+		*(wp->d1p) = mp->md.disp_lo;
+		*(wp->d2p) = mp->md.disp_hi;
+		break;
+	    case GETCONTROLLIMITS:
+		*(wp->d1p) = mp->md.ctrl_lo;
+		*(wp->d2p) = mp->md.ctrl_hi;
+		break;
+	    case GETWARNLIMITS:
+		*(wp->d1p) = mp->md.warn_lo;
+		*(wp->d2p) = mp->md.warn_hi;
+		break;
+	    case GETALARMLIMITS:
+		*(wp->d1p) = mp->md.alarm_lo;
+		*(wp->d2p) = mp->md.alarm_hi;
+		break;
+	    case GETENUMSTATES:
+		/* as my_get_callback() does it */
+		for (i = 0, p = wp->strp; i < mp->md.no_str; i++, p += EZCA_ENUM_STRING_SIZE)
+		    strncpy(p, mp->md.strs[i], EZCA_ENUM_STRING_SIZE);
+		if (i < EZCA_ENUM_STATES)
+		    *p = 0;
+		break;
+	    case GETMETADATA:
+		*((EzcaMetadataRec *) wp->pval) = mp->md;
+		break;
+	    default:
+		break;
+	} /* end switch() */
+    } /* endif */
+
+    CHAN_UNLOCK(cp);
+
+    if (rc && (Trace || Debug))
+	printf("meta_from_cache() served >%s< worktype %d\n",
+	    cp->pvname, wp->worktype);
+
+    return rc;
+
+} /* end meta_from_cache() */
+
+/****************************************************************
+*
+* hands a get reply to 'wp' (the node that issued the request or
+* one that joined it); called with the lock of the channel held
+* and, if wp is trashed or the request failed, also ezcaMutex.
+*
+****************************************************************/
+
+static void get_reply(struct work *wp, struct event_handler_args arg)
+{
+
+int nbytes;
+
 	if (usable == wp->trashme)
 	{
 	    if (Trace || Debug)
-		printf("my_get_callback() pvname >%s<\n", wp->pvname);
+		printf("my_get_callback() pvname >%s<\n", WORK_PVNAME(wp));
 
 	    if (arg.status == ECA_NORMAL)
 	    {
@@ -5781,6 +10604,19 @@ EZCA_LOCK();
 	printf("my_get_callback() ezcadatatype %d (arg.type %ld) worktype %d\n",
 			wp->ezcadatatype, arg.type, wp->worktype);
 
+		    if (wp->worktype == GETMETADATA)
+		    {
+			/* any DBR_CTRL_XXXX; the record takes all of it */
+			if (!wp->pval
+			    || !meta_decode((EzcaMetadataRec *) wp->pval, arg.type, arg.dbr))
+			{
+			    fprintf(stderr, 
+"EZCA FATAL ERROR: my_get_callback() found arg.type %ld with wp->worktype GETMETADATA wp->pval %p\n",
+				arg.type, wp->pval);
+			    exit(1);
+			} /* endif */
+		    }
+		    else
 		    switch (arg.type)
 		    {
 			/* GET, GETSTATUS, or GETWITHSTATUS */
@@ -6941,7 +11777,7 @@ EZCA_LOCK();
 
 		wp->rc = EZCA_CAFAILURE;
 		wp->error_msg = ErrorMsgs[CAARRAYGETCALLBACK_MSG_IDX];
-		wp->aux_error_msg = strdup(ca_message(arg.status));
+		wp->aux_error_msg = work_strdup(wp, ca_message(arg.status));
 	    } /* endif */
 
 	    if (Trace || Debug)
@@ -6949,9 +11785,10 @@ EZCA_LOCK();
 
 	    wp->reported = TRUE;
 #ifdef DEBUG
-		printf("TSILL my_get_callback POST (%i)\n", ezcaOutstanding);
+		printf("TSILL my_get_callback POST (%i)\n", wp->ctx->outstanding);
 #endif
-		POST_DONE();
+		/* the owner may reuse wp from here on */
+		WORK_DONE(wp);
 	}
 	else
 	{
@@ -6959,18 +11796,51 @@ EZCA_LOCK();
 		printf("my_get_callback() inactive work node\n");
 		recycle_work(wp);
 	} /* endif */
-    }
-    else
+
+} /* end get_reply() */
+
+/****************************************************************
+*
+* appends a copy of a freshly received update to a monitor queue;
+* called by my_monitor_callback() (the only producer).
+*
+****************************************************************/
+
+static void enqueue_update(struct monitor *mp, struct monbuf *bp)
+{
+
+struct monq *q = mp->queue;
+BOOL full;
+unsigned slot;
+int nv;
+
+    CHAN_LOCK(mp->cp);
+    if ((full = (q->count >= q->depth)))
+	q->dropped++;
+    CHAN_UNLOCK(mp->cp);
+
+    if (!full)
     {
-        fprintf(stderr, "EZCA FATAL ERROR: my_get_callback() got NULL wp\n");
-        exit(1);
-    } /* endif */
+	/* slot 'tail' is not visible to the consumer before 'count' grows */
+	slot = q->tail;
+	if ((nv = bp->nelem) > q->nelem)
+	    nv = q->nelem;
 
-    if (Trace || Debug)
-	printf("exiting my_get_callback()\n");
+	memcpy(q->data + slot * q->nelem * q->esize, (char *) bp->pval, 
+	    nv * q->esize);
+	q->nvals[slot] = nv;
+	q->status[slot] = bp->status;
+	q->severity[slot] = bp->severity;
+	copy_time_stamp(&q->time_stamp[slot], &bp->time_stamp);
 
-EZCA_UNLOCK();
-} /* end my_get_callback() */
+	q->tail = (slot + 1) % q->depth;
+
+	CHAN_LOCK(mp->cp);
+	q->count++;
+	CHAN_UNLOCK(mp->cp);
+    } /* endif */
+
+} /* end enqueue_update() */
 
 /****************************************************************
 *
@@ -7002,10 +11872,19 @@ EZCA_UNLOCK();
 static void my_monitor_callback(struct event_handler_args arg)
 {
 
-struct monitor *mp;
+struct monitor *mp, *vp;
+struct monbuf *bp;
 int nbytes;
+BOOL wake;
+Deadline_t now;
+
+    /* NOTE: ezcaMutex is not taken here (unless a MONBLOCK is */
+    /*       waiting for this monitor); the data are published */
+    /*       by swapping buffers under the channel lock only,  */
+    /*       so updates of different channels don't contend.   */
+
+    EZCA_TRACE(EZCA_EV_CB_MONITOR, arg.usr, arg.status, arg.count);
 
-EZCA_LOCK();
     if (Trace || Debug)
 	printf("entering my_monitor_callback()\n");
 
@@ -7016,6 +11895,9 @@ EZCA_LOCK();
 	    /* checking that channel access gave us what we asked for */
 	    if (arg.type == mp->dbr_type)
 	    {
+		/* the back buffer is ours alone */
+		bp = mp->back;
+
 		if (arg.status == ECA_NORMAL)
 		{
 		    nbytes = arg.count * dbr_value_size[arg.type];
@@ -7025,24 +11907,26 @@ EZCA_LOCK();
 			    dbr_value_size[arg.type], arg.count,
 			    nbytes, mp->ezcadatatype, mp->dbr_type);
 
-		    if (arg.count != mp->last_nelem)
+		    if ((unsigned) nbytes > bp->size)
 		    {
 			if (Trace || Debug)
 		    printf("my_monitor_callback() allocating %ld X %d = %d bytes\n",
 				arg.count, dbr_value_size[arg.type], nbytes);
 
-			/* different amount coming in ... need new data buff */
+			/* more coming in than the buffer holds */
 
-			if (mp->pval)
+			if (bp->pval)
 			{
 			    if (Trace || Debug)
-			printf("my_monitor_callback() freeing mp->pval %p\n",
-				    mp->pval);
-			    ezcafree((char *) mp->pval);
-			    mp->pval = (void *) NULL;
+			printf("my_monitor_callback() freeing bp->pval %p\n",
+				    bp->pval);
+			    ezcafree((char *) bp->pval);
+			    bp->pval = (void *) NULL;
+			    MONMEM_ADD(-(double) bp->size);
+			    bp->size = 0;
 			} /* endif */
 
-			if (!(mp->pval = (void *) ezcamalloc((unsigned) nbytes)))
+			if (!(bp->pval = (void *) ezcamalloc((unsigned) nbytes)))
 			{
 			    fprintf(stderr, 
 	"EZCA FATAL ERROR: my_monitor_callback() could not allocate %d bytes\n",
@@ -7051,79 +11935,93 @@ EZCA_LOCK();
 			} /* endif */
 
 			if (Trace || Debug)
-		printf("my_monitor_callback() allocated %d bytes mp->pval %p\n",
-				nbytes, mp->pval);
+		printf("my_monitor_callback() allocated %d bytes bp->pval %p\n",
+				nbytes, bp->pval);
 
-			mp->last_nelem = arg.count;
+			bp->size = nbytes;
+			MONMEM_ADD((double) nbytes);
 
 		    } /* endif */
 
+		    bp->nelem = arg.count;
+
 		    switch (arg.type)
 		    {
 			case DBR_TIME_CHAR:
-			    memcpy((char *) (mp->pval), 
+			    memcpy((char *) (bp->pval), 
 			(char *) &(((struct dbr_time_char *) arg.dbr)->value),
 				nbytes);
-			    mp->status = 
+			    bp->status = 
 				((struct dbr_time_char *) arg.dbr)->status;
-			    mp->severity = 
+			    bp->severity = 
 				((struct dbr_time_char *) arg.dbr)->severity;
-			    copy_time_stamp(&(mp->time_stamp), 
+			    copy_time_stamp(&(bp->time_stamp), 
 				&(((struct dbr_time_char *) arg.dbr)->stamp));
 			    break;
 			case DBR_TIME_STRING:
-			    memcpy((char *) (mp->pval), 
+			    memcpy((char *) (bp->pval), 
 			(char *) &(((struct dbr_time_string *)arg.dbr)->value),
 				nbytes);
-			    mp->status = 
+			    bp->status = 
 				((struct dbr_time_string *) arg.dbr)->status;
-			    mp->severity = 
+			    bp->severity = 
 				((struct dbr_time_string *) arg.dbr)->severity;
-			    copy_time_stamp(&(mp->time_stamp), 
+			    copy_time_stamp(&(bp->time_stamp), 
 				&(((struct dbr_time_string *) arg.dbr)->stamp));
 			    break;
+			case DBR_TIME_ENUM:
+			    memcpy((char *) (bp->pval), 
+			(char *) &(((struct dbr_time_enum *)arg.dbr)->value),
+				nbytes);
+			    bp->status = 
+				((struct dbr_time_enum *) arg.dbr)->status;
+			    bp->severity = 
+				((struct dbr_time_enum *) arg.dbr)->severity;
+			    copy_time_stamp(&(bp->time_stamp),
+				&(((struct dbr_time_enum *) arg.dbr)->stamp));
+			    break;
 			case DBR_TIME_SHORT:
-			    memcpy((char *) (mp->pval), 
+			    memcpy((char *) (bp->pval), 
 			(char *) &(((struct dbr_time_short *)arg.dbr)->value),
 				nbytes);
-			    mp->status = 
+			    bp->status = 
 				((struct dbr_time_short *) arg.dbr)->status;
-			    mp->severity = 
+			    bp->severity = 
 				((struct dbr_time_short *) arg.dbr)->severity;
-			    copy_time_stamp(&(mp->time_stamp),
+			    copy_time_stamp(&(bp->time_stamp),
 				&(((struct dbr_time_short *) arg.dbr)->stamp));
 			    break;
 			case DBR_TIME_LONG:
-			    memcpy((char *) (mp->pval), 
+			    memcpy((char *) (bp->pval), 
 			(char *) &(((struct dbr_time_long *) arg.dbr)->value),
 				nbytes);
-			    mp->status = 
+			    bp->status = 
 				((struct dbr_time_long *) arg.dbr)->status;
-			    mp->severity = 
+			    bp->severity = 
 				((struct dbr_time_long *) arg.dbr)->severity;
-			    copy_time_stamp(&(mp->time_stamp),
+			    copy_time_stamp(&(bp->time_stamp),
 				&(((struct dbr_time_long *) arg.dbr)->stamp));
 			    break;
 			case DBR_TIME_FLOAT:
-			    memcpy((char *) (mp->pval), 
+			    memcpy((char *) (bp->pval), 
 			(char *) &(((struct dbr_time_float *)arg.dbr)->value),
 				nbytes);
-			    mp->status = 
+			    bp->status = 
 				((struct dbr_time_float *) arg.dbr)->status;
-			    mp->severity = 
+			    bp->severity = 
 				((struct dbr_time_float *) arg.dbr)->severity;
-			    copy_time_stamp(&(mp->time_stamp),
+			    copy_time_stamp(&(bp->time_stamp),
 				&(((struct dbr_time_float *) arg.dbr)->stamp));
 			    break;
 			case DBR_TIME_DOUBLE:
-			    memcpy((char *) (mp->pval), 
+			    memcpy((char *) (bp->pval), 
 			(char *)&(((struct dbr_time_double *)arg.dbr)->value),
 				nbytes);
-			    mp->status = 
+			    bp->status = 
 				((struct dbr_time_double *) arg.dbr)->status;
-			    mp->severity = 
+			    bp->severity = 
 				((struct dbr_time_double *) arg.dbr)->severity;
-			    copy_time_stamp(&(mp->time_stamp),
+			    copy_time_stamp(&(bp->time_stamp),
 				&(((struct dbr_time_double *) arg.dbr)->stamp));
 			    break;
 			default:
@@ -7135,22 +12033,10 @@ EZCA_LOCK();
 
 		    if (Trace || Debug)
 		    printf("my_monitor_callback() just memcpy %d bytes to %p\n",
-			    nbytes, mp->pval);
+			    nbytes, bp->pval);
 
-		    mp->needs_reading = TRUE;
-			if ( mp->waiter && usable == mp->waiter->trashme ) {
-				if ( mp->waiter->worktype != MONBLOCK ) {
-					fprintf(stderr,"EZCA FATAL ERROR: work type is not MONBLOCK\n");
-					exit(1);
-				}
-				mp->waiter->reported = TRUE;
-				mp->waiter->pval     = NULL;
-#ifdef DEBUG
-				printf("TSILL my_mon_callback POST (%i)\n", ezcaOutstanding);
-#endif
-				POST_DONE();
-			}
-			mp->waiter = (struct work *)NULL;
+		    if (mp->queue)
+			enqueue_update(mp, bp);
 		}
 		else
 		{
@@ -7158,19 +12044,73 @@ EZCA_LOCK();
 			printf("my_monitor_callback() found arg.status %d\n",
 			    arg.status);
 
-		    if (mp->pval)
+		    /* publish 'no value'; the memory is kept for reuse */
+		    bp->nelem = UNDEFINED;
+		    bp->status = UNDEFINED;
+		    bp->severity = UNDEFINED;
+		} /* endif */
+
+		set_deadline(&now, 0.);
+
+		/* publishing; every monitor reading from this */
+		/* subscription (see add_view()) has news      */
+		wake = FALSE;
+		CHAN_LOCK(mp->cp);
+		    if (arg.status == ECA_NORMAL)
 		    {
-			if (Trace || Debug)
-			printf("my_monitor_callback() freeing mp->pval %p\n",
-				mp->pval);
-			ezcafree((char *) mp->pval);
+			if (mp->nupdates++)
+			{
+			    double dt = time_diff(&now, &mp->last_update);
+
+			    mp->interval_sum += dt;
+			    if (dt > mp->interval_max)
+				mp->interval_max = dt;
+			} /* endif */
+			mp->last_update = now;
+			mp->bytes += dbr_size_n(arg.type, arg.count);
 		    } /* endif */
+		    mp->back = mp->mid;
+		    mp->mid = bp;
+		    mp->fresh = TRUE;
+		    mp->needs_reading = (bp->nelem != UNDEFINED);
+		    for (vp = mp->cp->monitor_list; vp; vp = vp->right)
+		    {
+			if (vp->src == mp)
+			{
+			    vp->needs_reading = mp->needs_reading;
+			    if (vp->needs_reading && vp->waiter)
+				wake = TRUE;
+			} /* endif */
+		    } /* endfor */
+		CHAN_UNLOCK(mp->cp);
 
-		    mp->pval = (void *) NULL;
-		    mp->needs_reading = FALSE;
-		    mp->last_nelem = UNDEFINED;
-		    mp->status = UNDEFINED;
-		    mp->severity = UNDEFINED;
+		if (wake)
+		{
+		    /* waiter and work node belong to the library; */
+		    /* recheck under its lock. Updates nobody waits */
+		    /* for never take it.                           */
+		    EZCA_LOCK();
+		    for (vp = mp->cp->monitor_list; vp; vp = vp->right)
+		    {
+			if (vp->src != mp || !vp->waiter)
+			    continue;
+			if ( vp->needs_reading && usable == vp->waiter->trashme ) {
+				if ( vp->waiter->worktype != MONBLOCK ) {
+					fprintf(stderr,"EZCA FATAL ERROR: work type is not MONBLOCK\n");
+					exit(1);
+				}
+				vp->waiter->reported = TRUE;
+				vp->waiter->pval     = NULL;
+#ifdef DEBUG
+				printf("TSILL my_mon_callback POST (%i)\n", vp->waiter->ctx->outstanding);
+#endif
+				WORK_DONE(vp->waiter);
+			}
+			CHAN_LOCK(mp->cp);
+			vp->waiter = (struct work *)NULL;
+			CHAN_UNLOCK(mp->cp);
+		    } /* endfor */
+		    EZCA_UNLOCK();
 		} /* endif */
 	    }
 	    else
@@ -7197,9 +12137,57 @@ EZCA_LOCK();
     if (Trace || Debug)
 	printf("exiting my_monitor_callback()\n");
 
-EZCA_UNLOCK();
 } /* end my_monitor_callback() */
 
+/****************************************************************
+*
+* Hands an update of a user callback subscription to the user. The
+* CA buffer is passed on as is and no lock is held; all dbr_time_xxx
+* structs start with status, severity and stamp.
+*
+****************************************************************/
+
+static void my_user_monitor_callback(struct event_handler_args arg)
+{
+
+struct moncb *ucp = (struct moncb *) arg.usr;
+struct dbr_time_short *hdr;
+EzcaMonitorUpdateRec u;
+
+    EZCA_TRACE(EZCA_EV_CB_MONITOR, ucp, arg.status, arg.count);
+
+    if (!ucp || !ucp->active)
+	return;
+
+    u.pvname = ucp->cp->pvname;
+    u.type = ucp->ezcadatatype;
+
+    if (ECA_NORMAL == arg.status && arg.dbr && arg.type == ucp->dbr_type)
+    {
+	hdr = (struct dbr_time_short *) arg.dbr;
+	u.nelem = (int) arg.count;
+	u.value = dbr_value_ptr(arg.dbr, arg.type);
+	u.timestamp = &hdr->stamp;
+	u.status = hdr->status;
+	u.severity = hdr->severity;
+    }
+    else
+    {
+	if (Trace || Debug)
+	    printf("my_user_monitor_callback() found arg.status %d\n",
+		arg.status);
+
+	u.nelem = 0;
+	u.value = (const void *) NULL;
+	u.timestamp = (const epicsTimeStamp *) NULL;
+	u.status = UNDEFINED;
+	u.severity = UNDEFINED;
+    } /* endif */
+
+    ucp->fn(ucp->arg, &u);
+
+} /* end my_user_monitor_callback() */
+
 /****************************************************************
 *
 * from epicsH/cadef.h
@@ -7222,24 +12210,33 @@ static void my_put_callback(struct event_handler_args arg)
 {
 
 struct work *wp;
+struct channel *cp;
+BOOL slow;
 
-EZCA_LOCK();
+EZCA_TRACE(EZCA_EV_CB_PUT, arg.usr, arg.status, 0);
     if (Trace || Debug)
 	printf("entering my_put_callback()\n");
 
     if ((wp = (struct work *) arg.usr))
     {
+	/* locking as in my_get_callback() */
+	cp = wp->cbcp;
+	CHAN_LOCK(cp);
+	if ((slow = (usable != wp->trashme || arg.status != ECA_NORMAL)))
+	{
+	    CHAN_UNLOCK(cp);
+	    EZCA_LOCK();
+	    CHAN_LOCK(cp);
+	} /* endif */
+
 	if (usable == wp->trashme)
 	{
-	    wp->reported = TRUE;
-#ifdef DEBUG
-		printf("TSILL my_put_callback POST (%i)\n", ezcaOutstanding);
-#endif
-		POST_DONE();
+	    if (arg.status == ECA_NORMAL)
+		record_round_trip(cp, &wp->issued);
 
 	    if (Trace || Debug)
 	printf("my_put_callback() pvname >%s< ezcatype %d setting reported\n",
-		    wp->pvname, wp->ezcadatatype);
+		    WORK_PVNAME(wp), wp->ezcadatatype);
 
 	    if (arg.status != ECA_NORMAL)
 	    {
@@ -7247,11 +12244,17 @@ EZCA_LOCK();
 		    printf("my_put_callback() found bad arg.status %d\n", 
 			arg.status);
 
-		wp->rc = EZCA_CAFAILURE;
 		wp->rc = EZCA_CAFAILURE;
 		wp->error_msg = ErrorMsgs[CAARRAYPUTCALLBACK_MSG_IDX];
-		wp->aux_error_msg = strdup(ca_message(arg.status));
+		wp->aux_error_msg = work_strdup(wp, ca_message(arg.status));
 	    } /* endif */
+
+	    wp->reported = TRUE;
+#ifdef DEBUG
+		printf("TSILL my_put_callback POST (%i)\n", wp->ctx->outstanding);
+#endif
+		/* the owner may reuse wp from here on */
+		WORK_DONE(wp);
 	}
 	else
 	{
@@ -7259,6 +12262,10 @@ EZCA_LOCK();
 		printf("my_put_callback() inactive work node\n");
 		recycle_work(wp);
 	} /* endif */
+
+	CHAN_UNLOCK(cp);
+	if (slow)
+	    EZCA_UNLOCK();
     }
     else
     {
@@ -7269,7 +12276,6 @@ EZCA_LOCK();
     if (Trace || Debug)
 	printf("exiting my_put_callback()\n");
 
-EZCA_UNLOCK();
 } /* end my_put_callback() */
 
 /*********************/
@@ -7294,29 +12300,50 @@ struct monitor *mp;
     {  
 	if ( 0 == --(*cpp)->refcnt ) {
 
+	/* the lock is released while clearing (EzcaClearEvent() etc.); */
+	/* nobody may find and revive the channel in the meantime        */
+	if ((*cpp)->pvname)
+	{
+	    REG_LOCK();
+	    ezcaRegRemove(Channels, &(*cpp)->reg);
+	    REG_UNLOCK();
+	    lru_unlink(*cpp);
+	} /* endif */
+
 	/* clearing monitor list       */
 	/* note that this loop ends up */
 	/* with p->monitor_list = NULL */
 
 	while ((mp = (*cpp)->monitor_list))
 	{
-	    if (((*cpp)->monitor_list = mp->right))
-		((*cpp)->monitor_list)->left = (struct monitor *) NULL;
-
-	    /* not calling clean_and_push_monitor() here because want to */
-	    /* bunch up these ca_clear_event() calls and flush as one    */
+	    unlink_monitor(mp);
 
 	    mp->active = FALSE;
 
-	    if (mp->pval)
+	    if (mp->src && mp->src != mp)
 	    {
-		ezcafree((char *) mp->pval);
-		mp->pval = (void *) NULL;
+		/* a view owns no subscription */
+		push_monitor(mp, &Monitor_avail_hdr);
+		continue;
 	    } /* endif */
 
-	    push_monitor(mp, ECA_NORMAL != EzcaClearEvent(mp) ? &Discarded_monitors : &Monitor_avail_hdr);
+	    /* not calling clean_and_push_monitor() here because want to */
+	    /* bunch up these ca_clear_event() calls and flush as one    */
+
+	    if (ECA_NORMAL != EzcaClearEvent(mp))
+		push_monitor(mp, &Discarded_monitors);
+	    else
+	    {
+		free_monitor_buffers(mp);
+		push_monitor(mp, &Monitor_avail_hdr);
+	    } /* endif */
 
 	} /* endwhile */
+
+	/* user callbacks go away with their channel */
+	while ((*cpp)->callbacks)
+	    remove_callback((*cpp)->callbacks);
+
 	/* clearing the chid */
 
 	clear_failed = EzcaClearChannel(*cpp);
@@ -7324,6 +12351,13 @@ struct monitor *mp;
 	EzcaPendIO((struct work *) NULL, SHORT_TIME);
 #endif
 
+	/* CA takes the channel's subscriptions along */
+	if (!clear_failed)
+	{
+	    reclaim_monitors(*cpp);
+	    reclaim_callbacks(*cpp);
+	} /* endif */
+
 	push_channel(*cpp, clear_failed ? &Discarded_channels : &Channel_avail_hdr);
 
 	} else if ( (*cpp)->refcnt < 0 ) {
@@ -7337,6 +12371,214 @@ struct monitor *mp;
 
 } /* end clean_and_push_channel() */
 
+/****************************************************************
+*
+* monitors go to Discarded_monitors when ca_clear_event() fails;
+* once their channel has been cleared, CA has dropped them, too,
+* and they can be reused.
+*
+****************************************************************/
+
+static void reclaim_monitors(struct channel *cp)
+{
+
+struct monitor **pmp, *mp;
+
+    for (pmp = &Discarded_monitors; (mp = *pmp); )
+    {
+	if (mp->cp == cp)
+	{
+	    *pmp = mp->left;
+	    MonitorPool.ndiscarded--;
+
+	    if (Debug)
+		printf("reclaim_monitors() reclaiming %p\n", mp);
+
+	    free_monitor_buffers(mp);
+	    push_monitor(mp, &Monitor_avail_hdr);
+	}
+	else
+	    pmp = &mp->left;
+    } /* endfor */
+
+} /* end reclaim_monitors() */
+
+/****************************************************************
+*
+* takes a user callback off its channel and clears its subscription.
+* If that fails CA may still call it; it stays (inactive) on
+* Discarded_callbacks until its channel is cleared.
+*
+****************************************************************/
+
+static void remove_callback(struct moncb *ucp)
+{
+
+struct moncb **pp;
+int rc;
+
+    for (pp = &ucp->cp->callbacks; *pp; pp = &(*pp)->next)
+    {
+	if (*pp == ucp)
+	{
+	    *pp = ucp->next;
+	    break;
+	} /* endif */
+    } /* endfor */
+
+    ucp->active = FALSE;
+
+    /* ca_clear_event() waits for the callback to complete */
+    EZCA_UNLOCK();
+    rc = ca_clear_event(ucp->evd);
+    EZCA_LOCK();
+
+    if (ECA_NORMAL == rc)
+	ezcafree((char *) ucp);
+    else
+    {
+	ucp->next = Discarded_callbacks;
+	Discarded_callbacks = ucp;
+    } /* endif */
+
+} /* end remove_callback() */
+
+static void reclaim_callbacks(struct channel *cp)
+{
+
+struct moncb **pp, *ucp;
+
+    for (pp = &Discarded_callbacks; (ucp = *pp); )
+    {
+	if (ucp->cp == cp)
+	{
+	    *pp = ucp->next;
+	    ezcafree((char *) ucp);
+	}
+	else
+	    pp = &ucp->next;
+    } /* endfor */
+
+} /* end reclaim_callbacks() */
+
+/****************************************************************
+*
+* allocates a queue for 'depth' updates of 'nelem' elements of
+* 'dbr_type'; returns NULL if no memory is available.
+*
+****************************************************************/
+
+static struct monq *create_queue(int dbr_type, unsigned long nelem, unsigned depth)
+{
+
+struct monq *q;
+
+    if (!(q = (struct monq *) ezcacalloc(1, sizeof(*q))))
+	return (struct monq *) NULL;
+
+    q->dbr_type = dbr_type;
+    q->esize = dbr_value_size[dbr_type];
+    q->depth = depth;
+    q->nelem = (int) (nelem ? nelem : 1);
+
+    if (!(q->data = (char *) ezcamalloc((unsigned) (depth * q->nelem * q->esize)))
+	|| !(q->nvals = (int *) ezcacalloc(depth, sizeof(*q->nvals)))
+	|| !(q->status = (short *) ezcacalloc(depth, sizeof(*q->status)))
+	|| !(q->severity = (short *) ezcacalloc(depth, sizeof(*q->severity)))
+	|| !(q->time_stamp = (epicsTimeStamp *) 
+		ezcacalloc(depth, sizeof(*q->time_stamp))))
+    {
+	free_queue(q);
+	return (struct monq *) NULL;
+    } /* endif */
+
+    if (Trace || Debug)
+	printf("create_queue() %u slots of %d X %d bytes\n",
+	    depth, q->nelem, q->esize);
+
+    MONMEM_ADD(queue_bytes(q));
+
+    return q;
+
+} /* end create_queue() */
+
+static void free_queue(struct monq *q)
+{
+    if (q)
+    {
+	if (q->data)
+	    ezcafree((char *) q->data);
+	if (q->nvals)
+	    ezcafree((char *) q->nvals);
+	if (q->status)
+	    ezcafree((char *) q->status);
+	if (q->severity)
+	    ezcafree((char *) q->severity);
+	if (q->time_stamp)
+	    ezcafree((char *) q->time_stamp);
+	ezcafree((char *) q);
+    } /* endif */
+
+} /* end free_queue() */
+
+/* bytes held by a queue (booked in MonitorMem) */
+static double queue_bytes(struct monq *q)
+{
+    return (double) sizeof(*q) + (double) q->depth * ((double) q->nelem * q->esize
+	+ sizeof(*q->nvals) + sizeof(*q->status) + sizeof(*q->severity)
+	+ sizeof(*q->time_stamp));
+} /* end queue_bytes() */
+
+/* MonitorMem as seen by a thread holding ezcaMutex */
+static double monitor_mem()
+{
+
+double rval;
+
+#ifdef EPICS_THREE_FOURTEEN
+    epicsMutexLock(ezcaCountMutex);
+    rval = MonitorMem;
+    epicsMutexUnlock(ezcaCountMutex);
+#else
+    rval = MonitorMem;
+#endif
+
+    return rval;
+
+} /* end monitor_mem() */
+
+/****************************************************************
+*
+* frees the data buffers of a monitor. This must only be done
+* once its subscription has been cleared successfully since the
+* callback fills mp->back without holding any lock. If clearing
+* failed the buffers are leaked along with the (discarded) monitor.
+*
+****************************************************************/
+
+static void free_monitor_buffers(struct monitor *mp)
+{
+
+int i;
+
+    for (i = 0; i < 3; i++)
+    {
+	if (mp->buf[i].pval)
+	{
+	    ezcafree((char *) mp->buf[i].pval);
+	    mp->buf[i].pval = (void *) NULL;
+	    MONMEM_ADD(-(double) mp->buf[i].size);
+	} /* endif */
+	mp->buf[i].size = 0;
+    } /* endfor */
+
+    if (mp->queue)
+	MONMEM_ADD(-queue_bytes(mp->queue));
+    free_queue(mp->queue);
+    mp->queue = (struct monq *) NULL;
+
+} /* end free_monitor_buffers() */
+
 /****************************************************************
 *
 *
@@ -7350,21 +12592,60 @@ int clear_failed;
 
 	mp->active = FALSE;
 
-	if (mp->pval)
-	{
-	    ezcafree((char *) mp->pval);
-	    mp->pval = (void *) NULL;
-	} /* endif */
-
 	clear_failed = EzcaClearEvent(mp);
 	EzcaPendIO((struct work *) NULL, SHORT_TIME);
 
+	if (!clear_failed)
+	    free_monitor_buffers(mp);
+
 	push_monitor(mp, clear_failed ? &Discarded_monitors : &Monitor_avail_hdr);
 
     } /* endif */
 
 } /* end clean_and_push_monitor() */
 
+/****************************************************************
+*
+* node slabs: the nodes are never given back to malloc but recycled
+* through the avail lists; the pools merely count them.
+*
+****************************************************************/
+
+static void init_pool(struct node_pool *pp, size_t size)
+{
+    pp->stride = (size + CACHELINE - 1) & ~((size_t) CACHELINE - 1);
+    pp->nslabs = 0;
+    pp->nnodes = 0;
+    pp->navail = 0;
+    pp->ndiscarded = 0;
+} /* end init_pool() */
+
+/****************************************************************
+*
+* allocates a slab of NodesPerSlab nodes aligned to a cache line;
+* returns the first node (*pn nodes follow at pp->stride) or NULL.
+* The caller threads the nodes onto its avail list.
+*
+****************************************************************/
+
+static char *carve_slab(struct node_pool *pp, int *pn)
+{
+
+char *raw;
+
+    *pn = NodesPerSlab;
+
+    if (!(raw = (char *) ezcamalloc((unsigned) (pp->stride * *pn + CACHELINE - 1))))
+	return (char *) NULL;
+
+    pp->nslabs++;
+    pp->nnodes += *pn;
+    pp->navail += *pn;
+
+    return (char *) (((size_t) raw + CACHELINE - 1) & ~((size_t) CACHELINE - 1));
+
+} /* end carve_slab() */
+
 /****************************************************************
 *
 *
@@ -7374,7 +12655,7 @@ static struct channel *pop_channel()
 {
 
 struct channel *rc;
-int i;
+int i, n;
 
     if (Debug)
     {
@@ -7386,33 +12667,39 @@ int i;
     {
         rc = Channel_avail_hdr;
         Channel_avail_hdr = rc->next;
+	ChannelPool.navail--;
     }
     else
     {
         if ((Channel_avail_hdr = (struct channel *) 
-	    ezcamalloc((unsigned) (sizeof(struct channel)*NODESPERMAL))) != NULL)
+	    carve_slab(&ChannelPool, &n)) != NULL)
         {
 	    if (Debug)
-		printf("pop_channel() allocated sizeof(struct channel) %d * NODESPERMAL %d bytes = %d bytes %p\n", 
-		    (unsigned)sizeof(struct channel), NODESPERMAL, 
-			(unsigned)sizeof(struct channel)*NODESPERMAL, Channel_avail_hdr);
+		printf("pop_channel() allocated stride %d * %d nodes = %d bytes %p\n", 
+		    (unsigned)ChannelPool.stride, n, 
+			(unsigned)ChannelPool.stride*n, Channel_avail_hdr);
 
-            for (rc = Channel_avail_hdr, i=0; i < (NODESPERMAL-1); i ++)
+            for (rc = Channel_avail_hdr, i=0; i < (n-1); i ++)
             {
-                rc->next = rc + 1;
+                rc->next = (struct channel *) ((char *) rc + ChannelPool.stride);
 				rc->refcnt = 0;
 		rc->pvname = (char *) NULL;
+		rc->meta = (struct chanmeta *) NULL;
+		CHAN_LOCK_INIT(rc);
 		if (Debug)
 		    printf("i = %d rc %p rc->next %p\n", i, rc, rc->next);
-                rc++;
+                rc = rc->next;
             } /* endfor */
             rc->next = (struct channel *) NULL;
 			rc->refcnt = 0;
 	    rc->pvname = (char *) NULL;
+	    rc->meta = (struct chanmeta *) NULL;
+	    CHAN_LOCK_INIT(rc);
 	    if (Debug)
 		printf("i = %d rc %p rc->next %p\n", i, rc, rc->next);
             rc = Channel_avail_hdr;
             Channel_avail_hdr = rc->next;
+	    ChannelPool.navail--;
         }
         else
             rc = (struct channel *) NULL;
@@ -7427,7 +12714,22 @@ int i;
 	    rc->pvname = (char *) NULL;
 	} /* endif */
 	rc->monitor_list = (struct monitor *) NULL;
+	rc->callbacks = (struct moncb *) NULL;
+	rc->nhandles = 0;
+	rc->pending = (struct work *) NULL;
+	rc->inflight = (struct work *) NULL;
+	rc->lru_prev = (struct channel *) NULL;
+	rc->lru_next = (struct channel *) NULL;
+	rc->not_found_at = 0;
 	rc->ever_successfully_searched = FALSE;
+	CHAN_LOCK(rc);
+	memset(&rc->stats, 0, sizeof(rc->stats));
+	rc->stats.connect_time = -1.;
+	if (rc->meta)
+	    rc->meta->valid = FALSE;
+	rc->meta_evd = (evid) NULL;
+	rc->meta_subscribing = FALSE;
+	CHAN_UNLOCK(rc);
 	if ( rc->refcnt ) {
 		fprintf(stderr,"EZCA FATAL ERROR: pop_channel refcnt != 0\n"); 
 		exit(1);
@@ -7455,7 +12757,7 @@ static struct monitor *pop_monitor()
 {
 
 struct monitor *rc;
-int i;
+int i, n;
 
     if (Debug)
     {
@@ -7467,25 +12769,26 @@ int i;
     {
         rc = Monitor_avail_hdr;
         Monitor_avail_hdr = rc->left;
+	MonitorPool.navail--;
     }
     else
     {
         if ((Monitor_avail_hdr = (struct monitor *) 
-	    ezcamalloc((unsigned) (sizeof(struct monitor)*NODESPERMAL))) != NULL)
+	    carve_slab(&MonitorPool, &n)) != NULL)
         {
 	    if (Debug)
-		printf("pop_monitor() allocated sizeof(struct monitor) %d * NODESPERMAL %d bytes = %d bytes %p\n", 
-		    (unsigned)sizeof(struct monitor), NODESPERMAL, 
-		    (unsigned)sizeof(struct monitor)*NODESPERMAL, Monitor_avail_hdr);
+		printf("pop_monitor() allocated stride %d * %d nodes = %d bytes %p\n", 
+		    (unsigned)MonitorPool.stride, n, 
+		    (unsigned)MonitorPool.stride*n, Monitor_avail_hdr);
 
-            for (rc = Monitor_avail_hdr, i=0; i < (NODESPERMAL-1); i ++)
+            for (rc = Monitor_avail_hdr, i=0; i < (n-1); i ++)
             {
-                rc->left = rc + 1;
+                rc->left = (struct monitor *) ((char *) rc + MonitorPool.stride);
 
 		if (Debug)
 		    printf("i = %d rc %p rc->left %p\n", i, rc, rc->left);
 
-                rc++;
+                rc = rc->left;
             } /* endfor */
             rc->left = (struct monitor *) NULL;
 
@@ -7494,6 +12797,7 @@ int i;
 
             rc = Monitor_avail_hdr;
             Monitor_avail_hdr = rc->left;
+	    MonitorPool.navail--;
         }
         else
             rc = (struct monitor *) NULL;
@@ -7507,12 +12811,28 @@ int i;
 	rc->cp = (struct channel *) NULL;
 	rc->ezcadatatype = UNDEFINED;
 	rc->dbr_type = UNDEFINED;
-	rc->pval = (void *) NULL;
 	rc->needs_reading = FALSE;
+	rc->fresh = FALSE;
 	rc->active = FALSE;
-	rc->last_nelem = UNDEFINED;
-	rc->status = UNDEFINED;
-	rc->severity = UNDEFINED;
+	for (i = 0; i < 3; i++)
+	{
+	    rc->buf[i].pval = (void *) NULL;
+	    rc->buf[i].size = 0;
+	    rc->buf[i].nelem = UNDEFINED;
+	    rc->buf[i].status = UNDEFINED;
+	    rc->buf[i].severity = UNDEFINED;
+	} /* endfor */
+	rc->front = &rc->buf[0];
+	rc->mid = &rc->buf[1];
+	rc->back = &rc->buf[2];
+	rc->queue = (struct monq *) NULL;
+	rc->src = (struct monitor *) NULL;
+	rc->nviews = 0;
+	rc->count = 0;
+	rc->nupdates = 0;
+	rc->interval_sum = 0.;
+	rc->interval_max = 0.;
+	rc->bytes = 0.;
     } /* endif */
 
     if (Debug)
@@ -7535,7 +12855,7 @@ static struct work *pop_work()
 {
 
 struct work *rc;
-int i;
+int i, n;
 
     if (Debug)
     {
@@ -7547,38 +12867,42 @@ int i;
     {
         rc = Work_avail_hdr;
         Work_avail_hdr = rc->next;
+	WorkPool.navail--;
     }
     else
     {
         if ((Work_avail_hdr = (struct work *) 
-	    ezcamalloc((unsigned) (sizeof(struct work)*NODESPERMAL))) != NULL)
+	    carve_slab(&WorkPool, &n)) != NULL)
         {
 
 	    if (Debug)
-		printf("pop_work() allocated sizeof(struct work) %d * NODESPERMAL %d bytes = %d bytes %p\n", 
-		    (unsigned)sizeof(struct work), NODESPERMAL, 
-		    (unsigned)sizeof(struct work)*NODESPERMAL, Work_avail_hdr);
+		printf("pop_work() allocated stride %d * %d nodes = %d bytes %p\n", 
+		    (unsigned)WorkPool.stride, n, 
+		    (unsigned)WorkPool.stride*n, Work_avail_hdr);
 
-            for (rc = Work_avail_hdr, i=0; i < (NODESPERMAL-1); i ++)
+            for (rc = Work_avail_hdr, i=0; i < (n-1); i ++)
             {
-                rc->next = rc + 1;
+                rc->next = (struct work *) ((char *) rc + WorkPool.stride);
 		rc->pvname = (char *) NULL;
 		rc->aux_error_msg = (char *) NULL;
+		rc->in_arena = FALSE;
 
 		if (Debug)
 		    printf("i = %d rc %p rc->next %p\n", i, rc, rc->next);
 
-                rc++;
+                rc = rc->next;
             } /* endfor */
             rc->next = (struct work *) NULL;
 	    rc->pvname = (char *) NULL;
 	    rc->aux_error_msg = (char *) NULL;
+	    rc->in_arena = FALSE;
 
 	    if (Debug)
 		printf("i = %d rc %p rc->next %p\n", i, rc, rc->next);
 
             rc = Work_avail_hdr;
             Work_avail_hdr = rc->next;
+	    WorkPool.navail--;
         }
         else
             rc = (struct work *) NULL;
@@ -7614,16 +12938,19 @@ static void init_work(struct work *wp)
 	wp->error_msg = (char *) NULL;
 	if (wp->aux_error_msg)
 	{
-	    ezcafree(wp->aux_error_msg);
+	    work_free(wp, wp->aux_error_msg);
 	    wp->aux_error_msg = (char *) NULL;
 	} /* endif */
 	wp->trashme = usable;
 	wp->needs_work = FALSE;
 	if (wp->pvname)
 	{
-	    ezcafree(wp->pvname);
+	    work_free(wp, wp->pvname);
 	    wp->pvname = (char *) NULL;
 	} /* endif */
+	wp->in_arena = FALSE;
+	wp->ticket = (EzcaTicket) NULL;
+	wp->ctx = Ctx;
 	wp->dbr_type = UNDEFINED;
 	wp->reported = FALSE;
 	wp->worktype = UNDEFINED;
@@ -7641,6 +12968,11 @@ static void init_work(struct work *wp)
 	wp->tsp = (epicsTimeStamp *) NULL;
 	wp->pchid = (chid *) NULL;
 	wp->pevid = (evid *) NULL;
+	wp->deferred = FALSE;
+	wp->next_pending = (struct work *) NULL;
+	wp->cbcp = (struct channel *) NULL;
+	wp->next_inflight = (struct work *) NULL;
+	wp->joined = (struct work *) NULL;
     } /* endif */
 
 } /* end init_work() */
@@ -7652,7 +12984,6 @@ static void init_work(struct work *wp)
 
 static void push_channel(struct channel *p, struct channel **plist)
 {
-struct channel **pc,*c;
 
     if (Debug)
     {
@@ -7664,19 +12995,23 @@ struct channel **pc,*c;
     {
 	if (p->pvname)
 	{
-		for ( pc = &Channels[hash(p->pvname)]; *pc; pc = & (*pc)->next )
-			if ( !strcmp(p->pvname, (*pc)->pvname ) ) {
-				c = *pc;
-				*pc = c->next;
-				c->next = 0;
-				break;
-			}
-		
+		/* no-op if it never made it into Channels or */
+		/* clean_and_push_channel() took it out       */
+		REG_LOCK();
+		ezcaRegRemove(Channels, &p->reg);
+		REG_UNLOCK();
+		lru_unlink(p);
+
 	    ezcafree(p->pvname);
 	    p->pvname = (char *) NULL;
 	} /* endif */
 	p->next = *plist;
 	*plist = p;
+
+	if (plist == &Channel_avail_hdr)
+	    ChannelPool.navail++;
+	else
+	    ChannelPool.ndiscarded++;
     } /* endif */
 
     if (Debug)
@@ -7709,8 +13044,17 @@ static void push_monitor(struct monitor *p, struct monitor **l)
 
     if (p)
     {
-	/* add paranoia */
-	memset(p, 0, sizeof(*p));
+	if (l == &Monitor_avail_hdr)
+	{
+	    /* add paranoia */
+	    memset(p, 0, sizeof(*p));
+	    MonitorPool.navail++;
+	}
+	else
+	{
+	    /* keep cp and the buffers for reclaim_monitors() */
+	    MonitorPool.ndiscarded++;
+	} /* endif */
 	p->left = *l;
 	*l = p;
     } /* endif */
@@ -7748,6 +13092,8 @@ struct work **ppw, *pw;
 			*ppw = wp->next;
 			wp->next = Work_avail_hdr;
 			Work_avail_hdr = wp;
+			WorkPool.ndiscarded--;
+			WorkPool.navail++;
 			if (Debug) {
 				printf("Success; %p moved from Discarded to Avail list\n", wp);
 				printf("exiting recycle_work()\n");
@@ -7755,12 +13101,15 @@ struct work **ppw, *pw;
 			return;
 		}
 	}
-	/* If we get here, the node is still on the work list
-	 * or in Workp...
+	/* If we get here, the node is still on the work list,
+	 * in Workp (of the thread owning it; we may be running
+	 * in a CA thread) or belongs to an async group...
 	 */
-	for ( pw = Work_list.head; pw && pw != wp; pw = pw->next )
+	for ( pw = wp->ctx->work_list.head; pw && pw != wp; pw = pw->next )
 		;
-	if ( pw || Workp == wp ) {
+	if ( !pw && wp->ticket && find_ticket(wp->ticket) )
+		pw = wp;
+	if ( pw || wp->ctx->workp == wp ) {
 		/* simply reset trashme */
 		wp->trashme = recyclable;
 		if (Debug) {
@@ -7787,26 +13136,31 @@ static void push_work(struct work *p)
     {
 	if (p->pvname)
 	{
-	    ezcafree(p->pvname);
+	    work_free(p, p->pvname);
 	    p->pvname = (char *) NULL;
 	} /* endif */
 
 	if (p->aux_error_msg)
 	{
-	    ezcafree(p->aux_error_msg);
+	    work_free(p, p->aux_error_msg);
 	    p->aux_error_msg = (char *) NULL;
 	} /* endif */
 
+	p->in_arena = FALSE;
+	p->ticket = (EzcaTicket) NULL;
+
 	if (trashed == p->trashme)
 	{
 	    p->next = Discarded_work;
 	    Discarded_work = p;
+	    WorkPool.ndiscarded++;
 	}
 	else
 	{
 		/* usable and recyclable work nodes appear here */
 	    p->next = Work_avail_hdr;
 	    Work_avail_hdr = p;
+	    WorkPool.navail++;
 	} /* endif */
     } /* endif */
 
@@ -7831,6 +13185,10 @@ static void push_work(struct work *p)
 
 static void print_avails()
 {
+    printf("Slabs (slabs/nodes/avail/discarded): channels %lu/%lu/%lu/%lu monitors %lu/%lu/%lu/%lu work %lu/%lu/%lu/%lu\n",
+	ChannelPool.nslabs, ChannelPool.nnodes, ChannelPool.navail, ChannelPool.ndiscarded,
+	MonitorPool.nslabs, MonitorPool.nnodes, MonitorPool.navail, MonitorPool.ndiscarded,
+	WorkPool.nslabs, WorkPool.nnodes, WorkPool.navail, WorkPool.ndiscarded);
     print_channel_avail();
     print_monitor_avail();
     print_work_avail();
@@ -7861,19 +13219,21 @@ struct channel *cp;
 static void print_channels()
 {
 
-int            i;
+unsigned long  i;
 struct channel *cp;
 struct monitor *mp;
 
     printf("Start Channels:\n");
-	for ( i=0; i<HASHTABLESIZE; i++ )
-    for (cp = Channels[i]; cp; cp = cp->next) 
+    printf("%lu channels in %lu buckets\n",
+	ezcaRegCount(Channels), ezcaRegBuckets(Channels));
+	for ( i=0; i<ezcaRegBuckets(Channels); i++ )
+    for (cp = REG2CHANNEL(ezcaRegBucket(Channels, i)); cp; cp = REG2CHANNEL(cp->reg.chain)) 
     {
-	printf(">%s< %p (nxt %p) ml %p ", 
-	    cp->pvname, cp, cp->next, cp->monitor_list);
+	printf(">%s< %p (nxt %p) ml %p rc %d hdl %d ", 
+	    cp->pvname, cp, cp->reg.chain, cp->monitor_list, cp->refcnt, cp->nhandles);
 	for (mp = cp->monitor_list; mp; mp = mp->right) 
 	    printf("M>(lft %p) %p (rght %p) type %d pval %p active %c cp %p<M ",
-		mp->left, mp, mp->right, mp->ezcadatatype, mp->pval, 
+		mp->left, mp, mp->right, mp->ezcadatatype, mp->src->front->pval, 
 		(mp->active ? 'T' : 'F'), mp->cp);
 	printf("\n");
     } /* endfor */
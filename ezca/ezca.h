@@ -57,11 +57,43 @@ typedef int (*EzcaPollCb)();
 epicsShareFunc EzcaPollCb epicsShareAPI ezcaPollCbInstall(EzcaPollCb);
 epicsShareFunc int epicsShareAPI ezcaEndGroup(void);
 epicsShareFunc int epicsShareAPI ezcaEndGroupWithReport(int **rcs, int *nrcs);
+/* Prepared groups: ezcaPrepareGroup() ends the current group (executing
+ * it once) and keeps the work so that ezcaExecuteGroup() can run it
+ * again without rebuilding it. Results go to the buffers that were
+ * passed when the group was built. Only 'get'-type work may be prepared.
+ * Any thread may execute (or free) a prepared group but it fails with
+ * EZCA_INGROUP while another thread is executing it.
+ */
+typedef struct EzcaGroupRec_ *EzcaGroup;
+epicsShareFunc int epicsShareAPI ezcaPrepareGroup(EzcaGroup *pg, int **rcs, int *nrcs);
+epicsShareFunc int epicsShareAPI ezcaExecuteGroup(EzcaGroup g, int **rcs, int *nrcs);
+epicsShareFunc int epicsShareAPI ezcaFreeGroup(EzcaGroup g);
+/* Async groups: ezcaEndGroupAsync() issues the requests of the current
+ * group and returns right away with a ticket; several groups may be in
+ * flight at once. Results go to the user buffers as they arrive.
+ * ezcaGroupTest() and ezcaGroupWait() (timeout < 0: up to the group's
+ * deadline) return 1 once the group is over (all requests reported or
+ * timed out), 0 if it is not and < 0 for an invalid ticket.
+ * ezcaGroupWaitAny() returns the index of a group in ts[] that is over
+ * (NULL entries are skipped), -1 if none is within 'timeout' and -2 on
+ * invalid arguments. ezcaGroupCollect() waits for the group, returns
+ * its rcs like ezcaEndGroupWithReport() and invalidates the ticket.
+ */
+typedef struct EzcaTicketRec_ *EzcaTicket;
+epicsShareFunc int epicsShareAPI ezcaEndGroupAsync(EzcaTicket *pt);
+epicsShareFunc int epicsShareAPI ezcaGroupTest(EzcaTicket t);
+epicsShareFunc int epicsShareAPI ezcaGroupWait(EzcaTicket t, float timeout);
+epicsShareFunc int epicsShareAPI ezcaGroupWaitAny(EzcaTicket *ts, int n, float timeout);
+epicsShareFunc int epicsShareAPI ezcaGroupCollect(EzcaTicket t, int **rcs, int *nrcs);
 epicsShareFunc int epicsShareAPI ezcaGetErrorString(char *prefix, char **buff);
 epicsShareFunc int epicsShareAPI ezcaNewMonitorValue(char *pvname, 
 	char ezcatype); /* returns TRUE/FALSE or < 0 if no monitor or other error */
 /* Block until monitor happens */
 epicsShareFunc int epicsShareAPI ezcaNewMonitorWait(char *pvname, char ezcatype);
+/* # of updates queued by a monitor set with ezcaSetMonitorQueued();
+ * < 0 (like ezcaNewMonitorValue) if there is no such monitor.
+ */
+epicsShareFunc int epicsShareAPI ezcaGetQueuedCount(char *pvname, char ezcatype);
 epicsShareFunc void epicsShareAPI ezcaPerror(char *prefix);
 
 /* Non-Groupable Work Functions */
@@ -77,18 +109,200 @@ epicsShareFunc int epicsShareAPI ezcaGetRetryCount(void);
 epicsShareFunc float epicsShareAPI ezcaGetTimeout(void);
 epicsShareFunc int epicsShareAPI ezcaPvToChid(char *pvname, chid **cid);
 epicsShareFunc int epicsShareAPI ezcaSetMonitor(char *pvname, char ezcatype, unsigned long count);
+/* A queued monitor additionally keeps up to 'depth' updates (value,
+ * status, severity and timestamp) which ezcaGetQueued() removes in
+ * one call; updates arriving while the queue is full are counted
+ * in *ndropped. Update 'k' is stored at element 'k*nelem' of 'buff'
+ * and index 'k' of the (optional) nvals, timestamp, status and
+ * severity arrays; *nupd returns the number of updates stored.
+ */
+epicsShareFunc int epicsShareAPI ezcaSetMonitorQueued(char *pvname, char ezcatype, unsigned long count, unsigned depth);
+epicsShareFunc int epicsShareAPI ezcaGetQueued(char *pvname, char ezcatype,
+	int nelem, int maxupd, void *data_buff, int *nvals, epicsTimeStamp *timestamp,
+	short *status, short *severity, int *nupd, unsigned long *ndropped);
+/* User callbacks: 'fn' is called with every update of 'pvname' as
+ * 'ezcatype' (count 0: native count) on a subscription of its own.
+ * The update points right into the CA buffer and is only valid
+ * during the call; 'value' (and 'timestamp') are NULL if CA
+ * reported an error. 'fn' runs in the CA callback thread without
+ * any ezca lock held (without preemptive callbacks: from within
+ * the ezca call that polls CA). It must not call ezca (hand the
+ * data over to another thread instead) and should return quickly.
+ * 'fn' may run before ezcaAddMonitorCallback() returns; once
+ * ezcaRemoveMonitorCallback() (which must not be called from 'fn')
+ * returns it is not called again. Callbacks go away with their
+ * channel (ezcaClearChannel(), ezcaPurge()).
+ */
+typedef struct EzcaMonitorUpdateRec_ {
+	const char           *pvname;
+	char                  type;
+	int                   nelem;
+	const void           *value;
+	const epicsTimeStamp *timestamp;
+	short                 status;
+	short                 severity;
+} EzcaMonitorUpdateRec;
+typedef void (*EzcaMonitorCallback)(void *arg, const EzcaMonitorUpdateRec *update);
+epicsShareFunc int epicsShareAPI ezcaAddMonitorCallback(char *pvname, char ezcatype,
+	unsigned long count, EzcaMonitorCallback fn, void *arg);
+epicsShareFunc int epicsShareAPI ezcaRemoveMonitorCallback(char *pvname, char ezcatype,
+	EzcaMonitorCallback fn, void *arg);
 epicsShareFunc int epicsShareAPI ezcaSetRetryCount(int retry);
 epicsShareFunc int epicsShareAPI ezcaSetTimeout(float sec);
+/* PVs that could not be found fail immediately with EZCA_NOTFOUND
+ * for 'sec' seconds (default 30); CA keeps searching for them in
+ * the background. sec <= 0 disables this.
+ */
+epicsShareFunc int epicsShareAPI ezcaSetNotFoundHoldoff(float sec);
+epicsShareFunc float epicsShareAPI ezcaGetNotFoundHoldoff(void);
+/* Channel, monitor and work nodes are allocated in slabs of 'n'
+ * (default 64) cache-line aligned nodes. ezcaGetNodeStats() reports
+ * the occupancy of one kind of node; 'ndiscarded' counts nodes which
+ * cannot be reused until CA is done with them.
+ */
+#define EZCA_NODE_CHANNEL 0
+#define EZCA_NODE_MONITOR 1
+#define EZCA_NODE_WORK    2
+epicsShareFunc int epicsShareAPI ezcaSetNodesPerSlab(int n);
+epicsShareFunc int epicsShareAPI ezcaGetNodeStats(int kind, unsigned long *nslabs,
+	unsigned long *nnodes, unsigned long *ninuse, unsigned long *ndiscarded);
+/* # of heap allocations made so far for PV names, error strings and
+ * PUT data of work requests. Grouped work takes these from an arena
+ * which is released in one step when the next group starts, so a
+ * group costs O(1) allocations regardless of its size.
+ */
+epicsShareFunc unsigned long epicsShareAPI ezcaGetWorkAllocs(void);
+/* Groups (and the error of the last call, see ezcaPerror()) are kept
+ * per thread; threads may run groups at the same time.
+ */
 epicsShareFunc int epicsShareAPI ezcaStartGroup(void);
 epicsShareFunc int epicsShareAPI ezcaClearChannel(char *pvname);
 epicsShareFunc int epicsShareAPI ezcaPurge(int disconnectedOnly);
+/* Channel cache policy. Channels are evicted (cleared) in the
+ * background, least recently used first, while more than
+ * 'maxChannels' are cached and once they have not been used for
+ * 'maxIdle' seconds. A channel is used whenever a call names it or
+ * uses a handle to it. Channels with monitors (or monitor callbacks)
+ * or handles (including prepared groups) are never evicted. A new
+ * monitor fails with EZCA_FAILEDMALLOC if the buffers and queues of
+ * all monitors could then exceed 'maxMonitorBytes'. 0 disables a
+ * limit; all are off by default. Switching all of them off stops
+ * the background eviction before the call returns (do so before
+ * destroying the CA context). ezcaGetCacheStats() reports the #
+ * of cached channels, of channels evicted so far and the bytes held
+ * by monitors; any of the pointers may be NULL.
+ */
+epicsShareFunc int epicsShareAPI ezcaSetCachePolicy(unsigned long maxChannels, float maxIdle, double maxMonitorBytes);
+epicsShareFunc int epicsShareAPI ezcaGetCacheStats(unsigned long *nchannels, unsigned long *nevicted, double *monitorBytes);
 epicsShareFunc void epicsShareAPI ezcaTraceOff(void);
 epicsShareFunc void epicsShareAPI ezcaTraceOn(void);
 
+/* Handles refer directly to a (cached) channel and save the
+ * name lookup on every access. A handle keeps its channel
+ * alive until released. A released handle must not be used;
+ * calls reject it (EZCA_INVALIDARG) unless ezcaResolve() has
+ * handed it out again meanwhile.
+ */
+typedef struct EzcaHandleRec_ *EzcaHandle;
+epicsShareFunc int epicsShareAPI ezcaResolve(char *pvname, EzcaHandle *ph);
+epicsShareFunc int epicsShareAPI ezcaReleaseHandle(EzcaHandle h);
+
+/* ezcaConnectMany() queues searches for PVs which are not cached yet
+ * and returns right away; the first request using such a channel
+ * waits for it to connect. ezcaConnectionState() (and the ...H()
+ * variant) store the cached state of each PV in states[] without
+ * any network traffic and return the number of connected ones
+ * (-1 on invalid arguments).
+ */
+#define EZCA_CS_NOCHANNEL    0 /* not cached (never used or cleared) */
+#define EZCA_CS_SEARCHING    1 /* searched for, never connected yet  */
+#define EZCA_CS_CONNECTED    2
+#define EZCA_CS_DISCONNECTED 3 /* was connected; CA reconnects it    */
+#define EZCA_CS_NOTFOUND     4 /* search timed out (negative cache)  */
+epicsShareFunc int epicsShareAPI ezcaConnectMany(char **pvnames, int n);
+epicsShareFunc int epicsShareAPI ezcaConnectionState(char **pvnames, int n, int *states);
+epicsShareFunc int epicsShareAPI ezcaConnectionStateH(EzcaHandle *hs, int n, int *states);
+/* Likewise, the element count of each connected channel (-1 if
+ * not connected); it may change when a channel reconnects.
+ */
+epicsShareFunc int epicsShareAPI ezcaElementCountH(EzcaHandle *hs, int n, int *nelem);
+/* Warm start: ezcaSaveChannels() writes the channels which have been
+ * connected to a text file (one per line: name, native DBF type and
+ * element count); ezcaLoadChannels() queues searches for the channels
+ * listed in such a file like ezcaConnectMany().
+ */
+epicsShareFunc int epicsShareAPI ezcaSaveChannels(char *file);
+epicsShareFunc int epicsShareAPI ezcaLoadChannels(char *file);
+
+/* Per-channel performance counters. They are kept while the channel
+ * is cached (ezcaClearChannel()/ezcaPurge() discard them). Round trips
+ * (request issued to reply received) of gets and put-callbacks are
+ * counted in a histogram: bin 0 holds those shorter than
+ * EZCA_STATS_BIN0 seconds, bin i < EZCA_STATS_NBINS-1 those shorter
+ * than EZCA_STATS_BIN0 * 2^i, the last bin all others. Gets are
+ * counted when the reply arrives, puts when issued. Monitor counters
+ * cover all ezcaSetMonitor() subscriptions of the channel (not the
+ * ezcaAddMonitorCallback() ones). Times are in seconds; a negative
+ * time means 'no such event yet'. Without EPICS 3.14 the resolution
+ * is one second.
+ *
+ * ezcaGetStats() fills stats[] for 'n' PVs (all zero with negative
+ * times for PVs which are not cached) and returns the number of PVs
+ * which are cached (-1 on invalid arguments). It does not use the
+ * network.
+ */
+#define EZCA_STATS_NBINS 16
+#define EZCA_STATS_BIN0  64.0E-6
+typedef struct EzcaStatsRec_ {
+	double        connect_time;    /* search until first connection  */
+	unsigned long reconnects;
+	unsigned long gets;
+	unsigned long puts;
+	unsigned long monitor_updates;
+	double        bytes_in;        /* gets and monitor updates       */
+	double        bytes_out;       /* puts                           */
+	unsigned long latency[EZCA_STATS_NBINS];
+	double        latency_avg;
+	double        latency_max;
+	double        monitor_interval_avg;
+	double        monitor_interval_max;
+	double        last_update_age; /* since the last monitor update  */
+} EzcaStatsRec, *EzcaStats;
+epicsShareFunc int epicsShareAPI ezcaGetStats(char **pvnames, int n, EzcaStatsRec *stats);
+
+/* Contention of the library mutex per call site of its lock (API
+ * functions are reported under their own name). ezcaLockStatsOn()
+ * resets and enables the statistics; it costs a trylock plus two
+ * clock reads per acquisition. ezcaGetLockStats() copies up to 'n'
+ * sites into stats[] and returns the number of sites used while
+ * enabled (-1 on invalid arguments; 0 without EPICS 3.14). Times
+ * are in seconds; a hold is timed from the outermost acquisition
+ * to its release.
+ */
+typedef struct EzcaLockStatsRec_ {
+	const char    *func;       /* where the lock was taken */
+	int            line;
+	unsigned long  count;      /* acquisitions             */
+	unsigned long  contended;  /* ... which had to wait    */
+	double         wait_sum;
+	double         wait_max;
+	unsigned long  holds;      /* outermost acquisitions   */
+	double         hold_sum;
+	double         hold_max;
+} EzcaLockStatsRec;
+epicsShareFunc void epicsShareAPI ezcaLockStatsOn(void);
+epicsShareFunc void epicsShareAPI ezcaLockStatsOff(void);
+epicsShareFunc int epicsShareAPI ezcaGetLockStats(EzcaLockStatsRec *stats, int n);
+
 /* Groupable Work Functions */
 
 epicsShareFunc int epicsShareAPI ezcaGet(char *pvname, char ezcatype, 
 	int nelem, void *data_buff);
+/* Units, precision, limits and enum strings are cached with the
+ * channel once fetched and kept current by a DBE_PROPERTY
+ * subscription (EPICS 3.14.11 or later); later calls don't go to
+ * the server.
+ */
 epicsShareFunc int epicsShareAPI ezcaGetControlLimits(char *pvname, 
 	double *low, double *high);
 epicsShareFunc int epicsShareAPI ezcaGetGraphicLimits(char *pvname, 
@@ -111,6 +325,14 @@ epicsShareFunc int epicsShareAPI ezcaPut(char *pvname, char ezcatype,
 	int nelem, void *data_buff);
 epicsShareFunc int epicsShareAPI ezcaPutOldCa(char *pvname, char ezcatype, 
 	int nelem, void *data_buff);
+/* same as above but using a handle obtained from ezcaResolve() */
+epicsShareFunc int epicsShareAPI ezcaGetH(EzcaHandle h, char ezcatype, 
+	int nelem, void *data_buff);
+epicsShareFunc int epicsShareAPI ezcaGetWithStatusH(EzcaHandle h, 
+	char ezcatype, int nelem, void *data_buff, epicsTimeStamp *timestamp, 
+	short *status, short *severity);
+epicsShareFunc int epicsShareAPI ezcaPutH(EzcaHandle h, char ezcatype, 
+	int nelem, void *data_buff);
 
 /* must match size of char units[] in dbr_gr_xxxx */
 /* and dbr_ctrl_xxxx structs in db_access.h       */
@@ -122,6 +344,24 @@ epicsShareFunc int epicsShareAPI ezcaPutOldCa(char *pvname, char ezcatype,
 
 epicsShareFunc int epicsShareAPI ezcaGetEnumStrings(char *pvname, char states[EZCA_ENUM_STATES][EZCA_ENUM_STRING_SIZE]);
 
+/* All of the above from a single DBR_CTRL_xxx request (of the native
+ * type) - and from the cache described above. What the native type
+ * does not define is left empty: 'units' and the limits for enums,
+ * 'precision' (-1) unless float or double, the enum strings unless
+ * enum. A native string PV yields an empty record.
+ */
+typedef struct EzcaMetadataRec_ {
+	char   units[EZCA_UNITS_SIZE];
+	short  precision;
+	double disp_lo,  disp_hi;   /* graphic limits */
+	double ctrl_lo,  ctrl_hi;
+	double warn_lo,  warn_hi;
+	double alarm_lo, alarm_hi;
+	int    no_str;
+	char   strs[EZCA_ENUM_STATES][EZCA_ENUM_STRING_SIZE];
+} EzcaMetadataRec;
+epicsShareFunc int epicsShareAPI ezcaGetMetadata(char *pvname, EzcaMetadataRec *md);
+
 /* Data Types */
 #define ezcaByte   0
 #define ezcaString 1
@@ -143,6 +383,7 @@ epicsShareFunc int epicsShareAPI ezcaGetEnumStrings(char *pvname, char states[EZ
 #define EZCA_NOTINGROUP        8
 #define EZCA_ABORTED           9
 #define EZCA_INTERNALERR      10
+#define EZCA_NOTFOUND         11 /* PV recently not found (negative cache) */
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,195 @@
+/* Resizable channel registry for ezca (see ezcaReg.h) */
+#include <stdlib.h>
+#include <string.h>
+#include <epicsTypes.h>
+
+#define epicsExportSharedSymbols
+#include <shareLib.h>
+
+#include <ezcaReg.h>
+
+#define EZCA_REG_DFLT_BUCKETS 256
+/* grow when the number of nodes exceeds LOADFACT * buckets */
+#define EZCA_REG_LOADFACT     1
+
+struct EzcaRegRec_ {
+	EzcaRegNode   *buckets;
+	unsigned long  mask;     /* # of buckets - 1 */
+	unsigned long  count;
+	int            nogrow;   /* growing failed once; don't retry */
+};
+
+/****************************************************************
+*
+* FNV-1a; we use all the bits of the hash to select a bucket
+* (the mask) and keep them for comparing (and growing).
+*
+****************************************************************/
+
+epicsShareFunc epicsUInt32 epicsShareAPI
+ezcaRegHash(const char *name, size_t *plen)
+{
+const unsigned char *p = (const unsigned char*)name;
+epicsUInt32          h = 2166136261U;
+
+	while ( *p ) {
+		h ^= *p++;
+		h *= 16777619U;
+	}
+	if ( plen )
+		*plen = (size_t)(p - (const unsigned char*)name);
+	return h;
+} /* end ezcaRegHash() */
+
+epicsShareFunc EzcaReg epicsShareAPI
+ezcaRegCreate(unsigned long nbuckets)
+{
+EzcaReg       rval;
+unsigned long n;
+
+	if ( 0 == nbuckets )
+		nbuckets = EZCA_REG_DFLT_BUCKETS;
+
+	for ( n = 1; n < nbuckets; n <<= 1 )
+		/* round up to power of two */;
+
+	if ( ! (rval = malloc(sizeof(*rval))) )
+		return 0;
+
+	if ( ! (rval->buckets = calloc(n, sizeof(*rval->buckets))) ) {
+		free(rval);
+		return 0;
+	}
+	rval->mask   = n - 1;
+	rval->count  = 0;
+	rval->nogrow = 0;
+	return rval;
+} /* end ezcaRegCreate() */
+
+epicsShareFunc void epicsShareAPI
+ezcaRegDestroy(EzcaReg reg)
+{
+	if ( reg ) {
+		free(reg->buckets);
+		free(reg);
+	}
+} /* end ezcaRegDestroy() */
+
+/****************************************************************
+*
+* double the number of buckets; since the full hash is stored
+* in every node this is a pure relinking operation. If no
+* memory is available we just carry on with the old table.
+*
+****************************************************************/
+
+static void grow(EzcaReg reg)
+{
+EzcaRegNode   *nb, n, nxt;
+unsigned long  i, nmask;
+
+	nmask = (reg->mask << 1) | 1;
+
+	if ( nmask <= reg->mask || ! (nb = calloc(nmask + 1, sizeof(*nb))) ) {
+		reg->nogrow = 1;
+		return;
+	}
+
+	for ( i = 0; i <= reg->mask; i++ ) {
+		for ( n = reg->buckets[i]; n; n = nxt ) {
+			nxt                   = n->chain;
+			n->chain              = nb[n->hash & nmask];
+			nb[n->hash & nmask]   = n;
+		}
+	}
+
+	free(reg->buckets);
+	reg->buckets = nb;
+	reg->mask    = nmask;
+} /* end grow() */
+
+epicsShareFunc EzcaRegNode epicsShareAPI
+ezcaRegFind(EzcaReg reg, const char *name)
+{
+size_t      len;
+epicsUInt32 h = ezcaRegHash(name, &len);
+EzcaRegNode n;
+
+	for ( n = reg->buckets[h & reg->mask]; n; n = n->chain ) {
+		if ( n->hash == h && n->len == len && 0 == memcmp(n->name, name, len) )
+			return n;
+	}
+	return 0;
+} /* end ezcaRegFind() */
+
+epicsShareFunc EzcaRegNode epicsShareAPI
+ezcaRegFindN(EzcaReg reg, const char *name, size_t len)
+{
+const unsigned char *p = (const unsigned char*)name;
+epicsUInt32          h = 2166136261U;
+size_t               i;
+EzcaRegNode          n;
+
+	/* same as ezcaRegHash() */
+	for ( i = 0; i < len; i++ ) {
+		h ^= p[i];
+		h *= 16777619U;
+	}
+
+	for ( n = reg->buckets[h & reg->mask]; n; n = n->chain ) {
+		if ( n->hash == h && n->len == len && 0 == memcmp(n->name, name, len) )
+			return n;
+	}
+	return 0;
+} /* end ezcaRegFindN() */
+
+epicsShareFunc void epicsShareAPI
+ezcaRegInsert(EzcaReg reg, EzcaRegNode node, const char *name)
+{
+EzcaRegNode *b;
+
+	node->name = name;
+	node->hash = ezcaRegHash(name, &node->len);
+
+	if ( reg->count >= EZCA_REG_LOADFACT * (reg->mask + 1) && ! reg->nogrow )
+		grow(reg);
+
+	b           = &reg->buckets[node->hash & reg->mask];
+	node->chain = *b;
+	*b          = node;
+	reg->count++;
+} /* end ezcaRegInsert() */
+
+epicsShareFunc int epicsShareAPI
+ezcaRegRemove(EzcaReg reg, EzcaRegNode node)
+{
+EzcaRegNode *pn;
+
+	for ( pn = &reg->buckets[node->hash & reg->mask]; *pn; pn = &(*pn)->chain ) {
+		if ( *pn == node ) {
+			*pn         = node->chain;
+			node->chain = 0;
+			reg->count--;
+			return 0;
+		}
+	}
+	return -1;
+} /* end ezcaRegRemove() */
+
+epicsShareFunc unsigned long epicsShareAPI
+ezcaRegCount(EzcaReg reg)
+{
+	return reg->count;
+} /* end ezcaRegCount() */
+
+epicsShareFunc unsigned long epicsShareAPI
+ezcaRegBuckets(EzcaReg reg)
+{
+	return reg->mask + 1;
+} /* end ezcaRegBuckets() */
+
+epicsShareFunc EzcaRegNode epicsShareAPI
+ezcaRegBucket(EzcaReg reg, unsigned long i)
+{
+	return i <= reg->mask ? reg->buckets[i] : 0;
+} /* end ezcaRegBucket() */
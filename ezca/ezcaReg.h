@@ -0,0 +1,90 @@
+#ifndef EZCA_REG_H
+#define EZCA_REG_H
+
+/* Channel registry for ezca.
+ *
+ * A chained hash table keyed by PV name which grows (doubling the
+ * number of buckets) when the load factor exceeds 1. Every node
+ * caches the full hash value and the length of its name so that
+ * a lookup only calls strcmp() on a genuine match candidate and
+ * growing never needs to rehash any names.
+ *
+ * The registry is 'intrusive': users embed an EzcaRegNodeRec in
+ * their own objects and the registry never allocates or frees
+ * nodes; it only allocates the bucket array.
+ *
+ * The registry does no locking. ezca modifies it holding both its
+ * library mutex and a (plain) registry mutex so that a lookup needs
+ * only one of the two.
+ */
+
+#include <stddef.h>
+#include <epicsTypes.h>
+#include <shareLib.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct EzcaRegNodeRec_ {
+	struct EzcaRegNodeRec_ *chain;
+	epicsUInt32             hash;
+	size_t                  len;
+	const char             *name;
+} EzcaRegNodeRec, *EzcaRegNode;
+
+typedef struct EzcaRegRec_ *EzcaReg;
+
+/* Create a registry; 'nbuckets' is rounded up to a power of two
+ * (0 selects a default). Returns NULL if no memory is available.
+ */
+epicsShareFunc EzcaReg epicsShareAPI
+ezcaRegCreate(unsigned long nbuckets);
+
+/* Destroy a registry; the nodes are not touched */
+epicsShareFunc void epicsShareAPI
+ezcaRegDestroy(EzcaReg reg);
+
+/* Hash a name and compute its length */
+epicsShareFunc epicsUInt32 epicsShareAPI
+ezcaRegHash(const char *name, size_t *plen);
+
+/* Look up a name; returns NULL if not found */
+epicsShareFunc EzcaRegNode epicsShareAPI
+ezcaRegFind(EzcaReg reg, const char *name);
+
+/* Look up the first 'len' characters of 'name' */
+epicsShareFunc EzcaRegNode epicsShareAPI
+ezcaRegFindN(EzcaReg reg, const char *name, size_t len);
+
+/* Insert 'node' under 'name' (the name string is referenced,
+ * not copied and must remain valid while the node is registered).
+ * Duplicates are not checked for. If the table cannot grow it
+ * simply gets more crowded; insertion itself never fails.
+ */
+epicsShareFunc void epicsShareAPI
+ezcaRegInsert(EzcaReg reg, EzcaRegNode node, const char *name);
+
+/* Remove 'node'; returns 0 if it was registered, -1 otherwise */
+epicsShareFunc int epicsShareAPI
+ezcaRegRemove(EzcaReg reg, EzcaRegNode node);
+
+/* Number of registered nodes */
+epicsShareFunc unsigned long epicsShareAPI
+ezcaRegCount(EzcaReg reg);
+
+/* Number of buckets and bucket heads for walking the table.
+ * NOTE: an insertion may grow the table and invalidate a walk
+ *       in progress; removal never does.
+ */
+epicsShareFunc unsigned long epicsShareAPI
+ezcaRegBuckets(EzcaReg reg);
+
+epicsShareFunc EzcaRegNode epicsShareAPI
+ezcaRegBucket(EzcaReg reg, unsigned long i);
+
+#ifdef __cplusplus
+};
+#endif
+
+#endif
@@ -0,0 +1,275 @@
+/* Binary event tracer for ezca (see ezcaTrace.h) */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <epicsVersion.h>
+#include <epicsTypes.h>
+#include <epicsTime.h>
+
+#define BASE_IS_MIN_VERSION(a,b,c) \
+	(   EPICS_VERSION > (a)    \
+	|| (EPICS_VERSION==(a) && EPICS_REVISION > (b)) \
+	|| (EPICS_VERSION==(a) && EPICS_REVISION == (b) && EPICS_MODIFICATION >= (c)) \
+	)
+
+#if BASE_IS_MIN_VERSION(3,14,0)
+#define EZCA_TRACE_SUPPORTED
+#include <epicsThread.h>
+#include <epicsMutex.h>
+#endif
+
+#define epicsExportSharedSymbols
+#include <shareLib.h>
+
+#include <ezcaTrace.h>
+
+#define EZCA_TRACE_DFLT_NRECS 16384
+
+volatile int ezcaTraceActive = 0;
+
+static const char *evNames[] = {
+	"NONE",
+	"SEARCH",
+	"CONN_UP",
+	"CONN_DOWN",
+	"ISSUE_GET",
+	"ISSUE_PUT",
+	"CB_GET",
+	"CB_PUT",
+	"CB_MONITOR",
+	"WAIT_START",
+	"WAIT_END",
+	"LOCK_WAIT",
+	"LOCK",
+	"UNLOCK",
+};
+
+epicsShareFunc const char * epicsShareAPI
+ezcaTraceEventName(int event)
+{
+	return event >= 0 && event < EZCA_EV_NEVENTS ? evNames[event] : "???";
+} /* end ezcaTraceEventName() */
+
+#ifdef EZCA_TRACE_SUPPORTED
+
+/* A ring is only written by its thread; 'head' counts all records
+ * ever written and 'tail' marks where the current trace started.
+ * Rings are never freed (a thread may be recording into it at any
+ * time) and are reused by a new start.
+ */
+typedef struct TraceRing_ {
+	struct TraceRing_  *next;
+	EzcaTraceRecRec    *recs;
+	unsigned long       mask;
+	volatile unsigned long head;
+	unsigned long       tail;
+	epicsUInt16         id;
+	char                thread[EZCA_TRACE_NAME_SIZE];
+} TraceRing;
+
+static epicsThreadOnceId    traceOnce = EPICS_THREAD_ONCE_INIT;
+static epicsThreadPrivateId ringKey;
+static epicsMutexId         ringMtx;
+static TraceRing           *rings;
+static unsigned             nrings;
+static unsigned long        ringSize;
+
+static void traceInit(void *unused)
+{
+	ringKey = epicsThreadPrivateCreate();
+	ringMtx = epicsMutexCreate();
+} /* end traceInit() */
+
+/****************************************************************
+*
+* the calling thread's ring; created (and registered) when the
+* thread records its first event.
+*
+****************************************************************/
+
+static TraceRing *getRing(void)
+{
+TraceRing *r;
+
+	if ( (r = epicsThreadPrivateGet(ringKey)) )
+		return r;
+
+	if ( ! (r = calloc(1, sizeof(*r))) )
+		return 0;
+
+	if ( ! (r->recs = malloc(ringSize * sizeof(*r->recs))) ) {
+		free(r);
+		return 0;
+	}
+	r->mask = ringSize - 1;
+	strncpy(r->thread, epicsThreadGetNameSelf(), sizeof(r->thread) - 1);
+
+	epicsMutexLock(ringMtx);
+		r->id   = (epicsUInt16) nrings++;
+		r->next = rings;
+		rings   = r;
+	epicsMutexUnlock(ringMtx);
+
+	epicsThreadPrivateSet(ringKey, r);
+	return r;
+} /* end getRing() */
+
+epicsShareFunc void epicsShareAPI
+ezcaTraceRecord(int event, const void *ptr, long a, long b)
+{
+TraceRing       *r;
+EzcaTraceRecRec *p;
+epicsTimeStamp   now;
+size_t           v = (size_t) ptr;
+
+	if ( ! ezcaTraceActive || ! (r = getRing()) )
+		return;
+
+	epicsTimeGetCurrent(&now);
+
+	p = &r->recs[r->head & r->mask];
+	p->sec    = now.secPastEpoch;
+	p->nsec   = now.nsec;
+	p->event  = (epicsUInt16) event;
+	p->ring   = r->id;
+	p->a      = (epicsInt32) a;
+	p->b      = (epicsInt32) b;
+	p->ptr_lo = (epicsUInt32) v;
+	/* avoid shifting by the full width on 32-bit hosts */
+	p->ptr_hi = (epicsUInt32) ((v >> 16) >> 16);
+	p->pad    = 0;
+
+	r->head++;
+} /* end ezcaTraceRecord() */
+
+epicsShareFunc int epicsShareAPI
+ezcaTraceStart(unsigned long nrecs)
+{
+TraceRing     *r;
+unsigned long  n;
+
+	epicsThreadOnce(&traceOnce, traceInit, 0);
+
+	if ( ! ringKey || ! ringMtx )
+		return -1;
+
+	if ( 0 == nrecs )
+		nrecs = EZCA_TRACE_DFLT_NRECS;
+	for ( n = 1; n < nrecs; n <<= 1 )
+		/* round up to power of two */;
+
+	epicsMutexLock(ringMtx);
+		if ( 0 == ringSize ) {
+			ringSize = n;
+		} else if ( n != ringSize ) {
+			/* existing rings can't be resized */
+			epicsMutexUnlock(ringMtx);
+			return -1;
+		}
+		for ( r = rings; r; r = r->next )
+			r->tail = r->head;
+	epicsMutexUnlock(ringMtx);
+
+	ezcaTraceActive = 1;
+	return 0;
+} /* end ezcaTraceStart() */
+
+epicsShareFunc void epicsShareAPI
+ezcaTraceStop(void)
+{
+	ezcaTraceActive = 0;
+} /* end ezcaTraceStop() */
+
+epicsShareFunc int epicsShareAPI
+ezcaTraceSave(const char *file)
+{
+FILE                *f;
+TraceRing           *r;
+EzcaTraceFileHdrRec  fh;
+EzcaTraceRingHdrRec  rh;
+EzcaTraceRecRec     *buf;
+unsigned long        head, from, copied, i;
+int                  rval = 0;
+
+	if ( ! ringMtx || ! (f = fopen(file, "wb")) )
+		return -1;
+
+	epicsMutexLock(ringMtx);
+
+	/* ringSize is fixed once set and there are no rings before */
+	if ( ! (buf = malloc((ringSize ? ringSize : 1) * sizeof(*buf))) ) {
+		epicsMutexUnlock(ringMtx);
+		fclose(f);
+		return -1;
+	}
+
+	memset(&fh, 0, sizeof(fh));
+	memcpy(fh.magic, EZCA_TRACE_MAGIC, sizeof(fh.magic));
+	fh.order  = EZCA_TRACE_ORDER;
+	fh.nrings = nrings;
+	if ( 1 != fwrite(&fh, sizeof(fh), 1, f) )
+		rval = -1;
+
+	for ( r = rings; r && 0 == rval; r = r->next ) {
+		head = r->head;
+		from = head - r->tail > ringSize ? head - ringSize : r->tail;
+
+		for ( i = from; i != head; i++ )
+			buf[i - from] = r->recs[i & r->mask];
+		copied = from;
+
+		/* the thread may have kept recording while we copied;
+		 * drop what it overwrote, including the slot it may be
+		 * writing right now (the one 'ringSize' behind its head).
+		 */
+		i = r->head;
+		if ( i - from >= ringSize )
+			from = i - ringSize + 1 < head ? i - ringSize + 1 : head;
+
+		memset(&rh, 0, sizeof(rh));
+		strncpy(rh.thread, r->thread, sizeof(rh.thread) - 1);
+		rh.nrecs = (epicsUInt32) (head - from);
+		rh.lost  = (epicsUInt32) (from - r->tail);
+		if ( 1 != fwrite(&rh, sizeof(rh), 1, f) )
+			rval = -1;
+
+		if ( 0 == rval && head != from
+		     && head - from != fwrite(&buf[from - copied], sizeof(*buf), head - from, f) )
+			rval = -1;
+	}
+
+	epicsMutexUnlock(ringMtx);
+
+	free(buf);
+
+	if ( fclose(f) )
+		rval = -1;
+
+	return rval;
+} /* end ezcaTraceSave() */
+
+#else
+
+epicsShareFunc void epicsShareAPI
+ezcaTraceRecord(int event, const void *ptr, long a, long b)
+{
+} /* end ezcaTraceRecord() */
+
+epicsShareFunc int epicsShareAPI
+ezcaTraceStart(unsigned long nrecs)
+{
+	return -1;
+} /* end ezcaTraceStart() */
+
+epicsShareFunc void epicsShareAPI
+ezcaTraceStop(void)
+{
+} /* end ezcaTraceStop() */
+
+epicsShareFunc int epicsShareAPI
+ezcaTraceSave(const char *file)
+{
+	return -1;
+} /* end ezcaTraceSave() */
+
+#endif
@@ -0,0 +1,124 @@
+#ifndef EZCA_TRACE_H
+#define EZCA_TRACE_H
+
+/* Binary event tracer for ezca.
+ *
+ * Unlike ezcaTraceOn()/ezcaDebugOn(), which print text from inside
+ * the locked paths, the tracer stores fixed-size records in memory:
+ * every thread writes to a ring of its own, so recording an event
+ * takes no lock - just a clock read and a few stores. When a ring
+ * is full the oldest records are overwritten.
+ *
+ * ezcaTraceSave() writes all rings to a binary file which the
+ * ezcaTraceDump tool converts to text or to the JSON format of the
+ * Chrome trace viewer (chrome://tracing, ui.perfetto.dev).
+ *
+ * Saving while threads are still recording is allowed: records
+ * which a thread overwrote while they were being saved are dropped
+ * (and counted as lost). Stop the tracer first for a complete
+ * snapshot.
+ *
+ * The tracer needs EPICS 3.14 or later (ezcaTraceStart() fails on
+ * older versions).
+ */
+
+#include <epicsTypes.h>
+#include <shareLib.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* 'ptr' and the integers 'a' and 'b' of each event */
+typedef enum {
+	EZCA_EV_NONE = 0,
+	EZCA_EV_SEARCH,      /* chid;    a: CA status                 */
+	EZCA_EV_CONN_UP,     /* chid                                  */
+	EZCA_EV_CONN_DOWN,   /* chid                                  */
+	EZCA_EV_ISSUE_GET,   /* work;    a: DBR type,   b: count      */
+	EZCA_EV_ISSUE_PUT,   /* work;    a: DBR type,   b: count      */
+	EZCA_EV_CB_GET,      /* work;    a: CA status,  b: count      */
+	EZCA_EV_CB_PUT,      /* work;    a: CA status                 */
+	EZCA_EV_CB_MONITOR,  /* monitor; a: CA status,  b: count      */
+	EZCA_EV_WAIT_START,  /* event;   a: outstanding b: timeout ms */
+	EZCA_EV_WAIT_END,    /* event;   a: outstanding b: CA status  */
+	EZCA_EV_LOCK_WAIT,   /* mutex (about to be locked)            */
+	EZCA_EV_LOCK,        /* mutex (acquired)                      */
+	EZCA_EV_UNLOCK,      /* mutex (about to be released)          */
+	EZCA_EV_NEVENTS
+} EzcaTraceEvent;
+
+/* A record; the layout is the same in memory and in the file */
+typedef struct EzcaTraceRecRec_ {
+	epicsUInt32 sec;     /* epicsTimeStamp */
+	epicsUInt32 nsec;
+	epicsUInt16 event;
+	epicsUInt16 ring;    /* which thread recorded it */
+	epicsInt32  a;
+	epicsInt32  b;
+	epicsUInt32 ptr_lo;  /* pointer or chid */
+	epicsUInt32 ptr_hi;
+	epicsUInt32 pad;
+} EzcaTraceRecRec, *EzcaTraceRec;
+
+/* File layout (host byte order):
+ *   EzcaTraceFileHdrRec
+ *   nrings times: EzcaTraceRingHdrRec followed by 'nrecs' records,
+ *   oldest first.
+ */
+#define EZCA_TRACE_MAGIC     "EZCATRC1"
+#define EZCA_TRACE_ORDER     0x01020304
+#define EZCA_TRACE_NAME_SIZE 32
+
+typedef struct EzcaTraceFileHdrRec_ {
+	char        magic[8];
+	epicsUInt32 order;   /* EZCA_TRACE_ORDER as written by the host */
+	epicsUInt32 nrings;
+} EzcaTraceFileHdrRec;
+
+typedef struct EzcaTraceRingHdrRec_ {
+	char        thread[EZCA_TRACE_NAME_SIZE];
+	epicsUInt32 nrecs;
+	epicsUInt32 lost;    /* overwritten since the tracer was started */
+} EzcaTraceRingHdrRec;
+
+/* Start recording (clears what was recorded so far). Each thread
+ * gets a ring of 'nrecs' records (rounded up to a power of two;
+ * 0 selects a default) when it first records an event. The size
+ * is fixed by the first start; a later start asking for a different
+ * size (0 meaning the default) fails.
+ * Returns 0 on success, -1 if no memory, the size differs or not
+ * supported.
+ */
+epicsShareFunc int epicsShareAPI
+ezcaTraceStart(unsigned long nrecs);
+
+/* Stop recording; the records are kept */
+epicsShareFunc void epicsShareAPI
+ezcaTraceStop(void);
+
+/* Write the records to 'file'; returns 0 on success, -1 on error */
+epicsShareFunc int epicsShareAPI
+ezcaTraceSave(const char *file);
+
+/* Printable name of an event */
+epicsShareFunc const char * epicsShareAPI
+ezcaTraceEventName(int event);
+
+/* Record an event; use EZCA_TRACE() which is cheap while the tracer
+ * is off.
+ */
+epicsShareFunc void epicsShareAPI
+ezcaTraceRecord(int event, const void *ptr, long a, long b);
+
+/* for EZCA_TRACE() only */
+extern volatile int ezcaTraceActive;
+
+#define EZCA_TRACE(event, ptr, a, b) \
+	do { if ( ezcaTraceActive ) ezcaTraceRecord((event), (ptr), (long)(a), (long)(b)); } while (0)
+
+#ifdef __cplusplus
+};
+#endif
+
+#endif
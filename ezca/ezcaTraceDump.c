@@ -0,0 +1,160 @@
+/* Convert a trace saved by ezcaTraceSave() to text or to the JSON
+ * format of the Chrome trace viewer (chrome://tracing, ui.perfetto.dev).
+ *
+ * The records of all threads are merged in time order. Text lines
+ * show the time (seconds since the first record), thread, event,
+ * pointer (or chid) and the two integers (see ezcaTrace.h).
+ *
+ * In JSON, waits and lock waits/holds become duration events and
+ * everything else instant events; the pointer and the integers are
+ * passed as arguments.
+ *
+ * Usage: ezcaTraceDump [-j] trace_file
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ezcaTrace.h>
+
+static int
+cmprec(const void *a, const void *b)
+{
+const EzcaTraceRecRec *ra = a, *rb = b;
+
+	if ( ra->sec != rb->sec )
+		return ra->sec < rb->sec ? -1 : 1;
+	if ( ra->nsec != rb->nsec )
+		return ra->nsec < rb->nsec ? -1 : 1;
+	/* keep the order of a thread ('pad' holds the position in the file) */
+	return ra->pad < rb->pad ? -1 : (ra->pad > rb->pad ? 1 : 0);
+}
+
+static double
+since(const EzcaTraceRecRec *r, const EzcaTraceRecRec *t0)
+{
+	return (double)((long)r->sec - (long)t0->sec) + ((double)r->nsec - (double)t0->nsec) * 1.0e-9;
+}
+
+static void
+json_event(FILE *o, const EzcaTraceRecRec *r, const EzcaTraceRecRec *t0, const char *name, const char *ph, int *first)
+{
+	fprintf( o, "%s\n{\"name\":\"%s\",\"ph\":\"%s\",%s\"ts\":%.3f,\"pid\":1,\"tid\":%u,"
+	            "\"args\":{\"ptr\":\"0x%08lx%08lx\",\"a\":%ld,\"b\":%ld}}",
+		*first ? "" : ",",
+		name, ph, 'i' == *ph ? "\"s\":\"t\"," : "",
+		since( r, t0 ) * 1.0e6, (unsigned)r->ring,
+		(unsigned long)r->ptr_hi, (unsigned long)r->ptr_lo,
+		(long)r->a, (long)r->b );
+	*first = 0;
+}
+
+int main( int argc, char * argv[] )
+{
+FILE                *f, *o = stdout;
+EzcaTraceFileHdrRec  fh;
+EzcaTraceRingHdrRec *rings  = 0;
+EzcaTraceRecRec     *recs   = 0, *r;
+unsigned long        n = 0, i, k;
+int                  json = 0, first = 1;
+
+	if ( argc > 1 && 0 == strcmp( argv[1], "-j" ) ) {
+		json = 1;
+		argc--; argv++;
+	}
+
+	if ( argc != 2 ) {
+		fprintf( stderr, "Usage: ezcaTraceDump [-j] trace_file\n" );
+		return 1;
+	}
+
+	if ( ! (f = fopen( argv[1], "rb" )) ) {
+		perror( argv[1] );
+		return 1;
+	}
+
+	if ( 1 != fread( &fh, sizeof(fh), 1, f ) || memcmp( fh.magic, EZCA_TRACE_MAGIC, sizeof(fh.magic) ) ) {
+		fprintf( stderr, "%s: not an ezca trace file\n", argv[1] );
+		return 1;
+	}
+	if ( EZCA_TRACE_ORDER != fh.order ) {
+		fprintf( stderr, "%s: written by a host of different byte order\n", argv[1] );
+		return 1;
+	}
+
+	if ( fh.nrings && ! (rings = calloc( fh.nrings, sizeof(*rings) )) ) {
+		fprintf( stderr, "No memory\n" );
+		return 1;
+	}
+
+	for ( k = 0; k < fh.nrings; k++ ) {
+		if ( 1 != fread( &rings[k], sizeof(rings[k]), 1, f ) ) {
+			fprintf( stderr, "%s: truncated\n", argv[1] );
+			return 1;
+		}
+		rings[k].thread[sizeof(rings[k].thread) - 1] = 0;
+		if ( ! (r = realloc( recs, (n + rings[k].nrecs + 1) * sizeof(*recs) )) ) {
+			fprintf( stderr, "No memory\n" );
+			return 1;
+		}
+		recs = r;
+		if ( rings[k].nrecs != fread( recs + n, sizeof(*recs), rings[k].nrecs, f ) ) {
+			fprintf( stderr, "%s: truncated\n", argv[1] );
+			return 1;
+		}
+		/* records carry the id the ring had when recording; use the index */
+		for ( i = n; i < n + rings[k].nrecs; i++ ) {
+			recs[i].ring = (epicsUInt16) k;
+			recs[i].pad  = (epicsUInt32) i;
+		}
+		n += rings[k].nrecs;
+		if ( rings[k].lost )
+			fprintf( stderr, "Thread '%s': %lu records overwritten\n",
+				rings[k].thread, (unsigned long)rings[k].lost );
+	}
+	fclose( f );
+
+	if ( n )
+		qsort( recs, n, sizeof(*recs), cmprec );
+
+	if ( json ) {
+		fprintf( o, "{\"traceEvents\":[" );
+		for ( k = 0; k < fh.nrings; k++ ) {
+			fprintf( o, "%s\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%lu,\"args\":{\"name\":\"%s\"}}",
+				first ? "" : ",", k, rings[k].thread );
+			first = 0;
+		}
+	}
+
+	for ( i = 0; i < n; i++ ) {
+		r = &recs[i];
+		if ( ! json ) {
+			fprintf( o, "%14.9f %-16s %-10s 0x%08lx%08lx %11ld %11ld\n",
+				since( r, recs ),
+				r->ring < fh.nrings ? rings[r->ring].thread : "?",
+				ezcaTraceEventName( r->event ),
+				(unsigned long)r->ptr_hi, (unsigned long)r->ptr_lo,
+				(long)r->a, (long)r->b );
+			continue;
+		}
+		switch ( r->event ) {
+			case EZCA_EV_WAIT_START: json_event( o, r, recs, "wait",      "B", &first ); break;
+			case EZCA_EV_WAIT_END:   json_event( o, r, recs, "wait",      "E", &first ); break;
+			case EZCA_EV_LOCK_WAIT:  json_event( o, r, recs, "lock wait", "B", &first ); break;
+			case EZCA_EV_LOCK:
+				json_event( o, r, recs, "lock wait", "E", &first );
+				json_event( o, r, recs, "locked",    "B", &first );
+			break;
+			case EZCA_EV_UNLOCK:     json_event( o, r, recs, "locked",    "E", &first ); break;
+			default:
+				json_event( o, r, recs, ezcaTraceEventName( r->event ), "i", &first );
+			break;
+		}
+	}
+
+	if ( json )
+		fprintf( o, "\n]}\n" );
+
+	free( recs );
+	free( rings );
+	return 0;
+}
@@ -128,18 +128,44 @@ int	            n             = 0;
 double         *dptr;
 char            type          = ezcaNative;
 epicsTimeStamp *ts            = 0;
+MultiEzcaPVSet  set           = 0;
 LcaError       *theErr        = errCreate(sciclean);
 SciErr          sciErr;
+int            *pia           = 0;
+int             sciType;
 
 	CheckInputArgument(pvApiCtx,1,3);
 	CheckOutputArgument(pvApiCtx,0,2);
 
-	mpvs = -1; ntmp = 1;
-	pvs  = lcaGetApiStringMatrix(pvApiCtx, theErr, 1, &mpvs, &ntmp);
-	if ( ! pvs ) {
+	sciErr = getVarAddressFromPosition( pvApiCtx, 1, &pia );
+	if ( lcaCheckSciError(theErr, &sciErr) ) {
+		goto bail;
+	}
+	
+	sciErr = getVarType( pvApiCtx, pia, &sciType );
+	if ( lcaCheckSciError(theErr, &sciErr) ) {
 		goto bail;
 	}
-	SCICLEAN_SVAR(pvs);
+
+	if ( sci_strings != sciType ) {
+		/* a PV set ID */
+		mtmp = ntmp = 1;
+		if ( ! (dptr = lcaGetApiDblMatrix( pvApiCtx, theErr, 1, &mtmp, &ntmp )) ) {
+			goto bail;
+		}
+		if ( ! (set = multi_ezca_pvset_find( (int) round(*dptr) )) ) {
+			lcaSetError(theErr, EZCA_INVALIDARG, "Invalid PV set (use lcaNewPVSet)");
+			goto bail;
+		}
+		multi_ezca_pvset_names( set, &mpvs );
+	} else {
+		mpvs = -1; ntmp = 1;
+		pvs  = lcaGetApiStringMatrix(pvApiCtx, theErr, 1, &mpvs, &ntmp);
+		if ( ! pvs ) {
+			goto bail;
+		}
+		SCICLEAN_SVAR(pvs);
+	}
 
 	if ( Rhs > 1 ) {
 		mtmp = ntmp = 1;
@@ -160,7 +186,10 @@ SciErr          sciErr;
 	}
 
 	/* we can't preallocate the result matrix -- n is unknown at this point */
-	status = multi_ezca_get( pvs, &type, &buf, mpvs, &n, &ts, theErr );
+	if ( set )
+		status = multi_ezca_pvset_get( set, &type, &buf, &n, &ts, theErr );
+	else
+		status = multi_ezca_get( pvs, &type, &buf, mpvs, &n, &ts, theErr );
 
 	/* register cleanups for memory allocated by multi_ezca_get */
 	LCACLEAN(ts);
@@ -579,6 +608,110 @@ SciErr        sciErr;
  	return 0;
 }
 
+/* [units, precision, limits, enumStrings] = lcaGetMetadata(pvs)
+ * 'limits' is m x 8: graphic, control, warning and alarm limits
+ * (low/high each)
+ */
+int intsezcaGetMetadata(char *fname, PvApiCtxType pvApiCtx, Sciclean sciclean)
+{
+int              m,n,i,j,ij,status;
+char           **pvs MAY_ALIAS,**tmp;
+EzcaMetadataRec *mdbuf MAY_ALIAS = 0;
+MultiArgRec      args[1];
+LcaError        *theErr = errCreate(sciclean);
+SciErr           sciErr;
+short           *sptr;
+double          *dptr;
+
+	CheckInputArgument(pvApiCtx,1,1);
+	CheckOutputArgument(pvApiCtx,0,4);
+
+	m = -1;
+	n =  1;
+	if ( ! (pvs = lcaGetApiStringMatrix(pvApiCtx, theErr, 1, &m, &n)) ) {
+		return 0;
+	}
+	SCICLEAN_SVAR(pvs);
+
+	MSetArg(args[0], sizeof(*mdbuf), 0, &mdbuf);
+
+	status = multi_ezca_get_misc(pvs, m, (MultiEzcaFunc)ezcaGetMetadata, NumberOf(args), args, theErr);
+
+	/* if mdbuf was created register a cleanup */
+	LCACLEAN(mdbuf);
+
+	if ( ! status )
+		return 0;
+
+	/* scilab expects NULL terminated char** list */
+	n = EZCA_ENUM_STATES;
+	if ( ! (tmp = lcaMalloc(sizeof(char*) * (n*m+1))) )
+		return 0;
+	LCACLEAN(tmp); /* register cleanup; CreateVarFromPtr may fail and execute 'return 0' */
+
+	for ( i=0; i<m; i++ ) {
+		mdbuf[i].units[EZCA_UNITS_SIZE-1] = 0;
+		tmp[i] = mdbuf[i].units;
+	}
+	tmp[m] = 0;
+	sciErr = createMatrixOfString( pvApiCtx, nbInputArgument( pvApiCtx ) + 1, m, 1, (const char * const *)tmp );
+	if ( lcaCheckSciError(theErr, &sciErr) ) {
+		return 0;
+	}
+	AssignOutputVariable(pvApiCtx, 1) = nbInputArgument( pvApiCtx ) + 1;
+
+	if ( Lhs >= 2 ) {
+		sciErr = allocMatrixOfInteger16( pvApiCtx, nbInputArgument( pvApiCtx ) + 2, m, 1, &sptr );
+		if ( lcaCheckSciError(theErr, &sciErr) ) {
+			return 0;
+		}
+		for ( i=0; i<m; i++ )
+			sptr[i] = mdbuf[i].precision;
+		AssignOutputVariable(pvApiCtx, 2) = nbInputArgument( pvApiCtx ) + 2;
+	}
+
+	if ( Lhs >= 3 ) {
+		sciErr = allocMatrixOfDouble( pvApiCtx, nbInputArgument( pvApiCtx ) + 3, m, 8, &dptr );
+		if ( lcaCheckSciError(theErr, &sciErr) ) {
+			return 0;
+		}
+		/* column-major, one row per PV */
+		for ( i=0; i<m; i++ ) {
+			dptr[i + 0*m] = mdbuf[i].disp_lo;
+			dptr[i + 1*m] = mdbuf[i].disp_hi;
+			dptr[i + 2*m] = mdbuf[i].ctrl_lo;
+			dptr[i + 3*m] = mdbuf[i].ctrl_hi;
+			dptr[i + 4*m] = mdbuf[i].warn_lo;
+			dptr[i + 5*m] = mdbuf[i].warn_hi;
+			dptr[i + 6*m] = mdbuf[i].alarm_lo;
+			dptr[i + 7*m] = mdbuf[i].alarm_hi;
+		}
+		AssignOutputVariable(pvApiCtx, 3) = nbInputArgument( pvApiCtx ) + 3;
+	}
+
+	if ( Lhs >= 4 ) {
+		/* as lcaGetEnumStrings(); unused states are empty */
+		ij = 0;
+		for ( j=0; j<n; j++ ) {
+			for ( i=0; i<m; i++ ) {
+				if ( j < mdbuf[i].no_str )
+					mdbuf[i].strs[j][EZCA_ENUM_STRING_SIZE-1] = 0;
+				else
+					mdbuf[i].strs[j][0] = 0;
+				tmp[ij++] = mdbuf[i].strs[j];
+			}
+		}
+		tmp[ij] = 0;
+		sciErr = createMatrixOfString( pvApiCtx, nbInputArgument( pvApiCtx ) + 4, m, n, (const char * const *)tmp );
+		if ( lcaCheckSciError(theErr, &sciErr) ) {
+			return 0;
+		}
+		AssignOutputVariable(pvApiCtx, 4) = nbInputArgument( pvApiCtx ) + 4;
+	}
+
+ 	return 0;
+}
+
 
 int intsezcaGetRetryCount(char *fname, PvApiCtxType pvApiCtx, Sciclean sciclean)
 {
@@ -791,6 +924,57 @@ LcaError *theErr = errCreate(sciclean);
 	return 0;
 }
 
+int intsezcaNewPVSet(char *fname, PvApiCtxType pvApiCtx, Sciclean sciclean)
+{
+int       m,n,id,*iptr;
+char    **s MAY_ALIAS;
+SciErr    sciErr;
+LcaError *theErr = errCreate(sciclean);
+
+	CheckInputArgument(pvApiCtx,1,1);
+	CheckOutputArgument(pvApiCtx,0,1);
+
+	m = -1;
+	n =  1;
+	if ( ! (s = lcaGetApiStringMatrix(pvApiCtx, theErr, 1, &m, &n)) ) {
+		return 0;
+	}
+	SCICLEAN_SVAR(s);
+
+	if ( !(id = multi_ezca_pvset_create(s, m, theErr)) ) {
+		return 0;
+	}
+
+	n = 1;
+	sciErr = allocMatrixOfInteger32( pvApiCtx, nbInputArgument( pvApiCtx ) + 1, n, n, &iptr );
+	if ( lcaCheckSciError(theErr, &sciErr) ) {
+		multi_ezca_pvset_destroy(id, theErr);
+		return 0;
+	}
+	*iptr = id;
+	AssignOutputVariable(pvApiCtx, 1) = nbInputArgument( pvApiCtx ) + 1;
+	return 0;
+}
+
+int intsezcaClearPVSet(char *fname, PvApiCtxType pvApiCtx, Sciclean sciclean)
+{
+int       m,n;
+double   *dptr;
+LcaError *theErr = errCreate(sciclean);
+
+	CheckInputArgument(pvApiCtx,1,1);
+	CheckOutputArgument(pvApiCtx,0,1);
+
+	m = n = 1;
+	if ( ! (dptr = lcaGetApiDblMatrix( pvApiCtx, theErr, 1, &m, &n)) ) {
+		return 0;
+	}
+
+	multi_ezca_pvset_destroy((int)round(*dptr), theErr);
+	AssignOutputVariable(pvApiCtx, 1) = 0;
+	return 0;
+}
+
 int intsezcaSetSeverityWarnLevel(char *fname, PvApiCtxType pvApiCtx, Sciclean sciclean)
 {
 int       m,n;
@@ -811,13 +995,13 @@ LcaError *theErr = errCreate(sciclean);
 
 int intsezcaSetMonitor(char *fname, PvApiCtxType pvApiCtx, Sciclean sciclean)
 {
-int       mpvs, mtmp, ntmp, n = 0;
+int       mpvs, mtmp, ntmp, n = 0, depth = 0;
 double   *dptr;
 char    **pvs MAY_ALIAS;
 char      type  = ezcaNative;
 LcaError *theErr = errCreate(sciclean);
 
-	CheckInputArgument(pvApiCtx,1,3);
+	CheckInputArgument(pvApiCtx,1,4);
 	CheckOutputArgument(pvApiCtx,0,1);
 
 	mpvs = -1;
@@ -835,9 +1019,16 @@ LcaError *theErr = errCreate(sciclean);
 		n = (int)round(*dptr);
 		if ( Rhs > 2 && !arg2ezcaType(&type,3, theErr, pvApiCtx) )
 			goto cleanup;
+		if ( Rhs > 3 ) {
+			mtmp = ntmp = 1;
+			if ( ! (dptr = lcaGetApiDblMatrix( pvApiCtx, theErr, 4, &mtmp, &ntmp )) ) {
+				goto cleanup;
+			}
+			depth = (int)round(*dptr);
+		}
 	}
 
-	(void) multi_ezca_set_mon(pvs, mpvs, type, n, theErr);
+	(void) multi_ezca_set_mon(pvs, mpvs, type, n, depth, theErr);
 
 cleanup:
 	return 0;
@@ -903,3 +1094,368 @@ LcaError *theErr = errCreate(sciclean);
 cleanup:
 	return 0;
 }
+
+int intsezcaGetQueued(char *fname, PvApiCtxType pvApiCtx, Sciclean sciclean)
+{
+int             mpvs, mtmp, ntmp, k, itmp;
+double         *reptr = 0, *imptr = 0;
+char          **pvs MAY_ALIAS = 0;
+void           *buf MAY_ALIAS = 0;
+int	            n             = 0;
+double         *dptr;
+char            type          = ezcaNative;
+epicsTimeStamp *ts            = 0;
+unsigned long   dropped       = 0;
+double          ddropped;
+LcaError       *theErr        = errCreate(sciclean);
+SciErr          sciErr;
+
+	CheckInputArgument(pvApiCtx,1,3);
+	CheckOutputArgument(pvApiCtx,0,3);
+
+	mpvs = -1; ntmp = 1;
+	if ( ! (pvs = lcaGetApiStringMatrix(pvApiCtx, theErr, 1, &mpvs, &ntmp)) ) {
+		return 0;
+	}
+	SCICLEAN_SVAR(pvs);
+
+	if ( 1 != mpvs ) {
+		lcaSetError(theErr, EZCA_INVALIDARG, "Expected a single PV name");
+		goto bail;
+	}
+
+	if ( Rhs > 1 ) {
+		mtmp = ntmp = 1;
+		if ( ! (dptr = lcaGetApiDblMatrix( pvApiCtx, theErr, 2, &mtmp, &ntmp )) ) {
+			goto bail;
+		}
+		n = (int) round(*dptr);
+		if ( Rhs > 2 && !arg2ezcaType(&type,3, theErr, pvApiCtx) )
+			goto bail;
+	}
+
+	k = multi_ezca_get_queued( pvs[0], &type, &buf, &n, &ts, &dropped, theErr );
+
+	/* register cleanups for memory allocated by multi_ezca_get_queued */
+	LCACLEAN(ts);
+	if ( ezcaString == type ) {
+		LCACLEAN_SVAR(buf);
+	} else {
+		LCACLEAN(buf);
+	}
+
+	if ( k < 0 ) {
+		for ( itmp = 1; itmp <= Lhs; itmp++ ) {
+    		AssignOutputVariable(pvApiCtx, itmp) = 0;
+		}
+		goto bail;
+	}
+
+	/* one row per update */
+	if ( ezcaString == type && k > 0 ) {
+		sciErr = createMatrixOfString( pvApiCtx, nbInputArgument( pvApiCtx ) + 1, k, n, (const char * const *)buf );
+	} else {
+		sciErr = createMatrixOfDouble( pvApiCtx, nbInputArgument( pvApiCtx ) + 1, k, k > 0 ? n : 0, (double*)buf );
+	}
+	if ( lcaCheckSciError(theErr, &sciErr) ) {
+		goto bail;
+	}
+   	AssignOutputVariable(pvApiCtx, 1) = nbInputArgument( pvApiCtx ) + 1;
+
+	if ( Lhs >= 2 ) {
+		ntmp = 1;
+		sciErr = allocComplexMatrixOfDouble( pvApiCtx, nbInputArgument( pvApiCtx ) + 2, k, ntmp, &reptr, &imptr );
+		if ( lcaCheckSciError(theErr, &sciErr) ) {
+			goto bail;
+		}
+		multi_ezca_ts_cvt( k, ts, reptr, imptr );
+   		AssignOutputVariable(pvApiCtx, 2) = nbInputArgument( pvApiCtx ) + 2;
+	}
+
+	if ( Lhs >= 3 ) {
+		ddropped = (double)dropped;
+		sciErr = createMatrixOfDouble( pvApiCtx, nbInputArgument( pvApiCtx ) + 3, 1, 1, &ddropped );
+		if ( lcaCheckSciError(theErr, &sciErr) ) {
+			goto bail;
+		}
+   		AssignOutputVariable(pvApiCtx, 3) = nbInputArgument( pvApiCtx ) + 3;
+	}
+
+bail:
+	return 0;
+}
+
+int intsezcaGetAsync(char *fname, PvApiCtxType pvApiCtx, Sciclean sciclean)
+{
+int             mpvs, mtmp, ntmp, id, *iptr;
+char          **pvs MAY_ALIAS = 0;
+int	            n             = 0;
+double         *dptr;
+char            type          = ezcaNative;
+MultiEzcaPVSet  set           = 0;
+LcaError       *theErr        = errCreate(sciclean);
+SciErr          sciErr;
+int            *pia           = 0;
+int             sciType;
+
+	CheckInputArgument(pvApiCtx,1,3);
+	CheckOutputArgument(pvApiCtx,0,1);
+
+	sciErr = getVarAddressFromPosition( pvApiCtx, 1, &pia );
+	if ( lcaCheckSciError(theErr, &sciErr) ) {
+		return 0;
+	}
+	
+	sciErr = getVarType( pvApiCtx, pia, &sciType );
+	if ( lcaCheckSciError(theErr, &sciErr) ) {
+		return 0;
+	}
+
+	if ( sci_strings != sciType ) {
+		/* a PV set ID */
+		mtmp = ntmp = 1;
+		if ( ! (dptr = lcaGetApiDblMatrix( pvApiCtx, theErr, 1, &mtmp, &ntmp )) ) {
+			return 0;
+		}
+		if ( ! (set = multi_ezca_pvset_find( (int) round(*dptr) )) ) {
+			lcaSetError(theErr, EZCA_INVALIDARG, "Invalid PV set (use lcaNewPVSet)");
+			return 0;
+		}
+		pvs = multi_ezca_pvset_names( set, &mpvs );
+	} else {
+		mpvs = -1; ntmp = 1;
+		pvs  = lcaGetApiStringMatrix(pvApiCtx, theErr, 1, &mpvs, &ntmp);
+		if ( ! pvs ) {
+			return 0;
+		}
+		SCICLEAN_SVAR(pvs);
+	}
+
+	if ( Rhs > 1 ) {
+		mtmp = ntmp = 1;
+		if ( ! (dptr = lcaGetApiDblMatrix( pvApiCtx, theErr, 2, &mtmp, &ntmp )) ) {
+			return 0;
+		}
+		n = (int) round(*dptr);
+		if ( Rhs > 2 && !arg2ezcaType(&type,3, theErr, pvApiCtx) )
+			return 0;
+	}
+
+	if ( !(id = multi_ezca_get_async( pvs, &type, mpvs, n, theErr )) ) {
+		return 0;
+	}
+
+	ntmp = 1;
+	sciErr = allocMatrixOfInteger32( pvApiCtx, nbInputArgument( pvApiCtx ) + 1, ntmp, ntmp, &iptr );
+	if ( lcaCheckSciError(theErr, &sciErr) ) {
+		/* discard the request */
+		multi_ezca_fetch( id, &type, 0, &n, 0, 0 );
+		return 0;
+	}
+	*iptr = id;
+	AssignOutputVariable(pvApiCtx, 1) = nbInputArgument( pvApiCtx ) + 1;
+	return 0;
+}
+
+int intsezcaFetch(char *fname, PvApiCtxType pvApiCtx, Sciclean sciclean)
+{
+int             mpvs, mtmp, ntmp, itmp;
+double         *reptr = 0, *imptr = 0;
+void           *buf MAY_ALIAS = 0;
+int	            n             = 0;
+double         *dptr;
+char            type          = ezcaNative;
+epicsTimeStamp *ts            = 0;
+LcaError       *theErr        = errCreate(sciclean);
+SciErr          sciErr;
+
+	CheckInputArgument(pvApiCtx,1,1);
+	CheckOutputArgument(pvApiCtx,0,2);
+
+	mtmp = ntmp = 1;
+	if ( ! (dptr = lcaGetApiDblMatrix( pvApiCtx, theErr, 1, &mtmp, &ntmp )) ) {
+		return 0;
+	}
+
+	mpvs = multi_ezca_fetch( (int) round(*dptr), &type, &buf, &n, &ts, theErr );
+
+	/* register cleanups for memory allocated by multi_ezca_fetch */
+	LCACLEAN(ts);
+	if ( ezcaString == type ) {
+		LCACLEAN_SVAR(buf);
+	} else {
+		LCACLEAN(buf);
+	}
+
+	if ( !mpvs ) {
+		for ( itmp = 1; itmp <= Lhs; itmp++ ) {
+    		AssignOutputVariable(pvApiCtx, itmp) = 0;
+		}
+		goto bail;
+	}
+
+	if ( ezcaString == type ) {
+		sciErr = createMatrixOfString( pvApiCtx, nbInputArgument( pvApiCtx ) + 1, mpvs, n, (const char * const *)buf );
+	} else {
+		sciErr = createMatrixOfDouble( pvApiCtx, nbInputArgument( pvApiCtx ) + 1, mpvs, n, (double*)buf );
+	}
+	if ( lcaCheckSciError(theErr, &sciErr) ) {
+		goto bail;
+	}
+   	AssignOutputVariable(pvApiCtx, 1) = nbInputArgument( pvApiCtx ) + 1;
+
+	if ( Lhs >= 2 ) {
+		ntmp = 1;
+		sciErr = allocComplexMatrixOfDouble( pvApiCtx, nbInputArgument( pvApiCtx ) + 2, mpvs, ntmp, &reptr, &imptr );
+		if ( lcaCheckSciError(theErr, &sciErr) ) {
+			goto bail;
+		}
+		multi_ezca_ts_cvt( mpvs, ts, reptr, imptr );
+   		AssignOutputVariable(pvApiCtx, 2) = nbInputArgument( pvApiCtx ) + 2;
+	}
+
+bail:
+	return 0;
+}
+
+int intsezcaConnect(char *fname, PvApiCtxType pvApiCtx, Sciclean sciclean)
+{
+int mpvs, ntmp;
+char     **pvs MAY_ALIAS;
+LcaError *theErr = errCreate(sciclean);
+
+	CheckInputArgument(pvApiCtx,1,1);
+	CheckOutputArgument(pvApiCtx,0,1);
+
+	mpvs = -1; ntmp = 1;
+	if ( ! (pvs = lcaGetApiStringMatrix(pvApiCtx, theErr, 1, &mpvs, &ntmp)) ) {
+		return 0;
+	}
+	SCICLEAN_SVAR(pvs);
+
+	(void) multi_ezca_connect(pvs, mpvs, theErr);
+
+	AssignOutputVariable(pvApiCtx, 1) = 0;
+	return 0;
+}
+
+int intsezcaGetConnectionState(char *fname, PvApiCtxType pvApiCtx, Sciclean sciclean)
+{
+int mpvs, ntmp, *i;
+char     **pvs MAY_ALIAS;
+LcaError *theErr = errCreate(sciclean);
+SciErr    sciErr;
+
+	CheckInputArgument(pvApiCtx,1,1);
+	CheckOutputArgument(pvApiCtx,0,1);
+
+	mpvs = -1; ntmp = 1;
+	if ( ! (pvs = lcaGetApiStringMatrix(pvApiCtx, theErr, 1, &mpvs, &ntmp)) ) {
+		return 0;
+	}
+	SCICLEAN_SVAR(pvs);
+
+	ntmp = 1;
+	sciErr = allocMatrixOfInteger32( pvApiCtx, nbInputArgument( pvApiCtx ) + 1, mpvs, ntmp, &i );
+	if ( lcaCheckSciError(theErr, &sciErr) ) {
+		goto cleanup;
+	}
+
+	(void) multi_ezca_connection_state(pvs, mpvs, i, theErr);
+
+	AssignOutputVariable(pvApiCtx, 1) = nbInputArgument( pvApiCtx ) + 1;
+
+cleanup:
+	return 0;
+}
+
+int intsezcaGetStats(char *fname, PvApiCtxType pvApiCtx, Sciclean sciclean)
+{
+int mpvs, ntmp;
+char     **pvs MAY_ALIAS;
+double   *stats, *hist = 0;
+LcaError *theErr = errCreate(sciclean);
+SciErr    sciErr;
+
+	CheckInputArgument(pvApiCtx,1,1);
+	CheckOutputArgument(pvApiCtx,0,2);
+
+	mpvs = -1; ntmp = 1;
+	if ( ! (pvs = lcaGetApiStringMatrix(pvApiCtx, theErr, 1, &mpvs, &ntmp)) ) {
+		return 0;
+	}
+	SCICLEAN_SVAR(pvs);
+
+	ntmp = MULTI_EZCA_STATS_NCOLS;
+	sciErr = allocMatrixOfDouble( pvApiCtx, nbInputArgument( pvApiCtx ) + 1, mpvs, ntmp, &stats );
+	if ( lcaCheckSciError(theErr, &sciErr) ) {
+		goto cleanup;
+	}
+
+	if ( Lhs >= 2 ) {
+		ntmp = EZCA_STATS_NBINS;
+		sciErr = allocMatrixOfDouble( pvApiCtx, nbInputArgument( pvApiCtx ) + 2, mpvs, ntmp, &hist );
+		if ( lcaCheckSciError(theErr, &sciErr) ) {
+			goto cleanup;
+		}
+	}
+
+	(void) multi_ezca_get_stats(pvs, mpvs, stats, hist, theErr);
+
+	AssignOutputVariable(pvApiCtx, 1) = nbInputArgument( pvApiCtx ) + 1;
+	if ( Lhs >= 2 ) {
+		AssignOutputVariable(pvApiCtx, 2) = nbInputArgument( pvApiCtx ) + 2;
+	}
+
+cleanup:
+	return 0;
+}
+
+int intsezcaGetLockStats(char *fname, PvApiCtxType pvApiCtx, Sciclean sciclean)
+{
+int       m, n, on = -1;
+double   *dptr;
+double   *stats = 0;
+char    **sites MAY_ALIAS = 0;
+LcaError *theErr = errCreate(sciclean);
+SciErr    sciErr;
+
+	CheckInputArgument(pvApiCtx,0,1);
+	CheckOutputArgument(pvApiCtx,0,2);
+
+	if ( Rhs > 0 ) {
+		m = n = 1;
+		if ( ! (dptr = lcaGetApiDblMatrix( pvApiCtx, theErr, 1, &m, &n)) ) {
+			return 0;
+		}
+		on = 0. != *dptr;
+	}
+
+	m = multi_ezca_lock_stats( on, &stats, &sites, theErr );
+
+	LCACLEAN(stats);
+	LCACLEAN_SVAR(sites);
+
+	if ( m < 0 ) {
+		goto cleanup;
+	}
+
+	n = MULTI_EZCA_LOCK_STATS_NCOLS;
+	sciErr = createMatrixOfDouble( pvApiCtx, nbInputArgument( pvApiCtx ) + 1, m, m ? n : 0, stats );
+	if ( lcaCheckSciError(theErr, &sciErr) ) {
+		goto cleanup;
+	}
+	AssignOutputVariable(pvApiCtx, 1) = nbInputArgument( pvApiCtx ) + 1;
+
+	if ( Lhs >= 2 ) {
+		n = 1;
+		sciErr = createMatrixOfString( pvApiCtx, nbInputArgument( pvApiCtx ) + 2, m, m ? n : 0, (const char * const *)sites );
+		if ( lcaCheckSciError(theErr, &sciErr) ) {
+			goto cleanup;
+		}
+		AssignOutputVariable(pvApiCtx, 2) = nbInputArgument( pvApiCtx ) + 2;
+	}
+
+cleanup:
+	return 0;
+}
@@ -10,13 +10,15 @@
 #include <string.h>
 #include <stdarg.h>
 #include <stdio.h>
+#include <stdlib.h>
 
 #if BASE_IS_MIN_VERSION(3,14,7)
-#include <stdlib.h>
 #include <epicsExit.h>
 #endif
 
 #include <errlog.h>
+#include <epicsThread.h>
+#include <epicsEvent.h>
 
 #if defined(WIN32) || defined(_WIN32)
 typedef int pid_t;
@@ -79,11 +81,15 @@ private:
 	int         inFiniFlag;
 	int         isMccFlag;
 	const char *matlabVersionString;
+	char       *warmStart;       // LABCA_WARMSTART file (opt-in)
+	epicsEventId warmStartDone;  // background warm start finished
 
 	multiEzcaInitializer(const multiEzcaInitializer &);
 	multiEzcaInitializer &operator=(const multiEzcaInitializer &);
 
 	void msgPrintf(const char *fmt, ...);
+
+	static void warmStartThread(void *arg);
 	
 public:
 	multiEzcaInitializer();
@@ -245,6 +251,20 @@ int skipCaContextDestroy = 0;
 
 	// FIXME: proper ezca shutdown; move all of this to ezca...
 
+	if ( warmStart ) {
+		if ( warmStartDone ) {
+			// don't race with a warm start that is still loading
+			epicsEventWaitWithTimeout( warmStartDone, 5.0 );
+		}
+#if DEBUG_FINA > 1
+		msgPrintf((char*)"saving channel list to %s...\n", warmStart);
+#endif
+		ezcaSaveChannels( warmStart );
+	}
+
+	// stop evicting; the eviction thread must leave CA alone from now on
+	ezcaSetCachePolicy( 0, 0., 0. );
+
 #if DEBUG_FINA > 1
 	msgPrintf((char*)"clearing channels...\n");
 #endif
@@ -289,6 +309,7 @@ int skipCaContextDestroy = 0;
 #ifdef MATLAB_APP
 	::free((void*) matlabVersionString);
 #endif
+	::free( warmStart );
 
 #if DEBUG_FINA > 0
 	msgPrintf((char*)"Leaving labca finalizer\n");
@@ -299,7 +320,9 @@ multiEzcaInitializer::multiEzcaInitializer()
 : initDone           ( 0 ),
   inFiniFlag         ( 0 ),
   isMccFlag          ( 0 ),
-  matlabVersionString( 0 )
+  matlabVersionString( 0 ),
+  warmStart          ( 0 ),
+  warmStartDone      ( 0 )
 {
 #ifdef SCILAB_APP
 	initialize();
@@ -307,10 +330,29 @@ multiEzcaInitializer::multiEzcaInitializer()
 	/* under matlab initialize from mex-file context */
 }
 
+// Create the CA context (ezca's init) and queue the searches for the
+// channels of the previous session. The first labCA call waits for
+// the context but not for the channels; those it uses it waits for
+// as usual.
+void
+multiEzcaInitializer::warmStartThread(void *arg)
+{
+multiEzcaInitializer *me = (multiEzcaInitializer*)arg;
+
+	ezcaAutoErrorMessageOff(); /* calls ezca init() */
+	ezcaLoadChannels( me->warmStart );
+	epicsEventSignal( me->warmStartDone );
+}
+
 int
 multiEzcaInitializer::initialize()
 {
 CtrlCStateRec saved;
+const char   *ws;
+const char   *cs;
+unsigned long maxChannels = 0;
+float         maxIdle     = 0.;
+double        maxMonBytes = 0.;
 
 	if ( initDone )
 		return 1;
@@ -426,8 +468,42 @@ CtrlCStateRec saved;
 
 	multi_ezca_ctrlC_initialize();
 
+	/* opt-in: remember the channels of this session in a file
+	 * and search for them right away next time.
+	 */
+	if ( (ws = getenv("LABCA_WARMSTART")) && *ws ) {
+		warmStart = ::strdup( ws );
+	}
+
 	multi_ezca_ctrlC_prologue(&saved);
-	ezcaAutoErrorMessageOff(); /* calls ezca init() */
+	/* the thread (and the CA threads it creates) inherit
+	 * the signal mask set up by the prologue.
+	 */
+	if (    warmStart
+	     && (warmStartDone = epicsEventCreate( epicsEventEmpty ))
+	     && epicsThreadCreate( "labcaWarmStart", epicsThreadPriorityMedium,
+	                           epicsThreadGetStackSize( epicsThreadStackMedium ),
+	                           warmStartThread, this ) ) {
+		msgPrintf((char*)"Warm start from %s in the background\n", warmStart);
+	} else {
+		ezcaAutoErrorMessageOff(); /* calls ezca init() */
+		if ( warmStart ) {
+			ezcaLoadChannels( warmStart );
+		}
+		if ( warmStartDone ) {
+			epicsEventSignal( warmStartDone );
+		}
+	}
+	/* opt-in: evict channels which are no longer used;
+	 * LABCA_CACHE="maxChannels[,maxIdleSeconds[,maxMonitorBytes]]"
+	 * (0 is no limit). ezca's eviction thread inherits the mask, too.
+	 */
+	if ( (cs = getenv("LABCA_CACHE")) && *cs ) {
+		if ( sscanf( cs, "%lu,%f,%lf", &maxChannels, &maxIdle, &maxMonBytes ) < 1
+		     || EZCA_OK != ezcaSetCachePolicy( maxChannels, maxIdle, maxMonBytes ) ) {
+			msgPrintf((char*)"Ignoring invalid LABCA_CACHE '%s'\n", cs);
+		}
+	}
 	multi_ezca_ctrlC_epilogue(&saved);
 
 	/* MUST initialize errlog -- otherwise it is never initialized
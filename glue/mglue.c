@@ -19,14 +19,40 @@ releasePVs(PVs *pvs)
 {
 int i;
 	if ( pvs && pvs->names ) {
-		for ( i=0; i<pvs->m; i++ ) {
-			lcaFree(pvs->names[i]);
+		if ( !pvs->set ) {
+			for ( i=0; i<pvs->m; i++ ) {
+				lcaFree(pvs->names[i]);
+			}
+			lcaFree( pvs->names );
 		}
-		lcaFree( pvs->names );
 		multi_ezca_ctrlC_epilogue( &pvs->ctrlc );	
 	}
 }
 
+int epicsShareAPI
+buildPVsOrSet(const mxArray *pin, PVs *pvs, LcaError *pe)
+{
+int pm;
+
+	if ( !pvs || !pin || !mxIsNumeric(pin) )
+		return buildPVs(pin, pvs, pe);
+
+	pvs->names = 0;
+	pvs->m     = 0;
+	pvs->set   = 0;
+
+	/* a PV set already holds the converted names */
+	if ( 1 != mxGetM(pin) || 1 != mxGetN(pin)
+	     || !(pvs->set = multi_ezca_pvset_find( (int)mxGetScalar(pin) )) ) {
+		lcaSetError(pe, EZCA_INVALIDARG, "Invalid PV set (use lcaNewPVSet)");
+		return -1;
+	}
+	pvs->names = multi_ezca_pvset_names( pvs->set, &pm );
+	pvs->m     = pm;
+	multi_ezca_ctrlC_prologue(&pvs->ctrlc);
+	return 0;
+}
+
 int epicsShareAPI
 buildPVs(const mxArray *pin, PVs *pvs, LcaError *pe)
 {
@@ -40,6 +66,7 @@ int	rval = -1;
 
 	pvs->names = 0;
 	pvs->m     = 0;
+	pvs->set   = 0;
 
 	if ( !pin )
 		return -1;
@@ -115,6 +142,7 @@ lcaErrorIdGet(int err)
 		case EZCA_NOMONITOR:        return "labca:noMonitor";
 		case EZCA_NOCHANNEL:        return "labca:noChannel";
 		case EZCA_ABORTED:          return "labca:usrAbort";
+		case EZCA_NOTFOUND:         return "labca:pvNotFound";
 	}
 	return "labca:unkownError";
 }
@@ -11,11 +11,13 @@
 #include <lcaError.h>
 #include <cadef.h>
 #include <ezca.h>
+#include <multiEzca.h>
 
 typedef struct PVs_ {
 	CtrlCStateRec	ctrlc;
 	size_t    		m;
 	char 			**names;
+	MultiEzcaPVSet	set;	/* non-NULL if 'names' are owned by a PV set */
 } PVs;
 
 #include "shareLib.h"
@@ -27,9 +29,16 @@ extern "C" {
 epicsShareFunc void epicsShareAPI
 releasePVs(PVs *pvs);
 
+/* 'pin' is a cell array of PV names (or a single name) */
 epicsShareFunc int epicsShareAPI
 buildPVs(const mxArray *pin, PVs *pvs, LcaError *pe);
 
+/* same but 'pin' may also be the (numeric) ID of a PV set created
+ * by lcaNewPVSet; only for functions which document that.
+ */
+epicsShareFunc int epicsShareAPI
+buildPVsOrSet(const mxArray *pin, PVs *pvs, LcaError *pe);
+
 epicsShareFunc const char * epicsShareAPI
 lcaErrorIdGet(int err);
 
@@ -206,15 +206,44 @@ unsigned idx,i;
 	return 0;
 }
 
+/* fake handles are just the names */
+static int ezcaResolve(char *name, EzcaHandle *ph)
+{
+	*ph = (EzcaHandle)name;
+	return 0;
+}
+
+static int ezcaReleaseHandle(EzcaHandle h)
+{
+	return 0;
+}
+
+static int ezcaGetWithStatusH(EzcaHandle h, char type, int nelms, void *bufp, epicsTimeStamp *pts, short *st, short *se)
+{
+	return ezcaGetWithStatus((char*)h, type, nelms, bufp, pts, st, se);
+}
+
 #endif
 
-static int do_end_group(int *dims, int m, LcaError *pe)
+/* end the current group (pg, g and t NULL), end and prepare it (pg non-NULL),
+ * execute a prepared group (g non-NULL) or wait for an async group
+ * (t non-NULL) and collect the report.
+ */
+static int end_group(EzcaGroup *pg, EzcaGroup g, EzcaTicket t, int *dims, int m, LcaError *pe)
 {
 int nrcs,i;
 int rval = EZCA_OK;
 	if ( pe ) {
-		rval = ezcaEndGroupWithReport(&pe->errs, &nrcs);
-		assert(nrcs == m);
+		if ( pg )
+			rval = ezcaPrepareGroup(pg, &pe->errs, &nrcs);
+		else if ( g )
+			rval = ezcaExecuteGroup(g, &pe->errs, &nrcs);
+		else if ( t )
+			rval = ezcaGroupCollect(t, &pe->errs, &nrcs);
+		else
+			rval = ezcaEndGroupWithReport(&pe->errs, &nrcs);
+		/* prepare/execute may fail without producing a report */
+		assert(nrcs == m || (nrcs < 0 && !pe->errs));
 		if ( EZCA_OK != rval && dims ) {
 			for ( i=0; i<nrcs; i++ )
 				dims[i] = 0;
@@ -241,11 +270,23 @@ int rval = EZCA_OK;
 		if ( pe->errs )
 			pe->nerrs = m;
 	} else {
-		rval = ezcaEndGroup();
+		if ( pg )
+			rval = ezcaPrepareGroup(pg, 0, 0);
+		else if ( g )
+			rval = ezcaExecuteGroup(g, 0, 0);
+		else if ( t )
+			rval = ezcaGroupCollect(t, 0, 0);
+		else
+			rval = ezcaEndGroup();
 	}
 	return rval;
 }
 
+static int do_end_group(int *dims, int m, LcaError *pe)
+{
+	return end_group(0, 0, 0, dims, m, pe);
+}
+
 
 /* our 'strdup' implementation (*IMPORTANT*, in order for the matlab implementation using mxMalloc!!)
  * also, strdup is not POSIX...
@@ -567,44 +608,21 @@ cleanup:
 	return rval;
 }
 
-int epicsShareAPI
-multi_ezca_get(char **nms, char *type, void **pres, int m, int *pn, epicsTimeStamp **pts, LcaError *pe)
+/* find element counts and transfer types for a vector of PVs;
+ * on success all channels are connected, *pn holds the max.
+ * number of elements and *prowsize the size of a row buffer.
+ */
+static int
+get_layout(char **nms, int m, char *type, int nreq, int *dims, char *types, int *pn, int *prowsize, LcaError *pe)
 {
-void            *cbuf  = 0;
-void            *fbuf  = 0;
-int             *dims  = 0;
-short           *stat  = 0;
-short           *sevr  = 0;
-int             rval   = 0;
-char            *types = 0;
-int             mo     = m;
-int             rowsize,typesz,nreq,nstrings;
-epicsTimeStamp *ts    = 0;
-int             rc;
-
-register int  i,n = 0;
-register char *bufp;
-
-	nreq  = *pn;
-
-	*pn   = 0;
-	*pres = 0;
-	*pts  = 0;
-
-	/* get buffers; since we do asynchronous processing, we
-	 * need to buffer the full array - we cannot do it row-wise
-	 */
-	if ( !(dims = lcaCalloc( m , sizeof(*dims) )) || !(types = lcaMalloc( m * sizeof(*types) )) ) {
-		ezErr1( EZCA_FAILEDMALLOC, "multi_ezca_get: not enough memory", pe);
-		goto cleanup;
-	}
+int  typesz,nstrings,tmp;
+int  i,n;
 
 	if ( multi_ezca_get_nelem( nms, m, dims, pe ) )
-		goto cleanup;
+		return -1;
 
 	typesz = 0;
 	for ( nstrings=n=i=0; i<m; i++) {
-		int tmp;
 
 		/* clip to requested n */
 		if ( nreq > 0 && dims[i] > nreq )
@@ -627,37 +645,60 @@ register char *bufp;
 				"multi_ezca_get: type mismatch native 'string/enum' PVs cannot be\n"
 				"mixed with numericals -- use 'char' type to enforce conversion\n",
 				pe);
-			goto cleanup;
+			return -1;
 		} else {
 			*type = ezcaString;
 		}
 	}
 
-	rowsize = n * typesz;
+	*pn       = n;
+	*prowsize = n * typesz;
+	return 0;
+}
 
-	if ( !(cbuf = lcaMalloc( m * rowsize ))          ||
-		 !(stat = lcaCalloc( m,  sizeof(*stat)))     ||
-		 !(ts   = lcaMalloc( m * sizeof(epicsTimeStamp)))  ||
-		 !(sevr = lcaMalloc( m * sizeof(*sevr))) ) {
-		ezErr1( EZCA_FAILEDMALLOC, "multi_ezca_get: not enough memory", pe);
-		goto cleanup;
-	}
+/* read values along with status into the row buffer 'cbuf' by
+ * handle or, if 'hdls' is NULL, by name; if 'pg' is non-NULL the
+ * group is kept as a prepared group.
+ */
+static int
+get_group(char **nms, EzcaHandle *hdls, int m, char *types, int *dims, int rowsize, char *cbuf, epicsTimeStamp *ts, short *stat, short *sevr, EzcaGroup *pg, LcaError *pe)
+{
+int           rc;
+register int  i;
+register char *bufp;
 
-	/* get the values along with status */
 	ezcaStartGroup();
 		for ( i=0, bufp=cbuf; i<m; i++, bufp+=rowsize ) {
-			if ( (rc = ezcaGetWithStatus(nms[i],types[i],dims[i], bufp,ts + i,stat+i,sevr+i)) ) {
+			if ( hdls )
+				rc = ezcaGetWithStatusH(hdls[i],types[i],dims[i], bufp,ts + i,stat+i,sevr+i);
+			else
+				rc = ezcaGetWithStatus(nms[i],types[i],dims[i], bufp,ts + i,stat+i,sevr+i);
+			if ( rc ) {
 				ezErr(rc, "multi_ezca_get - ", pe);
-				goto cleanup;
+				return -1;
 			}
 		}
 
-	if ( EZCA_OK != (rc = do_end_group(dims, m, pe)) ) {
+	if ( EZCA_OK != (rc = end_group(pg, 0, 0, dims, m, pe)) ) {
 		ezErr(rc, "multi_ezca_get - ", pe);
 #ifndef SILENT_AND_PROGRESS
-		goto cleanup;
+		return -1;
 #endif
 	}
+	return 0;
+}
+
+/* check severities and transpose/convert the row buffer into
+ * a freshly allocated result matrix (NULL on error)
+ */
+static void *
+get_convert(char **nms, int m, char type, char *types, int *dims, int n, int rowsize, char *cbuf, short *stat, short *sevr, LcaError *pe)
+{
+void          *fbuf  = 0;
+int           mo     = m;
+
+register int  i;
+register char *bufp;
 
 	for ( i=0; i<m; i++ ) {
 		char *dotp;
@@ -672,7 +713,7 @@ register char *bufp;
 	}
 
 	/* allocate the target buffer */
-	if ( ezcaString == *type )
+	if ( ezcaString == type )
 		/* Scilab expects NULL terminated char** list */
 		fbuf = lcaCalloc( m*n+1, sizeof(char*) );
 	else
@@ -680,7 +721,7 @@ register char *bufp;
 
 	if ( !fbuf ) {
 		ezErr1( EZCA_FAILEDMALLOC, "multi_ezca_get: not enough memory", pe);
-		goto cleanup;
+		return 0;
 	}
 
 	/* transpose and convert */
@@ -737,18 +778,72 @@ register char *bufp;
 	dims[i] = j;
 	}
 
-	*pres = fbuf; fbuf  = 0;
-	*pts = ts; ts = 0;
-
-	*pn   = n;
-	rval  = m;
+	return fbuf;
 
 cleanup:
-	if ( fbuf && ezcaString == *type ) {
+	if ( ezcaString == type ) {
 		for ( i=0; i<n*m; i++)
 			lcaFree(((char**)fbuf)[i]);
 	}
 	lcaFree(fbuf);
+	return 0;
+}
+
+int epicsShareAPI
+multi_ezca_get(char **nms, char *type, void **pres, int m, int *pn, epicsTimeStamp **pts, LcaError *pe)
+{
+void            *cbuf  = 0;
+int             *dims  = 0;
+short           *stat  = 0;
+short           *sevr  = 0;
+int             rval   = 0;
+char            *types = 0;
+int             rowsize,nreq;
+epicsTimeStamp *ts    = 0;
+
+int           n = 0;
+
+	nreq  = *pn;
+
+	*pn   = 0;
+	*pres = 0;
+	*pts  = 0;
+
+	/* get buffers; since we do asynchronous processing, we
+	 * need to buffer the full array - we cannot do it row-wise
+	 */
+	if ( !(dims = lcaCalloc( m , sizeof(*dims) )) || !(types = lcaMalloc( m * sizeof(*types) )) ) {
+		ezErr1( EZCA_FAILEDMALLOC, "multi_ezca_get: not enough memory", pe);
+		goto cleanup;
+	}
+
+	if ( get_layout( nms, m, type, nreq, dims, types, &n, &rowsize, pe ) )
+		goto cleanup;
+
+	/* a one-off read goes by name; resolving handles would cost
+	 * as many lookups as it saves (PV sets keep theirs, see below)
+	 */
+	if ( !(cbuf = lcaMalloc( m * rowsize ))          ||
+		 !(stat = lcaCalloc( m,  sizeof(*stat)))     ||
+		 !(ts   = lcaMalloc( m * sizeof(epicsTimeStamp)))  ||
+		 !(sevr = lcaMalloc( m * sizeof(*sevr))) ) {
+		ezErr1( EZCA_FAILEDMALLOC, "multi_ezca_get: not enough memory", pe);
+		goto cleanup;
+	}
+
+	/* get the values along with status */
+	if ( get_group( nms, 0, m, types, dims, rowsize, cbuf, ts, stat, sevr, 0, pe ) )
+		goto cleanup;
+
+	if ( !(*pres = get_convert( nms, m, *type, types, dims, n, rowsize, cbuf, stat, sevr, pe )) )
+		goto cleanup;
+
+	*pts = ts; ts = 0;
+
+	*pn   = n;
+	rval  = m;
+
+cleanup:
 	lcaFree(cbuf);
 	lcaFree(dims);
 	lcaFree(types);
@@ -758,6 +853,407 @@ cleanup:
 	return rval;
 }
 
+/* PV sets keep everything multi_ezca_get() computes for a list of
+ * names (handles, element counts, types, buffers and a prepared
+ * group) so that subsequent reads merely execute the group.
+ *
+ * NOTE: a set lives across calls; its memory must not come from
+ *       lcaMalloc() (= mxMalloc() under matlab which is released
+ *       when the mex function returns).
+ */
+struct MultiEzcaPVSetRec_ {
+	int             m;
+	char            **names;
+	EzcaHandle      *hdls;
+	int             nhdls;
+	EzcaGroup       grp;      /* NULL if the layout must be (re)computed */
+	EzcaTicket      ticket;   /* async read in flight (see multi_ezca_get_async()) */
+	char            rtype;    /* type and count requested when 'grp' was built */
+	int             rn;
+	char            type;     /* resulting type */
+	int             n;
+	int             rowsize;
+	int             *dims;
+	char            *types;
+	int             *nelem;   /* native counts when the layout was made */
+	char            *cbuf;
+	short           *stat;
+	short           *sevr;
+	epicsTimeStamp  *ts;
+};
+
+static MultiEzcaPVSet *pvsets  = 0;
+static int             npvsets = 0;
+
+/* async reads are PV sets of their own (with separate IDs) */
+static MultiEzcaPVSet *asyncs  = 0;
+static int             nasyncs = 0;
+
+/* forget the layout and the group (but keep the handles) */
+static void
+pvset_flush(MultiEzcaPVSet s)
+{
+	if ( s->grp )
+		ezcaFreeGroup( s->grp );
+	s->grp = 0;
+	free( s->dims );  s->dims  = 0;
+	free( s->types ); s->types = 0;
+	free( s->nelem ); s->nelem = 0;
+	free( s->cbuf );  s->cbuf  = 0;
+	free( s->stat );  s->stat  = 0;
+	free( s->sevr );  s->sevr  = 0;
+	free( s->ts );    s->ts    = 0;
+}
+
+static void
+pvset_free(MultiEzcaPVSet s)
+{
+int i;
+	/* CA may still write to the buffers */
+	if ( s->ticket )
+		ezcaGroupCollect( s->ticket, 0, 0 );
+	pvset_flush( s );
+	for ( i=0; i<s->nhdls; i++ )
+		ezcaReleaseHandle( s->hdls[i] );
+	free( s->hdls );
+	if ( s->names ) {
+		for ( i=0; i<s->m; i++ )
+			free( s->names[i] );
+		free( s->names );
+	}
+	free( s );
+}
+
+static int
+pvset_layout(MultiEzcaPVSet s, char *type, int nreq, LcaError *pe)
+{
+int rc;
+int m = s->m;
+
+	pvset_flush( s );
+
+	if ( !(s->dims  = calloc( m, sizeof(*s->dims) )) ||
+	     !(s->types = malloc( m * sizeof(*s->types) )) ||
+	     !(s->nelem = malloc( m * sizeof(*s->nelem) )) ) {
+		ezErr1( EZCA_FAILEDMALLOC, "multi_ezca_get: not enough memory", pe);
+		return -1;
+	}
+
+	if ( get_layout( s->names, m, type, nreq, s->dims, s->types, &s->n, &s->rowsize, pe ) )
+		return -1;
+
+	s->type = *type;
+
+	/* handles survive a change of the layout */
+	for ( ; s->nhdls<m; s->nhdls++ ) {
+		if ( (rc = ezcaResolve(s->names[s->nhdls], s->hdls + s->nhdls)) ) {
+			ezErr(rc, "multi_ezca_get - ", pe);
+			return -1;
+		}
+	}
+
+	/* remembered to notice a reconnection with a different count */
+	ezcaElementCountH( s->hdls, m, s->nelem );
+
+	if ( !(s->cbuf = malloc( m * s->rowsize + 1 ))   ||
+		 !(s->stat = calloc( m,  sizeof(*s->stat)))  ||
+		 !(s->ts   = malloc( m * sizeof(*s->ts)))    ||
+		 !(s->sevr = malloc( m * sizeof(*s->sevr))) ) {
+		ezErr1( EZCA_FAILEDMALLOC, "multi_ezca_get: not enough memory", pe);
+		return -1;
+	}
+	return 0;
+}
+
+/* nonzero if a channel came back with a different element count */
+static int
+pvset_stale(MultiEzcaPVSet s)
+{
+int *nelem;
+int  i, rval = 0;
+
+	if ( !(nelem = lcaMalloc( s->m * sizeof(*nelem) )) )
+		return 1;
+
+	ezcaElementCountH( s->hdls, s->m, nelem );
+
+	/* disconnected ones fail the read anyway */
+	for ( i=0; i<s->m && !rval; i++ )
+		rval = nelem[i] >= 0 && nelem[i] != s->nelem[i];
+
+	lcaFree( nelem );
+	return rval;
+}
+
+/* a set holding a copy of the names; NULL if there is no memory */
+static MultiEzcaPVSet
+pvset_new(char **nms, int m)
+{
+MultiEzcaPVSet s = 0;
+int            i;
+
+	if ( !(s = calloc( 1, sizeof(*s) ))                   ||
+	     !(s->names = calloc( m, sizeof(*s->names) ))     ||
+	     !(s->hdls  = calloc( m, sizeof(*s->hdls) )) ) {
+		goto nomem;
+	}
+	s->m = m;
+
+	for ( i=0; i<m; i++ ) {
+		if ( !(s->names[i] = malloc( strlen(nms[i]) + 1 )) )
+			goto nomem;
+		strcpy( s->names[i], nms[i] );
+	}
+	return s;
+
+nomem:
+	if ( s )
+		pvset_free( s );
+	return 0;
+}
+
+/* enter 's' into a table of sets; returns its ID or 0 if there is no memory */
+static int
+pvset_enter(MultiEzcaPVSet **ptab, int *pn, MultiEzcaPVSet s)
+{
+MultiEzcaPVSet *tmp;
+int            i;
+
+	for ( i=0; i<*pn && (*ptab)[i]; i++ )
+		;
+	if ( i == *pn ) {
+		if ( !(tmp = realloc( *ptab, (*pn + 16) * sizeof(*tmp) )) )
+			return 0;
+		memset( tmp + *pn, 0, 16 * sizeof(*tmp) );
+		*ptab  = tmp;
+		*pn   += 16;
+	}
+	(*ptab)[i] = s;
+
+	/* IDs start at 1 */
+	return i + 1;
+}
+
+int epicsShareAPI
+multi_ezca_pvset_create(char **nms, int m, LcaError *pe)
+{
+MultiEzcaPVSet s = 0;
+int            id;
+
+	if ( m < 1 ) {
+		ezErr1( EZCA_INVALIDARG, "multi_ezca_pvset_create: need at least one PV", pe);
+		return 0;
+	}
+
+	if ( !(s = pvset_new( nms, m )) || !(id = pvset_enter( &pvsets, &npvsets, s )) ) {
+		ezErr1( EZCA_FAILEDMALLOC, "multi_ezca_pvset_create: not enough memory", pe);
+		if ( s )
+			pvset_free( s );
+		return 0;
+	}
+
+	return id;
+}
+
+MultiEzcaPVSet epicsShareAPI
+multi_ezca_pvset_find(int id)
+{
+	return ( id > 0 && id <= npvsets ) ? pvsets[id - 1] : 0;
+}
+
+char ** epicsShareAPI
+multi_ezca_pvset_names(MultiEzcaPVSet s, int *pm)
+{
+	*pm = s->m;
+	return s->names;
+}
+
+int epicsShareAPI
+multi_ezca_pvset_destroy(int id, LcaError *pe)
+{
+int i;
+
+	if ( id < 0 ) {
+		for ( i=0; i<npvsets; i++ ) {
+			if ( pvsets[i] ) {
+				pvset_free( pvsets[i] );
+				pvsets[i] = 0;
+			}
+		}
+		return 0;
+	}
+
+	if ( !multi_ezca_pvset_find( id ) ) {
+		ezErr1( EZCA_INVALIDARG, "multi_ezca_pvset_destroy: invalid PV set", pe);
+		return -1;
+	}
+	pvset_free( pvsets[id - 1] );
+	pvsets[id - 1] = 0;
+	return 0;
+}
+
+int epicsShareAPI
+multi_ezca_pvset_get(MultiEzcaPVSet s, char *type, void **pres, int *pn, epicsTimeStamp **pts, LcaError *pe)
+{
+int             *dims  = 0;
+epicsTimeStamp *ts    = 0;
+int             rval   = 0;
+int             nreq,rc;
+char            rtype  = *type;
+int             m      = s->m;
+
+	nreq  = *pn;
+
+	*pn   = 0;
+	*pres = 0;
+	*pts  = 0;
+
+	if ( !s->grp || s->rtype != rtype || s->rn != nreq || pvset_stale( s ) ) {
+		if ( pvset_layout( s, type, nreq, pe ) )
+			goto cleanup;
+	} else {
+		*type = s->type;
+	}
+
+	/* the report may clobber the element counts; work on a copy */
+	if ( !(dims = lcaMalloc( m * sizeof(*dims) )) ||
+	     !(ts   = lcaMalloc( m * sizeof(*ts) )) ) {
+		ezErr1( EZCA_FAILEDMALLOC, "multi_ezca_get: not enough memory", pe);
+		goto cleanup;
+	}
+	memcpy( dims, s->dims, m * sizeof(*dims) );
+
+	if ( s->grp ) {
+		if ( EZCA_OK != (rc = end_group( 0, s->grp, 0, dims, m, pe )) ) {
+			ezErr(rc, "multi_ezca_get - ", pe);
+#ifndef SILENT_AND_PROGRESS
+			goto cleanup;
+#endif
+		}
+	} else {
+		if ( get_group( 0, s->hdls, m, s->types, dims, s->rowsize, s->cbuf, s->ts, s->stat, s->sevr, &s->grp, pe ) )
+			goto cleanup;
+		s->rtype = rtype;
+		s->rn    = nreq;
+	}
+
+	if ( !(*pres = get_convert( s->names, m, s->type, s->types, dims, s->n, s->rowsize, s->cbuf, s->stat, s->sevr, pe )) )
+		goto cleanup;
+
+	memcpy( ts, s->ts, m * sizeof(*ts) );
+	*pts = ts; ts = 0;
+
+	*pn   = s->n;
+	rval  = m;
+
+cleanup:
+	lcaFree(dims);
+	lcaFree(ts);
+	return rval;
+}
+
+int epicsShareAPI
+multi_ezca_get_async(char **nms, char *type, int m, int n, LcaError *pe)
+{
+MultiEzcaPVSet s;
+int            i, rc, id;
+char           *bufp;
+
+	if ( m < 1 ) {
+		ezErr1( EZCA_INVALIDARG, "multi_ezca_get_async: need at least one PV", pe);
+		return 0;
+	}
+
+	if ( !(s = pvset_new( nms, m )) ) {
+		ezErr1( EZCA_FAILEDMALLOC, "multi_ezca_get_async: not enough memory", pe);
+		return 0;
+	}
+
+	/* connecting and finding the element counts is still synchronous */
+	if ( pvset_layout( s, type, n, pe ) )
+		goto bail;
+
+	ezcaStartGroup();
+		for ( i=0, bufp=s->cbuf; i<m; i++, bufp+=s->rowsize ) {
+			if ( (rc = ezcaGetWithStatusH(s->hdls[i],s->types[i],s->dims[i], bufp,s->ts + i,s->stat+i,s->sevr+i)) ) {
+				ezErr(rc, "multi_ezca_get_async - ", pe);
+				goto bail;
+			}
+		}
+
+	if ( EZCA_OK != (rc = ezcaEndGroupAsync( &s->ticket )) ) {
+		ezErr(rc, "multi_ezca_get_async - ", pe);
+		goto bail;
+	}
+
+	if ( !(id = pvset_enter( &asyncs, &nasyncs, s )) ) {
+		ezErr1( EZCA_FAILEDMALLOC, "multi_ezca_get_async: not enough memory", pe);
+		goto bail;
+	}
+
+	return id;
+
+bail:
+	pvset_free( s );
+	return 0;
+}
+
+int epicsShareAPI
+multi_ezca_fetch(int id, char *type, void **pres, int *pn, epicsTimeStamp **pts, LcaError *pe)
+{
+MultiEzcaPVSet  s;
+epicsTimeStamp *ts    = 0;
+int             rval   = 0;
+int             rc,m;
+
+	if ( !(s = ( id > 0 && id <= nasyncs ) ? asyncs[id - 1] : 0) ) {
+		ezErr1( EZCA_INVALIDARG, "multi_ezca_fetch: invalid (already fetched?) request", pe);
+		return 0;
+	}
+	asyncs[id - 1] = 0;
+
+	if ( !pres ) {
+		/* just discard the request */
+		pvset_free( s );
+		return 0;
+	}
+
+	*pn   = 0;
+	*pres = 0;
+	*pts  = 0;
+
+	m = s->m;
+
+	rc        = end_group( 0, 0, s->ticket, s->dims, m, pe );
+	s->ticket = 0;
+	if ( EZCA_OK != rc ) {
+		ezErr(rc, "multi_ezca_get - ", pe);
+#ifndef SILENT_AND_PROGRESS
+		goto cleanup;
+#endif
+	}
+
+	if ( !(ts = lcaMalloc( m * sizeof(*ts) )) ) {
+		ezErr1( EZCA_FAILEDMALLOC, "multi_ezca_fetch: not enough memory", pe);
+		goto cleanup;
+	}
+
+	if ( !(*pres = get_convert( s->names, m, s->type, s->types, s->dims, s->n, s->rowsize, s->cbuf, s->stat, s->sevr, pe )) )
+		goto cleanup;
+
+	memcpy( ts, s->ts, m * sizeof(*ts) );
+	*pts = ts; ts = 0;
+
+	*type = s->type;
+	*pn   = s->n;
+	rval  = m;
+
+cleanup:
+	lcaFree(ts);
+	pvset_free( s );
+	return rval;
+}
+
 int epicsShareAPI
 multi_ezca_get_misc(char **nms, int m, MultiEzcaFunc ezcaProc, int nargs, MultiArg args, LcaError *pe)
 {
@@ -896,7 +1392,7 @@ cleanup:
 }
 
 int epicsShareAPI
-multi_ezca_set_mon(char **nms,  int m, int type, int clip, LcaError *pe)
+multi_ezca_set_mon(char **nms,  int m, int type, int clip, int depth, LcaError *pe)
 {
 char *types = 0;
 int  *dims  = 0;
@@ -922,7 +1418,9 @@ int  rval = -1;
 			if ( -1 == types[i] ) {
 				ezErr(EZCA_NOTCONNECTED, "multi_ezca_set_monitor - channel not connected", pe);
 				rval = -1;
-			} else if ( (rc = ezcaSetMonitor(nms[i], types[i], dims[i])) ) {
+			} else if ( (rc = depth > 0 ?
+			                  ezcaSetMonitorQueued(nms[i], types[i], dims[i], depth) :
+			                  ezcaSetMonitor(nms[i], types[i], dims[i])) ) {
 				rval = -1;
 				ezErr(rc, "multi_ezca_set_monitor - ", pe);
 			}
@@ -938,6 +1436,93 @@ cleanup:
 	return rval;
 }
 
+int epicsShareAPI
+multi_ezca_get_queued(char *nm, char *type, void **pres, int *pn, epicsTimeStamp **pts, unsigned long *pdropped, LcaError *pe)
+{
+char            *types = 0;
+char            **nms  = 0;
+void            *cbuf  = 0;
+int             *dims  = 0;
+short           *stat  = 0;
+short           *sevr  = 0;
+epicsTimeStamp  *ts    = 0;
+int             nreq, n, k, i, rc;
+int             rowsize;
+int             rval   = -1;
+
+	nreq  = *pn;
+
+	*pn   = 0;
+	*pres = 0;
+	*pts  = 0;
+	*pdropped = 0;
+
+	if ( !(types = getTypes(&nm, 1, *type)) ) {
+		ezErr1(EZCA_FAILEDMALLOC, "multi_ezca_get_queued: not enough memory", pe);
+		goto cleanup;
+	}
+	if ( ezcaNative == types[0] ) {
+		ezErr1(EZCA_NOTCONNECTED, "multi_ezca_get_queued: channel not connected", pe);
+		goto cleanup;
+	}
+
+	if ( (k = ezcaGetQueuedCount(nm, types[0])) < 0 ) {
+		ezErr1(EZCA_NOMONITOR, "multi_ezca_get_queued: no queued monitor set (use lcaSetMonitor with a queue depth)", pe);
+		goto cleanup;
+	}
+
+	if ( multi_ezca_get_nelem( &nm, 1, &n, pe ) )
+		goto cleanup;
+
+	if ( nreq > 0 && n > nreq )
+		n = nreq;
+
+	rowsize = n * typesize(types[0]);
+
+	/* NOTE: more updates may arrive meanwhile; they are left in the queue */
+	if ( k > 0 ) {
+		if ( !(cbuf = lcaMalloc( k * rowsize ))                   ||
+			 !(dims = lcaMalloc( k * sizeof(*dims) ))             ||
+			 !(stat = lcaMalloc( k * sizeof(*stat) ))             ||
+			 !(sevr = lcaMalloc( k * sizeof(*sevr) ))             ||
+			 !(ts   = lcaMalloc( k * sizeof(epicsTimeStamp) ))    ||
+			 !(nms  = lcaMalloc( k * sizeof(*nms) )) ) {
+			ezErr1(EZCA_FAILEDMALLOC, "multi_ezca_get_queued: not enough memory", pe);
+			goto cleanup;
+		}
+	}
+
+	if ( (rc = ezcaGetQueued(nm, types[0], n, k, cbuf, dims, ts, stat, sevr, &k, pdropped)) ) {
+		ezErr(rc, "multi_ezca_get_queued - ", pe);
+		goto cleanup;
+	}
+
+	if ( ezcaString == types[0] )
+		*type = ezcaString;
+
+	if ( k > 0 ) {
+		/* every row comes from the same PV */
+		for ( i=0; i<k; i++ )
+			nms[i] = nm;
+		if ( !(*pres = get_convert( nms, k, *type, types, dims, n, rowsize, cbuf, stat, sevr, pe )) )
+			goto cleanup;
+	}
+
+	*pts = ts; ts = 0;
+	*pn  = n;
+	rval = k;
+
+cleanup:
+	lcaFree( types );
+	lcaFree( nms );
+	lcaFree( cbuf );
+	lcaFree( dims );
+	lcaFree( stat );
+	lcaFree( sevr );
+	lcaFree( ts );
+	return rval;
+}
+
 int epicsShareAPI
 multi_ezca_check_mon(char **nms, int m, int type, int *val, LcaError *pe)
 {
@@ -1032,6 +1617,9 @@ multi_ezca_clear_channels(char **nms, int m, LcaError *pe)
 int rval = EZCA_OK, i, r = EZCA_OK;
 
 	if ( !nms ) {
+		/* PV sets hold on to their channels */
+		if ( m < 0 )
+			multi_ezca_pvset_destroy( -1, pe );
 		if ( (rval = ezcaPurge( m<0 ? 0 : 1 )) )
 			ezErr(rval, "multi_ezca_clear_channels - ", pe);
 	} else {
@@ -1048,6 +1636,134 @@ int rval = EZCA_OK, i, r = EZCA_OK;
 	return rval;
 }
 
+int epicsShareAPI
+multi_ezca_connect(char **nms, int m, LcaError *pe)
+{
+int rval;
+
+	if ( (rval = ezcaConnectMany(nms, m)) )
+		ezErr(rval, "multi_ezca_connect - ", pe);
+
+	return rval;
+}
+
+int epicsShareAPI
+multi_ezca_connection_state(char **nms, int m, int *states, LcaError *pe)
+{
+int rval;
+
+	if ( (rval = ezcaConnectionState(nms, m, states)) < 0 )
+		ezErr1(EZCA_INVALIDARG, "multi_ezca_connection_state: invalid argument", pe);
+
+	return rval;
+}
+
+/* negative times mean 'never' */
+#define STATS_TIME(t) ( (t) < 0. ? DBL_NAN : (t) )
+
+int epicsShareAPI
+multi_ezca_get_stats(char **nms, int m, double *stats, double *hist, LcaError *pe)
+{
+EzcaStatsRec *s;
+int           rval, i, j;
+
+	if ( !(s = malloc( (m > 0 ? m : 1) * sizeof(*s) )) ) {
+		ezErr1( EZCA_FAILEDMALLOC, "multi_ezca_get_stats: not enough memory", pe );
+		return -1;
+	}
+
+	if ( (rval = ezcaGetStats(nms, m, s)) < 0 ) {
+		ezErr1(EZCA_INVALIDARG, "multi_ezca_get_stats: invalid argument", pe);
+	} else {
+		/* column-major, one row per PV */
+		for ( i=0; i<m; i++ ) {
+			stats[i +  0*m] = STATS_TIME( s[i].connect_time );
+			stats[i +  1*m] = (double) s[i].reconnects;
+			stats[i +  2*m] = (double) s[i].gets;
+			stats[i +  3*m] = (double) s[i].puts;
+			stats[i +  4*m] = (double) s[i].monitor_updates;
+			stats[i +  5*m] = s[i].bytes_in;
+			stats[i +  6*m] = s[i].bytes_out;
+			stats[i +  7*m] = STATS_TIME( s[i].latency_avg );
+			stats[i +  8*m] = STATS_TIME( s[i].latency_max );
+			stats[i +  9*m] = STATS_TIME( s[i].monitor_interval_avg );
+			stats[i + 10*m] = STATS_TIME( s[i].monitor_interval_max );
+			stats[i + 11*m] = STATS_TIME( s[i].last_update_age );
+			if ( hist ) {
+				for ( j=0; j<EZCA_STATS_NBINS; j++ )
+					hist[i + j*m] = (double) s[i].latency[j];
+			}
+		}
+	}
+
+	free( s );
+	return rval;
+}
+
+int epicsShareAPI
+multi_ezca_lock_stats(int on, double **pstats, char ***psites, LcaError *pe)
+{
+EzcaLockStatsRec *s     = 0;
+double           *stats = 0;
+char            **sites = 0;
+char              buf[100];
+int               m, n, i;
+
+	*pstats = 0;
+	*psites = 0;
+
+	if ( on > 0 )
+		ezcaLockStatsOn();
+	else if ( 0 == on )
+		ezcaLockStatsOff();
+
+	/* sites may get registered meanwhile; just report what fits */
+	m = ezcaGetLockStats(0, 0);
+
+	if ( m > 0 ) {
+		if ( !(s     = malloc( m * sizeof(*s) ))                                  ||
+		     !(stats = lcaMalloc( m * MULTI_EZCA_LOCK_STATS_NCOLS * sizeof(*stats) )) ||
+		     !(sites = lcaCalloc( m+1, sizeof(*sites) )) ) {
+			ezErr1( EZCA_FAILEDMALLOC, "multi_ezca_lock_stats: not enough memory", pe );
+			goto bail;
+		}
+		if ( (n = ezcaGetLockStats(s, m)) < m )
+			m = n;
+	}
+
+	for ( i=0; i<m; i++ ) {
+		/* column-major, one row per site */
+		stats[i + 0*m] = (double) s[i].count;
+		stats[i + 1*m] = (double) s[i].contended;
+		stats[i + 2*m] = s[i].wait_sum;
+		stats[i + 3*m] = s[i].wait_max;
+		stats[i + 4*m] = (double) s[i].holds;
+		stats[i + 5*m] = s[i].hold_sum;
+		stats[i + 6*m] = s[i].hold_max;
+		sprintf( buf, "%.80s:%d", s[i].func, s[i].line );
+		if ( !(sites[i] = my_strdup( buf )) ) {
+			ezErr1( EZCA_FAILEDMALLOC, "multi_ezca_lock_stats: not enough memory", pe );
+			goto bail;
+		}
+	}
+
+	free( s );
+	*pstats = stats;
+	*psites = sites;
+	return m > 0 ? m : 0;
+
+bail:
+	free( s );
+	if ( sites ) {
+		/* NULL terminated */
+		for ( i=0; sites[i]; i++ )
+			lcaFree( sites[i] );
+	}
+	lcaFree( sites );
+	lcaFree( stats );
+	return -1;
+}
+
 void epicsShareAPI
 lcaErrorInit(LcaError *pe)
 {
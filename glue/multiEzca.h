@@ -69,6 +69,47 @@ multi_ezca_put(char **nms, int m, char type, void *fbuf, int mo, int n, int doWa
 epicsShareFunc int epicsShareAPI
 multi_ezca_get(char **nms, char *type, void **pres, int m, int *pn, epicsTimeStamp **pts, LcaError *pe);
 
+/* PV sets: a persistent copy of a vector of PV names which remembers
+ * the resolved channels, element counts, types and a prepared ezca
+ * group so that repeated reads of the same PVs avoid all set-up work.
+ * Sets are identified by a positive integer ID.
+ */
+typedef struct MultiEzcaPVSetRec_ *MultiEzcaPVSet;
+
+/* returns the ID of the new set or 0 on error */
+epicsShareFunc int epicsShareAPI
+multi_ezca_pvset_create(char **nms, int m, LcaError *pe);
+
+/* destroy a set; id < 0 destroys all sets */
+epicsShareFunc int epicsShareAPI
+multi_ezca_pvset_destroy(int id, LcaError *pe);
+
+/* returns NULL if 'id' is not a valid set */
+epicsShareFunc MultiEzcaPVSet epicsShareAPI
+multi_ezca_pvset_find(int id);
+
+/* the names are owned by the set */
+epicsShareFunc char ** epicsShareAPI
+multi_ezca_pvset_names(MultiEzcaPVSet s, int *pm);
+
+/* same semantics as multi_ezca_get() */
+epicsShareFunc int epicsShareAPI
+multi_ezca_pvset_get(MultiEzcaPVSet s, char *type, void **pres, int *pn, epicsTimeStamp **pts, LcaError *pe);
+
+/* Start reading a vector of PVs (up to 'n' elements, all if n <= 0)
+ * without waiting for the values; returns a positive ID or 0 on error.
+ * Connecting the channels still happens synchronously.
+ */
+epicsShareFunc int epicsShareAPI
+multi_ezca_get_async(char **nms, char *type, int m, int n, LcaError *pe);
+
+/* Wait for an async read and return the values with the same semantics
+ * as multi_ezca_get() (return value is the number of PVs). The ID is
+ * invalid afterwards. If 'pres' is NULL the read is just discarded.
+ */
+epicsShareFunc int epicsShareAPI
+multi_ezca_fetch(int id, char *type, void **pres, int *pn, epicsTimeStamp **pts, LcaError *pe);
+
 typedef struct MultiArgRec_ {
 	int		size;
 	void	*buf;
@@ -89,13 +130,61 @@ multi_ezca_get_misc(char **nms, int m, MultiEzcaFunc ezcaProc, int nargs, MultiA
 /* destroy a number (column vector) of channels;
  * if 'nms==NULL', 'm' has a special meaning:
  *  m == 0 : all currently disconnected channels are cleared
- *  m <  0 : all channels are cleared
+ *  m <  0 : all channels (and PV sets) are cleared
  */
 epicsShareFunc int epicsShareAPI
 multi_ezca_clear_channels(char **nms, int m, LcaError *pe);
 
+/* queue searches for a number of channels without waiting for them
+ * (see ezcaConnectMany)
+ */
+epicsShareFunc int epicsShareAPI
+multi_ezca_connect(char **nms, int m, LcaError *pe);
+
+/* cached connection state (EZCA_CS_XXX) of a number of channels;
+ * returns the number of connected ones or -1 on error.
+ */
+epicsShareFunc int epicsShareAPI
+multi_ezca_connection_state(char **nms, int m, int *states, LcaError *pe);
+
+/* performance counters of a number of channels (see ezcaGetStats);
+ * 'stats' is a m x MULTI_EZCA_STATS_NCOLS matrix (column-major):
+ *   connect time, reconnects, gets, puts, monitor updates, bytes in,
+ *   bytes out, average and max round trip, average and max monitor
+ *   interval, age of the last monitor update
+ * (times in seconds; NaN if there was no such event). The optional
+ * 'hist' (m x EZCA_STATS_NBINS) receives the round trip histograms.
+ * Returns the number of cached channels or -1 on error.
+ */
+#define MULTI_EZCA_STATS_NCOLS 12
+epicsShareFunc int epicsShareAPI
+multi_ezca_get_stats(char **nms, int m, double *stats, double *hist, LcaError *pe);
+
+/* contention of the ezca library lock (see ezcaGetLockStats); 'on'
+ * > 0 resets and enables the statistics, 0 disables them and < 0
+ * leaves them alone. Returns the number of call sites 'm' and, in
+ * *pstats, a m x MULTI_EZCA_LOCK_STATS_NCOLS matrix (column-major):
+ *   acquisitions, contended acquisitions, total and max wait,
+ *   outermost acquisitions, total and max hold time
+ * and in *psites their names ("function:line", the array is NULL
+ * terminated); both (and the strings) are to be released with
+ * lcaFree. Returns -1 on error.
+ */
+#define MULTI_EZCA_LOCK_STATS_NCOLS 7
+epicsShareFunc int epicsShareAPI
+multi_ezca_lock_stats(int on, double **pstats, char ***psites, LcaError *pe);
+
+/* depth > 0 establishes queued monitors (see ezcaSetMonitorQueued) */
+epicsShareFunc int epicsShareAPI
+multi_ezca_set_mon(char **nms,  int m, int type, int clip, int depth, LcaError *pe);
+
+/* drain the queue of a single PV; returns the number of updates
+ * (rows of the *pn column result in *pres; *pres is NULL if there
+ * are none) or -1 on error. *pdropped is the number of updates lost
+ * since the last call because the queue was full.
+ */
 epicsShareFunc int epicsShareAPI
-multi_ezca_set_mon(char **nms,  int m, int type, int clip, LcaError *pe);
+multi_ezca_get_queued(char *nm, char *type, void **pres, int *pn, epicsTimeStamp **pts, unsigned long *pdropped, LcaError *pe);
 
 epicsShareFunc int epicsShareAPI
 multi_ezca_check_mon(char **nms, int m, int type, int *val, LcaError *pe);
@@ -46,6 +46,7 @@ struct { Myinterfun f ;  const wchar_t *name; } Tab[]={
 	{labca_gateway<intsezcaGetPrecision>,			L"lcaGetPrecision"},
 	{labca_gateway<intsezcaGetUnits>,				L"lcaGetUnits"},
 	{labca_gateway<intsezcaGetEnumStrings>,			L"lcaGetEnumStrings"},
+	{labca_gateway<intsezcaGetMetadata>,			L"lcaGetMetadata"},
 	{labca_gateway<intsezcaGetRetryCount>,			L"lcaGetRetryCount"},
 	{labca_gateway<intsezcaSetRetryCount>,			L"lcaSetRetryCount"},
 	{labca_gateway<intsezcaGetTimeout>,				L"lcaGetTimeout"},
@@ -59,6 +60,15 @@ struct { Myinterfun f ;  const wchar_t *name; } Tab[]={
 	{labca_gateway<intsezcaNewMonitorWait>,			L"lcaNewMonitorWait"},
 	{labca_gateway<intsezcaDelay>,	    			L"lcaDelay"},
 	{labca_gateway<intsezcaLastError>,    			L"lcaLastError"},
+	{labca_gateway<intsezcaNewPVSet>,    			L"lcaNewPVSet"},
+	{labca_gateway<intsezcaClearPVSet>,    			L"lcaClearPVSet"},
+	{labca_gateway<intsezcaGetQueued>,    			L"lcaGetQueued"},
+	{labca_gateway<intsezcaGetAsync>,    			L"lcaGetAsync"},
+	{labca_gateway<intsezcaFetch>,    			L"lcaFetch"},
+	{labca_gateway<intsezcaConnect>,    			L"lcaConnect"},
+	{labca_gateway<intsezcaGetConnectionState>,	L"lcaGetConnectionState"},
+	{labca_gateway<intsezcaGetStats>,    			L"lcaGetStats"},
+	{labca_gateway<intsezcaGetLockStats>,		L"lcaGetLockStats"},
 };
 
 /* WIN:
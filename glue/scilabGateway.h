@@ -21,6 +21,7 @@ int intsezcaGetStatus(char *name, PvApiCtxType pvApiCtx, Sciclean cleanup);
 int intsezcaGetPrecision(char *name, PvApiCtxType pvApiCtx, Sciclean cleanup);
 int intsezcaGetUnits(char *name, PvApiCtxType pvApiCtx, Sciclean cleanup);
 int intsezcaGetEnumStrings(char *name, PvApiCtxType pvApiCtx, Sciclean cleanup);
+int intsezcaGetMetadata(char *name, PvApiCtxType pvApiCtx, Sciclean cleanup);
 int intsezcaGetRetryCount(char *name, PvApiCtxType pvApiCtx, Sciclean cleanup);
 int intsezcaSetRetryCount(char *name, PvApiCtxType pvApiCtx, Sciclean cleanup);
 int intsezcaGetTimeout(char *name, PvApiCtxType pvApiCtx, Sciclean cleanup);
@@ -34,6 +35,15 @@ int intsezcaNewMonitorValue(char *name, PvApiCtxType pvApiCtx, Sciclean cleanup)
 int intsezcaNewMonitorWait(char *name, PvApiCtxType pvApiCtx, Sciclean cleanup);
 int intsezcaDelay(char *name, PvApiCtxType pvApiCtx, Sciclean cleanup);
 int intsezcaLastError(char *name, PvApiCtxType pvApiCtx, Sciclean cleanup);
+int intsezcaNewPVSet(char *name, PvApiCtxType pvApiCtx, Sciclean cleanup);
+int intsezcaClearPVSet(char *name, PvApiCtxType pvApiCtx, Sciclean cleanup);
+int intsezcaGetQueued(char *name, PvApiCtxType pvApiCtx, Sciclean cleanup);
+int intsezcaGetAsync(char *name, PvApiCtxType pvApiCtx, Sciclean cleanup);
+int intsezcaFetch(char *name, PvApiCtxType pvApiCtx, Sciclean cleanup);
+int intsezcaConnect(char *name, PvApiCtxType pvApiCtx, Sciclean cleanup);
+int intsezcaGetConnectionState(char *name, PvApiCtxType pvApiCtx, Sciclean cleanup);
+int intsezcaGetStats(char *name, PvApiCtxType pvApiCtx, Sciclean cleanup);
+int intsezcaGetLockStats(char *name, PvApiCtxType pvApiCtx, Sciclean cleanup);
 
 int
 labCA(wchar_t *funcName);
@@ -0,0 +1,45 @@
+/* matlab wrapper for destroying a PV set */
+
+/* LICENSE: EPICS open license, see ../LICENSE file */
+
+#include "mglue.h"
+#include "multiEzca.h"
+
+#include <cadef.h>
+#include <ezca.h>
+
+void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
+{
+const mxArray *tmp;
+LcaError theErr;
+
+	lcaMexGblInit();
+
+	lcaErrorInit(&theErr);
+
+	LHSCHECK(nlhs, plhs);
+
+	if ( 1 < nlhs ) {
+		lcaSetError(&theErr, EZCA_INVALIDARG, "Too many lhs args");
+		goto cleanup;
+	}
+
+	if ( 1 != nrhs ) {
+		lcaSetError(&theErr, EZCA_INVALIDARG, "Expected 1 rhs argument");
+		goto cleanup;
+	}
+
+	if ( ! mxIsNumeric(tmp = prhs[0]) || 1 != mxGetM(tmp) || 1 != mxGetN(tmp) ) {
+		lcaSetError(&theErr, EZCA_INVALIDARG, "Argument must be a numeric scalar (PV set ID)");
+		goto cleanup;
+	}
+
+	if ( multi_ezca_pvset_destroy( (int)mxGetScalar(tmp), &theErr ) )
+		goto cleanup;
+
+	nlhs = 0;
+
+cleanup:
+	/* do this LAST (in case mexErrMsgTxt is called) */
+	ERR_CHECK(nlhs, plhs, &theErr);
+}
@@ -0,0 +1,44 @@
+/* matlab wrapper for ezcaConnectMany */
+
+/* LICENSE: EPICS open license, see ../LICENSE file */
+
+#include "mglue.h"
+#include "multiEzca.h"
+
+#include <cadef.h>
+#include <ezca.h>
+
+void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
+{
+PVs     pvs = { {0} };
+LcaError theErr;
+
+	lcaMexGblInit();
+
+	lcaErrorInit(&theErr);
+
+	LHSCHECK(nlhs, plhs);
+
+	if ( 1 < nlhs ) {
+		lcaSetError(&theErr, EZCA_INVALIDARG, "Too many lhs args");
+		goto cleanup;
+	}
+
+	if ( 1 != nrhs ) {
+		lcaSetError(&theErr, EZCA_INVALIDARG, "Expected one rhs argument");
+		goto cleanup;
+	}
+
+	if ( buildPVs(prhs[0], &pvs, &theErr) )
+		goto cleanup;
+
+	if ( multi_ezca_connect( pvs.names, pvs.m, &theErr ) )
+		goto cleanup;
+
+	nlhs = 0;
+
+cleanup:
+	releasePVs(&pvs);
+	/* do this LAST (in case mexErrMsgTxt is called) */
+	ERR_CHECK(nlhs, plhs, &theErr);
+}
@@ -0,0 +1,100 @@
+/* matlab wrapper for collecting the result of lcaGetAsync */
+
+/* LICENSE: EPICS open license, see ../LICENSE file */
+
+#include "mglue.h"
+#include "multiEzca.h"
+
+#include <cadef.h>
+#include <ezca.h>
+
+void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
+{
+void	*pres = 0;
+int     i,m = 0,n = 0;
+const mxArray *tmp;
+mxArray     *clean0 = 0, *clean1 = 0;
+char	       type = ezcaNative;
+epicsTimeStamp  *ts = 0;
+LcaError theErr;
+
+	lcaMexGblInit();
+
+	lcaErrorInit(&theErr);
+
+	LHSCHECK(nlhs, plhs);
+
+	if ( nlhs > 2 ) {
+		lcaSetError(&theErr, EZCA_INVALIDARG, "Too many output args");
+		goto cleanup;
+	}
+
+	if ( 1 != nrhs ) {
+		lcaSetError(&theErr, EZCA_INVALIDARG, "Expected 1 rhs argument");
+		goto cleanup;
+	}
+
+	if ( ! mxIsNumeric(tmp = prhs[0]) || 1 != mxGetM(tmp) || 1 != mxGetN(tmp) ) {
+		lcaSetError(&theErr, EZCA_INVALIDARG, "Argument must be a numeric scalar (lcaGetAsync ID)");
+		goto cleanup;
+	}
+
+	m = multi_ezca_fetch( (int)mxGetScalar(tmp), &type, &pres, &n, &ts, &theErr );
+
+	if ( !pres )
+		goto cleanup;
+
+	/* if pres != NULL, we have a valid reply... */
+	if ( ezcaString == type ) {
+		/* convert string array to a matlab cell array of matlab strings */
+		if ( !(clean0 = plhs[0] = mxCreateCellMatrix(m, n)) ) {
+			lcaSetError(&theErr, EZCA_FAILEDMALLOC, "Not enough memory");
+			goto cleanup;
+		}
+		for ( i = 0; i < m * n; i++ ) {
+			if ( !(tmp = mxCreateString(((const char**)pres)[i])) ) {
+				lcaSetError(&theErr, EZCA_FAILEDMALLOC, "Not enough memory");
+				goto cleanup;
+			}
+			mxSetCell(plhs[0], i, (mxArray*)tmp);
+		}
+	} else {
+		if ( !(clean0 = plhs[0] = mxCreateDoubleMatrix(m,n,mxREAL)) ) {
+			lcaSetError(&theErr, EZCA_FAILEDMALLOC, "Not enough memory");
+			goto cleanup;
+		}
+		memcpy(mxGetPr(plhs[0]), pres, sizeof(double) * m * n);
+	}
+
+	/* If requested, generate the timestamp matrix */
+	if ( nlhs > 1 ) {
+		/* give them the time stamps */
+		if ( !(clean1 = plhs[1] = mxCreateDoubleMatrix(m,1,mxCOMPLEX)) ) {
+			lcaSetError(&theErr, EZCA_FAILEDMALLOC, "Not enough memory");
+			goto cleanup;
+		}
+		multi_ezca_ts_cvt( m, ts, mxGetPr(plhs[1]), mxGetPi(plhs[1]) );
+	}
+	clean0 = clean1 = 0;
+	nlhs = 0;
+
+cleanup:
+	if ( clean0 ) {
+		mxDestroyArray( clean0 );
+		plhs[0] = 0;
+	}
+	if ( clean1 ) {
+		mxDestroyArray( clean1 );
+		plhs[1] = 0;
+	}
+	if ( ezcaString == type && pres ) {
+		/* free string elements also */
+		for ( i=0; i<m*n; i++ ) {
+			lcaFree( ((char**)pres)[i] );
+		}
+	}
+	lcaFree(pres);
+	lcaFree(ts);
+	/* do this LAST (in case mexErrMsgTxt is called) */
+	ERR_CHECK(nlhs, plhs, &theErr);
+}
@@ -56,10 +56,13 @@ LcaError theErr;
 		}
 	}
 
-	if ( buildPVs(prhs[0], &pvs, &theErr) )
+	if ( buildPVsOrSet(prhs[0], &pvs, &theErr) )
 		goto cleanup;
 
-    multi_ezca_get( pvs.names, &type, &pres, pvs.m, &n, &ts, &theErr );
+	if ( pvs.set )
+		multi_ezca_pvset_get( pvs.set, &type, &pres, &n, &ts, &theErr );
+	else
+		multi_ezca_get( pvs.names, &type, &pres, pvs.m, &n, &ts, &theErr );
 
 	if ( !pres )
 		goto cleanup;
@@ -0,0 +1,72 @@
+/* matlab wrapper for starting an asynchronous lcaGet */
+
+/* LICENSE: EPICS open license, see ../LICENSE file */
+
+#include "mglue.h"
+#include "multiEzca.h"
+
+#include <cadef.h>
+#include <ezca.h>
+
+void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
+{
+int     n = 0;
+int     id;
+const mxArray *tmp;
+PVs     pvs = { {0} };
+char	type = ezcaNative;
+LcaError theErr;
+
+	lcaMexGblInit();
+
+	lcaErrorInit(&theErr);
+
+	LHSCHECK(nlhs, plhs);
+
+	if ( 1 < nlhs ) {
+		lcaSetError(&theErr, EZCA_INVALIDARG, "Too many lhs args");
+		goto cleanup;
+	}
+
+	if ( nrhs < 1 || nrhs > 3 ) {
+		lcaSetError(&theErr, EZCA_INVALIDARG, "Expected 1..3 rhs argument");
+		goto cleanup;
+	}
+
+	/* check for an optional 'column dimension' argument */
+	if ( nrhs > 1 ) {
+		if ( ! mxIsNumeric(tmp = prhs[1]) || 1 != mxGetM(tmp) || 1 != mxGetN(tmp) ) {
+			lcaSetError(&theErr, EZCA_INVALIDARG, "2nd argument must be a numeric scalar");
+			goto cleanup;
+		}
+		n = (int)mxGetScalar( tmp );
+	}
+
+	/* check for an optional data type argument */
+	if ( nrhs > 2 ) {
+		if ( ezcaInvalid == (type = marg2ezcaType( prhs[2], &theErr )) ) {
+			goto cleanup;
+		}
+	}
+
+	if ( buildPVsOrSet(prhs[0], &pvs, &theErr) )
+		goto cleanup;
+
+	if ( !(id = multi_ezca_get_async( pvs.names, &type, (int)pvs.m, n, &theErr )) )
+		goto cleanup;
+
+	if ( !(plhs[0] = mxCreateDoubleMatrix(1,1,mxREAL)) ) {
+		/* discard the request */
+		multi_ezca_fetch( id, &type, 0, &n, 0, &theErr );
+		lcaSetError(&theErr, EZCA_FAILEDMALLOC, "Not enough memory");
+		goto cleanup;
+	}
+	*mxGetPr(plhs[0]) = (double)id;
+
+	nlhs = 0;
+
+cleanup:
+	releasePVs(&pvs);
+	/* do this LAST (in case mexErrMsgTxt is called) */
+	ERR_CHECK(nlhs, plhs, &theErr);
+}
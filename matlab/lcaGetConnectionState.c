@@ -0,0 +1,48 @@
+/* matlab wrapper for ezcaConnectionState */
+
+/* LICENSE: EPICS open license, see ../LICENSE file */
+
+#include "mglue.h"
+#include "multiEzca.h"
+
+#include <cadef.h>
+#include <ezca.h>
+
+void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
+{
+PVs     pvs = { {0} };
+LcaError theErr;
+
+	lcaMexGblInit();
+
+	lcaErrorInit(&theErr);
+
+	LHSCHECK(nlhs, plhs);
+
+	if ( nlhs > 1 ) {
+		lcaSetError(&theErr, EZCA_INVALIDARG, "Too many output args");
+		goto cleanup;
+	}
+
+	if ( 1 != nrhs ) {
+		lcaSetError(&theErr, EZCA_INVALIDARG, "Expected one rhs argument");
+		goto cleanup;
+	}
+
+	if ( buildPVs(prhs[0], &pvs, &theErr) )
+		goto cleanup;
+
+	if ( ! (plhs[0] = mxCreateNumericMatrix( pvs.m, 1, mxINT32_CLASS, mxREAL )) ) {
+		lcaSetError(&theErr, EZCA_FAILEDMALLOC, "Not enough memory");
+		goto cleanup;
+	}
+
+	if ( multi_ezca_connection_state( pvs.names, pvs.m, (int*)mxGetData(plhs[0]), &theErr ) >= 0 ) {
+		nlhs = 0;
+	}
+
+cleanup:
+	releasePVs(&pvs);
+	/* do this LAST (in case mexErrMsgTxt is called) */
+	ERR_CHECK(nlhs, plhs, &theErr);
+}
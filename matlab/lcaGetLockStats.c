@@ -0,0 +1,78 @@
+/* matlab wrapper for ezcaGetLockStats */
+
+/* LICENSE: EPICS open license, see ../LICENSE file */
+
+#include "mglue.h"
+#include "multiEzca.h"
+
+#include <cadef.h>
+#include <ezca.h>
+
+void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
+{
+double   *stats = 0;
+char    **sites = 0;
+int       m     = -1, i, on = -1;
+mxArray  *tmp;
+LcaError  theErr;
+
+	lcaMexGblInit();
+
+	lcaErrorInit(&theErr);
+
+	LHSCHECK(nlhs, plhs);
+
+	if ( nlhs > 2 ) {
+		lcaSetError(&theErr, EZCA_INVALIDARG, "Too many output args");
+		goto cleanup;
+	}
+
+	if ( nrhs > 1 ) {
+		lcaSetError(&theErr, EZCA_INVALIDARG, "Expected at most one rhs argument");
+		goto cleanup;
+	}
+
+	if ( nrhs > 0 ) {
+		if ( ! mxIsNumeric(prhs[0]) || 1 != mxGetM(prhs[0]) || 1 != mxGetN(prhs[0]) ) {
+			lcaSetError(&theErr, EZCA_INVALIDARG, "Expected a numeric scalar argument");
+			goto cleanup;
+		}
+		on = 0. != mxGetScalar(prhs[0]);
+	}
+
+	if ( (m = multi_ezca_lock_stats( on, &stats, &sites, &theErr )) < 0 )
+		goto cleanup;
+
+	if ( ! (plhs[0] = mxCreateDoubleMatrix( m, MULTI_EZCA_LOCK_STATS_NCOLS, mxREAL )) ) {
+		lcaSetError(&theErr, EZCA_FAILEDMALLOC, "Not enough memory");
+		goto cleanup;
+	}
+	if ( m > 0 )
+		memcpy( mxGetPr(plhs[0]), stats, m * MULTI_EZCA_LOCK_STATS_NCOLS * sizeof(*stats) );
+
+	if ( nlhs > 1 ) {
+		if ( !(plhs[1] = mxCreateCellMatrix(m, 1)) ) {
+			lcaSetError(&theErr, EZCA_FAILEDMALLOC, "Not enough memory");
+			goto cleanup;
+		}
+		for ( i = 0; i < m; i++ ) {
+			if ( !(tmp = mxCreateString(sites[i])) ) {
+				lcaSetError(&theErr, EZCA_FAILEDMALLOC, "Not enough memory");
+				goto cleanup;
+			}
+			mxSetCell(plhs[1], i, tmp);
+		}
+	}
+
+	nlhs = 0;
+
+cleanup:
+	if ( sites ) {
+		for ( i = 0; sites[i]; i++ )
+			lcaFree( sites[i] );
+	}
+	lcaFree( sites );
+	lcaFree( stats );
+	/* do this LAST (in case mexErrMsgTxt is called) */
+	ERR_CHECK(nlhs, plhs, &theErr);
+}
@@ -0,0 +1,142 @@
+/* matlab wrapper for ezcaGetMetadata */
+
+/* LICENSE: EPICS open license, see ../LICENSE file */
+
+#include "mglue.h"
+#include "multiEzca.h"
+
+#include <cadef.h>
+#include <ezca.h>
+
+#ifdef __GNUC__
+#define MAY_ALIAS __attribute__((may_alias))
+#else
+#define MAY_ALIAS
+#endif
+
+static const char *fields[] = {
+	"units",
+	"precision",
+	"graphicLimits",
+	"controlLimits",
+	"warnLimits",
+	"alarmLimits",
+	"enumStrings",
+};
+
+static mxArray *
+limits(double lo, double hi)
+{
+mxArray *rval;
+
+	if ( (rval = mxCreateDoubleMatrix(1, 2, mxREAL)) ) {
+		mxGetPr(rval)[0] = lo;
+		mxGetPr(rval)[1] = hi;
+	}
+	return rval;
+}
+
+/* fill element 'i' of the struct array; returns 0 if out of memory
+ * (fields already set are destroyed with the struct array)
+ */
+static int
+setElement(mxArray *s, int i, EzcaMetadataRec *md)
+{
+mxArray *tmp;
+int      j;
+
+	if ( !(tmp = mxCreateString(md->units)) )
+		return 0;
+	mxSetField(s, i, "units", tmp);
+
+	if ( !(tmp = mxCreateDoubleScalar((double)md->precision)) )
+		return 0;
+	mxSetField(s, i, "precision", tmp);
+
+	if ( !(tmp = limits(md->disp_lo, md->disp_hi)) )
+		return 0;
+	mxSetField(s, i, "graphicLimits", tmp);
+
+	if ( !(tmp = limits(md->ctrl_lo, md->ctrl_hi)) )
+		return 0;
+	mxSetField(s, i, "controlLimits", tmp);
+
+	if ( !(tmp = limits(md->warn_lo, md->warn_hi)) )
+		return 0;
+	mxSetField(s, i, "warnLimits", tmp);
+
+	if ( !(tmp = limits(md->alarm_lo, md->alarm_hi)) )
+		return 0;
+	mxSetField(s, i, "alarmLimits", tmp);
+
+	if ( !(tmp = mxCreateCellMatrix(md->no_str, 1)) )
+		return 0;
+	mxSetField(s, i, "enumStrings", tmp);
+	for ( j = 0; j < md->no_str; j++ ) {
+		mxArray *str;
+		/* strings from the server need not be terminated */
+		md->strs[j][EZCA_ENUM_STRING_SIZE-1] = 0;
+		if ( !(str = mxCreateString(md->strs[j])) )
+			return 0;
+		mxSetCell(tmp, j, str);
+	}
+
+	return 1;
+}
+
+void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
+{
+PVs     pvs = { {0} };
+int     i;
+LcaError theErr;
+MultiArgRec	args[1];
+EzcaMetadataRec *mdbuf MAY_ALIAS = 0;
+
+	lcaMexGblInit();
+
+	lcaErrorInit(&theErr);
+
+	LHSCHECK(nlhs, plhs);
+
+	if ( nlhs > 1 ) {
+		lcaSetError(&theErr, EZCA_INVALIDARG, "Too many output args");
+		goto cleanup;
+	}
+
+	if ( 1 != nrhs ) {
+		lcaSetError(&theErr, EZCA_INVALIDARG, "Expected one rhs argument");
+		goto cleanup;
+	}
+
+	if ( buildPVs(prhs[0], &pvs, &theErr) )
+		goto cleanup;
+
+	MSetArg(args[0], sizeof(*mdbuf), 0, &mdbuf);
+
+	/* one DBR_CTRL request per PV, all in one group */
+	if ( !multi_ezca_get_misc(pvs.names, pvs.m, (MultiEzcaFunc)ezcaGetMetadata, NumberOf(args), args, &theErr) )
+		goto cleanup;
+
+	if ( !(plhs[0] = mxCreateStructMatrix(pvs.m, 1, NumberOf(fields), fields)) ) {
+		lcaSetError(&theErr, EZCA_FAILEDMALLOC, "Not enough memory");
+		goto cleanup;
+	}
+
+	for ( i = 0; i < pvs.m; i++ ) {
+		if ( !setElement(plhs[0], i, &mdbuf[i]) ) {
+			mxDestroyArray(plhs[0]);
+			plhs[0] = 0;
+			lcaSetError(&theErr, EZCA_FAILEDMALLOC, "Not enough memory");
+			goto cleanup;
+		}
+	}
+
+	nlhs = 0;
+
+cleanup:
+	if ( mdbuf )
+		lcaFree( mdbuf );
+	releasePVs(&pvs);
+	/* do this LAST (in case mexErrMsgTxt is called) */
+	ERR_CHECK(nlhs, plhs, &theErr);
+}
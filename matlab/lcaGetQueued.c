@@ -0,0 +1,128 @@
+/* matlab wrapper for ezcaGetQueued */
+
+/* LICENSE: EPICS open license, see ../LICENSE file */
+
+#include "mglue.h"
+#include "multiEzca.h"
+
+#include <cadef.h>
+#include <ezca.h>
+
+#include <ctype.h>
+
+void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
+{
+void	*pres = 0;
+int     i,k = 0,n = 0;
+const mxArray *tmp;
+mxArray     *clean0 = 0, *clean1 = 0;
+PVs             pvs = { {0} };
+char	       type = ezcaNative;
+epicsTimeStamp  *ts = 0;
+unsigned long   dropped = 0;
+LcaError theErr;
+
+	lcaMexGblInit();
+
+	lcaErrorInit(&theErr);
+
+	LHSCHECK(nlhs, plhs);
+
+	if ( nlhs > 3 ) {
+		lcaSetError(&theErr, EZCA_INVALIDARG, "Too many output args");
+		goto cleanup;
+	}
+
+	if ( nrhs < 1 || nrhs > 3 ) {
+		lcaSetError(&theErr, EZCA_INVALIDARG, "Expected 1..3 rhs argument");
+		goto cleanup;
+	}
+
+	/* check for an optional 'column dimension' argument */
+	if ( nrhs > 1 ) {
+		if ( ! mxIsNumeric(tmp = prhs[1]) || 1 != mxGetM(tmp) || 1 != mxGetN(tmp) ) {
+			lcaSetError(&theErr, EZCA_INVALIDARG, "2nd argument must be a numeric scalar");
+			goto cleanup;
+		}
+		n = (int)mxGetScalar( tmp );
+	}
+
+	/* check for an optional data type argument */
+	if ( nrhs > 2 ) {
+		if ( ezcaInvalid == (type = marg2ezcaType( prhs[2], &theErr )) ) {
+			goto cleanup;
+		}
+	}
+
+	if ( buildPVs(prhs[0], &pvs, &theErr) )
+		goto cleanup;
+
+	if ( 1 != pvs.m ) {
+		lcaSetError(&theErr, EZCA_INVALIDARG, "Expected a single PV name");
+		goto cleanup;
+	}
+
+	if ( (k = multi_ezca_get_queued( pvs.names[0], &type, &pres, &n, &ts, &dropped, &theErr )) < 0 )
+		goto cleanup;
+
+	/* one row per update */
+	if ( ezcaString == type ) {
+		if ( !(clean0 = plhs[0] = mxCreateCellMatrix(k, n)) ) {
+			lcaSetError(&theErr, EZCA_FAILEDMALLOC, "Not enough memory");
+			goto cleanup;
+		}
+		for ( i = 0; i < k * n; i++ ) {
+			if ( !(tmp = mxCreateString(((const char**)pres)[i])) ) {
+				lcaSetError(&theErr, EZCA_FAILEDMALLOC, "Not enough memory");
+				goto cleanup;
+			}
+			mxSetCell(plhs[0], i, (mxArray*)tmp);
+		}
+	} else {
+		if ( !(clean0 = plhs[0] = mxCreateDoubleMatrix(k,n,mxREAL)) ) {
+			lcaSetError(&theErr, EZCA_FAILEDMALLOC, "Not enough memory");
+			goto cleanup;
+		}
+		if ( k > 0 )
+			memcpy(mxGetPr(plhs[0]), pres, sizeof(double) * k * n);
+	}
+
+	if ( nlhs > 1 ) {
+		if ( !(clean1 = plhs[1] = mxCreateDoubleMatrix(k,1,mxCOMPLEX)) ) {
+			lcaSetError(&theErr, EZCA_FAILEDMALLOC, "Not enough memory");
+			goto cleanup;
+		}
+		multi_ezca_ts_cvt( k, ts, mxGetPr(plhs[1]), mxGetPi(plhs[1]) );
+	}
+
+	if ( nlhs > 2 ) {
+		if ( !(plhs[2] = mxCreateDoubleMatrix( 1, 1, mxREAL )) ) {
+			lcaSetError(&theErr, EZCA_FAILEDMALLOC, "Not enough memory");
+			goto cleanup;
+		}
+		*mxGetPr(plhs[2]) = (double)dropped;
+	}
+	clean0 = clean1 = 0;
+	nlhs = 0;
+
+cleanup:
+	if ( clean0 ) {
+		mxDestroyArray( clean0 );
+		plhs[0] = 0;
+	}
+	if ( clean1 ) {
+		mxDestroyArray( clean1 );
+		plhs[1] = 0;
+	}
+	if ( ezcaString == type && pres ) {
+		/* free string elements also */
+		for ( i=0; i<k*n; i++ ) {
+			lcaFree( ((char**)pres)[i] );
+		}
+	}
+	lcaFree(pres);
+	lcaFree(ts);
+	releasePVs(&pvs);
+	/* do this LAST (in case mexErrMsgTxt is called) */
+	ERR_CHECK(nlhs, plhs, &theErr);
+}
@@ -0,0 +1,53 @@
+/* matlab wrapper for ezcaGetStats */
+
+/* LICENSE: EPICS open license, see ../LICENSE file */
+
+#include "mglue.h"
+#include "multiEzca.h"
+
+#include <cadef.h>
+#include <ezca.h>
+
+void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
+{
+PVs     pvs = { {0} };
+LcaError theErr;
+
+	lcaMexGblInit();
+
+	lcaErrorInit(&theErr);
+
+	LHSCHECK(nlhs, plhs);
+
+	if ( nlhs > 2 ) {
+		lcaSetError(&theErr, EZCA_INVALIDARG, "Too many output args");
+		goto cleanup;
+	}
+
+	if ( 1 != nrhs ) {
+		lcaSetError(&theErr, EZCA_INVALIDARG, "Expected one rhs argument");
+		goto cleanup;
+	}
+
+	if ( buildPVs(prhs[0], &pvs, &theErr) )
+		goto cleanup;
+
+	if ( ! (plhs[0] = mxCreateDoubleMatrix( pvs.m, MULTI_EZCA_STATS_NCOLS, mxREAL )) ) {
+		lcaSetError(&theErr, EZCA_FAILEDMALLOC, "Not enough memory");
+		goto cleanup;
+	}
+
+	if ( nlhs > 1 && ! (plhs[1] = mxCreateDoubleMatrix( pvs.m, EZCA_STATS_NBINS, mxREAL )) ) {
+		lcaSetError(&theErr, EZCA_FAILEDMALLOC, "Not enough memory");
+		goto cleanup;
+	}
+
+	if ( multi_ezca_get_stats( pvs.names, pvs.m, mxGetPr(plhs[0]), nlhs > 1 ? mxGetPr(plhs[1]) : 0, &theErr ) >= 0 ) {
+		nlhs = 0;
+	}
+
+cleanup:
+	releasePVs(&pvs);
+	/* do this LAST (in case mexErrMsgTxt is called) */
+	ERR_CHECK(nlhs, plhs, &theErr);
+}
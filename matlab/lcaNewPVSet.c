@@ -0,0 +1,52 @@
+/* matlab wrapper for creating a persistent PV set */
+
+/* LICENSE: EPICS open license, see ../LICENSE file */
+
+#include "mglue.h"
+#include "multiEzca.h"
+
+#include <cadef.h>
+#include <ezca.h>
+
+void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
+{
+PVs     pvs = { {0} };
+int     id;
+LcaError theErr;
+
+	lcaMexGblInit();
+
+	lcaErrorInit(&theErr);
+
+	LHSCHECK(nlhs, plhs);
+
+	if ( 1 < nlhs ) {
+		lcaSetError(&theErr, EZCA_INVALIDARG, "Too many lhs args");
+		goto cleanup;
+	}
+
+	if ( 1 != nrhs ) {
+		lcaSetError(&theErr, EZCA_INVALIDARG, "Expected 1 rhs argument");
+		goto cleanup;
+	}
+
+	if ( buildPVs(prhs[0], &pvs, &theErr) )
+		goto cleanup;
+
+	if ( !(id = multi_ezca_pvset_create( pvs.names, (int)pvs.m, &theErr )) )
+		goto cleanup;
+
+	if ( !(plhs[0] = mxCreateDoubleMatrix(1,1,mxREAL)) ) {
+		multi_ezca_pvset_destroy( id, &theErr );
+		lcaSetError(&theErr, EZCA_FAILEDMALLOC, "Not enough memory");
+		goto cleanup;
+	}
+	*mxGetPr(plhs[0]) = (double)id;
+
+	nlhs = 0;
+
+cleanup:
+	releasePVs(&pvs);
+	/* do this LAST (in case mexErrMsgTxt is called) */
+	ERR_CHECK(nlhs, plhs, &theErr);
+}
@@ -16,6 +16,7 @@
 void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
 {
 int     n = 0;
+int     depth = 0;
 const mxArray *tmp;
 PVs     pvs = { {0} };
 char	type = ezcaNative;
@@ -32,8 +33,8 @@ LcaError theErr;
 		goto cleanup;
 	}
 
-	if ( nrhs < 1 || nrhs > 3 ) {
-		lcaSetError(&theErr, EZCA_INVALIDARG, "Expected 1..3 rhs argument");
+	if ( nrhs < 1 || nrhs > 4 ) {
+		lcaSetError(&theErr, EZCA_INVALIDARG, "Expected 1..4 rhs argument");
 		goto cleanup;
 	}
 
@@ -53,10 +54,19 @@ LcaError theErr;
 		}
 	}
 
+	/* check for an optional queue depth argument */
+	if ( nrhs > 3 ) {
+		if ( ! mxIsNumeric(tmp = prhs[3]) || 1 != mxGetM(tmp) || 1 != mxGetN(tmp) ) {
+			lcaSetError(&theErr, EZCA_INVALIDARG, "4th argument must be a numeric scalar");
+			goto cleanup;
+		}
+		depth = (int)mxGetScalar( tmp );
+	}
+
 	if ( buildPVs(prhs[0], &pvs, &theErr) )
 		goto cleanup;
 
-    if ( 0 == multi_ezca_set_mon( pvs.names, pvs.m, type, n, &theErr ) ) {
+    if ( 0 == multi_ezca_set_mon( pvs.names, pvs.m, type, n, depth, &theErr ) ) {
 		nlhs = 0;
 	}
 
@@ -0,0 +1,279 @@
+/* Test for async groups (ezcaEndGroupAsync() and friends).
+ *
+ * Run against a soft IOC serving lcaTest.db (see st.cmd). Checks
+ *  - several groups in flight at once, picked up in the order they
+ *    complete with ezcaGroupWaitAny() and checked with ezcaGroupTest()
+ *    and ezcaGroupWait() before being collected;
+ *  - collecting a group from a thread other than the one which
+ *    issued it;
+ *  - groups reading a PV which doesn't exist: they are not over until
+ *    their deadline, the other requests in them still succeed and
+ *    ezcaGroupWaitAny() returns a group completing before that;
+ *  - invalid tickets and arguments.
+ *
+ * Usage: ezcaAsyncTest
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <cadef.h>
+#include <epicsTime.h>
+#include <epicsThread.h>
+#include <epicsEvent.h>
+#include "ezca.h"
+
+#define NPVS     10
+#define NELM     100
+#define TIMEOUT  0.2
+#define RETRIES  1
+#define DEADLINE (TIMEOUT * (RETRIES + 1))
+
+static char *scls[NPVS] = {
+	"lca:scl0", "lca:scl1", "lca:scl2", "lca:scl3", "lca:scl4",
+	"lca:scl5", "lca:scl6", "lca:scl7", "lca:scl8", "lca:scl9",
+};
+
+static char *wavs[NPVS] = {
+	"lca:wav0", "lca:wav1", "lca:wav2", "lca:wav3", "lca:wav4",
+	"lca:wav5", "lca:wav6", "lca:wav7", "lca:wav8", "lca:wav9",
+};
+
+static int            failures = 0;
+static double         sclVal[NPVS];
+static epicsInt32     wavVal[NPVS][NELM];
+
+static double         sclGot[NPVS];
+static epicsInt32     wavGot[NPVS][NELM];
+
+static void
+fail(const char *what, int rc)
+{
+	fprintf( stderr, "FAILED: %s (rc %d)\n", what, rc );
+	failures++;
+}
+
+static int
+setup(void)
+{
+int i, j, rc;
+
+	for ( i = 0; i < NPVS; i++ ) {
+		sclVal[i] = i + 0.5;
+		for ( j = 0; j < NELM; j++ )
+			wavVal[i][j] = 100 * i + j;
+		if (    EZCA_OK != (rc = ezcaPut( scls[i], ezcaDouble, 1, &sclVal[i] ))
+		     || EZCA_OK != (rc = ezcaPut( wavs[i], ezcaLong, NELM, wavVal[i] )) ) {
+			fprintf( stderr, "Unable to write %s/%s; is the IOC up?\n", scls[i], wavs[i] );
+			return -1;
+		}
+	}
+	return 0;
+}
+
+/* a group reading scls[i] and wavs[i] */
+static EzcaTicket
+issue_pair(int i)
+{
+EzcaTicket t = 0;
+int        rc;
+
+	sclGot[i] = -1.;
+	wavGot[i][NELM-1] = -1;
+	ezcaStartGroup();
+	ezcaGet( scls[i], ezcaDouble, 1,    &sclGot[i] );
+	ezcaGet( wavs[i], ezcaLong,   NELM, wavGot[i]  );
+	if ( EZCA_OK != (rc = ezcaEndGroupAsync( &t )) )
+		fail( "ezcaEndGroupAsync()", rc );
+	return t;
+}
+
+static void
+check_pair(int i, int rc, int *rcs, int n)
+{
+int j;
+
+	if ( EZCA_OK != rc || 2 != n || EZCA_OK != rcs[0] || EZCA_OK != rcs[1] ) {
+		fail( "collecting a group", rc );
+		return;
+	}
+	if ( sclGot[i] != sclVal[i] )
+		fail( "wrong scalar value", i );
+	for ( j = 0; j < NELM; j++ ) {
+		if ( wavGot[i][j] != wavVal[i][j] ) {
+			fail( "wrong waveform value", i );
+			break;
+		}
+	}
+}
+
+static void
+test_many(void)
+{
+EzcaTicket ts[NPVS];
+int        i, k, rc, n;
+int       *rcs;
+
+	for ( i = 0; i < NPVS; i++ )
+		ts[i] = issue_pair( i );
+
+	for ( k = 0; k < NPVS; k++ ) {
+		i = ezcaGroupWaitAny( ts, NPVS, -1. );
+		if ( i < 0 || i >= NPVS || !ts[i] ) {
+			fail( "ezcaGroupWaitAny()", i );
+			return;
+		}
+		if ( 1 != (rc = ezcaGroupTest( ts[i] )) )
+			fail( "ezcaGroupTest() of a group which is over", rc );
+		if ( 1 != (rc = ezcaGroupWait( ts[i], 0. )) )
+			fail( "ezcaGroupWait() of a group which is over", rc );
+
+		rcs = 0;
+		rc  = ezcaGroupCollect( ts[i], &rcs, &n );
+		check_pair( i, rc, rcs, n );
+		ezcaFree( rcs );
+		ts[i] = 0;
+	}
+
+	if ( -1 != (rc = ezcaGroupWaitAny( ts, NPVS, 0. )) )
+		fail( "ezcaGroupWaitAny() without any group", rc );
+}
+
+static EzcaTicket     collectTicket;
+static int            collectRc, collectN;
+static int           *collectRcs;
+static epicsEventId   collected;
+
+static void
+collector(void *arg)
+{
+	collectRc = ezcaGroupCollect( collectTicket, &collectRcs, &collectN );
+	epicsEventSignal( collected );
+}
+
+static void
+test_other_thread(void)
+{
+	collected     = epicsEventMustCreate( epicsEventEmpty );
+	collectTicket = issue_pair( 3 );
+	collectRcs    = 0;
+
+	epicsThreadMustCreate( "ezcaAsyncTest", epicsThreadPriorityMedium,
+		epicsThreadGetStackSize( epicsThreadStackSmall ),
+		collector, 0 );
+	epicsEventMustWait( collected );
+
+	check_pair( 3, collectRc, collectRcs, collectN );
+	ezcaFree( collectRcs );
+}
+
+/* a group with a PV which never connects; 'good' is read, too */
+static EzcaTicket
+issue_missing(char *pv, int good)
+{
+EzcaTicket t = 0;
+double     v;
+int        rc;
+
+	sclGot[good] = -1.;
+	ezcaStartGroup();
+	ezcaGet( scls[good], ezcaDouble, 1, &sclGot[good] );
+	ezcaGet( pv,         ezcaDouble, 1, &v );
+	if ( EZCA_OK != (rc = ezcaEndGroupAsync( &t )) )
+		fail( "ezcaEndGroupAsync()", rc );
+	return t;
+}
+
+static void
+check_missing(int good, int rc, int *rcs, int n)
+{
+	if ( EZCA_OK == rc || 2 != n ) {
+		fail( "collecting a group which timed out", rc );
+		return;
+	}
+	if ( EZCA_OK != rcs[0] || sclGot[good] != sclVal[good] )
+		fail( "good PV in a group which timed out", rcs[0] );
+	if ( EZCA_OK == rcs[1] )
+		fail( "missing PV in a group which timed out", rcs[1] );
+}
+
+static void
+test_timeout(void)
+{
+EzcaTicket     ts[2];
+epicsTimeStamp then, now;
+double         t;
+int            rc, n;
+int           *rcs;
+
+	ezcaSetTimeout( TIMEOUT );
+	ezcaSetRetryCount( RETRIES );
+
+	/* let the deadline expire before collecting */
+	ts[0] = issue_missing( "lca:noSuchPV1", 0 );
+	if ( 0 != (rc = ezcaGroupTest( ts[0] )) )
+		fail( "ezcaGroupTest() before the deadline", rc );
+	if ( 0 != (rc = ezcaGroupWait( ts[0], 0.01 )) )
+		fail( "ezcaGroupWait() before the deadline", rc );
+	epicsThreadSleep( 2. * DEADLINE );
+	rcs = 0;
+	rc  = ezcaGroupCollect( ts[0], &rcs, &n );
+	check_missing( 0, rc, rcs, n );
+	ezcaFree( rcs );
+
+	/* a group which completes is picked before one which times out */
+	epicsTimeGetCurrent( &then );
+	ts[0] = issue_missing( "lca:noSuchPV2", 1 );
+	ts[1] = issue_pair( 2 );
+	if ( 1 != (rc = ezcaGroupWaitAny( ts, 2, -1. )) )
+		fail( "ezcaGroupWaitAny() with a group timing out", rc );
+	rcs = 0;
+	rc  = ezcaGroupCollect( ts[1], &rcs, &n );
+	check_pair( 2, rc, rcs, n );
+	ezcaFree( rcs );
+
+	/* waits until the deadline */
+	if ( 1 != (rc = ezcaGroupWait( ts[0], -1. )) )
+		fail( "ezcaGroupWait() until the deadline", rc );
+	epicsTimeGetCurrent( &now );
+	t = epicsTimeDiffInSeconds( &now, &then );
+	if ( t < 0.5 * DEADLINE || t > DEADLINE + 1. )
+		fail( "ezcaGroupWait() returned too early or late", (int)(t * 1000.) );
+	rcs = 0;
+	rc  = ezcaGroupCollect( ts[0], &rcs, &n );
+	check_missing( 1, rc, rcs, n );
+	ezcaFree( rcs );
+}
+
+static void
+test_invalid(void)
+{
+EzcaTicket t = 0;
+int        rc, n = 0;
+int       *rcs = (int *) &n;
+
+	if ( EZCA_NOTINGROUP != (rc = ezcaEndGroupAsync( &t )) || t )
+		fail( "ezcaEndGroupAsync() outside of a group", rc );
+	if ( (rc = ezcaGroupTest( 0 )) >= 0 )
+		fail( "ezcaGroupTest() of an invalid ticket", rc );
+	if ( (rc = ezcaGroupWait( 0, 0. )) >= 0 )
+		fail( "ezcaGroupWait() of an invalid ticket", rc );
+	if ( -2 != (rc = ezcaGroupWaitAny( 0, 1, 0. )) )
+		fail( "ezcaGroupWaitAny() of no tickets", rc );
+	if ( EZCA_INVALIDARG != (rc = ezcaGroupCollect( 0, &rcs, &n )) || rcs || -1 != n )
+		fail( "ezcaGroupCollect() of an invalid ticket", rc );
+}
+
+int main( int argc, char * argv[] )
+{
+	ezcaAutoErrorMessageOff();
+
+	if ( setup() )
+		return 1;
+
+	test_many();
+	test_other_thread();
+	test_timeout();
+	test_invalid();
+
+	printf( "%s\n", failures ? "FAILED" : "PASSED" );
+	return failures ? 1 : 0;
+}
@@ -0,0 +1,82 @@
+/* Benchmark for the cost of 'trivial' ezca calls.
+ *
+ * Measures ezcaGetNelem() and ezcaNewMonitorValue() on a cached,
+ * connected channel.
+ *
+ * With '-o' the program creates a non-preemptive CA context before
+ * ezca initializes. ezca then falls back to what every call used to
+ * do: pend for callbacks (ca_pend_event(1e-12)) in its prologue. Run
+ * the benchmark with and without '-o' to compare the two prologues.
+ *
+ * Usage: ezcaCallBench [-o] [pv_name [iterations]]
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <cadef.h>
+#include <epicsTime.h>
+#include "ezca.h"
+
+static double
+elapsed(epicsTimeStamp *then, unsigned long n)
+{
+epicsTimeStamp now;
+
+	epicsTimeGetCurrent( &now );
+	return epicsTimeDiffInSeconds( &now, then ) * 1.0e9 / (double)n;
+}
+
+int main( int argc, char * argv[] )
+{
+char           *pv = "lca:wav0";
+unsigned long  n   = 100000;
+unsigned long  i;
+int            nelem;
+epicsTimeStamp then;
+double         t_nelem, t_monval;
+int            old = 0;
+
+	if ( argc > 1 && 0 == strcmp( argv[1], "-o" ) ) {
+		old = 1;
+		argc--;
+		argv++;
+	}
+	if ( argc > 1 )
+		pv = argv[1];
+	if ( argc > 2 )
+		n  = strtoul( argv[2], 0, 0 );
+
+	/* ezca finds this context and pends in every call */
+	if ( old && ECA_NORMAL != ca_context_create( ca_disable_preemptive_callback ) ) {
+		fprintf( stderr, "Unable to create CA context\n" );
+		return 1;
+	}
+
+	/* connect and cache the channel */
+	if ( EZCA_OK != ezcaGetNelem( pv, &nelem ) ) {
+		fprintf( stderr, "Unable to connect to %s\n", pv );
+		return 1;
+	}
+	if ( EZCA_OK != ezcaSetMonitor( pv, ezcaDouble, 0 ) ) {
+		fprintf( stderr, "Unable to monitor %s\n", pv );
+		return 1;
+	}
+
+	epicsTimeGetCurrent( &then );
+	for ( i = 0; i < n; i++ )
+		ezcaGetNelem( pv, &nelem );
+	t_nelem = elapsed( &then, n );
+
+	epicsTimeGetCurrent( &then );
+	for ( i = 0; i < n; i++ )
+		ezcaNewMonitorValue( pv, ezcaDouble );
+	t_monval = elapsed( &then, n );
+
+	printf( "%24s %12s (%s prologue)\n", "call", "[ns/call]",
+		old ? "pending" : "non-pending" );
+	printf( "%24s %12.1f\n", "ezcaGetNelem",        t_nelem  );
+	printf( "%24s %12.1f\n", "ezcaNewMonitorValue", t_monval );
+
+	ezcaClearMonitor( pv, ezcaDouble );
+	return 0;
+}
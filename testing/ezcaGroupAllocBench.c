@@ -0,0 +1,75 @@
+/* Allocation count and timing of grouped ezcaGet()s.
+ *
+ * Reads the same PV N times (N = 1k .. max) in one group and reports
+ * the number of heap allocations ezca made for the work requests
+ * (ezcaGetWorkAllocs()) per group. Names and error strings of grouped
+ * work come from an arena, so after the first round this should be a
+ * small constant independent of N.
+ *
+ * Identical gets in flight share one CA request (the others get a
+ * copy of its reply), so a group issues a single request to CA; the
+ * times reported are those of queueing and completing the work
+ * requests, not of N round trips to the server.
+ *
+ * Usage: ezcaGroupAllocBench [pv_name [max_items [rounds]]]
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <cadef.h>
+#include <epicsTime.h>
+#include "ezca.h"
+
+int main( int argc, char * argv[] )
+{
+char           *pv     = "lca:scl0";
+unsigned long  nmax    = 50000;
+unsigned long  rounds  = 5;
+unsigned long  n, i, r, allocs;
+double         *vals;
+epicsTimeStamp then, now;
+double         t;
+
+	if ( argc > 1 )
+		pv     = argv[1];
+	if ( argc > 2 )
+		nmax   = strtoul( argv[2], 0, 0 );
+	if ( argc > 3 )
+		rounds = strtoul( argv[3], 0, 0 );
+
+	if ( ! (vals = malloc( sizeof(*vals) * nmax )) ) {
+		fprintf( stderr, "No memory for %lu values\n", nmax );
+		return 1;
+	}
+
+	/* connect and cache the channel */
+	if ( EZCA_OK != ezcaGet( pv, ezcaDouble, 1, vals ) ) {
+		fprintf( stderr, "Unable to connect to %s\n", pv );
+		return 1;
+	}
+
+	printf( "%10s %8s %16s %12s\n", "items", "round", "allocs/group", "[ms/group]" );
+
+	for ( n = 1000; n <= nmax; n *= 10 ) {
+		for ( r = 0; r < rounds; r++ ) {
+			allocs = ezcaGetWorkAllocs();
+			epicsTimeGetCurrent( &then );
+
+			ezcaStartGroup();
+			for ( i = 0; i < n; i++ )
+				ezcaGet( pv, ezcaDouble, 1, &vals[i] );
+			if ( EZCA_OK != ezcaEndGroup() ) {
+				fprintf( stderr, "Group of %lu failed\n", n );
+				return 1;
+			}
+
+			epicsTimeGetCurrent( &now );
+			t = epicsTimeDiffInSeconds( &now, &then ) * 1.0e3;
+
+			printf( "%10lu %8lu %16lu %12.2f\n",
+				n, r, ezcaGetWorkAllocs() - allocs, t );
+		}
+	}
+
+	free( vals );
+	return 0;
+}
@@ -0,0 +1,296 @@
+/* Test for single-flight gets (a get sharing the reply of an
+ * identical one in flight).
+ *
+ * Run against a soft IOC serving lcaTest.db (see st.cmd). Checks that
+ *  - duplicates of a PV in one group, and 'PV' and 'PV.VAL', read the
+ *    same value (and 'PV.VAL' doesn't make another channel);
+ *  - a put in a group ends the sharing: a get after it sees the new
+ *    value;
+ *  - several threads reading the same PV all succeed;
+ *  - a get of another async group which shared a request that timed
+ *    out still succeeds (within its own deadline);
+ *  - a get which timed out itself while sharing a request that then
+ *    timed out, too, doesn't leave its work node discarded for good.
+ * The timeouts are provoked with a tiny timeout for one group at a
+ * time (each async group has a deadline of its own); whether a
+ * request actually times out depends on the timing, so the run is
+ * repeated and the number of timeouts is reported.
+ *
+ * Usage: ezcaJoinTest [iterations]
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <cadef.h>
+#include <epicsThread.h>
+#include <epicsEvent.h>
+#include "ezca.h"
+
+#define SHARED   "lca:scl2"
+#define NWAVS    10
+#define NELM     100
+#define TINY     1.e-6
+#define TIMEOUT  5.0
+#define NTHREADS 4
+#define NREADS   1000
+
+#define TIMED_OUT(rc) (EZCA_NOTIMELYRESPONSE == (rc) || EZCA_ABORTED == (rc))
+
+static char *wavs[NWAVS] = {
+	"lca:wav0", "lca:wav1", "lca:wav2", "lca:wav3", "lca:wav4",
+	"lca:wav5", "lca:wav6", "lca:wav7", "lca:wav8", "lca:wav9",
+};
+
+static int            failures = 0;
+static double         sharedVal = 1234.5;
+static epicsEventId   threadDone;
+static int            threadFailures[NTHREADS];
+static epicsInt32     wavBuf[NWAVS][NELM];
+
+static void
+fail(const char *what, int rc)
+{
+	fprintf( stderr, "FAILED: %s (rc %d)\n", what, rc );
+	failures++;
+}
+
+/* a group reading all waveforms ahead of SHARED (so that its reply
+ * comes late) and ending asynchronously
+ */
+static EzcaTicket
+issue_slow(double *pval)
+{
+EzcaTicket t = 0;
+int        i;
+
+	ezcaStartGroup();
+	for ( i = 0; i < NWAVS; i++ )
+		ezcaGet( wavs[i], ezcaLong, NELM, wavBuf[i] );
+	ezcaGet( SHARED, ezcaDouble, 1, pval );
+	if ( EZCA_OK != ezcaEndGroupAsync( &t ) )
+		fail( "ezcaEndGroupAsync()", -1 );
+	return t;
+}
+
+static EzcaTicket
+issue_shared(double *pval)
+{
+EzcaTicket t = 0;
+
+	ezcaStartGroup();
+	ezcaGet( SHARED, ezcaDouble, 1, pval );
+	if ( EZCA_OK != ezcaEndGroupAsync( &t ) )
+		fail( "ezcaEndGroupAsync()", -1 );
+	return t;
+}
+
+/* rc of the last request of a group; -1 if the group failed to report */
+static int
+collect_last(EzcaTicket t)
+{
+int *rcs = 0;
+int  n   = 0;
+int  rc;
+
+	ezcaGroupCollect( t, &rcs, &n );
+	rc = ( rcs && n > 0 ) ? rcs[n-1] : -1;
+	ezcaFree( rcs );
+	return rc;
+}
+
+static void
+test_duplicates(void)
+{
+double         d[3];
+int           *rcs = 0;
+int            n   = 0;
+int            i, rc;
+unsigned long  nch0, nch1;
+
+	if ( EZCA_OK != (rc = ezcaPut( "lca:scl0", ezcaDouble, 1, &sharedVal )) ) {
+		fail( "ezcaPut(lca:scl0)", rc );
+		return;
+	}
+	ezcaGetCacheStats( &nch0, 0, 0 );
+
+	ezcaStartGroup();
+	ezcaGet( "lca:scl0",     ezcaDouble, 1, &d[0] );
+	ezcaGet( "lca:scl0",     ezcaDouble, 1, &d[1] );
+	ezcaGet( "lca:scl0.VAL", ezcaDouble, 1, &d[2] );
+	rc = ezcaEndGroupWithReport( &rcs, &n );
+
+	if ( EZCA_OK != rc || 3 != n )
+		fail( "group with duplicates", rc );
+	for ( i = 0; i < n; i++ ) {
+		if ( EZCA_OK != rcs[i] )
+			fail( "duplicate get", rcs[i] );
+		else if ( d[i] != sharedVal )
+			fail( "duplicate get returned a wrong value", 0 );
+	}
+	ezcaFree( rcs );
+
+	ezcaGetCacheStats( &nch1, 0, 0 );
+	if ( nch1 != nch0 )
+		fail( "'PV.VAL' created a channel of its own", (int)(nch1 - nch0) );
+}
+
+static void
+test_put_ends_sharing(void)
+{
+double  before = 1.0, after = 2.0, a = 0., b = 0.;
+int    *rcs = 0;
+int     n   = 0;
+int     i, rc;
+
+	if ( EZCA_OK != (rc = ezcaPut( "lca:scl1", ezcaDouble, 1, &before )) ) {
+		fail( "ezcaPut(lca:scl1)", rc );
+		return;
+	}
+
+	ezcaStartGroup();
+	ezcaGet( "lca:scl1", ezcaDouble, 1, &a );
+	ezcaPut( "lca:scl1", ezcaDouble, 1, &after );
+	ezcaGet( "lca:scl1", ezcaDouble, 1, &b );
+	rc = ezcaEndGroupWithReport( &rcs, &n );
+
+	if ( EZCA_OK != rc || 3 != n )
+		fail( "group with get/put/get", rc );
+	for ( i = 0; i < n; i++ ) {
+		if ( EZCA_OK != rcs[i] )
+			fail( "get/put/get", rcs[i] );
+	}
+	ezcaFree( rcs );
+
+	if ( a != before || b != after )
+		fail( "a get after a put shared the reply of one before it", 0 );
+}
+
+static void
+reader(void *arg)
+{
+int    *nfail = (int *) arg;
+double  v;
+int     i;
+
+	for ( i = 0; i < NREADS; i++ ) {
+		if ( EZCA_OK != ezcaGet( SHARED, ezcaDouble, 1, &v ) || v != sharedVal )
+			(*nfail)++;
+	}
+	epicsEventSignal( threadDone );
+}
+
+static void
+test_threads(void)
+{
+int i;
+
+	threadDone = epicsEventMustCreate( epicsEventEmpty );
+	for ( i = 0; i < NTHREADS; i++ ) {
+		epicsThreadMustCreate( "ezcaJoinTest", epicsThreadPriorityMedium,
+			epicsThreadGetStackSize( epicsThreadStackSmall ),
+			reader, &threadFailures[i] );
+	}
+	for ( i = 0; i < NTHREADS; i++ )
+		epicsEventMustWait( threadDone );
+	for ( i = 0; i < NTHREADS; i++ ) {
+		if ( threadFailures[i] )
+			fail( "concurrent reader", threadFailures[i] );
+	}
+}
+
+/* the leader's group times out while a live get of another group
+ * shares its request; that one must not fail
+ */
+static int
+test_live_joiner(void)
+{
+EzcaTicket t1, t2;
+double     v1 = 0., v2 = 0.;
+int        rc1, rc2;
+
+	ezcaSetTimeout( TINY );
+	t1 = issue_slow( &v1 );
+	ezcaSetTimeout( TIMEOUT );
+	t2 = issue_shared( &v2 );
+
+	/* t1's deadline has passed; gives up on what is still missing */
+	ezcaGroupTest( t1 );
+
+	rc2 = collect_last( t2 );
+	rc1 = collect_last( t1 );
+
+	if ( EZCA_OK != rc2 || v2 != sharedVal )
+		fail( "live get sharing a request that timed out", rc2 );
+	if ( EZCA_OK != rc1 && !TIMED_OUT(rc1) )
+		fail( "leader", rc1 );
+
+	return TIMED_OUT(rc1);
+}
+
+/* a get sharing a request times out first, then the request does */
+static int
+test_trashed_joiner(void)
+{
+EzcaTicket t1, t2;
+double     v1 = 0., v2 = 0.;
+int        rc1, rc2;
+
+	ezcaSetTimeout( TINY );
+	t1 = issue_slow( &v1 );
+	t2 = issue_shared( &v2 );
+	ezcaSetTimeout( TIMEOUT );
+
+	ezcaGroupTest( t2 );
+	ezcaGroupTest( t1 );
+
+	rc2 = collect_last( t2 );
+	rc1 = collect_last( t1 );
+
+	if ( EZCA_OK != rc2 && !TIMED_OUT(rc2) )
+		fail( "timed out get sharing a request", rc2 );
+	if ( EZCA_OK != rc1 && !TIMED_OUT(rc1) )
+		fail( "leader", rc1 );
+
+	return TIMED_OUT(rc1) && TIMED_OUT(rc2);
+}
+
+int main( int argc, char * argv[] )
+{
+int           n = 200;
+int           i, rc, nlive = 0, ntrashed = 0;
+unsigned long ndiscarded;
+double        v;
+
+	if ( argc > 1 )
+		n = atoi( argv[1] );
+
+	ezcaAutoErrorMessageOff();
+	ezcaSetTimeout( TIMEOUT );
+
+	if ( EZCA_OK != (rc = ezcaPut( SHARED, ezcaDouble, 1, &sharedVal )) ) {
+		fprintf( stderr, "Unable to write %s; is the IOC up?\n", SHARED );
+		return 1;
+	}
+
+	test_duplicates();
+	test_put_ends_sharing();
+	test_threads();
+
+	for ( i = 0; i < n; i++ ) {
+		nlive    += test_live_joiner();
+		ntrashed += test_trashed_joiner();
+	}
+	printf( "leader timed out under a live joiner    %4d of %d times\n", nlive, n );
+	printf( "leader timed out under a trashed joiner %4d of %d times\n", ntrashed, n );
+
+	/* late replies recycle what was given up on */
+	epicsThreadSleep( 1.0 );
+	if ( EZCA_OK != (rc = ezcaGet( SHARED, ezcaDouble, 1, &v )) )
+		fail( "get after the timeouts", rc );
+
+	ezcaGetNodeStats( EZCA_NODE_WORK, 0, 0, 0, &ndiscarded );
+	if ( ndiscarded )
+		fail( "work nodes still discarded", (int) ndiscarded );
+
+	printf( "%s\n", failures ? "FAILED" : "PASSED" );
+	return failures ? 1 : 0;
+}
@@ -0,0 +1,97 @@
+/* Benchmark for the ezca channel registry (ezcaReg.c).
+ *
+ * Registers N names (N = 1k .. 1M by default) and measures the
+ * average cost of a successful and of an unsuccessful lookup.
+ * With a growing table these should stay flat as N increases.
+ *
+ * Usage: ezcaRegBench [max_channels [lookups]]
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <epicsTime.h>
+#include "ezcaReg.h"
+
+#define NAME_MAX_LEN 40
+
+typedef struct {
+	EzcaRegNodeRec node;
+	char           name[NAME_MAX_LEN];
+} BenchNode;
+
+static double
+lookups(EzcaReg reg, unsigned long n, unsigned long nlook, int hit)
+{
+char          (*names)[NAME_MAX_LEN];
+unsigned long  i, k, found = 0;
+epicsTimeStamp then, now;
+
+	if ( ! (names = malloc( sizeof(*names) * nlook )) ) {
+		fprintf( stderr, "No memory for %lu names\n", nlook );
+		exit( 1 );
+	}
+
+	/* format the keys up front; only the lookups are timed */
+	for ( i = 0; i < nlook; i++ ) {
+		/* cheap pseudo-random scatter over the registered set */
+		k = (i * 2654435761UL) % n;
+		sprintf( names[i], hit ? "BENCH:DEV%07lu:VAL" : "BENCH:DEV%07lu:NOT", k );
+	}
+
+	epicsTimeGetCurrent( &then );
+	for ( i = 0; i < nlook; i++ ) {
+		if ( ezcaRegFind( reg, names[i] ) )
+			found++;
+	}
+	epicsTimeGetCurrent( &now );
+
+	free( names );
+
+	if ( found != (hit ? nlook : 0) ) {
+		fprintf( stderr, "ERROR: %lu lookups found %lu entries\n", nlook, found );
+		exit( 1 );
+	}
+
+	return epicsTimeDiffInSeconds( &now, &then ) * 1.0e9 / (double)nlook;
+}
+
+int main( int argc, char * argv[] )
+{
+unsigned long  nmax  = 1000000;
+unsigned long  nlook = 1000000;
+unsigned long  n, i;
+BenchNode     *nodes;
+EzcaReg        reg;
+
+	if ( argc > 1 )
+		nmax  = strtoul( argv[1], 0, 0 );
+	if ( argc > 2 )
+		nlook = strtoul( argv[2], 0, 0 );
+
+	if ( ! (nodes = malloc( sizeof(*nodes) * nmax )) ) {
+		fprintf( stderr, "No memory for %lu nodes\n", nmax );
+		return 1;
+	}
+
+	printf( "%10s %10s %16s %16s\n", "channels", "buckets", "hit [ns/lookup]", "miss [ns/lookup]" );
+
+	for ( n = 1000; n <= nmax; n *= 10 ) {
+		/* start from the default size so growth is part of the test */
+		if ( ! (reg = ezcaRegCreate( 0 )) ) {
+			fprintf( stderr, "Unable to create registry\n" );
+			return 1;
+		}
+		for ( i = 0; i < n; i++ ) {
+			sprintf( nodes[i].name, "BENCH:DEV%07lu:VAL", i );
+			ezcaRegInsert( reg, &nodes[i].node, nodes[i].name );
+		}
+		printf( "%10lu %10lu %16.1f %16.1f\n",
+			ezcaRegCount( reg ),
+			ezcaRegBuckets( reg ),
+			lookups( reg, n, nlook, 1 ),
+			lookups( reg, n, nlook, 0 ) );
+		ezcaRegDestroy( reg );
+	}
+
+	free( nodes );
+	return 0;
+}
@@ -0,0 +1,145 @@
+/* Multi-threaded throughput of ezca.
+ *
+ * Runs against a soft IOC serving lcaTest.db (see st.cmd). N threads
+ * each read a scalar of their own (lca:scl0 .. lca:scl9, reused if
+ * there are more threads) for T seconds:
+ *
+ *   get   every read is an ezcaGet() round trip; the get callbacks
+ *         of different channels no longer serialize on the library
+ *         mutex.
+ *   mon   the channels are monitored and ezcaGet() returns the
+ *         latest update; measures the cost of the locking alone.
+ *   grp   every thread reads all ten scalars in a group; groups of
+ *         different threads run at the same time (an op is a group).
+ *
+ * The aggregate and per-thread rates are printed; compare runs with
+ * 1, 2, 4, ... threads.
+ *
+ * Usage: ezcaThreadBench <nthreads> <seconds> get|mon|grp
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <cadef.h>
+#include <epicsTime.h>
+#include <epicsThread.h>
+#include <epicsEvent.h>
+#include "ezca.h"
+
+#define MAXTHREADS 64
+#define NPVS       10
+
+typedef struct Worker_ {
+	char          pv[32];
+	int           grp;
+	double        secs;
+	unsigned long ops;
+	unsigned long errs;
+	epicsEventId  done;
+} Worker;
+
+static epicsEventId  go;
+
+static int
+get_group(void)
+{
+char   pv[32];
+double val[NPVS];
+int    i;
+
+	ezcaStartGroup();
+	for ( i = 0; i < NPVS; i++ ) {
+		/* the name is copied */
+		sprintf( pv, "lca:scl%d", i );
+		ezcaGet( pv, ezcaDouble, 1, &val[i] );
+	}
+	return ezcaEndGroup();
+}
+
+static void
+work(void *arg)
+{
+Worker        *w = arg;
+epicsTimeStamp then, now;
+double         val;
+
+	epicsEventWait( go );
+	/* pass the start on to the next thread */
+	epicsEventSignal( go );
+
+	epicsTimeGetCurrent( &then );
+	do {
+		if ( EZCA_OK == (w->grp ? get_group() : ezcaGet( w->pv, ezcaDouble, 1, &val )) )
+			w->ops++;
+		else
+			w->errs++;
+		epicsTimeGetCurrent( &now );
+	} while ( epicsTimeDiffInSeconds( &now, &then ) < w->secs );
+
+	epicsEventSignal( w->done );
+}
+
+int main( int argc, char * argv[] )
+{
+Worker         w[MAXTHREADS];
+char           name[32];
+int            n, i, mon, grp;
+double         secs, tot = 0.;
+unsigned long  errs = 0;
+
+	if ( argc != 4
+	     || (n = atoi( argv[1] )) < 1 || n > MAXTHREADS
+	     || (secs = atof( argv[2] )) <= 0.
+	     || ( strcmp( argv[3], "get" ) && strcmp( argv[3], "mon" ) && strcmp( argv[3], "grp" ) ) ) {
+		fprintf( stderr, "Usage: %s <nthreads> <seconds> get|mon|grp\n", argv[0] );
+		return 1;
+	}
+	mon = ! strcmp( argv[3], "mon" );
+	grp = ! strcmp( argv[3], "grp" );
+
+	ezcaAutoErrorMessageOff();
+
+	go = epicsEventMustCreate( epicsEventEmpty );
+
+	for ( i = 0; i < n; i++ ) {
+		memset( &w[i], 0, sizeof(w[i]) );
+		sprintf( w[i].pv, "lca:scl%d", i % NPVS );
+		w[i].secs = secs;
+		w[i].grp  = grp;
+		w[i].done = epicsEventMustCreate( epicsEventEmpty );
+		if ( mon && i < NPVS ) {
+			if ( EZCA_OK != ezcaSetMonitor( w[i].pv, ezcaDouble, 1 ) ) {
+				fprintf( stderr, "Unable to monitor %s; is the IOC up?\n", w[i].pv );
+				return 1;
+			}
+		}
+	}
+
+	/* connect (and wait for the first update) before timing */
+	for ( i = 0; i < n && i < NPVS; i++ ) {
+		double val;
+		if ( EZCA_OK != ezcaGet( w[i].pv, ezcaDouble, 1, &val ) ) {
+			fprintf( stderr, "Unable to read %s; is the IOC up?\n", w[i].pv );
+			return 1;
+		}
+	}
+
+	for ( i = 0; i < n; i++ ) {
+		sprintf( name, "bench%d", i );
+		epicsThreadMustCreate( name, epicsThreadPriorityMedium,
+			epicsThreadGetStackSize( epicsThreadStackMedium ), work, &w[i] );
+	}
+
+	epicsEventSignal( go );
+
+	for ( i = 0; i < n; i++ ) {
+		epicsEventWait( w[i].done );
+		printf( "%-8s %-10s %10.0f ops/s\n", "thread", w[i].pv, (double)w[i].ops / secs );
+		tot  += (double)w[i].ops;
+		errs += w[i].errs;
+	}
+
+	printf( "%d threads (%s): %10.0f ops/s total, %lu errors\n", n, argv[3], tot / secs, errs );
+
+	return errs ? 1 : 0;
+}
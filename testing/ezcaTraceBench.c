@@ -0,0 +1,72 @@
+/* Cost of the ezca binary tracer (ezcaTrace.h).
+ *
+ * Times N calls of EZCA_TRACE() with the tracer off and on, then
+ * (if a PV is given) traces a number of ezcaGet()s and writes the
+ * trace to a file for ezcaTraceDump.
+ *
+ * Usage: ezcaTraceBench [n [pv_name [trace_file]]]
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <cadef.h>
+#include <epicsTime.h>
+#include "ezca.h"
+#include "ezcaTrace.h"
+
+static double
+bench(unsigned long n)
+{
+unsigned long  i;
+epicsTimeStamp then, now;
+
+	epicsTimeGetCurrent( &then );
+	for ( i = 0; i < n; i++ )
+		EZCA_TRACE( EZCA_EV_ISSUE_GET, &i, i, 0 );
+	epicsTimeGetCurrent( &now );
+
+	return epicsTimeDiffInSeconds( &now, &then ) * 1.0e9 / (double)n;
+}
+
+int main( int argc, char * argv[] )
+{
+unsigned long  n    = 10000000;
+char           *pv  = 0;
+char           *out = "ezca.trc";
+double         val;
+int            i;
+
+	if ( argc > 1 )
+		n   = strtoul( argv[1], 0, 0 );
+	if ( argc > 2 )
+		pv  = argv[2];
+	if ( argc > 3 )
+		out = argv[3];
+
+	printf( "tracer off: %8.1f ns/event\n", bench( n ) );
+
+	if ( ezcaTraceStart( 0 ) ) {
+		fprintf( stderr, "Unable to start the tracer\n" );
+		return 1;
+	}
+	printf( "tracer on:  %8.1f ns/event\n", bench( n ) );
+
+	if ( pv ) {
+		/* only trace the gets */
+		ezcaTraceStart( 0 );
+		for ( i = 0; i < 100; i++ ) {
+			if ( EZCA_OK != ezcaGet( pv, ezcaDouble, 1, &val ) ) {
+				fprintf( stderr, "Unable to read %s\n", pv );
+				return 1;
+			}
+		}
+		ezcaTraceStop();
+		if ( ezcaTraceSave( out ) ) {
+			fprintf( stderr, "Unable to write %s\n", out );
+			return 1;
+		}
+		printf( "trace of 100 gets written to %s\n", out );
+	}
+
+	ezcaTraceStop();
+	return 0;
+}
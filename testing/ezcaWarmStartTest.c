@@ -0,0 +1,124 @@
+/* Test for the ezca warm start (ezcaSaveChannels/ezcaLoadChannels).
+ *
+ * Run against a soft IOC serving lcaTest.db (see st.cmd):
+ *
+ *   ezcaWarmStartTest save /tmp/lca.ws   connects all PVs of lcaTest.db
+ *                                        and writes the channel list
+ *   ezcaWarmStartTest load /tmp/lca.ws   (a new process) queues the
+ *                                        searches, reports how long it
+ *                                        takes until all are connected
+ *                                        and how long a group reading
+ *                                        all of them then takes.
+ *
+ * A group of ezcaGetNelem()s on cold channels is timed for comparison
+ * when invoked with 'cold'.
+ *
+ * Usage: ezcaWarmStartTest save|load <file> | cold
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <cadef.h>
+#include <epicsTime.h>
+#include <epicsThread.h>
+#include "ezca.h"
+
+static char *pvs[] = {
+	"lca:wav0", "lca:wav1", "lca:wav2", "lca:wav3", "lca:wav4", "lca:wav5",
+	"lca:wav6", "lca:wav7", "lca:wav8", "lca:wav9", "lca:wavA", "lca:count",
+	"lca:scl0", "lca:scl1", "lca:scl2", "lca:scl3", "lca:scl4", "lca:scl5",
+	"lca:scl6", "lca:scl7", "lca:scl8", "lca:scl9", "lca:out",  "lca:li1",
+};
+
+#define NPVS ((int)(sizeof(pvs)/sizeof(pvs[0])))
+
+static double
+since(epicsTimeStamp *then)
+{
+epicsTimeStamp now;
+
+	epicsTimeGetCurrent( &now );
+	return epicsTimeDiffInSeconds( &now, then ) * 1.0e3;
+}
+
+/* read the element count of all PVs in one group */
+static int
+get_all(double *pms)
+{
+int            nelem[NPVS];
+int            i, rc;
+epicsTimeStamp then;
+
+	epicsTimeGetCurrent( &then );
+	ezcaStartGroup();
+	for ( i = 0; i < NPVS; i++ )
+		ezcaGetNelem( pvs[i], &nelem[i] );
+	rc = ezcaEndGroup();
+	*pms = since( &then );
+	return rc;
+}
+
+int main( int argc, char * argv[] )
+{
+int            states[NPVS];
+int            i, n;
+double         t;
+epicsTimeStamp then;
+
+	if ( argc < 2 || ( strcmp( argv[1], "cold" ) && argc < 3 ) ) {
+		fprintf( stderr, "Usage: %s save|load <file> | cold\n", argv[0] );
+		return 1;
+	}
+
+	if ( 0 == strcmp( argv[1], "cold" ) ) {
+		if ( EZCA_OK != get_all( &t ) ) {
+			fprintf( stderr, "Reading the PVs failed; is the IOC up?\n" );
+			return 1;
+		}
+		printf( "cold group of %d PVs:          %8.2f ms\n", NPVS, t );
+		return 0;
+	}
+
+	if ( 0 == strcmp( argv[1], "save" ) ) {
+		if ( EZCA_OK != get_all( &t ) ) {
+			fprintf( stderr, "Reading the PVs failed; is the IOC up?\n" );
+			return 1;
+		}
+		if ( EZCA_OK != ezcaSaveChannels( argv[2] ) ) {
+			fprintf( stderr, "Saving the channel list failed\n" );
+			return 1;
+		}
+		printf( "saved %d channels to %s\n", NPVS, argv[2] );
+		return 0;
+	}
+
+	epicsTimeGetCurrent( &then );
+	if ( EZCA_OK != ezcaLoadChannels( argv[2] ) ) {
+		fprintf( stderr, "Loading the channel list failed\n" );
+		return 1;
+	}
+	printf( "ezcaLoadChannels() returned after %8.2f ms\n", since( &then ) );
+
+	/* must not have waited for anything */
+	n = ezcaConnectionState( pvs, NPVS, states );
+	for ( i = 0; i < NPVS; i++ ) {
+		if ( EZCA_CS_NOCHANNEL == states[i] ) {
+			fprintf( stderr, "FAILED: %s was not in the channel list\n", pvs[i] );
+			return 1;
+		}
+	}
+
+	while ( n < NPVS && since( &then ) < 5000. ) {
+		epicsThreadSleep( 0.001 );
+		n = ezcaConnectionState( pvs, NPVS, states );
+	}
+	printf( "%2d of %d connected after         %8.2f ms\n", n, NPVS, since( &then ) );
+
+	if ( EZCA_OK != get_all( &t ) ) {
+		fprintf( stderr, "FAILED: reading the PVs\n" );
+		return 1;
+	}
+	printf( "warm group of %d PVs:          %8.2f ms\n", NPVS, t );
+
+	return n == NPVS ? 0 : 1;
+}